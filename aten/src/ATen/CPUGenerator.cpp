@@ -1,5 +1,7 @@
 #include "ATen/CPUGenerator.h"
 
+#include "TH/THGenerator.hpp"
+
 #define const_generator_cast(generator) \
   dynamic_cast<const CPUGenerator&>(generator)
 
@@ -46,4 +48,15 @@ void * CPUGenerator::unsafeGetTH() {
   return generator;
 }
 
+// Reserves `increment` blocks of the Philox stream keyed by the initial seed
+// and returns the seed and the offset of the first reserved block. Kernels
+// that draw from disjoint blocks can then run in parallel; see
+// native/cpu/Philox.h.
+std::pair<uint64_t, uint64_t> CPUGenerator::nextPhiloxSeed(uint64_t increment) {
+  std::lock_guard<std::mutex> lock(generator->mutex);
+  uint64_t offset = generator->gen_state.philox_seed_offset;
+  generator->gen_state.philox_seed_offset += increment;
+  return std::make_pair(generator->gen_state.the_initial_seed, offset);
+}
+
 } // namespace at
@@ -0,0 +1,262 @@
+#include "ATen/Parallel.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace at {
+
+namespace {
+
+thread_local bool in_parallel_region_ = false;
+
+ParallelBackend default_backend() {
+  const char* env = std::getenv("ATEN_PARALLEL_BACKEND");
+  if (env) {
+    if (std::strcmp(env, "serial") == 0) {
+      return ParallelBackend::Serial;
+    }
+    if (std::strcmp(env, "native") == 0) {
+      return ParallelBackend::Native;
+    }
+#ifdef _OPENMP
+    if (std::strcmp(env, "openmp") == 0) {
+      return ParallelBackend::OpenMP;
+    }
+#endif
+    AT_WARN("ATEN_PARALLEL_BACKEND=", env, " is not supported, using the default backend");
+  }
+#ifdef _OPENMP
+  return ParallelBackend::OpenMP;
+#else
+  return ParallelBackend::Native;
+#endif
+}
+
+std::atomic<ParallelBackend>& backend() {
+  static std::atomic<ParallelBackend> backend_(default_backend());
+  return backend_;
+}
+
+// A batch of tasks submitted by a single parallel_for/parallel_reduce call.
+// Tasks are claimed through an atomic counter, so whichever thread gets to
+// the group first simply takes the next index; the queued tickets only serve
+// to recruit idle workers.
+struct TaskGroup {
+  TaskGroup(int64_t num_tasks, const std::function<void(int64_t)>* fn)
+      : num_tasks(num_tasks), fn(fn), next(0), done(0) {}
+
+  const int64_t num_tasks;
+  // Owned by the submitting thread, which waits for every claimed task to
+  // finish before returning, so it outlives every call made through it.
+  const std::function<void(int64_t)>* fn;
+  std::atomic<int64_t> next;
+  std::atomic<int64_t> done;
+
+  std::mutex mutex;
+  std::condition_variable finished;
+  std::exception_ptr exception;
+
+  // Runs tasks of this group until none are left to claim.
+  void run() {
+    internal::ParallelRegionGuard guard;
+    int64_t id;
+    while ((id = next.fetch_add(1)) < num_tasks) {
+      try {
+        (*fn)(id);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!exception) {
+          exception = std::current_exception();
+        }
+      }
+      if (done.fetch_add(1) + 1 == num_tasks) {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.notify_all();
+      }
+    }
+  }
+
+  void wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return done.load() == num_tasks; });
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+};
+
+// Thread pool with one deque per worker. A worker pops its own deque from
+// the back and steals from the front of the other deques when it runs dry.
+class WorkStealingPool {
+ public:
+  explicit WorkStealingPool(size_t num_workers)
+      : queues_(num_workers), pending_(0), next_queue_(0), stop_(false) {
+    for (size_t i = 0; i < num_workers; i++) {
+      workers_.emplace_back([this, i] { main_loop(i); });
+    }
+  }
+
+  ~WorkStealingPool() {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      stop_ = true;
+    }
+    wakeup_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  size_t size() const {
+    return workers_.size();
+  }
+
+  void submit(const std::shared_ptr<TaskGroup>& group, size_t num_tickets) {
+    const size_t start = next_queue_.fetch_add(num_tickets);
+    for (size_t i = 0; i < num_tickets; i++) {
+      auto& queue = queues_[(start + i) % queues_.size()];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      queue.tickets.push_back(group);
+    }
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      pending_ += num_tickets;
+    }
+    if (num_tickets == 1) {
+      wakeup_.notify_one();
+    } else {
+      wakeup_.notify_all();
+    }
+  }
+
+ private:
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<std::shared_ptr<TaskGroup>> tickets;
+  };
+
+  bool pop(size_t self, std::shared_ptr<TaskGroup>& group) {
+    {
+      auto& own = queues_[self];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (!own.tickets.empty()) {
+        group = std::move(own.tickets.back());
+        own.tickets.pop_back();
+      }
+    }
+    for (size_t i = 1; !group && i < queues_.size(); i++) {
+      auto& victim = queues_[(self + i) % queues_.size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tickets.empty()) {
+        group = std::move(victim.tickets.front());
+        victim.tickets.pop_front();
+      }
+    }
+    if (group) {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      pending_--;
+      return true;
+    }
+    return false;
+  }
+
+  void main_loop(size_t self) {
+    while (true) {
+      std::shared_ptr<TaskGroup> group;
+      if (pop(self, group)) {
+        group->run();
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      wakeup_.wait(lock, [this] { return stop_ || pending_ > 0; });
+      if (stop_ && pending_ == 0) {
+        return;
+      }
+    }
+  }
+
+  std::vector<WorkerQueue> queues_;
+  std::vector<std::thread> workers_;
+
+  std::mutex sleep_mutex_;
+  std::condition_variable wakeup_;
+  size_t pending_;
+  std::atomic<size_t> next_queue_;
+  bool stop_;
+};
+
+WorkStealingPool& native_pool() {
+  // The calling thread always participates, so one worker fewer than the
+  // number of cores is enough to keep every core busy.
+  static WorkStealingPool pool(
+      std::max<int64_t>(internal::get_max_threads(), 2) - 1);
+  return pool;
+}
+
+} // namespace
+
+void set_parallel_backend(ParallelBackend backend_) {
+#ifndef _OPENMP
+  AT_CHECK(
+      backend_ != ParallelBackend::OpenMP,
+      "ATen was compiled without OpenMP support");
+#endif
+  backend().store(backend_);
+}
+
+ParallelBackend get_parallel_backend() {
+  return backend().load();
+}
+
+bool in_parallel_region() {
+  return in_parallel_region_;
+}
+
+namespace internal {
+
+ParallelRegionGuard::ParallelRegionGuard() : prev_(in_parallel_region_) {
+  in_parallel_region_ = true;
+}
+
+ParallelRegionGuard::~ParallelRegionGuard() {
+  in_parallel_region_ = prev_;
+}
+
+int64_t get_max_threads() {
+  int64_t num_threads = get_num_threads();
+  if (num_threads > 0) {
+    return num_threads;
+  }
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return std::max<int64_t>(std::thread::hardware_concurrency(), 1);
+#endif
+}
+
+void run_on_native_pool(
+    int64_t num_tasks,
+    const std::function<void(int64_t)>& fn) {
+  if (num_tasks <= 0) {
+    return;
+  }
+  auto& pool = native_pool();
+  auto group = std::make_shared<TaskGroup>(num_tasks, &fn);
+  const int64_t num_helpers = std::min<int64_t>(
+      {num_tasks - 1, get_max_threads() - 1, (int64_t)pool.size()});
+  if (num_helpers > 0) {
+    pool.submit(group, num_helpers);
+  }
+  group->run();
+  group->wait();
+}
+
+} // namespace internal
+} // namespace at
@@ -1,12 +1,38 @@
 #pragma once
 #include <ATen/ATen.h>
+#include <algorithm>
 #include <cstddef>
+#include <functional>
+#include <numeric>
+#include <vector>
 
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
 namespace at {
+
+// Intra-op parallelism backends used by parallel_for and parallel_reduce.
+//
+//   Serial - run every range on the calling thread.
+//   OpenMP - static chunking over an OpenMP parallel region (only available
+//            when ATen is compiled with OpenMP).
+//   Native - ATen's own work-stealing thread pool (see Parallel.cpp).
+//
+// The default is OpenMP when available and Native otherwise. It can be
+// overridden with set_parallel_backend or the ATEN_PARALLEL_BACKEND
+// environment variable ("serial", "openmp" or "native").
+enum class ParallelBackend { Serial, OpenMP, Native };
+
+AT_API void set_parallel_backend(ParallelBackend backend);
+AT_API ParallelBackend get_parallel_backend();
+
+// Returns true when called from inside the body of a parallel_for or
+// parallel_reduce. Nested parallel constructs run inline on the current
+// thread instead of spawning more work, so that concurrent callers do not
+// oversubscribe the machine.
+AT_API bool in_parallel_region();
+
 namespace internal {
 // This parameter is heuristically chosen to determine the minimum number of
 // work that warrants paralellism. For example, when summing an array, it is
@@ -14,6 +40,43 @@ namespace internal {
 // no parallel algorithm (such as parallel_reduce) should split work into
 // smaller than GRAIN_SIZE chunks.
 constexpr int64_t GRAIN_SIZE = 32768;
+
+// Number of chunks the native backend aims to hand to every thread. Having
+// more than one chunk per thread lets idle threads steal the tail of an
+// unbalanced range.
+constexpr int64_t CHUNKS_PER_THREAD = 4;
+
+// Marks the current thread as executing a parallel region for its lifetime.
+struct AT_API ParallelRegionGuard {
+  ParallelRegionGuard();
+  ~ParallelRegionGuard();
+ private:
+  bool prev_;
+};
+
+// Number of threads intra-op work may use: get_num_threads() when it was set,
+// otherwise the hardware concurrency.
+AT_API int64_t get_max_threads();
+
+// Runs fn(0), ..., fn(num_tasks - 1) on the native work-stealing pool. The
+// calling thread participates and the call returns once every task has
+// finished. The first exception thrown by a task is rethrown here.
+AT_API void run_on_native_pool(
+    int64_t num_tasks,
+    const std::function<void(int64_t)>& fn);
+
+// Chooses a chunk size of at least grain_size that splits [begin, end) into
+// roughly CHUNKS_PER_THREAD chunks per thread.
+inline int64_t adaptive_grain_size(
+    int64_t begin,
+    int64_t end,
+    int64_t grain_size,
+    int64_t num_threads) {
+  const int64_t range = end - begin;
+  const int64_t target = (range + num_threads * CHUNKS_PER_THREAD - 1) /
+      (num_threads * CHUNKS_PER_THREAD);
+  return std::max(std::max(grain_size, target), (int64_t)1);
+}
 } // namespace internal
 
 inline int64_t divup(int64_t x, int64_t y) {
@@ -26,21 +89,55 @@ inline void parallel_for(
     const int64_t end,
     const int64_t grain_size,
     const F f) {
+  if (begin >= end) {
+    return;
+  }
+  if ((end - begin) < grain_size || in_parallel_region()) {
+    f(begin, end);
+    return;
+  }
+  switch (get_parallel_backend()) {
 #ifdef _OPENMP
-#pragma omp parallel if ((end - begin) >= grain_size)
-  {
-    int64_t num_threads = omp_get_num_threads();
-    int64_t tid = omp_get_thread_num();
-    int64_t chunk_size = divup((end - begin), num_threads);
-    int64_t begin_tid = begin + tid * chunk_size;
-    if (begin_tid < end)
-      f(begin_tid, std::min(end, chunk_size + begin_tid));
+    case ParallelBackend::OpenMP: {
+#pragma omp parallel
+      {
+        internal::ParallelRegionGuard guard;
+        int64_t num_threads = omp_get_num_threads();
+        int64_t tid = omp_get_thread_num();
+        int64_t chunk_size = divup((end - begin), num_threads);
+        int64_t begin_tid = begin + tid * chunk_size;
+        if (begin_tid < end)
+          f(begin_tid, std::min(end, chunk_size + begin_tid));
+      }
+      return;
+    }
+#endif
+    case ParallelBackend::Native: {
+      const int64_t num_threads = internal::get_max_threads();
+      if (num_threads <= 1) {
+        break;
+      }
+      const int64_t chunk_size =
+          internal::adaptive_grain_size(begin, end, grain_size, num_threads);
+      const int64_t num_chunks = divup((end - begin), chunk_size);
+      if (num_chunks <= 1) {
+        break;
+      }
+      internal::run_on_native_pool(num_chunks, [&](int64_t id) {
+        int64_t i = begin + id * chunk_size;
+        f(i, std::min(end, i + chunk_size));
+      });
+      return;
+    }
+    default:
+      break;
   }
-#else
   f(begin, end);
-#endif
 }
 
+// The range is always split into the same GRAIN_SIZE chunks and the partial
+// results are combined left to right, so the result does not depend on the
+// backend or on the number of threads.
 template <class scalar_t, class F, class SF>
 inline scalar_t parallel_reduce(
     const int64_t begin,
@@ -49,20 +146,46 @@ inline scalar_t parallel_reduce(
     const scalar_t ident,
     const F f,
     const SF sf) {
-  if (get_num_threads() == 1) {
+  if (begin >= end) {
+    return ident;
+  }
+  const int64_t num_results = divup((end - begin), grain_size);
+  if (num_results == 1) {
     return f(begin, end, ident);
-  } else {
-    const int64_t num_results = divup((end - begin), grain_size);
-    std::vector<scalar_t> results(num_results);
-    scalar_t* results_data = results.data();
-#pragma omp parallel for if ((end - begin) >= grain_size)
-    for (int64_t id = 0; id < num_results; id++) {
-      int64_t i = begin + id * grain_size;
-      results_data[id] = f(i, i + std::min(end - i, grain_size), ident);
+  }
+  std::vector<scalar_t> results(num_results);
+  scalar_t* results_data = results.data();
+  auto reduce_chunk = [&](int64_t id) {
+    int64_t i = begin + id * grain_size;
+    results_data[id] = f(i, i + std::min(end - i, grain_size), ident);
+  };
+  const bool serial =
+      internal::get_max_threads() <= 1 || in_parallel_region();
+  switch (serial ? ParallelBackend::Serial : get_parallel_backend()) {
+#ifdef _OPENMP
+    case ParallelBackend::OpenMP: {
+#pragma omp parallel
+      {
+        internal::ParallelRegionGuard guard;
+#pragma omp for
+        for (int64_t id = 0; id < num_results; id++) {
+          reduce_chunk(id);
+        }
+      }
+      break;
     }
-    return std::accumulate(
-        results_data, results_data + results.size(), ident, sf);
+#endif
+    case ParallelBackend::Native:
+      internal::run_on_native_pool(num_results, reduce_chunk);
+      break;
+    default:
+      for (int64_t id = 0; id < num_results; id++) {
+        reduce_chunk(id);
+      }
+      break;
   }
+  return std::accumulate(
+      results_data, results_data + results.size(), ident, sf);
 }
 
 } // namespace at
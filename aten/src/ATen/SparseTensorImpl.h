@@ -46,6 +46,13 @@ struct SparseTensorImpl : public TensorImpl {
   // because many algorithms proceed by merging two sorted lists (of indices).
   bool coalesced_ = false;
 
+  // Row pointers of the CSR form of a coalesced tensor with two sparse
+  // dimensions: the nonzeros of row i are the entries [crow_indices_[i],
+  // crow_indices_[i + 1]). Computed on first use and cached, since every
+  // sparse-dense matmul needs them; undefined until then. Any change of the
+  // indices drops it.
+  Tensor crow_indices_;
+
 public:
   // Public for now...
   explicit SparseTensorImpl(Type * type);
@@ -56,6 +63,7 @@ public:
   bool coalesced() const { return coalesced_; }
   Tensor indices() const { return indices_; }
   Tensor values() const { return values_; }
+  Tensor crow_indices() const { return crow_indices_; }
 
   const char * toString() const override;
   IntList sizes() const override;
@@ -80,6 +88,7 @@ public:
     }
     sparseDims_ = sparseDims;
     denseDims_ = denseDims;
+    crow_indices_ = Tensor();
   }
 
   // TODO: I hate these two setters, please get rid of them!!!
@@ -87,14 +96,29 @@ public:
     AT_ASSERT(indices.type().backend() == at::toDense(type().backend()));
     AT_ASSERT(indices.type().scalarType() == kLong);
     indices_ = indices;
+    crow_indices_ = Tensor();
   }
   void set_values(const Tensor& values) {
     AT_ASSERT(values.type().toSparse() == type());
     values_ = values;
   }
 
-  void set_coalesced(bool coalesced) { coalesced_ = coalesced; }
-  void set_nnz(int64_t nnz) { nnz_ = nnz; }
+  void set_coalesced(bool coalesced) {
+    coalesced_ = coalesced;
+    if (!coalesced) {
+      crow_indices_ = Tensor();
+    }
+  }
+  void set_nnz(int64_t nnz) {
+    nnz_ = nnz;
+    crow_indices_ = Tensor();
+  }
+  // crow_indices must be the row pointers of the current indices, see
+  // crow_indices_
+  void set_crow_indices(const Tensor& crow_indices) {
+    AT_ASSERT(coalesced_ && sparseDims_ == 2);
+    crow_indices_ = crow_indices;
+  }
 
   // This used to be called THSTensor_(_move)
   // NB: This used to be able to avoid a refcount bump, but I was too lazy to
@@ -7,9 +7,9 @@ namespace at { namespace vec256 {
 template <typename scalar_t, typename Op>
 inline scalar_t vec_reduce_all(
     const Op& vec_fun,
-    vec256::Vec256<scalar_t> acc_vec,
+    Vectorized<scalar_t> acc_vec,
     int64_t size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = Vectorized<scalar_t>;
   scalar_t acc_arr[Vec::size];
   acc_vec.store(acc_arr);
   for (int64_t i = 1; i < size; i++) {
@@ -24,7 +24,7 @@ inline scalar_t vec_reduce_all(
 
 template <typename scalar_t, typename Op>
 inline scalar_t reduce_all(const Op& vec_fun, scalar_t* data, int64_t size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = Vectorized<scalar_t>;
   if (size < Vec::size)
     return vec_reduce_all(vec_fun, Vec::loadu(data, size), size);
   int64_t d = Vec::size;
@@ -46,7 +46,7 @@ inline scalar_t map_reduce_all(
     const ReduceOp& red_fun,
     scalar_t* data,
     int64_t size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = Vectorized<scalar_t>;
   if (size < Vec::size)
     return vec_reduce_all(red_fun, map_fun(Vec::loadu(data, size)), size);
   int64_t d = Vec::size;
@@ -71,7 +71,7 @@ inline scalar_t map2_reduce_all(
     scalar_t* data,
     scalar_t* data2,
     int64_t size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = Vectorized<scalar_t>;
   if (size < Vec::size) {
     Vec data_vec = Vec::loadu(data, size);
     Vec data2_vec = Vec::loadu(data2, size);
@@ -101,7 +101,7 @@ inline void map(
     scalar_t* output_data,
     const scalar_t* input_data,
     int64_t size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = Vectorized<scalar_t>;
   int64_t d = 0;
   for (; d < size - (size % Vec::size); d += Vec::size) {
     Vec output_vec = vec_fun(Vec::loadu(input_data + d));
@@ -120,7 +120,7 @@ inline void map2(
     scalar_t* input_data,
     scalar_t* input_data2,
     int64_t size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = Vectorized<scalar_t>;
   int64_t d = 0;
   for (; d < size - (size % Vec::size); d += Vec::size) {
     Vec data_vec = Vec::loadu(input_data + d);
@@ -6,6 +6,10 @@
 #include "vec256_float.h"
 #include "vec256_double.h"
 #include "vec256_int.h"
+#include "vec512_base.h"
+#include "vec512_float.h"
+#include "vec512_double.h"
+#include "vec512_int.h"
 
 #include <algorithm>
 #include <cstddef>
@@ -17,6 +21,18 @@ namespace at {
 namespace vec256 {
 namespace {
 
+// The widest vector type of the CPU capability a kernel is compiled for.
+// Kernels under native/cpu should use Vectorized<T> and Vectorized<T>::size
+// rather than a fixed width, so that the AVX512 copy of the kernel works on
+// 512-bit vectors while the other copies keep using Vec256.
+#if defined(CPU_CAPABILITY_AVX512)
+template <typename T>
+using Vectorized = Vec512<T>;
+#else
+template <typename T>
+using Vectorized = Vec256<T>;
+#endif
+
 template <typename T>
 std::ostream& operator<<(std::ostream& stream, const Vec256<T>& vec) {
   T buf[Vec256<T>::size];
@@ -32,4 +48,19 @@ std::ostream& operator<<(std::ostream& stream, const Vec256<T>& vec) {
   return stream;
 }
 
+template <typename T>
+std::ostream& operator<<(std::ostream& stream, const Vec512<T>& vec) {
+  T buf[Vec512<T>::size];
+  vec.store(buf);
+  stream << "vec[";
+  for (int i = 0; i != Vec512<T>::size; i++) {
+    if (i != 0) {
+      stream << ", ";
+    }
+    stream << buf[i];
+  }
+  stream << "]";
+  return stream;
+}
+
 }}}
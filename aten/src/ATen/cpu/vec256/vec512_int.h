@@ -0,0 +1,137 @@
+#pragma once
+
+#include "intrinsics.h"
+#include "vec512_base.h"
+
+namespace at {
+namespace vec256 {
+namespace {
+
+// int16_t stays emulated, its instructions are part of AVX512BW
+#ifdef __AVX512F__
+
+struct Vec512i {
+  __m512i values;
+  Vec512i() {}
+  Vec512i(__m512i v) : values(v) {}
+  operator __m512i() const {
+    return values;
+  }
+};
+
+template <>
+struct Vec512<int64_t> : public Vec512i {
+  static constexpr int size = 8;
+  using Vec512i::Vec512i;
+  Vec512() {}
+  Vec512(int64_t v) { values = _mm512_set1_epi64(v); }
+  template <int64_t mask>
+  static Vec512<int64_t> blend(Vec512<int64_t> a, Vec512<int64_t> b) {
+    return _mm512_mask_blend_epi64(mask, a, b);
+  }
+  static Vec512<int64_t>
+  set(Vec512<int64_t> a, Vec512<int64_t> b, int64_t count = size) {
+    if (count >= size)
+      return b;
+    return _mm512_mask_blend_epi64((1 << count) - 1, a, b);
+  }
+  static Vec512<int64_t> loadu(const void* ptr) {
+    return _mm512_loadu_si512(ptr);
+  }
+  static Vec512<int64_t> loadu(const void* ptr, int64_t count) {
+    return _mm512_maskz_loadu_epi64((1 << count) - 1, ptr);
+  }
+  void store(void* ptr, int count = size) const {
+    if (count == size) {
+      _mm512_storeu_si512(ptr, values);
+    } else {
+      _mm512_mask_storeu_epi64(ptr, (1 << count) - 1, values);
+    }
+  }
+  Vec512<int64_t> abs() const {
+    return _mm512_abs_epi64(values);
+  }
+};
+
+template <>
+struct Vec512<int32_t> : public Vec512i {
+  static constexpr int size = 16;
+  using Vec512i::Vec512i;
+  Vec512() {}
+  Vec512(int32_t v) { values = _mm512_set1_epi32(v); }
+  template <int64_t mask>
+  static Vec512<int32_t> blend(Vec512<int32_t> a, Vec512<int32_t> b) {
+    return _mm512_mask_blend_epi32(mask, a, b);
+  }
+  static Vec512<int32_t>
+  set(Vec512<int32_t> a, Vec512<int32_t> b, int32_t count = size) {
+    if (count >= size)
+      return b;
+    return _mm512_mask_blend_epi32((1 << count) - 1, a, b);
+  }
+  static Vec512<int32_t> loadu(const void* ptr) {
+    return _mm512_loadu_si512(ptr);
+  }
+  static Vec512<int32_t> loadu(const void* ptr, int32_t count) {
+    return _mm512_maskz_loadu_epi32((1 << count) - 1, ptr);
+  }
+  void store(void* ptr, int count = size) const {
+    if (count == size) {
+      _mm512_storeu_si512(ptr, values);
+    } else {
+      _mm512_mask_storeu_epi32(ptr, (1 << count) - 1, values);
+    }
+  }
+  Vec512<int32_t> abs() const {
+    return _mm512_abs_epi32(values);
+  }
+};
+
+template <>
+Vec512<int64_t> inline operator+(const Vec512<int64_t>& a, const Vec512<int64_t>& b) {
+  return _mm512_add_epi64(a, b);
+}
+
+template <>
+Vec512<int32_t> inline operator+(const Vec512<int32_t>& a, const Vec512<int32_t>& b) {
+  return _mm512_add_epi32(a, b);
+}
+
+template <>
+Vec512<int64_t> inline operator-(const Vec512<int64_t>& a, const Vec512<int64_t>& b) {
+  return _mm512_sub_epi64(a, b);
+}
+
+template <>
+Vec512<int32_t> inline operator-(const Vec512<int32_t>& a, const Vec512<int32_t>& b) {
+  return _mm512_sub_epi32(a, b);
+}
+
+// _mm512_mullo_epi64 is part of AVX512DQ, so the product is put together from
+// 32-bit multiplies: a * b = lo(a) * lo(b) + ((hi(a) * lo(b) + lo(a) * hi(b)) << 32)
+template <>
+Vec512<int64_t> inline operator*(const Vec512<int64_t>& a, const Vec512<int64_t>& b) {
+  __m512i lo = _mm512_mul_epu32(a, b);
+  __m512i hi_a = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), b);
+  __m512i hi_b = _mm512_mul_epu32(a, _mm512_srli_epi64(b, 32));
+  __m512i hi = _mm512_slli_epi64(_mm512_add_epi64(hi_a, hi_b), 32);
+  return _mm512_add_epi64(lo, hi);
+}
+
+template <>
+Vec512<int32_t> inline operator*(const Vec512<int32_t>& a, const Vec512<int32_t>& b) {
+  return _mm512_mullo_epi32(a, b);
+}
+
+template <>
+Vec512<int64_t> inline max(const Vec512<int64_t>& a, const Vec512<int64_t>& b) {
+  return _mm512_max_epi64(a, b);
+}
+
+template <>
+Vec512<int32_t> inline max(const Vec512<int32_t>& a, const Vec512<int32_t>& b) {
+  return _mm512_max_epi32(a, b);
+}
+#endif
+
+}}}
@@ -29,8 +29,8 @@ template <typename scalar_t>
 inline void vrsqrt(scalar_t* out, scalar_t* in, int64_t size) {
   parallel_for(0, size, 2048, [out, in](int64_t begin, int64_t end) {
     map(
-        [](const Vec256<scalar_t>& x) {
-          return Vec256<scalar_t>((scalar_t)(1)) / x.sqrt();
+        [](const Vectorized<scalar_t>& x) {
+          return Vectorized<scalar_t>((scalar_t)(1)) / x.sqrt();
         },
         out + begin,
         in + begin,
@@ -44,7 +44,7 @@ inline void vrsqrt(scalar_t* out, scalar_t* in, int64_t size) {
   template <typename scalar_t>                                          \
   inline void v##op(scalar_t* out, scalar_t* in, int64_t size) {        \
     parallel_for(0, size, 2048, [out, in](int64_t begin, int64_t end) { \
-      map([](const Vec256<scalar_t>& x) { return x.op(); },             \
+      map([](const Vectorized<scalar_t>& x) { return x.op(); },         \
           out + begin,                                                  \
           in + begin,                                                   \
           end - begin);                                                 \
@@ -143,11 +143,13 @@ generators = {
     'CPUGenerator.h': {
         'name': 'CPU',
         'th_generator': 'THGenerator * generator;',
+        'methods': ['std::pair<uint64_t, uint64_t> nextPhiloxSeed(uint64_t increment);'],
         'header': 'TH/TH.h',
     },
     'CUDAGenerator.h': {
         'name': 'CUDA',
         'th_generator': '',
+        'methods': [],
         'header': 'THC/THC.h'
     },
 }
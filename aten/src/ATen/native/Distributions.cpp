@@ -9,6 +9,7 @@
 #include "ATen/CheckGenerator.h"
 #include "ATen/Generator.h"
 #include "ATen/native/Distributions.h"
+#include "ATen/native/cpu/RandomKernel.h"
 
 #include <functional>
 
@@ -54,6 +55,25 @@ THGenerator* get_generator(at::Generator* gen) {
   return gen_->generator;
 }
 
+at::CPUGenerator* get_cpu_generator(at::Generator* gen) {
+  auto default_gen = &at::globalContext().defaultGenerator(at::Backend::CPU);
+  return at::check_generator<at::CPUGenerator>(gen, default_gen);
+}
+
+// The Philox kernels fill contiguous tensors; anything else is sampled into
+// a temporary and copied over.
+template <typename F>
+at::Tensor& philox_sample(at::Tensor& self, const F& sample) {
+  if (self.is_contiguous()) {
+    sample(self);
+    return self;
+  }
+  at::Tensor out = self.type().tensor(self.sizes());
+  sample(out);
+  self.copy_(out);
+  return self;
+}
+
 int64_t sample_poisson(double lambda, THGenerator* generator) {
   if (lambda >= 10) {
     // transformed rejection method, (Hoermann, 1993)
@@ -145,14 +165,33 @@ Tensor& bernoulli_(Tensor& self, const Tensor& p_, Generator* gen) {
 }
 
 Tensor& bernoulli_(Tensor& self, double p, Generator* gen) {
-    self._bernoulli_(p, gen);
-    return self;
+  if (!self.is_cuda()) {
+    AT_CHECK(p >= 0 && p <= 1, "bernoulli_ expects p to be in [0, 1], but got p=", p);
+    return philox_sample(self, [&](Tensor& out) {
+      bernoulli_scalar_kernel(out, p, get_cpu_generator(gen));
+    });
+  }
+  self._bernoulli_(p, gen);
+  return self;
 }
 
 Tensor& bernoulli_(Tensor& self) {
   return native::bernoulli_(self, 0.5, nullptr);
 }
 
+Tensor& _uniform__cpu(Tensor& self, double from, double to, Generator* gen) {
+  return philox_sample(self, [&](Tensor& out) {
+    uniform_kernel(out, from, to, get_cpu_generator(gen));
+  });
+}
+
+Tensor& _normal__cpu(Tensor& self, double mean, double std, Generator* gen) {
+  AT_CHECK(std > 0.0, "normal_ expects std > 0.0, but found std=", std);
+  return philox_sample(self, [&](Tensor& out) {
+    normal_kernel(out, mean, std, get_cpu_generator(gen));
+  });
+}
+
 Tensor _standard_gamma_grad_cpu(const Tensor& self, const Tensor& output) {
   Tensor ret = self.type().tensor(self.sizes());
   AT_DISPATCH_FLOATING_TYPES(self.type(), "_standard_gamma_grad", [&] {
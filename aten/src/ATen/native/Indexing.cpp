@@ -20,11 +20,16 @@
 // Note 2: The behavior is more complicated when the index tensors are not all
 // adjacent (e.g. x[[0, 1], :, [2, 3]]). In this case, self and the index
 // tensors are transposed to the front: x.transpose(1, 2)[[0, 1], [2, 3]]
+//
+// On CPU, the indexed slices are gathered and scattered by the kernels in
+// cpu/IndexKernel.cpp. Other backends compute a linear index into self and
+// use take() and put_().
 
 
 #include "ATen/ATen.h"
 #include "ATen/NativeFunctions.h"
 #include "ATen/ExpandUtils.h"
+#include "ATen/native/cpu/IndexKernel.h"
 
 #include <algorithm>
 #include <functional>
@@ -142,7 +147,7 @@ static Tensor unsqueezeN(const Tensor & src, int64_t before, int64_t after) {
   return src.view(sizes);
 }
 
-static Tensor wrapIndexOnce(const Tensor & index, int64_t dim, int64_t dim_size) {
+static void checkIndexInBounds(const Tensor & index, int64_t dim, int64_t dim_size) {
   auto max_idx = index.max().toCLong();
   auto min_idx = index.min().toCLong();
   if (max_idx >= dim_size) {
@@ -151,6 +156,10 @@ static Tensor wrapIndexOnce(const Tensor & index, int64_t dim, int64_t dim_size)
   if (min_idx < -dim_size) {
     AT_ERROR("index ", min_idx, " is out of bounds for dimension ", dim, " with size ", dim_size);
   }
+}
+
+static Tensor wrapIndexOnce(const Tensor & index, int64_t dim, int64_t dim_size) {
+  checkIndexInBounds(index, dim, dim_size);
   return index.remainder(dim_size);
 }
 
@@ -217,15 +226,20 @@ static bool hasEmptyTensor(TensorList tensors) {
   return false;
 }
 
-static std::tuple<Tensor, Tensor> makeLinearIndex(Tensor self, TensorList orig) {
+// Expands the masks in `orig` and broadcasts the indices together, adding
+// nulls so that there is one index per dimension of self. If the non-null
+// indices are not adjacent, self and the indices are transposed together so
+// that they come first. Returns false, and leaves self and indices alone, if
+// any index is empty.
+static bool prepareIndices(Tensor & self, std::vector<Tensor> & indices, TensorList orig) {
   checkIndexTensorTypes(orig);
   // first expand ByteTensor (boolean masks) into 1 or more LongTensors
-  auto indices = expandByteTensors(self, orig);
-  if (hasEmptyTensor(indices)) {
-    return std::make_tuple(self, self.type().toScalarType(kLong).tensor());
+  auto expanded = expandByteTensors(self, orig);
+  if (hasEmptyTensor(expanded)) {
+    return false;
   }
   // next broadcast all index tensors together
-  indices = expand_outplace(indices);
+  indices = expand_outplace(expanded);
   // add missing null Tensors so that it matches self.dim()
   while (indices.size() < (size_t)self.dim()) {
     indices.emplace_back();
@@ -235,41 +249,107 @@ static std::tuple<Tensor, Tensor> makeLinearIndex(Tensor self, TensorList orig)
   if (!hasContiguousSubspace(indices)) {
     std::tie(self, indices) = transposeToFront(self, indices);
   }
+  return true;
+}
+
+static std::tuple<Tensor, Tensor> makeLinearIndex(Tensor self, TensorList orig) {
+  std::vector<Tensor> indices;
+  if (!prepareIndices(self, indices, orig)) {
+    return std::make_tuple(self, self.type().toScalarType(kLong).tensor());
+  }
   auto linearIndex = computeLinearIndex(self, indices);
   return std::make_tuple(self, linearIndex);
 }
 
+static bool useIndexKernel(const Tensor & self) {
+  return self.type().backend() == kCPU;
+}
+
+// Arguments of the CPU index kernels, see cpu/IndexKernel.h. Returns false if
+// there is nothing to index, in which case the linear index path is used.
+static bool makeKernelIndices(
+    Tensor & self, std::vector<Tensor> & kernelIndices, int64_t & dim,
+    TensorList orig) {
+  std::vector<Tensor> indices;
+  if (!prepareIndices(self, indices, orig)) {
+    return false;
+  }
+  auto isDefined = [](const Tensor & tensor){ return tensor.defined(); };
+  auto first = std::find_if(indices.begin(), indices.end(), isDefined);
+  if (first == indices.end()) {
+    return false;
+  }
+  dim = first - indices.begin();
+  Type& longType = self.type().toScalarType(kLong);
+  for (auto it = first; it != indices.end() && it->defined(); ++it) {
+    int64_t i = it - indices.begin();
+    checkIndexInBounds(*it, i, self.size(i));
+    kernelIndices.emplace_back(it->toType(longType).contiguous());
+  }
+  return true;
+}
+
+// Sizes of the result of indexing self by the kernel indices
+static std::vector<int64_t> indexedSizes(
+    const Tensor & self, TensorList kernelIndices, int64_t dim) {
+  auto selfSizes = self.sizes();
+  auto indexSizes = kernelIndices[0].sizes();
+  std::vector<int64_t> sizes(selfSizes.begin(), selfSizes.begin() + dim);
+  sizes.insert(sizes.end(), indexSizes.begin(), indexSizes.end());
+  sizes.insert(sizes.end(), selfSizes.begin() + dim + kernelIndices.size(), selfSizes.end());
+  return sizes;
+}
+
 Tensor index(const Tensor & self, TensorList indices) {
   if (indices.size() > (size_t)self.dim()) {
    AT_ERROR("too many indices for tensor of dimension ", self.dim(), " (got ", indices.size(), ")");
   }
 
+  if (useIndexKernel(self)) {
+    Tensor src = self;
+    std::vector<Tensor> kernelIndices;
+    int64_t dim;
+    if (makeKernelIndices(src, kernelIndices, dim, indices)) {
+      Tensor result = src.type().tensor(indexedSizes(src, kernelIndices, dim));
+      index_kernel(result, src, kernelIndices, dim);
+      return result;
+    }
+  }
+
   Tensor src, linearIndex;
   std::tie(src, linearIndex) = makeLinearIndex(self, indices);
   return src.take(linearIndex);
 }
 
-Tensor index_put(const Tensor & self, TensorList indices, const Tensor & value) {
-  if (indices.size() > (size_t)self.dim()) {
-   AT_ERROR("too many indices for tensor of dimension ", self.dim(), " (got ", indices.size(), ")");
-  }
-
-  Tensor src, linearIndex, expandedValue;
-  std::tie(src, linearIndex) = makeLinearIndex(self, indices);
-  std::tie(expandedValue) = expand_inplace(linearIndex, value);
-  Tensor dst = src.clone();
-  return dst.put_(linearIndex, expandedValue);
+Tensor index_put(const Tensor & self, TensorList indices, const Tensor & value, bool accumulate) {
+  return self.clone().index_put_(indices, value, accumulate);
 }
 
-Tensor & index_put_(Tensor & self, TensorList indices, const Tensor & value) {
+Tensor & index_put_(Tensor & self, TensorList indices, const Tensor & value, bool accumulate) {
   if (indices.size() > (size_t)self.dim()) {
    AT_ERROR("too many indices for tensor of dimension ", self.dim(), " (got ", indices.size(), ")");
   }
+  if (value.type() != self.type()) {
+    AT_ERROR("index_put_(): expected value of type ", self.type().toString(),
+             " but got ", value.type().toString());
+  }
+
+  if (useIndexKernel(self)) {
+    Tensor src = self;
+    std::vector<Tensor> kernelIndices;
+    int64_t dim;
+    if (makeKernelIndices(src, kernelIndices, dim, indices)) {
+      Tensor expandedValue = value.expand(indexedSizes(src, kernelIndices, dim));
+      index_put_kernel(src, kernelIndices, dim, expandedValue, accumulate);
+      return self;
+    }
+  }
 
   Tensor src, linearIndex, expandedValue;
   std::tie(src, linearIndex) = makeLinearIndex(self, indices);
   std::tie(expandedValue) = expand_inplace(linearIndex, value);
-  return src.put_(linearIndex, expandedValue);
+  src.put_(linearIndex, expandedValue, accumulate);
+  return self;
 }
 
 Tensor & index_copy_(Tensor & self, int64_t dim, const Tensor & index, const Tensor & source) {
@@ -4,7 +4,9 @@
 #include "ATen/Config.h"
 
 #include "ATen/detail/CUDAHooksInterface.h"
+#include "ATen/native/cpu/NormalizationKernel.h"
 
+#include <tuple>
 #include <vector>
 
 namespace at { namespace native {
@@ -17,6 +19,13 @@ namespace {
       throw std::runtime_error(ss.str());
     }
   }
+
+  // Whether the fused CPU kernels of layer_norm and group_norm apply
+  bool use_fused_cpu_norm(const Tensor& input) {
+    return input.type().backend() == kCPU &&
+        (input.type().scalarType() == kFloat ||
+         input.type().scalarType() == kDouble);
+  }
 }
 
 Tensor batch_norm(
@@ -115,6 +124,19 @@ Tensor layer_norm(const Tensor& input, IntList normalized_shape,
       n *= input_shape[i];
     }
 
+    if (use_fused_cpu_norm(input)) {
+      // weight and bias are flattened, autograd restores their shape
+      int64_t N = 1;
+      for (auto size : normalized_shape) {
+        N *= size;
+      }
+      return std::get<0>(at::_layer_norm(
+          input,
+          weight.defined() ? weight.reshape({N}) : weight,
+          bias.defined() ? bias.reshape({N}) : bias,
+          n, N, eps));
+    }
+
     // Apply layer norm
     auto input_reshaped = input.contiguous().view({1, n, -1});
 
@@ -165,6 +187,12 @@ Tensor group_norm(const Tensor& input, int64_t num_groups,
       throw std::runtime_error(ss.str());
     }
 
+    if (use_fused_cpu_norm(input)) {
+      const int64_t HxW = b * c == 0 ? 0 : input.numel() / (b * c);
+      return std::get<0>(at::_group_norm(
+          input, weight, bias, b, c, HxW, num_groups, eps));
+    }
+
     // Apply group norm
     auto input_reshaped = input.contiguous().view({1, b * num_groups, -1});
 
@@ -188,4 +216,88 @@ Tensor group_norm(const Tensor& input, int64_t num_groups,
     }
 }
 
+std::tuple<Tensor, Tensor, Tensor> layer_norm_cpu(
+    const Tensor& input, const Tensor& weight /* optional */, const Tensor& bias /* optional */,
+    int64_t M, int64_t N, double eps) {
+  AT_CHECK(input.numel() == M * N, "Expected input with ", M * N,
+           " elements, but got input of size ", input.sizes());
+  auto X = input.contiguous();
+  auto gamma = weight.defined() ? weight.contiguous() : weight;
+  auto beta = bias.defined() ? bias.contiguous() : bias;
+  Tensor Y = at::native::empty_like(X);
+  Tensor mean = X.type().tensor({M});
+  Tensor rstd = X.type().tensor({M});
+  if (M > 0 && N > 0) {
+    layer_norm_kernel(Y, mean, rstd, X, gamma, beta, M, N, eps);
+  }
+  return std::make_tuple(Y, mean, rstd);
+}
+
+std::tuple<Tensor, Tensor, Tensor> layer_norm_backward_cpu(
+    const Tensor& grad_out, const Tensor& input, const Tensor& mean, const Tensor& rstd,
+    const Tensor& weight /* optional */, int64_t M, int64_t N, std::array<bool,3> output_mask) {
+  auto dY = grad_out.contiguous();
+  auto X = input.contiguous();
+  auto gamma = weight.defined() ? weight.contiguous() : weight;
+  Tensor dX, dgamma, dbeta;
+  if (output_mask[0]) {
+    dX = at::native::empty_like(X);
+  }
+  if (output_mask[1] && weight.defined()) {
+    dgamma = at::zeros({N}, X.type());
+  }
+  if (output_mask[2]) {
+    dbeta = at::zeros({N}, X.type());
+  }
+  if (M > 0 && N > 0) {
+    layer_norm_backward_kernel(
+        dX, dgamma, dbeta, dY, X, mean.contiguous(), rstd.contiguous(), gamma, M, N);
+  }
+  return std::make_tuple(dX, dgamma, dbeta);
+}
+
+std::tuple<Tensor, Tensor, Tensor> group_norm_cpu(
+    const Tensor& input, const Tensor& weight /* optional */, const Tensor& bias /* optional */,
+    int64_t N, int64_t C, int64_t HxW, int64_t group, double eps) {
+  AT_CHECK(input.numel() == N * C * HxW, "Expected input with ", N * C * HxW,
+           " elements, but got input of size ", input.sizes());
+  AT_CHECK(group > 0 && C % group == 0, "Expected number of channels ", C,
+           " to be divisible by the number of groups ", group);
+  auto X = input.contiguous();
+  auto gamma = weight.defined() ? weight.contiguous() : weight;
+  auto beta = bias.defined() ? bias.contiguous() : bias;
+  Tensor Y = at::native::empty_like(X);
+  Tensor mean = X.type().tensor({N, group});
+  Tensor rstd = X.type().tensor({N, group});
+  if (N > 0 && C > 0 && HxW > 0) {
+    group_norm_kernel(Y, mean, rstd, X, gamma, beta, N, C, HxW, group, eps);
+  }
+  return std::make_tuple(Y, mean, rstd);
+}
+
+std::tuple<Tensor, Tensor, Tensor> group_norm_backward_cpu(
+    const Tensor& grad_out, const Tensor& input, const Tensor& mean, const Tensor& rstd,
+    const Tensor& weight /* optional */, int64_t N, int64_t C, int64_t HxW, int64_t group,
+    std::array<bool,3> output_mask) {
+  auto dY = grad_out.contiguous();
+  auto X = input.contiguous();
+  auto gamma = weight.defined() ? weight.contiguous() : weight;
+  Tensor dX, dgamma, dbeta;
+  if (output_mask[0]) {
+    dX = at::native::empty_like(X);
+  }
+  if (output_mask[1] && weight.defined()) {
+    dgamma = at::zeros({C}, X.type());
+  }
+  if (output_mask[2]) {
+    dbeta = at::zeros({C}, X.type());
+  }
+  if (N > 0 && C > 0 && HxW > 0) {
+    group_norm_backward_kernel(
+        dX, dgamma, dbeta, dY, X, mean.contiguous(), rstd.contiguous(), gamma,
+        N, C, HxW, group);
+  }
+  return std::make_tuple(dX, dgamma, dbeta);
+}
+
 }} // at::native
@@ -0,0 +1,224 @@
+#pragma once
+
+// Building blocks for sorting and grouping on CPU. The parallel passes split
+// their input into the fixed chunks of num_chunks_for, so that per-chunk
+// results (histograms, group counts) can be combined in chunk order and the
+// output does not depend on the number of threads.
+
+#include "ATen/ATen.h"
+#include "ATen/Parallel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace at {
+namespace native {
+
+// Number of chunks the parallel passes split n elements into. The passes
+// rely on every chunk being processed as a whole by one task, so the chunks
+// are fixed here instead of being left to parallel_for.
+inline int64_t num_chunks_for(int64_t n) {
+  const int64_t max_chunks =
+      internal::get_max_threads() * internal::CHUNKS_PER_THREAD;
+  return std::max<int64_t>(
+      1, std::min<int64_t>(n / internal::GRAIN_SIZE, max_chunks));
+}
+
+// Runs fn(chunk, begin, end) for every chunk of [0, n)
+template <typename F>
+inline void for_each_chunk(int64_t n, int64_t num_chunks, const F& fn) {
+  const int64_t chunk_size = divup(n, num_chunks);
+  parallel_for(0, num_chunks, 1, [&](int64_t first, int64_t last) {
+    for (int64_t c = first; c < last; ++c) {
+      fn(c, std::min(n, c * chunk_size), std::min(n, (c + 1) * chunk_size));
+    }
+  });
+}
+
+// Maps every scalar type to an unsigned integer key of the same size, such
+// that keys compare like the values they encode. Negative zero is encoded
+// like zero. NaNs are kept as they are and sort after +inf (or before -inf
+// when their sign bit is set).
+template <typename scalar_t, typename Enable = void>
+struct RadixKey;
+
+template <typename scalar_t>
+struct RadixKey<
+    scalar_t,
+    typename std::enable_if<std::is_integral<scalar_t>::value>::type> {
+  using type = typename std::make_unsigned<scalar_t>::type;
+  static constexpr type sign_bit = std::is_signed<scalar_t>::value
+      ? type(1) << (sizeof(type) * 8 - 1)
+      : type(0);
+
+  static type encode(scalar_t value) {
+    return static_cast<type>(value) ^ sign_bit;
+  }
+  static scalar_t decode(type key) {
+    return static_cast<scalar_t>(key ^ sign_bit);
+  }
+};
+
+template <typename scalar_t>
+struct RadixKey<
+    scalar_t,
+    typename std::enable_if<std::is_floating_point<scalar_t>::value>::type> {
+  using type = typename std::conditional<
+      sizeof(scalar_t) == 4,
+      uint32_t,
+      uint64_t>::type;
+  static constexpr type sign_bit = type(1) << (sizeof(type) * 8 - 1);
+
+  static type encode(scalar_t value) {
+    if (value == 0) {
+      value = 0;
+    }
+    type bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits & sign_bit) ? ~bits : bits ^ sign_bit;
+  }
+  static scalar_t decode(type key) {
+    const type bits = (key & sign_bit) ? key ^ sign_bit : ~key;
+    scalar_t value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+};
+
+// Least significant digit radix sort of keys[0:n], moving indices along
+// with the keys when indices isn't null. keys_tmp and indices_tmp are
+// scratch buffers of the same size. Digits that are the same in every key
+// are skipped, which makes sorting keys of a small range cheap. Returns the
+// buffers that hold the sorted keys and indices.
+template <typename key_t>
+std::pair<key_t*, int64_t*> radix_sort(
+    key_t* keys,
+    key_t* keys_tmp,
+    int64_t* indices,
+    int64_t* indices_tmp,
+    int64_t n) {
+  constexpr int kRadixBits = 8;
+  constexpr int64_t kRadix = 1 << kRadixBits;
+  if (n <= 1) {
+    return std::make_pair(keys, indices);
+  }
+  const int64_t num_chunks = num_chunks_for(n);
+
+  std::vector<key_t> chunk_diff(num_chunks, 0);
+  for_each_chunk(n, num_chunks, [&](int64_t c, int64_t begin, int64_t end) {
+    key_t diff = 0;
+    for (int64_t i = begin; i < end; ++i) {
+      diff |= keys[i] ^ keys[0];
+    }
+    chunk_diff[c] = diff;
+  });
+  key_t diff = 0;
+  for (auto d : chunk_diff) {
+    diff |= d;
+  }
+
+  // offsets[c * kRadix + d] is where chunk c writes its next key with digit d
+  std::vector<int64_t> offsets(num_chunks * kRadix);
+  for (int shift = 0; shift < (int)sizeof(key_t) * 8; shift += kRadixBits) {
+    if (((diff >> shift) & (kRadix - 1)) == 0) {
+      continue;
+    }
+    std::fill(offsets.begin(), offsets.end(), 0);
+    for_each_chunk(n, num_chunks, [&](int64_t c, int64_t begin, int64_t end) {
+      int64_t* hist = offsets.data() + c * kRadix;
+      for (int64_t i = begin; i < end; ++i) {
+        ++hist[(keys[i] >> shift) & (kRadix - 1)];
+      }
+    });
+    int64_t total = 0;
+    for (int64_t d = 0; d < kRadix; ++d) {
+      for (int64_t c = 0; c < num_chunks; ++c) {
+        const int64_t count = offsets[c * kRadix + d];
+        offsets[c * kRadix + d] = total;
+        total += count;
+      }
+    }
+    for_each_chunk(n, num_chunks, [&](int64_t c, int64_t begin, int64_t end) {
+      int64_t* offset = offsets.data() + c * kRadix;
+      for (int64_t i = begin; i < end; ++i) {
+        const int64_t pos = offset[(keys[i] >> shift) & (kRadix - 1)]++;
+        keys_tmp[pos] = keys[i];
+        if (indices != nullptr) {
+          indices_tmp[pos] = indices[i];
+        }
+      }
+    });
+    std::swap(keys, keys_tmp);
+    std::swap(indices, indices_tmp);
+  }
+  return std::make_pair(keys, indices);
+}
+
+// Sorts data[0:n] by sorting chunks in parallel and then merging
+// neighbouring runs in parallel, doubling the run length every round.
+template <typename T, typename Compare>
+void parallel_sort(T* data, int64_t n, const Compare& comp) {
+  const int64_t num_chunks = num_chunks_for(n);
+  if (num_chunks <= 1) {
+    std::sort(data, data + n, comp);
+    return;
+  }
+  for_each_chunk(n, num_chunks, [&](int64_t c, int64_t begin, int64_t end) {
+    std::sort(data + begin, data + end, comp);
+  });
+  for (int64_t width = divup(n, num_chunks); width < n; width *= 2) {
+    const int64_t num_merges = divup(n, 2 * width);
+    parallel_for(0, num_merges, 1, [&](int64_t first, int64_t last) {
+      for (int64_t m = first; m < last; ++m) {
+        const int64_t lo = m * 2 * width;
+        const int64_t mid = std::min(n, lo + width);
+        const int64_t hi = std::min(n, lo + 2 * width);
+        std::inplace_merge(data + lo, data + mid, data + hi, comp);
+      }
+    });
+  }
+}
+
+// Given n sorted items where is_start(i) tells whether item i differs from
+// item i - 1, returns the id of the first group that starts in every chunk,
+// followed by the number of groups.
+template <typename IsStart>
+std::vector<int64_t> count_groups(int64_t n, const IsStart& is_start) {
+  const int64_t num_chunks = num_chunks_for(n);
+  std::vector<int64_t> first_id(num_chunks + 1, 0);
+  for_each_chunk(n, num_chunks, [&](int64_t c, int64_t begin, int64_t end) {
+    int64_t count = 0;
+    for (int64_t i = begin; i < end; ++i) {
+      count += is_start(i);
+    }
+    first_id[c + 1] = count;
+  });
+  std::partial_sum(first_id.begin(), first_id.end(), first_id.begin());
+  return first_id;
+}
+
+// Calls emit(i, id, is_start(i)) for every item, where id is the index of
+// the group of item i and first_id comes from count_groups.
+template <typename IsStart, typename Emit>
+void emit_groups(
+    int64_t n,
+    const std::vector<int64_t>& first_id,
+    const IsStart& is_start,
+    const Emit& emit) {
+  const int64_t num_chunks = first_id.size() - 1;
+  for_each_chunk(n, num_chunks, [&](int64_t c, int64_t begin, int64_t end) {
+    int64_t id = first_id[c] - 1;
+    for (int64_t i = begin; i < end; ++i) {
+      const bool start = is_start(i);
+      id += start;
+      emit(i, id, start);
+    }
+  });
+}
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,546 @@
+// Sorting and selection along a dimension: sort, topk, kthvalue, median and
+// mode.
+//
+// Every slice along dim is first copied into a contiguous buffer of radix
+// keys (see RadixKey), flipped when the largest elements should come first.
+// Elements are then ordered by key and by index, so ties keep their order in
+// the input and every operation agrees with sort. NaNs compare equal to each
+// other and larger than every other value.
+//
+// Slices are distributed over threads with parallel_for, each thread reusing
+// its scratch buffers. A single large slice is instead sorted with the
+// parallel radix sort of ParallelSortUtils.h.
+
+#include "ATen/ATen.h"
+#include "ATen/Dispatch.h"
+#include "ATen/Parallel.h"
+#include "ATen/WrapDimUtils.h"
+#include "ATen/native/ParallelSortUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace at { namespace native {
+
+namespace {
+
+// Slices shorter than this are sorted with std::sort instead of a radix sort
+constexpr int64_t kRadixSortMinSize = 1024;
+
+// topk keeps a heap of the k first elements for k up to this, and otherwise
+// partitions the slice around the k-th element
+constexpr int64_t kHeapSelectMaxK = 128;
+
+// Number of keys compared to the heap top at once when selecting with a heap
+constexpr int64_t kHeapSelectBlock = 32;
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value, bool>::type
+is_nan(T /* x */) {
+  return false;
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+is_nan(T x) {
+  return std::isnan(x);
+}
+
+// One slice of the input and the matching slices of values and indices.
+// set(i, index) writes the input element at index to position i.
+template <typename scalar_t>
+struct Slice {
+  void set(int64_t i, int64_t index) const {
+    values[i * values_stride] = input[index * input_stride];
+    indices[i * indices_stride] = index;
+  }
+
+  const scalar_t* input;
+  int64_t input_stride;
+  int64_t size;
+  scalar_t* values;
+  int64_t values_stride;
+  int64_t* indices;
+  int64_t indices_stride;
+};
+
+// Orders the elements of one slice at a time. The scratch buffers grow to
+// the largest slice seen and are reused for the following slices.
+template <typename scalar_t>
+class SliceSorter {
+ public:
+  using key_t = typename RadixKey<scalar_t>::type;
+
+  // Copies the keys of a slice. With descending the keys are flipped, so
+  // that the largest elements come first.
+  void load(const Slice<scalar_t>& slice, bool descending) {
+    n_ = slice.size;
+    keys_.resize(n_);
+    const key_t flip = descending ? std::numeric_limits<key_t>::max() : 0;
+    const key_t nan_key = std::numeric_limits<key_t>::max() ^ flip;
+    const scalar_t* input = slice.input;
+    const int64_t stride = slice.input_stride;
+    for (int64_t i = 0; i < n_; ++i) {
+      const scalar_t x = input[i * stride];
+      keys_[i] = is_nan(x) ? nan_key
+                           : static_cast<key_t>(RadixKey<scalar_t>::encode(x) ^ flip);
+    }
+  }
+
+  // Sorts the whole slice. Returns the indices of the elements in order.
+  const int64_t* sort() {
+    indices_.resize(n_);
+    std::iota(indices_.begin(), indices_.end(), 0);
+    keys_tmp_.resize(n_);
+    if (n_ < kRadixSortMinSize) {
+      const key_t* keys = keys_.data();
+      std::sort(indices_.begin(), indices_.end(), [keys](int64_t a, int64_t b) {
+        return keys[a] < keys[b] || (keys[a] == keys[b] && a < b);
+      });
+      for (int64_t i = 0; i < n_; ++i) {
+        keys_tmp_[i] = keys_[indices_[i]];
+      }
+      sorted_keys_ = keys_tmp_.data();
+      return indices_.data();
+    }
+    // The radix sort is stable and the indices start out in order, so ties
+    // stay ordered by index
+    indices_tmp_.resize(n_);
+    auto sorted = radix_sort(
+        keys_.data(), keys_tmp_.data(), indices_.data(), indices_tmp_.data(), n_);
+    sorted_keys_ = sorted.first;
+    return sorted.second;
+  }
+
+  // Returns the indices of the first k elements, which are in order when
+  // sorted is true.
+  const int64_t* select(int64_t k, bool sorted) {
+    if (k == n_) {
+      if (sorted) {
+        return sort();
+      }
+      indices_.resize(n_);
+      std::iota(indices_.begin(), indices_.end(), 0);
+      return indices_.data();
+    }
+    if (k <= kHeapSelectMaxK) {
+      return heap_select(k, sorted);
+    }
+    return partition_select(k, sorted);
+  }
+
+  // Returns the index of the k-th element (counting from 0)
+  int64_t nth(int64_t k) {
+    int64_t rank;
+    const key_t pivot = nth_key(k, &rank);
+    for (int64_t i = 0; i < n_; ++i) {
+      if (keys_[i] == pivot && rank-- == 0) {
+        return i;
+      }
+    }
+    AT_ERROR("nth: element not found");
+  }
+
+  // Returns the index of the last occurrence of the most frequent element.
+  // The smallest such element is chosen when there are several.
+  int64_t mode() {
+    const int64_t* order = sort();
+    int64_t best_count = 0;
+    int64_t best_index = 0;
+    int64_t run_begin = 0;
+    for (int64_t i = 0; i < n_; ++i) {
+      if (i == n_ - 1 || sorted_keys_[i] != sorted_keys_[i + 1]) {
+        if (i + 1 - run_begin > best_count) {
+          best_count = i + 1 - run_begin;
+          best_index = order[i];
+        }
+        run_begin = i + 1;
+      }
+    }
+    return best_index;
+  }
+
+ private:
+  // Returns the key of the k-th element, and in rank the number of elements
+  // with the same key that come before it.
+  key_t nth_key(int64_t k, int64_t* rank) {
+    keys_tmp_.assign(keys_.begin(), keys_.end());
+    std::nth_element(keys_tmp_.begin(), keys_tmp_.begin() + k, keys_tmp_.end());
+    const key_t pivot = keys_tmp_[k];
+    // Every key that is smaller than the pivot is now before it
+    int64_t num_less = 0;
+    for (int64_t i = 0; i < k; ++i) {
+      num_less += keys_tmp_[i] < pivot;
+    }
+    *rank = k - num_less;
+    return pivot;
+  }
+
+  // Keeps the k first elements seen so far in a heap whose top is the last
+  // of them. Most blocks of keys hold nothing that beats the top once the
+  // heap has filled up, and are skipped after a comparison of the whole
+  // block that the compiler vectorizes.
+  const int64_t* heap_select(int64_t k, bool sorted) {
+    heap_.clear();
+    for (int64_t i = 0; i < k; ++i) {
+      heap_.emplace_back(keys_[i], i);
+    }
+    std::make_heap(heap_.begin(), heap_.end());
+    // Elements with the same key as the top come after it, since they are
+    // visited in order, so only smaller keys get in
+    auto push = [&](int64_t i) {
+      if (keys_[i] < heap_.front().first) {
+        std::pop_heap(heap_.begin(), heap_.end());
+        heap_.back() = std::make_pair(keys_[i], i);
+        std::push_heap(heap_.begin(), heap_.end());
+      }
+    };
+    const key_t* keys = keys_.data();
+    int64_t i = k;
+    for (; i + kHeapSelectBlock <= n_; i += kHeapSelectBlock) {
+      const key_t top = heap_.front().first;
+      int beats = 0;
+      for (int64_t j = i; j < i + kHeapSelectBlock; ++j) {
+        beats |= keys[j] < top;
+      }
+      if (beats) {
+        for (int64_t j = i; j < i + kHeapSelectBlock; ++j) {
+          push(j);
+        }
+      }
+    }
+    for (; i < n_; ++i) {
+      push(i);
+    }
+    if (sorted) {
+      std::sort_heap(heap_.begin(), heap_.end());
+    }
+    indices_.resize(k);
+    for (int64_t j = 0; j < k; ++j) {
+      indices_[j] = heap_[j].second;
+    }
+    return indices_.data();
+  }
+
+  // Finds the key of the k-th element with a partition of the keys, and
+  // then gathers the first k elements in index order. The radix sort that
+  // puts them in order is stable, so ties stay ordered by index.
+  const int64_t* partition_select(int64_t k, bool sorted) {
+    int64_t num_equal;
+    const key_t pivot = nth_key(k - 1, &num_equal);
+    ++num_equal;
+    indices_.resize(n_);
+    int64_t m = 0;
+    for (int64_t i = 0; i < n_ && m < k; ++i) {
+      const key_t key = keys_[i];
+      if (key < pivot || (key == pivot && num_equal-- > 0)) {
+        keys_tmp_[m] = key;
+        indices_[m++] = i;
+      }
+    }
+    if (!sorted) {
+      return indices_.data();
+    }
+    if (k < kRadixSortMinSize) {
+      heap_.resize(k);
+      for (int64_t j = 0; j < k; ++j) {
+        heap_[j] = std::make_pair(keys_tmp_[j], indices_[j]);
+      }
+      std::sort(heap_.begin(), heap_.end());
+      for (int64_t j = 0; j < k; ++j) {
+        indices_[j] = heap_[j].second;
+      }
+      return indices_.data();
+    }
+    // The input keys are no longer needed and serve as scratch space
+    indices_tmp_.resize(k);
+    return radix_sort(
+        keys_tmp_.data(), keys_.data(), indices_.data(), indices_tmp_.data(), k)
+        .second;
+  }
+
+  int64_t n_ = 0;
+  std::vector<key_t> keys_;
+  std::vector<key_t> keys_tmp_;
+  std::vector<int64_t> indices_;
+  std::vector<int64_t> indices_tmp_;
+  std::vector<std::pair<key_t, int64_t>> heap_;
+  const key_t* sorted_keys_ = nullptr;
+};
+
+// Checks the types of the outputs and resizes them to the size of self,
+// with out_size elements along dim
+void prepare_outputs(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim,
+    int64_t out_size,
+    const char* name) {
+  AT_CHECK(
+      values.type() == self.type(),
+      name, ": expected values to have type ", self.type().toString(),
+      " but got ", values.type().toString());
+  AT_CHECK(
+      indices.type() == self.type().toScalarType(kLong),
+      name, ": expected indices to have type ",
+      self.type().toScalarType(kLong).toString(),
+      " but got ", indices.type().toString());
+  std::vector<int64_t> sizes = self.sizes().vec();
+  if (sizes.empty()) {
+    sizes.push_back(1);
+  }
+  sizes[dim] = out_size;
+  values.resize_(sizes);
+  indices.resize_(sizes);
+}
+
+// Removes dim from the outputs, and puts back the zero dimensions of a
+// scalar self
+void finish_outputs(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim,
+    bool keepdim) {
+  if (!keepdim || self.dim() == 0) {
+    values.squeeze_(dim);
+    indices.squeeze_(dim);
+  }
+}
+
+// Calls fn(sorter, slice) for every slice of self along dim, in parallel.
+// values and indices must have the size of self, except along dim.
+template <typename scalar_t, typename F>
+void parallel_for_each_slice(
+    const Tensor& self,
+    int64_t dim,
+    Tensor& values,
+    Tensor& indices,
+    const F& fn) {
+  // A scalar self is treated as a slice of one element
+  const Tensor input = self.dim() == 0 ? self.view({1}) : self;
+  std::vector<int64_t> sizes;
+  std::vector<int64_t> strides[3];
+  int64_t num_slices = 1;
+  for (int64_t d = 0; d < input.dim(); ++d) {
+    if (d != dim) {
+      sizes.push_back(input.size(d));
+      strides[0].push_back(input.stride(d));
+      strides[1].push_back(values.stride(d));
+      strides[2].push_back(indices.stride(d));
+      num_slices *= input.size(d);
+    }
+  }
+  if (num_slices == 0) {
+    return;
+  }
+
+  Slice<scalar_t> base;
+  base.input = input.data<scalar_t>();
+  base.input_stride = input.stride(dim);
+  base.size = input.size(dim);
+  base.values = values.data<scalar_t>();
+  base.values_stride = values.stride(dim);
+  base.indices = indices.data<int64_t>();
+  base.indices_stride = indices.stride(dim);
+
+  const int64_t grain_size =
+      std::max(internal::GRAIN_SIZE / std::max(base.size, (int64_t)1), (int64_t)1);
+  parallel_for(0, num_slices, grain_size, [&](int64_t begin, int64_t end) {
+    SliceSorter<scalar_t> sorter;
+    for (int64_t s = begin; s < end; ++s) {
+      int64_t offsets[3] = {0, 0, 0};
+      int64_t rest = s;
+      for (int64_t d = (int64_t)sizes.size() - 1; d >= 0; --d) {
+        const int64_t i = rest % sizes[d];
+        rest /= sizes[d];
+        for (int t = 0; t < 3; ++t) {
+          offsets[t] += i * strides[t][d];
+        }
+      }
+      Slice<scalar_t> slice = base;
+      slice.input += offsets[0];
+      slice.values += offsets[1];
+      slice.indices += offsets[2];
+      fn(sorter, slice);
+    }
+  });
+}
+
+// Writes the k-th element of every slice
+template <typename scalar_t>
+void kthvalue_slices(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t k,
+    int64_t dim) {
+  parallel_for_each_slice<scalar_t>(
+      self, dim, values, indices,
+      [k](SliceSorter<scalar_t>& sorter, const Slice<scalar_t>& slice) {
+        sorter.load(slice, false);
+        slice.set(0, sorter.nth(k));
+      });
+}
+
+} // namespace
+
+std::tuple<Tensor&, Tensor&> _sort_out_cpu(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim_,
+    bool descending) {
+  int64_t dim = maybe_wrap_dim(dim_, self.dim());
+  const int64_t size = self.dim() == 0 ? 1 : self.size(dim);
+  prepare_outputs(values, indices, self, dim, size, "sort");
+  AT_DISPATCH_ALL_TYPES(self.type(), "sort", [&] {
+    parallel_for_each_slice<scalar_t>(
+        self, dim, values, indices,
+        [descending](SliceSorter<scalar_t>& sorter, const Slice<scalar_t>& slice) {
+          sorter.load(slice, descending);
+          const int64_t* order = sorter.sort();
+          for (int64_t i = 0; i < slice.size; ++i) {
+            slice.set(i, order[i]);
+          }
+        });
+  });
+  finish_outputs(values, indices, self, dim, true);
+  return std::tuple<Tensor&, Tensor&>(values, indices);
+}
+
+std::tuple<Tensor&, Tensor&> _topk_out_cpu(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t k,
+    int64_t dim_,
+    bool largest,
+    bool sorted) {
+  int64_t dim = maybe_wrap_dim(dim_, self.dim());
+  const int64_t size = self.dim() == 0 ? 1 : self.size(dim);
+  AT_CHECK(k > 0 && k <= size, "topk: k not in range for dimension");
+  prepare_outputs(values, indices, self, dim, k, "topk");
+  AT_DISPATCH_ALL_TYPES(self.type(), "topk", [&] {
+    parallel_for_each_slice<scalar_t>(
+        self, dim, values, indices,
+        [=](SliceSorter<scalar_t>& sorter, const Slice<scalar_t>& slice) {
+          sorter.load(slice, largest);
+          const int64_t* order = sorter.select(k, sorted);
+          for (int64_t i = 0; i < k; ++i) {
+            slice.set(i, order[i]);
+          }
+        });
+  });
+  finish_outputs(values, indices, self, dim, true);
+  return std::tuple<Tensor&, Tensor&>(values, indices);
+}
+
+std::tuple<Tensor&, Tensor&> _kthvalue_out_cpu(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t k,
+    int64_t dim_,
+    bool keepdim) {
+  int64_t dim = maybe_wrap_dim(dim_, self.dim());
+  const int64_t size = self.dim() == 0 ? 1 : self.size(dim);
+  AT_CHECK(k > 0 && k <= size, "kthvalue: selected index out of range");
+  prepare_outputs(values, indices, self, dim, 1, "kthvalue");
+  AT_DISPATCH_ALL_TYPES(self.type(), "kthvalue", [&] {
+    kthvalue_slices<scalar_t>(values, indices, self, k - 1, dim);
+  });
+  finish_outputs(values, indices, self, dim, keepdim);
+  return std::tuple<Tensor&, Tensor&>(values, indices);
+}
+
+std::tuple<Tensor&, Tensor&> _median_out_cpu(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim_,
+    bool keepdim) {
+  int64_t dim = maybe_wrap_dim(dim_, self.dim());
+  const int64_t size = self.dim() == 0 ? 1 : self.size(dim);
+  AT_CHECK(size > 0, "median: dimension ", dim, " is empty");
+  prepare_outputs(values, indices, self, dim, 1, "median");
+  // The middle element, or the one before the middle for an even size
+  AT_DISPATCH_ALL_TYPES(self.type(), "median", [&] {
+    kthvalue_slices<scalar_t>(values, indices, self, (size - 1) / 2, dim);
+  });
+  finish_outputs(values, indices, self, dim, keepdim);
+  return std::tuple<Tensor&, Tensor&>(values, indices);
+}
+
+std::tuple<Tensor&, Tensor&> _mode_out_cpu(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim_,
+    bool keepdim) {
+  int64_t dim = maybe_wrap_dim(dim_, self.dim());
+  prepare_outputs(values, indices, self, dim, 1, "mode");
+  AT_DISPATCH_ALL_TYPES(self.type(), "mode", [&] {
+    parallel_for_each_slice<scalar_t>(
+        self, dim, values, indices,
+        [](SliceSorter<scalar_t>& sorter, const Slice<scalar_t>& slice) {
+          if (slice.size == 0) {
+            slice.values[0] = 0;
+            slice.indices[0] = 0;
+            return;
+          }
+          sorter.load(slice, false);
+          slice.set(0, sorter.mode());
+        });
+  });
+  finish_outputs(values, indices, self, dim, keepdim);
+  return std::tuple<Tensor&, Tensor&>(values, indices);
+}
+
+std::tuple<Tensor, Tensor> sort(const Tensor& self, int64_t dim, bool descending) {
+  Tensor values = self.type().tensor();
+  Tensor indices = self.type().toScalarType(kLong).tensor();
+  return at::sort_out(values, indices, self, dim, descending);
+}
+
+std::tuple<Tensor, Tensor> topk(
+    const Tensor& self,
+    int64_t k,
+    int64_t dim,
+    bool largest,
+    bool sorted) {
+  Tensor values = self.type().tensor();
+  Tensor indices = self.type().toScalarType(kLong).tensor();
+  return at::topk_out(values, indices, self, k, dim, largest, sorted);
+}
+
+std::tuple<Tensor, Tensor> kthvalue(
+    const Tensor& self,
+    int64_t k,
+    int64_t dim,
+    bool keepdim) {
+  Tensor values = self.type().tensor();
+  Tensor indices = self.type().toScalarType(kLong).tensor();
+  return at::kthvalue_out(values, indices, self, k, dim, keepdim);
+}
+
+std::tuple<Tensor, Tensor> median(const Tensor& self, int64_t dim, bool keepdim) {
+  Tensor values = self.type().tensor();
+  Tensor indices = self.type().toScalarType(kLong).tensor();
+  return at::median_out(values, indices, self, dim, keepdim);
+}
+
+std::tuple<Tensor, Tensor> mode(const Tensor& self, int64_t dim, bool keepdim) {
+  Tensor values = self.type().tensor();
+  Tensor indices = self.type().toScalarType(kLong).tensor();
+  return at::mode_out(values, indices, self, dim, keepdim);
+}
+
+}} // namespace at::native
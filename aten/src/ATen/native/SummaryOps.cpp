@@ -1,15 +1,113 @@
-// Returns the frequency of elements of input non-negative integer tensor.
+// Histograms: bincount returns the frequency of elements of input
+// non-negative integer tensor, and histc bins a floating point tensor.
 
 #include "ATen/ATen.h"
 #include "ATen/Dispatch.h"
+#include "ATen/Parallel.h"
 
+#include <algorithm>
+#include <cmath>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace at { namespace native {
 
-///////////////// bincount /////////////////
 namespace {
 
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value, bool>::type
+is_nan(T /* x */) {
+  return false;
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+is_nan(T x) {
+  return std::isnan(x);
+}
+
+// Minimum and maximum of data[0, n), which must not be empty. NaNs are
+// ignored, unless all elements are NaN.
+template <typename scalar_t>
+std::pair<scalar_t, scalar_t> minmax(const scalar_t* data, int64_t n) {
+  const int64_t num_chunks = divup(n, internal::GRAIN_SIZE);
+  std::vector<scalar_t> mins(num_chunks, data[0]);
+  std::vector<scalar_t> maxs(num_chunks, data[0]);
+  parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      const int64_t chunk_begin = c * internal::GRAIN_SIZE;
+      const int64_t chunk_end = std::min(n, chunk_begin + internal::GRAIN_SIZE);
+      scalar_t lo = data[chunk_begin];
+      scalar_t hi = data[chunk_begin];
+      for (int64_t i = chunk_begin; i < chunk_end; ++i) {
+        lo = (data[i] < lo || is_nan(lo)) ? data[i] : lo;
+        hi = (data[i] > hi || is_nan(hi)) ? data[i] : hi;
+      }
+      mins[c] = lo;
+      maxs[c] = hi;
+    }
+  });
+  scalar_t lo = mins[0];
+  scalar_t hi = maxs[0];
+  for (int64_t c = 0; c < num_chunks; ++c) {
+    lo = (mins[c] < lo || is_nan(lo)) ? mins[c] : lo;
+    hi = (maxs[c] > hi || is_nan(hi)) ? maxs[c] : hi;
+  }
+  return std::make_pair(lo, hi);
+}
+
+// Adds weight(i) to hist[bin(i)] for every i in [0, n) with bin(i) in
+// [0, nbins). The input is split into at most one chunk per thread, and each
+// chunk after the first fills a private copy of the bins. The copies are then
+// added to hist in chunk order, so the result only depends on the number of
+// chunks. Fewer chunks are used when there are many bins, so that merging
+// the copies never costs more than the pass over the input.
+template <typename hist_t, typename BinFn, typename WeightFn>
+void parallel_histogram(
+    hist_t* hist,
+    int64_t nbins,
+    int64_t n,
+    const BinFn& bin,
+    const WeightFn& weight) {
+  auto fill = [&](hist_t* h, int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const int64_t b = bin(i);
+      if (b >= 0 && b < nbins) {
+        h[b] += weight(i);
+      }
+    }
+  };
+  const int64_t num_chunks = std::min(
+      {divup(n, internal::GRAIN_SIZE),
+       internal::get_max_threads(),
+       std::max(n / std::max(nbins, (int64_t)1), (int64_t)1)});
+  if (num_chunks <= 1) {
+    fill(hist, 0, n);
+    return;
+  }
+  const int64_t chunk_size = divup(n, num_chunks);
+  std::vector<hist_t> private_hists((num_chunks - 1) * nbins, hist_t(0));
+  parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      hist_t* h = c == 0 ? hist : private_hists.data() + (c - 1) * nbins;
+      fill(h, c * chunk_size, std::min(n, (c + 1) * chunk_size));
+    }
+  });
+  parallel_for(
+      0, nbins, internal::GRAIN_SIZE / num_chunks, [&](int64_t begin, int64_t end) {
+        for (int64_t c = 1; c < num_chunks; ++c) {
+          const hist_t* h = private_hists.data() + (c - 1) * nbins;
+          for (int64_t b = begin; b < end; ++b) {
+            hist[b] += h[b];
+          }
+        }
+      });
+}
+
+///////////////// bincount /////////////////
+
 template <typename input_t, typename weights_t>
 Tensor _bincount_cpu_template(
     const Tensor& self,
@@ -18,7 +116,15 @@ Tensor _bincount_cpu_template(
   if (minlength < 0) {
     AT_ERROR("minlength should be >= 0");
   }
-  if (self.dim() != 1 || self.numel() == 0 || *self.min().data<input_t>() < 0) {
+  if (self.dim() != 1 || self.numel() == 0) {
+    AT_ERROR("bincount only supports 1-d non-negative integral inputs.");
+  }
+  const Tensor input = self.contiguous();
+  const input_t* self_p = input.data<input_t>();
+  const int64_t n = input.numel();
+  input_t min_value, max_value;
+  std::tie(min_value, max_value) = minmax(self_p, n);
+  if (min_value < 0) {
     AT_ERROR("bincount only supports 1-d non-negative integral inputs.");
   }
 
@@ -28,26 +134,73 @@ Tensor _bincount_cpu_template(
   }
 
   Tensor output;
-  int64_t nbins = static_cast<int64_t>(*self.max().data<input_t>()) + 1L;
+  int64_t nbins = static_cast<int64_t>(max_value) + 1L;
   nbins = std::max(nbins, minlength); // at least minlength # of bins
 
-  const input_t* self_p = self.contiguous().data<input_t>();
+  auto bin = [=](int64_t i) { return static_cast<int64_t>(self_p[i]); };
   if (has_weights) {
     output = native::zeros({nbins}, weights.options());
-    weights_t* output_p = output.data<weights_t>();
-    const weights_t* weights_p = weights.contiguous().data<weights_t>();
-    for (int64_t i = 0; i < self.size(0); i++) {
-      output_p[self_p[i]] += weights_p[i];
-    }
+    const Tensor weights_contig = weights.contiguous();
+    const weights_t* weights_p = weights_contig.data<weights_t>();
+    parallel_histogram(
+        output.data<weights_t>(), nbins, n, bin,
+        [=](int64_t i) { return weights_p[i]; });
   } else {
     output = native::zeros({nbins}, kLong);
-    int64_t* output_p = output.data<int64_t>();
-    for (int64_t i = 0; i < self.size(0); i++) {
-      output_p[self_p[i]] += 1L;
-    }
+    parallel_histogram(
+        output.data<int64_t>(), nbins, n, bin,
+        [](int64_t /* i */) { return (int64_t)1; });
   }
   return output;
 }
+
+///////////////// histc /////////////////
+
+template <typename scalar_t>
+void _histc_cpu_template(
+    Tensor& result,
+    const Tensor& self,
+    int64_t bins,
+    Scalar min,
+    Scalar max) {
+  if (bins <= 0) {
+    AT_ERROR("bins should be > 0, but got ", bins);
+  }
+  const Tensor input = self.contiguous();
+  const scalar_t* self_p = input.data<scalar_t>();
+  const int64_t n = input.numel();
+  scalar_t minval = min.to<scalar_t>();
+  scalar_t maxval = max.to<scalar_t>();
+  if (minval == maxval && n > 0) {
+    std::tie(minval, maxval) = minmax(self_p, n);
+  }
+  if (minval == maxval) {
+    minval = minval - 1;
+    maxval = maxval + 1;
+  }
+
+  // Counts are kept as integers, floating point bins stop counting at 2^24
+  // (float) or 2^53 (double)
+  std::vector<int64_t> counts(bins, 0);
+  const scalar_t range = maxval - minval;
+  parallel_histogram(
+      counts.data(), bins, n,
+      [=](int64_t i) -> int64_t {
+        const scalar_t x = self_p[i];
+        if (!(x >= minval && x <= maxval)) {
+          return -1;
+        }
+        const int64_t b = static_cast<int64_t>((x - minval) / range * bins);
+        return std::min(b, bins - 1);
+      },
+      [](int64_t /* i */) { return (int64_t)1; });
+
+  result.resize_({bins});
+  scalar_t* result_p = result.data<scalar_t>();
+  for (int64_t b = 0; b < bins; ++b) {
+    result_p[b] = static_cast<scalar_t>(counts[b]);
+  }
+}
 } // namespace
 
 Tensor
@@ -61,4 +214,21 @@ _bincount_cpu(const Tensor& self, const Tensor& weights, int64_t minlength) {
   });
 }
 
+Tensor& _histc_out_cpu(
+    Tensor& result,
+    const Tensor& self,
+    int64_t bins,
+    Scalar min,
+    Scalar max) {
+  AT_DISPATCH_FLOATING_TYPES(self.type(), "histc", [&] {
+    _histc_cpu_template<scalar_t>(result, self, bins, min, max);
+  });
+  return result;
+}
+
+Tensor _histc_cpu(const Tensor& self, int64_t bins, Scalar min, Scalar max) {
+  Tensor result = self.type().tensor();
+  return _histc_out_cpu(result, self, bins, min, max);
+}
+
 }} // namespace at::native
@@ -1,12 +1,21 @@
 // Returns unique elements of input tensor.
+//
+// The input is sorted with a parallel radix sort (or, for unique along a
+// dimension, a parallel merge sort of the slices) and the unique values,
+// their counts and the inverse indices are then produced together in one
+// pass over the sorted data. Both passes split the input into the same
+// fixed chunks, see num_chunks_for.
 
 #include "ATen/ATen.h"
 #include "ATen/Dispatch.h"
+#include "ATen/Parallel.h"
+#include "ATen/WrapDimUtils.h"
+#include "ATen/native/ParallelSortUtils.h"
 
-#include <set>
+#include <cstring>
+#include <numeric>
 #include <tuple>
-#include <unordered_map>
-#include <unordered_set>
+#include <vector>
 
 namespace at {
 namespace native{
@@ -14,47 +23,192 @@ namespace native{
 namespace {
 
 template <typename scalar_t>
-std::tuple<Tensor, Tensor> _unique_cpu_template(
+std::tuple<Tensor, Tensor, Tensor> _unique_cpu_template(
     const Tensor& self,
-    const bool sorted,
-    const bool return_inverse) {
-  const Tensor& input = self.contiguous();
+    const bool return_inverse,
+    const bool return_counts) {
+  using Key = RadixKey<scalar_t>;
+  using key_t = typename Key::type;
+  const Tensor input = self.contiguous();
   const scalar_t* input_data = input.data<scalar_t>();
-  std::unordered_set<scalar_t> set(input_data, input_data + input.numel());
-  Tensor output = at::empty({static_cast<int64_t>(set.size())}, input.type());
-  scalar_t* output_data = output.data<scalar_t>();
+  const int64_t n = input.numel();
 
-  if (sorted) {
-    std::vector<scalar_t> vec(set.begin(), set.end());
-    std::sort(vec.begin(), vec.end());
-    std::copy(vec.begin(), vec.end(), output_data);
-  } else {
-    std::copy(set.begin(), set.end(), output_data);
-  }
+  std::vector<key_t> keys(n);
+  std::vector<key_t> keys_tmp(n);
+  std::vector<int64_t> indices(return_inverse ? n : 0);
+  std::vector<int64_t> indices_tmp(return_inverse ? n : 0);
+  parallel_for(0, n, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      keys[i] = Key::encode(input_data[i]);
+    }
+    if (return_inverse) {
+      std::iota(indices.data() + begin, indices.data() + end, begin);
+    }
+  });
+  key_t* sorted_keys;
+  int64_t* sorted_indices;
+  std::tie(sorted_keys, sorted_indices) = radix_sort(
+      keys.data(),
+      keys_tmp.data(),
+      return_inverse ? indices.data() : nullptr,
+      return_inverse ? indices_tmp.data() : nullptr,
+      n);
+
+  // Values are compared rather than keys so that NaNs stay distinct, as
+  // they are for a hash set
+  auto is_start = [&](int64_t i) {
+    return i == 0 ||
+        Key::decode(sorted_keys[i]) != Key::decode(sorted_keys[i - 1]);
+  };
+  const auto first_id = count_groups(n, is_start);
+  const int64_t num_unique = first_id.back();
 
+  Tensor output = at::empty({num_unique}, input.type());
   Tensor inverse_indices = at::empty({0}, self.type().toScalarType(kLong));
+  Tensor counts = at::empty({0}, self.type().toScalarType(kLong));
+  scalar_t* output_data = output.data<scalar_t>();
+  int64_t* inverse_indices_data = nullptr;
   if (return_inverse) {
     inverse_indices.resize_(input.sizes());
-    int64_t* inverse_indices_data = inverse_indices.data<int64_t>();
-    std::unordered_map<scalar_t, int64_t> inverse_map;
-    inverse_map.reserve(output.numel());
-    for (int i = 0; i < output.numel(); ++i) {
-      inverse_map[output_data[i]] = i;
+    inverse_indices_data = inverse_indices.data<int64_t>();
+  }
+  // Position of the first item of every group, and n at the end
+  std::vector<int64_t> group_start(return_counts ? num_unique + 1 : 0, n);
+
+  emit_groups(n, first_id, is_start, [&](int64_t i, int64_t id, bool start) {
+    if (start) {
+      output_data[id] = Key::decode(sorted_keys[i]);
+      if (return_counts) {
+        group_start[id] = i;
+      }
     }
-    for (int i = 0; i < input.numel(); ++i) {
-      inverse_indices_data[i] = inverse_map[input_data[i]];
+    if (return_inverse) {
+      inverse_indices_data[sorted_indices[i]] = id;
+    }
+  });
+
+  if (return_counts) {
+    counts.resize_({num_unique});
+    int64_t* counts_data = counts.data<int64_t>();
+    parallel_for(
+        0, num_unique, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+          for (int64_t id = begin; id < end; ++id) {
+            counts_data[id] = group_start[id + 1] - group_start[id];
+          }
+        });
+  }
+  return std::make_tuple(output, inverse_indices, counts);
+}
+
+// Unique slices of self along dim, in lexicographic order
+template <typename scalar_t>
+std::tuple<Tensor, Tensor, Tensor> _unique_dim_cpu_template(
+    const Tensor& self,
+    const int64_t dim,
+    const bool return_inverse,
+    const bool return_counts) {
+  using Key = RadixKey<scalar_t>;
+  // Every slice becomes a contiguous row
+  const Tensor input = self.transpose(0, dim).contiguous();
+  const int64_t num_rows = input.size(0);
+  const int64_t row_size = num_rows == 0 ? 0 : input.numel() / num_rows;
+  const scalar_t* input_data = input.data<scalar_t>();
+
+  // Rows are compared through their keys, which order every value
+  // including NaNs
+  auto compare_rows = [&](int64_t a, int64_t b) {
+    const scalar_t* row_a = input_data + a * row_size;
+    const scalar_t* row_b = input_data + b * row_size;
+    for (int64_t k = 0; k < row_size; ++k) {
+      const auto key_a = Key::encode(row_a[k]);
+      const auto key_b = Key::encode(row_b[k]);
+      if (key_a != key_b) {
+        return key_a < key_b ? -1 : 1;
+      }
     }
+    return 0;
+  };
+
+  std::vector<int64_t> order(num_rows);
+  std::iota(order.begin(), order.end(), 0);
+  parallel_sort(order.data(), num_rows, [&](int64_t a, int64_t b) {
+    return compare_rows(a, b) < 0;
+  });
+
+  auto is_start = [&](int64_t i) {
+    return i == 0 || compare_rows(order[i], order[i - 1]) != 0;
+  };
+  const auto first_id = count_groups(num_rows, is_start);
+  const int64_t num_unique = first_id.back();
+
+  auto output_sizes = input.sizes().vec();
+  output_sizes[0] = num_unique;
+  Tensor output = at::empty(output_sizes, input.type());
+  Tensor inverse_indices = at::empty({0}, self.type().toScalarType(kLong));
+  Tensor counts = at::empty({0}, self.type().toScalarType(kLong));
+  scalar_t* output_data = output.data<scalar_t>();
+  int64_t* inverse_indices_data = nullptr;
+  if (return_inverse) {
+    inverse_indices.resize_({num_rows});
+    inverse_indices_data = inverse_indices.data<int64_t>();
   }
-  return std::make_tuple(output, inverse_indices);
+  std::vector<int64_t> group_start(return_counts ? num_unique + 1 : 0, num_rows);
+
+  emit_groups(
+      num_rows, first_id, is_start, [&](int64_t i, int64_t id, bool start) {
+        if (start) {
+          std::memcpy(
+              output_data + id * row_size,
+              input_data + order[i] * row_size,
+              row_size * sizeof(scalar_t));
+          if (return_counts) {
+            group_start[id] = i;
+          }
+        }
+        if (return_inverse) {
+          inverse_indices_data[order[i]] = id;
+        }
+      });
+
+  if (return_counts) {
+    counts.resize_({num_unique});
+    int64_t* counts_data = counts.data<int64_t>();
+    parallel_for(
+        0, num_unique, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+          for (int64_t id = begin; id < end; ++id) {
+            counts_data[id] = group_start[id + 1] - group_start[id];
+          }
+        });
+  }
+  output = output.transpose(0, dim).contiguous();
+  return std::make_tuple(output, inverse_indices, counts);
 }
+
 } // namespace
 
-std::tuple<Tensor, Tensor>
-_unique_cpu(const Tensor& self, const bool sorted, const bool return_inverse) {
+// The unique values are always sorted, `sorted` is accepted for
+// compatibility with the CUDA signature.
+std::tuple<Tensor, Tensor, Tensor> _unique_cpu(
+    const Tensor& self,
+    const bool sorted,
+    const bool return_inverse,
+    const bool return_counts) {
   return AT_DISPATCH_ALL_TYPES(self.type(), "unique", [&] {
-    return _unique_cpu_template<scalar_t>(self, sorted, return_inverse);
+    return _unique_cpu_template<scalar_t>(self, return_inverse, return_counts);
+  });
+}
+
+std::tuple<Tensor, Tensor, Tensor> _unique_dim_cpu(
+    const Tensor& self,
+    const int64_t dim,
+    const bool sorted,
+    const bool return_inverse,
+    const bool return_counts) {
+  return AT_DISPATCH_ALL_TYPES(self.type(), "unique_dim", [&] {
+    return _unique_dim_cpu_template<scalar_t>(
+        self, maybe_wrap_dim(dim, self.dim()), return_inverse, return_counts);
   });
 }
 
-}  // namespace native
-}  // namespace at
+} // namespace native
+} // namespace at
@@ -0,0 +1,277 @@
+#include "ATen/native/cpu/IndexKernel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "ATen/Dispatch.h"
+#include "ATen/Parallel.h"
+#include "ATen/cpu/vec256/vec256.h"
+
+// The indexed elements of self are visited one slice at a time: a slice is
+// the block of self spanned by the dimensions after the indexed ones, for one
+// position of the dimensions before them and one position of the indices.
+// The matching gathered values form a row of the result (or of the values of
+// index_put_). Offsets are computed from the strides of self and of the
+// index tensors, so no linear index is materialized.
+//
+// index parallelizes over rows. index_put_ may write an element from several
+// rows, so it instead splits the slices into column ranges and every thread
+// visits all rows, in order, for its range. This keeps accumulation free of
+// atomics and makes the last write win, as in a serial loop.
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// Sizes of a group of dimensions and the strides of one or more tensors
+// along them. Adjacent dimensions are merged when they are contiguous with
+// respect to each other in every tensor, so that the common cases reduce to
+// a single dimension.
+struct MergedDims {
+  MergedDims(IntList dim_sizes, std::vector<IntList> tensor_strides)
+      : strides(tensor_strides.size()), numel(1) {
+    for (size_t d = 0; d < dim_sizes.size(); ++d) {
+      numel *= dim_sizes[d];
+      if (dim_sizes[d] == 1) {
+        continue;
+      }
+      bool merge = !sizes.empty();
+      for (size_t t = 0; t < strides.size() && merge; ++t) {
+        merge = strides[t].back() == tensor_strides[t][d] * dim_sizes[d];
+      }
+      if (merge) {
+        sizes.back() *= dim_sizes[d];
+      } else {
+        sizes.push_back(dim_sizes[d]);
+      }
+      for (size_t t = 0; t < strides.size(); ++t) {
+        if (merge) {
+          strides[t].back() = tensor_strides[t][d];
+        } else {
+          strides[t].push_back(tensor_strides[t][d]);
+        }
+      }
+    }
+  }
+
+  // Offset in tensor t of the i-th element in row-major order
+  int64_t offset(int64_t i, size_t t) const {
+    int64_t result = 0;
+    for (int64_t d = (int64_t)sizes.size() - 1; d >= 0; --d) {
+      result += (i % sizes[d]) * strides[t][d];
+      i /= sizes[d];
+    }
+    return result;
+  }
+
+  std::vector<int64_t> sizes;
+  std::vector<std::vector<int64_t>> strides;
+  int64_t numel;
+};
+
+// Maps rows of the gathered values to slices of self, see the comment at the
+// top of the file.
+struct IndexedSlices {
+  IndexedSlices(
+      const Tensor& self,
+      TensorList indices,
+      int64_t dim,
+      const Tensor& values)
+      : before(self.sizes().slice(0, dim), {self.strides().slice(0, dim)}),
+        rows(
+            values.sizes().slice(0, dim + indices[0].dim()),
+            {values.strides().slice(0, dim + indices[0].dim())}),
+        inner(
+            self.sizes().slice(dim + indices.size()),
+            {self.strides().slice(dim + indices.size()),
+             values.strides().slice(dim + indices[0].dim())}),
+        index_numel(indices[0].numel()) {
+    for (size_t j = 0; j < indices.size(); ++j) {
+      index_data.push_back(indices[j].data<int64_t>());
+      index_sizes.push_back(self.size(dim + j));
+      index_strides.push_back(self.stride(dim + j));
+    }
+  }
+
+  int64_t num_rows() const {
+    return rows.numel;
+  }
+
+  int64_t slice_size() const {
+    return inner.numel;
+  }
+
+  int64_t self_offset(int64_t row) const {
+    const int64_t i = row % index_numel;
+    int64_t result = before.offset(row / index_numel, 0);
+    for (size_t j = 0; j < index_data.size(); ++j) {
+      int64_t index = index_data[j][i];
+      if (index < 0) {
+        index += index_sizes[j];
+      }
+      result += index * index_strides[j];
+    }
+    return result;
+  }
+
+  int64_t values_offset(int64_t row) const {
+    return rows.offset(row, 0);
+  }
+
+  MergedDims before;
+  MergedDims rows;
+  // strides[0] are the strides of self, strides[1] those of the values
+  MergedDims inner;
+  int64_t index_numel;
+  std::vector<const int64_t*> index_data;
+  std::vector<int64_t> index_sizes;
+  std::vector<int64_t> index_strides;
+};
+
+template <typename scalar_t>
+struct CopyOp {
+  static void apply(scalar_t* dst, const scalar_t* src, int64_t n) {
+    std::memcpy(dst, src, n * sizeof(scalar_t));
+  }
+  static void apply(scalar_t& dst, const scalar_t& src) {
+    dst = src;
+  }
+};
+
+template <typename scalar_t>
+struct AddOp {
+  static void apply(scalar_t* dst, const scalar_t* src, int64_t n) {
+    using Vec = Vectorized<scalar_t>;
+    int64_t k = 0;
+    for (; k + Vec::size <= n; k += Vec::size) {
+      (Vec::loadu(dst + k) + Vec::loadu(src + k)).store(dst + k);
+    }
+    for (; k < n; ++k) {
+      dst[k] += src[k];
+    }
+  }
+  static void apply(scalar_t& dst, const scalar_t& src) {
+    dst += src;
+  }
+};
+
+// Applies Op to the elements [begin, end) of a slice. dst_t and src_t select
+// the strides of dst and src in inner.
+template <typename Op, typename scalar_t>
+inline void apply_to_slice(
+    scalar_t* dst,
+    const scalar_t* src,
+    const MergedDims& inner,
+    size_t dst_t,
+    size_t src_t,
+    int64_t begin,
+    int64_t end) {
+  if (inner.sizes.empty()) {
+    Op::apply(*dst, *src);
+  } else if (inner.sizes.size() == 1) {
+    const int64_t dst_stride = inner.strides[dst_t][0];
+    const int64_t src_stride = inner.strides[src_t][0];
+    if (dst_stride == 1 && src_stride == 1) {
+      Op::apply(dst + begin, src + begin, end - begin);
+    } else {
+      for (int64_t k = begin; k < end; ++k) {
+        Op::apply(dst[k * dst_stride], src[k * src_stride]);
+      }
+    }
+  } else {
+    for (int64_t k = begin; k < end; ++k) {
+      Op::apply(dst[inner.offset(k, dst_t)], src[inner.offset(k, src_t)]);
+    }
+  }
+}
+
+template <typename scalar_t>
+void cpu_index(
+    Tensor& result,
+    const Tensor& self,
+    TensorList indices,
+    int64_t dim) {
+  const IndexedSlices slices(self, indices, dim, result);
+  const int64_t slice_size = slices.slice_size();
+  const scalar_t* self_data = self.data<scalar_t>();
+  scalar_t* result_data = result.data<scalar_t>();
+  const int64_t grain_size =
+      std::max(internal::GRAIN_SIZE / std::max(slice_size, (int64_t)1), (int64_t)1);
+  parallel_for(0, slices.num_rows(), grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; ++row) {
+      apply_to_slice<CopyOp<scalar_t>>(
+          result_data + slices.values_offset(row),
+          self_data + slices.self_offset(row),
+          slices.inner,
+          1,
+          0,
+          0,
+          slice_size);
+    }
+  });
+}
+
+template <typename scalar_t, typename Op>
+void cpu_index_put(
+    Tensor& self,
+    TensorList indices,
+    int64_t dim,
+    const Tensor& values) {
+  const IndexedSlices slices(self, indices, dim, values);
+  const int64_t num_rows = slices.num_rows();
+  scalar_t* self_data = self.data<scalar_t>();
+  const scalar_t* values_data = values.data<scalar_t>();
+  // Column ranges span at least a cache line, so that threads don't write
+  // to the same one
+  const int64_t grain_size = std::max(
+      internal::GRAIN_SIZE / std::max(num_rows, (int64_t)1),
+      (int64_t)(64 / sizeof(scalar_t)));
+  parallel_for(0, slices.slice_size(), grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t row = 0; row < num_rows; ++row) {
+      apply_to_slice<Op>(
+          self_data + slices.self_offset(row),
+          values_data + slices.values_offset(row),
+          slices.inner,
+          0,
+          1,
+          begin,
+          end);
+    }
+  });
+}
+
+static void index_kernel_impl(
+    Tensor& result,
+    const Tensor& self,
+    TensorList indices,
+    int64_t dim) {
+  AT_DISPATCH_ALL_TYPES_AND_HALF(self.type(), "index", [&] {
+    cpu_index<scalar_t>(result, self, indices, dim);
+  });
+}
+
+static void index_put_kernel_impl(
+    Tensor& self,
+    TensorList indices,
+    int64_t dim,
+    const Tensor& values,
+    bool accumulate) {
+  if (accumulate) {
+    AT_DISPATCH_ALL_TYPES(self.type(), "index_put_", [&] {
+      cpu_index_put<scalar_t, AddOp<scalar_t>>(self, indices, dim, values);
+    });
+  } else {
+    AT_DISPATCH_ALL_TYPES_AND_HALF(self.type(), "index_put_", [&] {
+      cpu_index_put<scalar_t, CopyOp<scalar_t>>(self, indices, dim, values);
+    });
+  }
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(index_kernel, &index_kernel_impl);
+REGISTER_DISPATCH(index_put_kernel, &index_put_kernel_impl);
+
+}} // namespace at::native
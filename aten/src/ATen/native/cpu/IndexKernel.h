@@ -0,0 +1,38 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include "CapabilityDispatch.h"
+
+namespace at {
+namespace native {
+
+// Advanced indexing of self by `indices`, a list of contiguous kLong tensors
+// of the same shape that index the adjacent dimensions dim, ...,
+// dim + indices.size() - 1 of self. Negative indices count from the end of
+// their dimension; all indices must be in bounds. The gathered values have
+// the shape
+//
+//   self.sizes()[:dim] + indices[0].sizes() + self.sizes()[dim + indices.size():]
+//
+// and result is a contiguous tensor of that shape.
+using index_fn = void (*)(
+    Tensor& /* result */,
+    const Tensor& /* self */,
+    TensorList /* indices */,
+    int64_t /* dim */);
+
+// Writes, or adds when accumulate is true, values (which has the shape of the
+// gathered values and may have any strides) to the indexed elements of self.
+// When an element is indexed more than once, the last value is written.
+using index_put_fn = void (*)(
+    Tensor& /* self */,
+    TensorList /* indices */,
+    int64_t /* dim */,
+    const Tensor& /* values */,
+    bool /* accumulate */);
+
+extern DispatchStub<index_fn> index_kernel;
+extern DispatchStub<index_put_fn> index_put_kernel;
+
+}
+}
@@ -0,0 +1,530 @@
+#include "ATen/native/cpu/NormalizationKernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "ATen/Dispatch.h"
+#include "ATen/Parallel.h"
+#include "ATen/cpu/vec256/vec256.h"
+
+// All kernels work on contiguous rows: the M rows of N elements of layer
+// norm, and the N * group groups of C / group * HxW elements of group norm.
+// Statistics are computed in a single pass with Welford's algorithm, and the
+// normalization and the affine transform are applied together in a second
+// pass that writes the output. The backward kernels similarly reduce each
+// row once and then write the gradient.
+//
+// On grainsize: see SoftMaxKernel.cpp. Every element costs roughly 8 simple
+// computations across the two passes.
+
+namespace at { namespace native {
+namespace {
+
+constexpr int64_t kOpsPerElement = 8;
+
+inline int64_t row_grain_size(int64_t row_size) {
+  return std::max(
+      internal::GRAIN_SIZE / (kOpsPerElement * std::max(row_size, (int64_t)1)),
+      (int64_t)1);
+}
+
+template <typename T>
+inline T horizontal_sum(const vec256::Vectorized<T>& v) {
+  using Vec = vec256::Vectorized<T>;
+  __at_align32__ T arr[Vec::size];
+  v.store(arr);
+  T sum = 0;
+  for (int64_t i = 0; i < Vec::size; ++i) {
+    sum += arr[i];
+  }
+  return sum;
+}
+
+// Merges the moments (count, mean, sum of squared deviations) of a disjoint
+// set of elements into (n, m1, m2), see Chan et al.
+template <typename T>
+inline void welford_combine(
+    int64_t& n,
+    T& m1,
+    T& m2,
+    int64_t n_b,
+    T m1_b,
+    T m2_b) {
+  if (n_b == 0) {
+    return;
+  }
+  const int64_t total = n + n_b;
+  const T delta = m1_b - m1;
+  const T ratio = T(n_b) / T(total);
+  m1 += delta * ratio;
+  m2 += m2_b + delta * delta * T(n) * ratio;
+  n = total;
+}
+
+// Mean and biased variance of X[0:N] in a single pass. Every lane of the
+// vector accumulators runs Welford's algorithm over the elements at its
+// offset, the lanes and the remaining tail are merged at the end.
+template <typename T>
+std::pair<T, T> rowwise_moments(const T* X, int64_t N) {
+  using Vec = vec256::Vectorized<T>;
+  constexpr int64_t K = Vec::size;
+  const int64_t n = N / K;
+  Vec m1_vec(T(0));
+  Vec m2_vec(T(0));
+  for (int64_t i = 0; i < n; ++i) {
+    const Vec x = Vec::loadu(X + i * K);
+    const Vec delta = x - m1_vec;
+    m1_vec = m1_vec + delta * Vec(T(1) / T(i + 1));
+    m2_vec = m2_vec + delta * (x - m1_vec);
+  }
+  __at_align32__ T m1_arr[K];
+  __at_align32__ T m2_arr[K];
+  m1_vec.store(m1_arr);
+  m2_vec.store(m2_arr);
+  int64_t count = 0;
+  T m1 = 0;
+  T m2 = 0;
+  if (n > 0) {
+    for (int64_t j = 0; j < K; ++j) {
+      welford_combine(count, m1, m2, n, m1_arr[j], m2_arr[j]);
+    }
+  }
+  for (int64_t i = n * K; i < N; ++i) {
+    ++count;
+    const T delta = X[i] - m1;
+    m1 += delta / T(count);
+    m2 += delta * (X[i] - m1);
+  }
+  return std::make_pair(m1, std::max(m2 / T(N), T(0)));
+}
+
+// Y = (X * scale + shift) * gamma + beta, gamma and beta may be null
+template <typename T>
+inline void normalize_row(
+    T* Y,
+    const T* X,
+    const T* gamma,
+    const T* beta,
+    T scale,
+    T shift,
+    int64_t N) {
+  using Vec = vec256::Vectorized<T>;
+  constexpr int64_t K = Vec::size;
+  for (int64_t j = 0; j < N; j += K) {
+    const int64_t count = std::min(K, N - j);
+    Vec y = Vec::loadu(X + j, count) * Vec(scale) + Vec(shift);
+    if (gamma != nullptr) {
+      y = y * Vec::loadu(gamma + j, count);
+    }
+    if (beta != nullptr) {
+      y = y + Vec::loadu(beta + j, count);
+    }
+    y.store(Y + j, count);
+  }
+}
+
+// Returns (sum(dY * gamma * X), sum(dY * gamma)), gamma may be null
+template <typename T>
+std::pair<T, T> rowwise_grad_sums(
+    const T* dY,
+    const T* X,
+    const T* gamma,
+    int64_t N) {
+  using Vec = vec256::Vectorized<T>;
+  constexpr int64_t K = Vec::size;
+  Vec ds_vec(T(0));
+  Vec db_vec(T(0));
+  int64_t j = 0;
+  for (; j + K <= N; j += K) {
+    Vec dy = Vec::loadu(dY + j);
+    if (gamma != nullptr) {
+      dy = dy * Vec::loadu(gamma + j);
+    }
+    ds_vec = ds_vec + dy * Vec::loadu(X + j);
+    db_vec = db_vec + dy;
+  }
+  T ds = horizontal_sum(ds_vec);
+  T db = horizontal_sum(db_vec);
+  for (; j < N; ++j) {
+    const T dy = gamma != nullptr ? dY[j] * gamma[j] : dY[j];
+    ds += dy * X[j];
+    db += dy;
+  }
+  return std::make_pair(ds, db);
+}
+
+// dX = dY * gamma * c1 + X * c2 + c3, gamma may be null
+template <typename T>
+inline void input_grad_row(
+    T* dX,
+    const T* dY,
+    const T* X,
+    const T* gamma,
+    T c1,
+    T c2,
+    T c3,
+    int64_t N) {
+  using Vec = vec256::Vectorized<T>;
+  constexpr int64_t K = Vec::size;
+  for (int64_t j = 0; j < N; j += K) {
+    const int64_t count = std::min(K, N - j);
+    Vec dy = Vec::loadu(dY + j, count);
+    if (gamma != nullptr) {
+      dy = dy * Vec::loadu(gamma + j, count);
+    }
+    const Vec dx =
+        dy * Vec(c1) + Vec::loadu(X + j, count) * Vec(c2) + Vec(c3);
+    dx.store(dX + j, count);
+  }
+}
+
+// With ds = sum(dY * gamma * X) and db = sum(dY * gamma) over a normalized
+// row of `size` elements, dX = dY * gamma * rstd + X * c2 + c3.
+template <typename T>
+inline std::pair<T, T>
+input_grad_coefficients(T ds, T db, T mean, T rstd, int64_t size) {
+  const T scale = T(1) / T(size);
+  const T c2 = (db * mean - ds) * rstd * rstd * rstd * scale;
+  const T c3 = -c2 * mean - db * rstd * scale;
+  return std::make_pair(c2, c3);
+}
+
+template <typename T>
+void layer_norm_forward(
+    Tensor& Y,
+    Tensor& mean,
+    Tensor& rstd,
+    const Tensor& X,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t M,
+    int64_t N,
+    T eps) {
+  const T* X_data = X.data<T>();
+  const T* gamma_data = gamma.defined() ? gamma.data<T>() : nullptr;
+  const T* beta_data = beta.defined() ? beta.data<T>() : nullptr;
+  T* Y_data = Y.data<T>();
+  T* mean_data = mean.data<T>();
+  T* rstd_data = rstd.data<T>();
+  parallel_for(0, M, row_grain_size(N), [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const T* X_ptr = X_data + i * N;
+      T m, var;
+      std::tie(m, var) = rowwise_moments(X_ptr, N);
+      const T s = T(1) / std::sqrt(var + eps);
+      mean_data[i] = m;
+      rstd_data[i] = s;
+      normalize_row(Y_data + i * N, X_ptr, gamma_data, beta_data, s, -m * s, N);
+    }
+  });
+}
+
+template <typename T>
+void layer_norm_backward(
+    Tensor& dX,
+    Tensor& dgamma,
+    Tensor& dbeta,
+    const Tensor& dY,
+    const Tensor& X,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t M,
+    int64_t N) {
+  using Vec = vec256::Vectorized<T>;
+  constexpr int64_t K = Vec::size;
+  const T* dY_data = dY.data<T>();
+  const T* X_data = X.data<T>();
+  const T* mean_data = mean.data<T>();
+  const T* rstd_data = rstd.data<T>();
+  const T* gamma_data = gamma.defined() ? gamma.data<T>() : nullptr;
+
+  if (dX.defined()) {
+    T* dX_data = dX.data<T>();
+    parallel_for(0, M, row_grain_size(N), [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        const T* dY_ptr = dY_data + i * N;
+        const T* X_ptr = X_data + i * N;
+        T ds, db, c2, c3;
+        std::tie(ds, db) = rowwise_grad_sums(dY_ptr, X_ptr, gamma_data, N);
+        std::tie(c2, c3) =
+            input_grad_coefficients(ds, db, mean_data[i], rstd_data[i], N);
+        input_grad_row(
+            dX_data + i * N, dY_ptr, X_ptr, gamma_data, rstd_data[i], c2, c3, N);
+      }
+    });
+  }
+
+  // Every task owns a range of columns and walks all rows over it, so the
+  // reduction over rows needs no per-thread buffers.
+  if (dgamma.defined() || dbeta.defined()) {
+    T* dgamma_data = dgamma.defined() ? dgamma.data<T>() : nullptr;
+    T* dbeta_data = dbeta.defined() ? dbeta.data<T>() : nullptr;
+    const int64_t grain_size = std::max(
+        internal::GRAIN_SIZE / (4 * std::max(M, (int64_t)1)), K);
+    parallel_for(0, N, grain_size, [&](int64_t begin, int64_t end) {
+      if (dgamma_data != nullptr) {
+        std::fill(dgamma_data + begin, dgamma_data + end, T(0));
+      }
+      if (dbeta_data != nullptr) {
+        std::fill(dbeta_data + begin, dbeta_data + end, T(0));
+      }
+      for (int64_t i = 0; i < M; ++i) {
+        const T* dY_ptr = dY_data + i * N;
+        const T* X_ptr = X_data + i * N;
+        const Vec m(mean_data[i]);
+        const Vec s(rstd_data[i]);
+        for (int64_t j = begin; j < end; j += K) {
+          const int64_t count = std::min(K, end - j);
+          const Vec dy = Vec::loadu(dY_ptr + j, count);
+          if (dgamma_data != nullptr) {
+            const Vec x_hat = (Vec::loadu(X_ptr + j, count) - m) * s;
+            const Vec acc = Vec::loadu(dgamma_data + j, count) + dy * x_hat;
+            acc.store(dgamma_data + j, count);
+          }
+          if (dbeta_data != nullptr) {
+            const Vec acc = Vec::loadu(dbeta_data + j, count) + dy;
+            acc.store(dbeta_data + j, count);
+          }
+        }
+      }
+    });
+  }
+}
+
+template <typename T>
+void group_norm_forward(
+    Tensor& Y,
+    Tensor& mean,
+    Tensor& rstd,
+    const Tensor& X,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    T eps) {
+  const int64_t D = C / group;
+  const T* X_data = X.data<T>();
+  const T* gamma_data = gamma.defined() ? gamma.data<T>() : nullptr;
+  const T* beta_data = beta.defined() ? beta.data<T>() : nullptr;
+  T* Y_data = Y.data<T>();
+  T* mean_data = mean.data<T>();
+  T* rstd_data = rstd.data<T>();
+  parallel_for(
+      0, N * group, row_grain_size(D * HxW), [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const int64_t g = i % group;
+          const T* X_ptr = X_data + i * D * HxW;
+          T* Y_ptr = Y_data + i * D * HxW;
+          T m, var;
+          std::tie(m, var) = rowwise_moments(X_ptr, D * HxW);
+          const T s = T(1) / std::sqrt(var + eps);
+          mean_data[i] = m;
+          rstd_data[i] = s;
+          for (int64_t d = 0; d < D; ++d) {
+            const int64_t c = g * D + d;
+            const T scale = gamma_data != nullptr ? s * gamma_data[c] : s;
+            const T shift = (beta_data != nullptr ? beta_data[c] : T(0)) -
+                m * scale;
+            normalize_row(
+                Y_ptr + d * HxW,
+                X_ptr + d * HxW,
+                static_cast<const T*>(nullptr),
+                static_cast<const T*>(nullptr),
+                scale,
+                shift,
+                HxW);
+          }
+        }
+      });
+}
+
+template <typename T>
+void group_norm_backward(
+    Tensor& dX,
+    Tensor& dgamma,
+    Tensor& dbeta,
+    const Tensor& dY,
+    const Tensor& X,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group) {
+  const int64_t D = C / group;
+  const T* dY_data = dY.data<T>();
+  const T* X_data = X.data<T>();
+  const T* mean_data = mean.data<T>();
+  const T* rstd_data = rstd.data<T>();
+  const T* gamma_data = gamma.defined() ? gamma.data<T>() : nullptr;
+
+  // sum(dY * X) and sum(dY) over every channel of every sample
+  std::vector<T> ds(N * C);
+  std::vector<T> db(N * C);
+  parallel_for(0, N * C, row_grain_size(HxW), [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      std::tie(ds[i], db[i]) = rowwise_grad_sums(
+          dY_data + i * HxW,
+          X_data + i * HxW,
+          static_cast<const T*>(nullptr),
+          HxW);
+    }
+  });
+
+  if (dX.defined()) {
+    T* dX_data = dX.data<T>();
+    parallel_for(
+        0, N * group, row_grain_size(D * HxW), [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            const int64_t g = i % group;
+            T ds_g = 0;
+            T db_g = 0;
+            for (int64_t d = 0; d < D; ++d) {
+              const int64_t c = g * D + d;
+              const T w = gamma_data != nullptr ? gamma_data[c] : T(1);
+              ds_g += ds[i * D + d] * w;
+              db_g += db[i * D + d] * w;
+            }
+            T c2, c3;
+            std::tie(c2, c3) = input_grad_coefficients(
+                ds_g, db_g, mean_data[i], rstd_data[i], D * HxW);
+            for (int64_t d = 0; d < D; ++d) {
+              const int64_t c = g * D + d;
+              const T c1 = gamma_data != nullptr
+                  ? rstd_data[i] * gamma_data[c]
+                  : rstd_data[i];
+              const int64_t offset = (i * D + d) * HxW;
+              input_grad_row(
+                  dX_data + offset,
+                  dY_data + offset,
+                  X_data + offset,
+                  static_cast<const T*>(nullptr),
+                  c1,
+                  c2,
+                  c3,
+                  HxW);
+            }
+          }
+        });
+  }
+
+  // dgamma = sum(dY * (X - mean) * rstd) and dbeta = sum(dY), both only
+  // need the per channel sums left to reduce over the batch.
+  if (dgamma.defined()) {
+    T* dgamma_data = dgamma.data<T>();
+    for (int64_t c = 0; c < C; ++c) {
+      T sum = 0;
+      for (int64_t n = 0; n < N; ++n) {
+        const int64_t i = n * group + c / D;
+        sum += rstd_data[i] * (ds[n * C + c] - mean_data[i] * db[n * C + c]);
+      }
+      dgamma_data[c] = sum;
+    }
+  }
+  if (dbeta.defined()) {
+    T* dbeta_data = dbeta.data<T>();
+    for (int64_t c = 0; c < C; ++c) {
+      T sum = 0;
+      for (int64_t n = 0; n < N; ++n) {
+        sum += db[n * C + c];
+      }
+      dbeta_data[c] = sum;
+    }
+  }
+}
+
+static void layer_norm_kernel_impl(
+    Tensor& Y,
+    Tensor& mean,
+    Tensor& rstd,
+    const Tensor& X,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t M,
+    int64_t N,
+    double eps) {
+  AT_DISPATCH_FLOATING_TYPES(X.type(), "layer_norm_kernel_impl", [&] {
+    layer_norm_forward<scalar_t>(
+        Y, mean, rstd, X, gamma, beta, M, N, static_cast<scalar_t>(eps));
+  });
+}
+
+static void layer_norm_backward_kernel_impl(
+    Tensor& dX,
+    Tensor& dgamma,
+    Tensor& dbeta,
+    const Tensor& dY,
+    const Tensor& X,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t M,
+    int64_t N) {
+  AT_DISPATCH_FLOATING_TYPES(X.type(), "layer_norm_backward_kernel_impl", [&] {
+    layer_norm_backward<scalar_t>(
+        dX, dgamma, dbeta, dY, X, mean, rstd, gamma, M, N);
+  });
+}
+
+static void group_norm_kernel_impl(
+    Tensor& Y,
+    Tensor& mean,
+    Tensor& rstd,
+    const Tensor& X,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    double eps) {
+  AT_DISPATCH_FLOATING_TYPES(X.type(), "group_norm_kernel_impl", [&] {
+    group_norm_forward<scalar_t>(
+        Y,
+        mean,
+        rstd,
+        X,
+        gamma,
+        beta,
+        N,
+        C,
+        HxW,
+        group,
+        static_cast<scalar_t>(eps));
+  });
+}
+
+static void group_norm_backward_kernel_impl(
+    Tensor& dX,
+    Tensor& dgamma,
+    Tensor& dbeta,
+    const Tensor& dY,
+    const Tensor& X,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group) {
+  AT_DISPATCH_FLOATING_TYPES(X.type(), "group_norm_backward_kernel_impl", [&] {
+    group_norm_backward<scalar_t>(
+        dX, dgamma, dbeta, dY, X, mean, rstd, gamma, N, C, HxW, group);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(layer_norm_kernel, &layer_norm_kernel_impl);
+REGISTER_DISPATCH(layer_norm_backward_kernel, &layer_norm_backward_kernel_impl);
+REGISTER_DISPATCH(group_norm_kernel, &group_norm_kernel_impl);
+REGISTER_DISPATCH(group_norm_backward_kernel, &group_norm_backward_kernel_impl);
+
+}} // namespace at::native
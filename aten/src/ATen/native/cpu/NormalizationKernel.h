@@ -0,0 +1,73 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include "CapabilityDispatch.h"
+
+namespace at {
+namespace native {
+
+// Layer norm over the last N elements of each of M contiguous rows.
+// weight and bias have N elements and may be undefined. mean and rstd
+// (1 / sqrt(var + eps)) are saved for the backward pass.
+using layer_norm_fn = void (*)(
+    Tensor& /* output */,
+    Tensor& /* mean */,
+    Tensor& /* rstd */,
+    const Tensor& /* input */,
+    const Tensor& /* weight */,
+    const Tensor& /* bias */,
+    int64_t /* M */,
+    int64_t /* N */,
+    double /* eps */);
+
+// Any of the gradients may be undefined, in which case it isn't computed.
+using layer_norm_backward_fn = void (*)(
+    Tensor& /* grad_input */,
+    Tensor& /* grad_weight */,
+    Tensor& /* grad_bias */,
+    const Tensor& /* grad_output */,
+    const Tensor& /* input */,
+    const Tensor& /* mean */,
+    const Tensor& /* rstd */,
+    const Tensor& /* weight */,
+    int64_t /* M */,
+    int64_t /* N */);
+
+// Group norm of a contiguous (N, C, HxW) input, with statistics computed
+// over each of the `group` groups of C / group channels of every sample.
+// weight and bias have C elements and may be undefined. mean and rstd have
+// N * group elements.
+using group_norm_fn = void (*)(
+    Tensor& /* output */,
+    Tensor& /* mean */,
+    Tensor& /* rstd */,
+    const Tensor& /* input */,
+    const Tensor& /* weight */,
+    const Tensor& /* bias */,
+    int64_t /* N */,
+    int64_t /* C */,
+    int64_t /* HxW */,
+    int64_t /* group */,
+    double /* eps */);
+
+using group_norm_backward_fn = void (*)(
+    Tensor& /* grad_input */,
+    Tensor& /* grad_weight */,
+    Tensor& /* grad_bias */,
+    const Tensor& /* grad_output */,
+    const Tensor& /* input */,
+    const Tensor& /* mean */,
+    const Tensor& /* rstd */,
+    const Tensor& /* weight */,
+    int64_t /* N */,
+    int64_t /* C */,
+    int64_t /* HxW */,
+    int64_t /* group */);
+
+extern DispatchStub<layer_norm_fn> layer_norm_kernel;
+extern DispatchStub<layer_norm_backward_fn> layer_norm_backward_kernel;
+extern DispatchStub<group_norm_fn> group_norm_kernel;
+extern DispatchStub<group_norm_backward_fn> group_norm_backward_kernel;
+
+}
+}
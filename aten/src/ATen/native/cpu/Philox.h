@@ -0,0 +1,110 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace at { namespace native {
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel random
+// numbers: as easy as 1, 2, 3", SC'11). Each 64-bit block index maps to four
+// independent 32-bit words, so any range of blocks can be generated without
+// producing the ones before it. Samplers reserve a range of blocks with
+// CPUGenerator::nextPhiloxSeed and let every parallel_for chunk fill its own
+// part of the output; the result only depends on the seed and the offset,
+// never on how the work was split.
+struct Philox4x32 {
+  static constexpr uint32_t kMul0 = 0xD2511F53;
+  static constexpr uint32_t kMul1 = 0xCD9E8D57;
+  static constexpr uint32_t kWeyl0 = 0x9E3779B9;
+  static constexpr uint32_t kWeyl1 = 0xBB67AE85;
+
+  Philox4x32(uint64_t seed, uint64_t offset)
+    : key0(static_cast<uint32_t>(seed)),
+      key1(static_cast<uint32_t>(seed >> 32)),
+      offset(offset) {}
+
+  // Writes the four words of block `offset + block` to out[0..3]
+  inline void operator()(uint64_t block, uint32_t* out) const {
+    const uint64_t counter = offset + block;
+    uint32_t c0 = static_cast<uint32_t>(counter);
+    uint32_t c1 = static_cast<uint32_t>(counter >> 32);
+    uint32_t c2 = 0;
+    uint32_t c3 = 0;
+    uint32_t k0 = key0;
+    uint32_t k1 = key1;
+    for (int round = 0; round < 10; round++) {
+      const uint64_t p0 = static_cast<uint64_t>(kMul0) * c0;
+      const uint64_t p1 = static_cast<uint64_t>(kMul1) * c2;
+      const uint32_t hi0 = static_cast<uint32_t>(p0 >> 32);
+      const uint32_t hi1 = static_cast<uint32_t>(p1 >> 32);
+      c0 = hi1 ^ c1 ^ k0;
+      c1 = static_cast<uint32_t>(p1);
+      c2 = hi0 ^ c3 ^ k1;
+      c3 = static_cast<uint32_t>(p0);
+      k0 += kWeyl0;
+      k1 += kWeyl1;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+  }
+
+  // Writes the words of blocks [begin, end) to out, four per block. Blocks
+  // are generated kLanes at a time with the rounds applied to all of them
+  // together, which the compiler can turn into vector code.
+  static constexpr int64_t kLanes = 8;
+  inline void fill(uint64_t begin, uint64_t end, uint32_t* out) const {
+    uint64_t block = begin;
+    for (; block + kLanes <= end; block += kLanes) {
+      uint32_t c0[kLanes], c1[kLanes], c2[kLanes], c3[kLanes];
+      for (int64_t j = 0; j < kLanes; j++) {
+        const uint64_t counter = offset + block + j;
+        c0[j] = static_cast<uint32_t>(counter);
+        c1[j] = static_cast<uint32_t>(counter >> 32);
+        c2[j] = 0;
+        c3[j] = 0;
+      }
+      uint32_t k0 = key0;
+      uint32_t k1 = key1;
+      for (int round = 0; round < 10; round++) {
+        for (int64_t j = 0; j < kLanes; j++) {
+          const uint64_t p0 = static_cast<uint64_t>(kMul0) * c0[j];
+          const uint64_t p1 = static_cast<uint64_t>(kMul1) * c2[j];
+          c0[j] = static_cast<uint32_t>(p1 >> 32) ^ c1[j] ^ k0;
+          c1[j] = static_cast<uint32_t>(p1);
+          c2[j] = static_cast<uint32_t>(p0 >> 32) ^ c3[j] ^ k1;
+          c3[j] = static_cast<uint32_t>(p0);
+        }
+        k0 += kWeyl0;
+        k1 += kWeyl1;
+      }
+      uint32_t* dst = out + 4 * (block - begin);
+      for (int64_t j = 0; j < kLanes; j++) {
+        dst[4 * j] = c0[j];
+        dst[4 * j + 1] = c1[j];
+        dst[4 * j + 2] = c2[j];
+        dst[4 * j + 3] = c3[j];
+      }
+    }
+    for (; block < end; block++) {
+      (*this)(block, out + 4 * (block - begin));
+    }
+  }
+
+  uint32_t key0;
+  uint32_t key1;
+  uint64_t offset;
+};
+
+// Uniform in [0, 1) from the top 24 bits of a word
+inline float philox_to_float(uint32_t x) {
+  return (x >> 8) * (1.0f / 16777216.0f);
+}
+
+// Uniform in [0, 1) from the top 53 bits of two words
+inline double philox_to_double(uint32_t hi, uint32_t lo) {
+  const uint64_t x = (static_cast<uint64_t>(hi) << 32) | lo;
+  return (x >> 11) * (1.0 / 9007199254740992.0);
+}
+
+}} // namespace at::native
@@ -0,0 +1,200 @@
+#include "ATen/native/cpu/RandomKernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "ATen/Dispatch.h"
+#include "ATen/Parallel.h"
+#include "ATen/cpu/vec256/vec256.h"
+#include "ATen/native/cpu/Philox.h"
+
+// All kernels fill a contiguous tensor from consecutive Philox blocks. A float
+// uniform takes one 32-bit word and a double uniform takes two, so a block
+// yields four float or two double uniforms. The normal kernel pairs up
+// consecutive uniforms for the Box-Muller transform, so both outputs of a pair
+// come from the same block. The bernoulli kernel compares one word per element
+// against p for every type.
+//
+// Work is split on block boundaries. Every chunk generates kBlocks blocks at a
+// time into a buffer on the stack and transforms it with Vectorized before
+// copying it to the output. The output doesn't depend on the number of
+// threads, but the normal kernel can differ in the last bits between CPU
+// capabilities since log is vectorized differently.
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// Blocks generated at a time by each chunk
+constexpr int64_t kBlocks = 64;
+
+// Uniforms of a floating point type produced per block
+template <typename scalar_t>
+constexpr int64_t values_per_block() {
+  return 16 / sizeof(scalar_t);
+}
+
+inline void words_to_uniform(const uint32_t* words, int64_t n, float* u) {
+  for (int64_t i = 0; i < n; i++) {
+    u[i] = philox_to_float(words[i]);
+  }
+}
+
+inline void words_to_uniform(const uint32_t* words, int64_t n, double* u) {
+  for (int64_t i = 0; i < n; i++) {
+    u[i] = philox_to_double(words[2 * i], words[2 * i + 1]);
+  }
+}
+
+// Reserves the blocks for `self` from the generator, and calls
+// f(words, n, values) to turn the words of every batch of blocks into the
+// n = blocks * per_block values that are copied to the output.
+template <typename scalar_t, typename F>
+void philox_apply(
+    Tensor& self,
+    CPUGenerator* generator,
+    int64_t per_block,
+    const F& f) {
+  const int64_t numel = self.numel();
+  if (numel == 0) {
+    return;
+  }
+  const int64_t num_blocks = (numel + per_block - 1) / per_block;
+  const auto seed = generator->nextPhiloxSeed(num_blocks);
+  const Philox4x32 philox(seed.first, seed.second);
+  scalar_t* data = self.data<scalar_t>();
+  const int64_t grain_size =
+      std::max(internal::GRAIN_SIZE / per_block, (int64_t)1);
+  parallel_for(0, num_blocks, grain_size, [&](int64_t begin, int64_t end) {
+    uint32_t words[4 * kBlocks];
+    scalar_t values[4 * kBlocks];
+    for (int64_t block = begin; block < end; block += kBlocks) {
+      const int64_t blocks = std::min(kBlocks, end - block);
+      philox.fill(block, block + blocks, words);
+      f(words, blocks * per_block, values);
+      const int64_t first = block * per_block;
+      const int64_t count = std::min(blocks * per_block, numel - first);
+      std::copy(values, values + count, data + first);
+    }
+  });
+}
+
+// values = from + range * values
+template <typename scalar_t>
+void uniform_transform(
+    scalar_t* values,
+    int64_t n,
+    scalar_t from,
+    scalar_t range) {
+  using Vec = Vectorized<scalar_t>;
+  const Vec vfrom(from);
+  const Vec vrange(range);
+  for (int64_t i = 0; i < n; i += Vec::size) {
+    const int64_t count = std::min((int64_t)Vec::size, n - i);
+    (Vec::loadu(values + i, count) * vrange + vfrom).store(values + i, count);
+  }
+}
+
+// Box-Muller on the pairs of uniforms (values[2i], values[2i + 1]), in place
+template <typename scalar_t>
+void normal_transform(
+    scalar_t* values,
+    int64_t n,
+    scalar_t mean,
+    scalar_t std) {
+  using Vec = Vectorized<scalar_t>;
+  scalar_t u1[2 * kBlocks];
+  scalar_t u2[2 * kBlocks];
+  const int64_t pairs = n / 2;
+  for (int64_t i = 0; i < pairs; i++) {
+    // 1 - u is in (0, 1], so its log is finite
+    u1[i] = 1 - values[2 * i];
+    u2[i] = values[2 * i + 1];
+  }
+  const Vec minus_two(-2);
+  const Vec two_pi(6.283185307179586);
+  const Vec vmean(mean);
+  const Vec vstd(std);
+  for (int64_t i = 0; i < pairs; i += Vec::size) {
+    const int64_t count = std::min((int64_t)Vec::size, pairs - i);
+    const Vec radius =
+        (Vec::loadu(u1 + i, count).log() * minus_two).sqrt() * vstd;
+    const Vec theta = Vec::loadu(u2 + i, count) * two_pi;
+    (radius * theta.cos() + vmean).store(u1 + i, count);
+    (radius * theta.sin() + vmean).store(u2 + i, count);
+  }
+  for (int64_t i = 0; i < pairs; i++) {
+    values[2 * i] = u1[i];
+    values[2 * i + 1] = u2[i];
+  }
+}
+
+void uniform_kernel_impl(
+    Tensor& self,
+    double from,
+    double to,
+    CPUGenerator* generator) {
+  AT_DISPATCH_FLOATING_TYPES(self.type(), "uniform_kernel_impl", [&] {
+    const scalar_t lo = from;
+    const scalar_t range = to - from;
+    philox_apply<scalar_t>(
+        self,
+        generator,
+        values_per_block<scalar_t>(),
+        [=](const uint32_t* words, int64_t n, scalar_t* values) {
+          words_to_uniform(words, n, values);
+          uniform_transform(values, n, lo, range);
+        });
+  });
+}
+
+void normal_kernel_impl(
+    Tensor& self,
+    double mean,
+    double std,
+    CPUGenerator* generator) {
+  AT_DISPATCH_FLOATING_TYPES(self.type(), "normal_kernel_impl", [&] {
+    const scalar_t m = mean;
+    const scalar_t s = std;
+    philox_apply<scalar_t>(
+        self,
+        generator,
+        values_per_block<scalar_t>(),
+        [=](const uint32_t* words, int64_t n, scalar_t* values) {
+          words_to_uniform(words, n, values);
+          normal_transform(values, n, m, s);
+        });
+  });
+}
+
+void bernoulli_scalar_kernel_impl(
+    Tensor& self,
+    double p,
+    CPUGenerator* generator) {
+  // An element is 1 when its word is below p * 2^32, which happens with
+  // probability p rounded down to a multiple of 2^-32. The comparison is done
+  // as word <= last on 32 bits so that it vectorizes.
+  const uint64_t threshold = static_cast<uint64_t>(p * 4294967296.0);
+  const bool nonzero = threshold > 0;
+  const uint32_t last = nonzero ? static_cast<uint32_t>(threshold - 1) : 0;
+  AT_DISPATCH_ALL_TYPES(self.type(), "bernoulli_scalar_kernel_impl", [&] {
+    philox_apply<scalar_t>(
+        self,
+        generator,
+        4,
+        [=](const uint32_t* words, int64_t n, scalar_t* values) {
+          for (int64_t i = 0; i < n; i++) {
+            values[i] = static_cast<scalar_t>(nonzero & (words[i] <= last));
+          }
+        });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(uniform_kernel, &uniform_kernel_impl);
+REGISTER_DISPATCH(normal_kernel, &normal_kernel_impl);
+REGISTER_DISPATCH(bernoulli_scalar_kernel, &bernoulli_scalar_kernel_impl);
+
+}} // namespace at::native
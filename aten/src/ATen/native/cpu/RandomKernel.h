@@ -0,0 +1,36 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/CPUGenerator.h>
+#include "CapabilityDispatch.h"
+
+namespace at {
+namespace native {
+
+// Samplers for contiguous tensors built on the generator's Philox stream
+// (see Philox.h). Each kernel reserves the blocks it needs from `generator`
+// and derives element i only from the seed, the reserved offset and i, so the
+// output is the same for any number of threads.
+using uniform_fn = void (*)(
+    Tensor& /* self */,
+    double /* from */,
+    double /* to */,
+    CPUGenerator* /* generator */);
+
+using normal_fn = void (*)(
+    Tensor& /* self */,
+    double /* mean */,
+    double /* std */,
+    CPUGenerator* /* generator */);
+
+using bernoulli_scalar_fn = void (*)(
+    Tensor& /* self */,
+    double /* p */,
+    CPUGenerator* /* generator */);
+
+extern DispatchStub<uniform_fn> uniform_kernel;
+extern DispatchStub<normal_fn> normal_kernel;
+extern DispatchStub<bernoulli_scalar_fn> bernoulli_scalar_kernel;
+
+}
+}
@@ -34,15 +34,16 @@ static void _parallel_for(int64_t size, int64_t step, bool parallelize, F func)
 }
 
 // Vectorized reduction defined by reduce operation `Op` with identity `ident`.
-// The reduction is built on top of reduce128, which reduces down a column
-// 128 bytes wide (WIDTH scalar elements). The width of 128 bytes is chosen
-// because of the "adjacent cache line prefetch" behavior on x86 CPUs.
+// The reduction is built on top of reduce_column, which reduces down a column
+// four vectors wide (WIDTH scalar elements). With Vec256 that is 128 bytes,
+// chosen because of the "adjacent cache line prefetch" behavior on x86 CPUs;
+// with Vec512 it is two such pairs of cache lines.
 template<typename scalar_t, template <class> class Op, int ident>
 struct Reduction {
+  using Vec = Vectorized<scalar_t>;
   // reduction width in number of scalar elements
-  static constexpr int WIDTH = 128 / sizeof(scalar_t);
+  static constexpr int WIDTH = 4 * Vec::size;
 
-  using Vec = Vec256<scalar_t>;
   using Reduce = Op<Vec>;
   using ReduceScalar = Op<scalar_t>;
 
@@ -75,7 +76,7 @@ struct Reduction {
           scalar_t buf[WIDTH] = {0};
           std::fill(buf, buf + WIDTH, ident);
           int64_t cols_rounded = n / WIDTH;
-          reduce128(data, buf, cols_rounded, WIDTH);
+          reduce_column(data, buf, cols_rounded, WIDTH);
           scalar_t result = ident;
           for (int64_t i = 0; i < WIDTH; i++) {
             result = ReduceScalar()(result, buf[i]);
@@ -101,7 +102,7 @@ struct Reduction {
               int64_t b = bi / (size / WIDTH);
               int64_t i = bi % (size / WIDTH);
               int64_t k = i * WIDTH;
-              reduce128(
+              reduce_column(
                   &data_[b * n * stride + k],
                   &out_[b * stride + k],
                   rows,
@@ -143,7 +144,7 @@ struct Reduction {
         (scalar_t)ident,
         [data](int64_t begin, int64_t end, scalar_t init) {
           scalar_t buf[WIDTH];
-          reduce128(&data[begin * WIDTH], buf, end - begin, WIDTH);
+          reduce_column(&data[begin * WIDTH], buf, end - begin, WIDTH);
           return std::accumulate(buf, buf + WIDTH, init, ReduceScalar());
         },
         ReduceScalar());
@@ -154,11 +155,13 @@ struct Reduction {
     return sum;
   }
 
-  // Reduce down a column of WIDTH elements (128 bytes) with the given number
-  // of rows. Stores the results in out[0 ... WIDTH-1].
-  static void reduce128(const scalar_t* data, scalar_t* out, int64_t rows, int64_t stride) {
-    Vec acc[4] = {ident, ident, ident, ident};  // 128 bytes (two cache lines)
-    static_assert(sizeof(acc) == 128, "accumulator should be 128 bytes");
+  // Reduce down a column of WIDTH elements (four vectors) with the given
+  // number of rows. Stores the results in out[0 ... WIDTH-1].
+  static void reduce_column(const scalar_t* data, scalar_t* out, int64_t rows, int64_t stride) {
+    Vec acc[4] = {ident, ident, ident, ident};
+    static_assert(
+        sizeof(acc) == WIDTH * sizeof(scalar_t),
+        "accumulator should be WIDTH elements");
     for (int64_t row = 0; row != rows; row++) {
       for (int j = 0; j != 4; j++) {
         auto val = Vec::loadu(&data[row * stride + j * Vec::size]);
@@ -0,0 +1,148 @@
+#include "ATen/native/cpu/SparseKernel.h"
+
+#include <algorithm>
+
+#include "ATen/Dispatch.h"
+#include "ATen/Parallel.h"
+#include "ATen/cpu/vec256/vec256.h"
+
+// Rows are split between threads by number of nonzeros rather than by count,
+// so that a few dense rows (as in power-law graphs) don't leave the other
+// threads idle. Every row is computed by a single thread, which accumulates
+// blocks of the output row in registers over all the nonzeros of the row.
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+template <typename scalar_t>
+struct CsrMatrix {
+  const int64_t* crow;
+  const int64_t* col;
+  const scalar_t* values;
+};
+
+// r_row[0, dim_k) += alpha * sum over the nonzeros i of the row of
+// values[i] * dense[col[i]], for contiguous rows of r and dense
+template <typename scalar_t>
+void csr_row_contiguous(
+    scalar_t* r_row,
+    const CsrMatrix<scalar_t>& a,
+    int64_t row_begin,
+    int64_t row_end,
+    const scalar_t* dense,
+    int64_t dense_stride,
+    int64_t dim_k,
+    scalar_t alpha) {
+  using Vec = Vectorized<scalar_t>;
+  int64_t k = 0;
+  for (; k + 4 * Vec::size <= dim_k; k += 4 * Vec::size) {
+    Vec acc0 = Vec::loadu(r_row + k);
+    Vec acc1 = Vec::loadu(r_row + k + Vec::size);
+    Vec acc2 = Vec::loadu(r_row + k + 2 * Vec::size);
+    Vec acc3 = Vec::loadu(r_row + k + 3 * Vec::size);
+    for (int64_t i = row_begin; i < row_end; ++i) {
+      const Vec w(alpha * a.values[i]);
+      const scalar_t* d = dense + a.col[i] * dense_stride + k;
+      acc0 = acc0 + w * Vec::loadu(d);
+      acc1 = acc1 + w * Vec::loadu(d + Vec::size);
+      acc2 = acc2 + w * Vec::loadu(d + 2 * Vec::size);
+      acc3 = acc3 + w * Vec::loadu(d + 3 * Vec::size);
+    }
+    acc0.store(r_row + k);
+    acc1.store(r_row + k + Vec::size);
+    acc2.store(r_row + k + 2 * Vec::size);
+    acc3.store(r_row + k + 3 * Vec::size);
+  }
+  for (; k + Vec::size <= dim_k; k += Vec::size) {
+    Vec acc = Vec::loadu(r_row + k);
+    for (int64_t i = row_begin; i < row_end; ++i) {
+      acc = acc + Vec(alpha * a.values[i]) *
+          Vec::loadu(dense + a.col[i] * dense_stride + k);
+    }
+    acc.store(r_row + k);
+  }
+  for (; k < dim_k; ++k) {
+    scalar_t acc = r_row[k];
+    for (int64_t i = row_begin; i < row_end; ++i) {
+      acc += alpha * a.values[i] * dense[a.col[i] * dense_stride + k];
+    }
+    r_row[k] = acc;
+  }
+}
+
+template <typename scalar_t>
+void cpu_csr_addmm(
+    Tensor& r,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense,
+    scalar_t alpha) {
+  const int64_t dim_i = crow_indices.size(0) - 1;
+  const int64_t dim_k = dense.size(1);
+  const int64_t nnz = col_indices.size(0);
+  const CsrMatrix<scalar_t> a{crow_indices.data<int64_t>(),
+                              col_indices.data<int64_t>(),
+                              values.data<scalar_t>()};
+  const scalar_t* dense_data = dense.data<scalar_t>();
+  scalar_t* r_data = r.data<scalar_t>();
+  const int64_t dense_stride0 = dense.stride(0);
+  const int64_t dense_stride1 = dense.stride(1);
+  const int64_t r_stride0 = r.stride(0);
+  const int64_t r_stride1 = r.stride(1);
+  const bool contiguous = dense_stride1 == 1 && r_stride1 == 1;
+
+  const int64_t grain_size =
+      std::max(internal::GRAIN_SIZE / std::max(dim_k, (int64_t)1), (int64_t)1);
+  parallel_for(0, nnz, grain_size, [&](int64_t begin, int64_t end) {
+    // The rows whose first nonzero is in [begin, end)
+    const int64_t h_begin =
+        std::lower_bound(a.crow, a.crow + dim_i, begin) - a.crow;
+    const int64_t h_end = std::lower_bound(a.crow, a.crow + dim_i, end) - a.crow;
+    for (int64_t h = h_begin; h < h_end; ++h) {
+      const int64_t row_begin = a.crow[h];
+      const int64_t row_end = a.crow[h + 1];
+      scalar_t* r_row = r_data + h * r_stride0;
+      if (dim_k == 1) {
+        scalar_t acc = 0;
+        for (int64_t i = row_begin; i < row_end; ++i) {
+          acc += a.values[i] * dense_data[a.col[i] * dense_stride0];
+        }
+        *r_row += alpha * acc;
+      } else if (contiguous) {
+        csr_row_contiguous(
+            r_row, a, row_begin, row_end, dense_data, dense_stride0, dim_k,
+            alpha);
+      } else {
+        for (int64_t i = row_begin; i < row_end; ++i) {
+          const scalar_t w = alpha * a.values[i];
+          const scalar_t* d = dense_data + a.col[i] * dense_stride0;
+          for (int64_t k = 0; k < dim_k; ++k) {
+            r_row[k * r_stride1] += w * d[k * dense_stride1];
+          }
+        }
+      }
+    }
+  });
+}
+
+static void csr_addmm_kernel_impl(
+    Tensor& r,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense,
+    Scalar alpha) {
+  AT_DISPATCH_ALL_TYPES(values.type(), "csr_addmm", [&] {
+    cpu_csr_addmm<scalar_t>(
+        r, crow_indices, col_indices, values, dense, alpha.to<scalar_t>());
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(csr_addmm_kernel, &csr_addmm_kernel_impl);
+
+}} // namespace at::native
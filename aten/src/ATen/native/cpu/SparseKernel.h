@@ -0,0 +1,25 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include "CapabilityDispatch.h"
+
+namespace at {
+namespace native {
+
+// r += alpha * A * dense, where A is a dim_i x dim_j matrix in CSR form:
+// crow_indices (dim_i + 1 row pointers), col_indices and values (nnz each)
+// are contiguous, columns are in [0, dim_j) and sorted within each row. r is
+// a dim_i x dim_k matrix and dense a dim_j x dim_k one; both may have any
+// strides. dim_k == 1 is a matrix-vector product.
+using csr_addmm_fn = void (*)(
+    Tensor& /* r */,
+    const Tensor& /* crow_indices */,
+    const Tensor& /* col_indices */,
+    const Tensor& /* values */,
+    const Tensor& /* dense */,
+    Scalar /* alpha */);
+
+extern DispatchStub<csr_addmm_fn> csr_addmm_kernel;
+
+}
+}
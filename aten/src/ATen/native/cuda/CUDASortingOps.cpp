@@ -0,0 +1,30 @@
+#include <ATen/ATen.h>
+
+namespace at { namespace native {
+
+std::tuple<Tensor&, Tensor&> _sort_out_cuda(Tensor& values, Tensor& indices,
+                                            const Tensor& self, int64_t dim,
+                                            bool descending) {
+  return at::_th_sort_out(values, indices, self, dim, descending);
+}
+
+std::tuple<Tensor&, Tensor&> _topk_out_cuda(Tensor& values, Tensor& indices,
+                                            const Tensor& self, int64_t k,
+                                            int64_t dim, bool largest,
+                                            bool sorted) {
+  return at::_th_topk_out(values, indices, self, k, dim, largest, sorted);
+}
+
+std::tuple<Tensor&, Tensor&> _median_out_cuda(Tensor& values, Tensor& indices,
+                                              const Tensor& self, int64_t dim,
+                                              bool keepdim) {
+  return at::_th_median_out(values, indices, self, dim, keepdim);
+}
+
+std::tuple<Tensor&, Tensor&> _mode_out_cuda(Tensor& values, Tensor& indices,
+                                            const Tensor& self, int64_t dim,
+                                            bool keepdim) {
+  return at::_th_mode_out(values, indices, self, dim, keepdim);
+}
+
+}}
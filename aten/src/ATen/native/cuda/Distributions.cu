@@ -119,4 +119,12 @@ Tensor _standard_gamma_grad_cuda(const Tensor& self, const Tensor& output) {
   return ret;
 }
 
+Tensor& _uniform__cuda(Tensor& self, double from, double to, Generator* gen) {
+  return self._th_uniform_(from, to, gen);
+}
+
+Tensor& _normal__cuda(Tensor& self, double mean, double std, Generator* gen) {
+  return self._th_normal_(mean, std, gen);
+}
+
 }} // namespace at::native
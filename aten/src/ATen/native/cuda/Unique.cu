@@ -5,8 +5,22 @@
 namespace at {
 namespace native{
 
-std::tuple<Tensor, Tensor>
-_unique_cuda(const Tensor& self, const bool sorted, const bool return_inverse) {
+std::tuple<Tensor, Tensor, Tensor> _unique_cuda(
+    const Tensor& self,
+    const bool sorted,
+    const bool return_inverse,
+    const bool return_counts) {
+  throw std::runtime_error(
+      "unique is currently CPU-only, and lacks CUDA support. "
+      "Pull requests welcome!");
+}
+
+std::tuple<Tensor, Tensor, Tensor> _unique_dim_cuda(
+    const Tensor& self,
+    const int64_t dim,
+    const bool sorted,
+    const bool return_inverse,
+    const bool return_counts) {
   throw std::runtime_error(
       "unique is currently CPU-only, and lacks CUDA support. "
       "Pull requests welcome!");
@@ -1,12 +1,20 @@
 // Basic functions on sparse tensors
 
 #include <ATen/ATen.h>
+#include <ATen/Parallel.h>
 #include <ATen/SparseTensorImpl.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/native/ParallelSortUtils.h>
 #include <ATen/native/sparse/SparseUtils.h>
 
 #include <TH/THBlasUtils.h>
 
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
 namespace at { namespace native {
 
 /******************************************************************************
@@ -53,6 +61,49 @@ Tensor _values_sparse(const SparseTensor& self) {
   return _get_sparse_impl(self)->values().narrow(0, 0, nnz);
 }
 
+namespace {
+  // Row pointers of a dim-row matrix whose nonzeros have the sorted row
+  // indices rows[0, nnz)
+  LongTensor _to_csr(const int64_t* rows, int64_t dim, int64_t nnz) {
+    LongTensor csr = native::zeros({dim + 1}, kLong);
+    int64_t* csr_ptr = csr.data<int64_t>();
+    // Entry i ends the rows [rows[i], rows[i + 1]), so every entry of csr is
+    // written by exactly one i
+    parallel_for(0, nnz, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        const int64_t next = (i + 1 == nnz) ? dim : rows[i + 1];
+        for (int64_t h = rows[i]; h < next; h++) {
+          csr_ptr[h + 1] = i + 1;
+        }
+      }
+    });
+    return csr;
+  }
+
+  // Guards SparseTensorImpl::crow_indices_, which const methods fill in
+  std::mutex crow_indices_mutex;
+}
+
+LongTensor _crow_indices_sparse(const SparseTensor& self) {
+  AT_CHECK(self._sparseDims() == 2,
+      "_crow_indices: expected 2 sparse dimensions, got ", self._sparseDims());
+  AT_CHECK(self.is_coalesced(),
+      "_crow_indices: expected a coalesced tensor, call coalesce() first");
+  SparseTensorImpl* impl = _get_sparse_impl(self);
+  std::lock_guard<std::mutex> lock(crow_indices_mutex);
+  if (!impl->crow_indices().defined()) {
+    const int64_t dim = self.size(0);
+    const int64_t nnz = self._nnz();
+    if (nnz == 0) {
+      impl->set_crow_indices(native::zeros({dim + 1}, kLong));
+    } else {
+      LongTensor rows = self._indices().select(0, 0).contiguous();
+      impl->set_crow_indices(_to_csr(rows.data<int64_t>(), dim, nnz));
+    }
+  }
+  return impl->crow_indices();
+}
+
 /******************************************************************************
  * creation methods
  ******************************************************************************/
@@ -197,6 +248,61 @@ SparseTensor clone_sparse(const SparseTensor& self) {
   return other;
 }
 
+/* CSR init: the result is coalesced and keeps a copy of crow_indices as
+ * its row pointers */
+
+SparseTensor _sparse_coo_tensor_from_csr(const LongTensor& crow_indices, const LongTensor& col_indices, const Tensor& values, ArrayRef<int64_t> size) {
+  AT_CHECK(size.size() == 2,
+      "_sparse_coo_tensor_from_csr: expected a matrix size, got ", size.size(), " dimensions");
+  AT_CHECK(!crow_indices.is_cuda() && !col_indices.is_cuda() && !values.is_cuda(),
+      "_sparse_coo_tensor_from_csr: only CPU tensors are supported");
+  const int64_t dim_i = size[0];
+  const int64_t dim_j = size[1];
+  AT_CHECK(crow_indices.dim() == 1 && crow_indices.size(0) == dim_i + 1,
+      "_sparse_coo_tensor_from_csr: expected ", dim_i + 1, " crow_indices, got ", crow_indices.sizes());
+  AT_CHECK(col_indices.dim() == 1 && values.dim() == 1 && col_indices.size(0) == values.size(0),
+      "_sparse_coo_tensor_from_csr: expected col_indices and values of the same length, got ",
+      col_indices.sizes(), " and ", values.sizes());
+  const int64_t nnz = col_indices.size(0);
+
+  LongTensor crow = crow_indices.clone();
+  LongTensor cols = col_indices.contiguous();
+  const int64_t* crow_ptr = crow.data<int64_t>();
+  const int64_t* cols_ptr = cols.data<int64_t>();
+  AT_CHECK(crow_ptr[0] == 0 && crow_ptr[dim_i] == nnz,
+      "_sparse_coo_tensor_from_csr: crow_indices must start at 0 and end at nnz = ", nnz);
+  for (int64_t h = 0; h < dim_i; h++) {
+    AT_CHECK(crow_ptr[h] <= crow_ptr[h + 1],
+        "_sparse_coo_tensor_from_csr: crow_indices must be non-decreasing");
+    for (int64_t i = crow_ptr[h]; i < crow_ptr[h + 1]; i++) {
+      AT_CHECK(cols_ptr[i] >= 0 && cols_ptr[i] < dim_j,
+          "_sparse_coo_tensor_from_csr: column index ", cols_ptr[i], " is out of bounds for size ", dim_j);
+      AT_CHECK(i == crow_ptr[h] || cols_ptr[i - 1] < cols_ptr[i],
+          "_sparse_coo_tensor_from_csr: columns must be sorted and unique within each row");
+    }
+  }
+
+  SparseTensor result;
+  if (nnz == 0) {
+    // TODO: use a 2 x 0 indices tensor when zero-size dims are supported
+    result = at::_sparse_coo_tensor_unsafe(native::empty({0}, kLong), values, size);
+  } else {
+    LongTensor indices = native::empty({2, nnz}, kLong);
+    int64_t* rows_ptr = indices.data<int64_t>();
+    const int64_t row_nnz = std::max(nnz / std::max(dim_i, (int64_t)1), (int64_t)1);
+    parallel_for(0, dim_i, internal::GRAIN_SIZE / row_nnz, [&](int64_t begin, int64_t end) {
+      for (int64_t h = begin; h < end; h++) {
+        std::fill(rows_ptr + crow_ptr[h], rows_ptr + crow_ptr[h + 1], h);
+      }
+    });
+    indices.select(0, 1).copy_(cols);
+    result = at::_sparse_coo_tensor_unsafe(indices, values, size);
+  }
+  _get_sparse_impl(result)->set_coalesced(true);
+  _get_sparse_impl(result)->set_crow_indices(crow);
+  return result;
+}
+
 /******************************************************************************
  * reshaping methods
  ******************************************************************************/
@@ -272,56 +378,119 @@ SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
   int64_t denseDims = self._denseDims();
   int64_t nnz = self._nnz();
 
-  LongTensor indices_scalar = at::zeros({nnz}, kLong);
-
+  // Flattened indices, which order the nonzeros like their indices do
+  std::vector<uint64_t> keys(nnz);
+  const int64_t* indices_ptr = indices.data<int64_t>();
+  const int64_t indices_stride0 = indices.stride(0);
+  const int64_t indices_stride1 = indices.stride(1);
+  std::vector<int64_t> factors(sparseDims);
   int64_t factor = 1;
   for (int64_t d = sparseDims - 1; d >= 0; d--) {
-    LongTensor indices_slice = indices.select(0, d);
-    indices_scalar.add_(indices_slice, factor); // cadd is swapped args
+    factors[d] = factor;
     factor *= self.size(d);
   }
+  parallel_for(0, nnz, internal::GRAIN_SIZE / sparseDims, [&](int64_t begin, int64_t end) {
+    for (int64_t j = begin; j < end; j++) {
+      int64_t key = 0;
+      for (int64_t d = 0; d < sparseDims; d++) {
+        key += indices_ptr[d * indices_stride0 + j * indices_stride1] * factors[d];
+      }
+      keys[j] = static_cast<uint64_t>(key);
+    }
+  });
+
+  // Tensors built in index order (e.g. by the embedding backward) only need
+  // their duplicates merged, and skip the sort. Without duplicates they are
+  // coalesced already.
+  enum Order { kIncreasing = 0, kNonDecreasing = 1, kUnsorted = 2 };
+  const int64_t num_chunks = num_chunks_for(nnz);
+  std::vector<int> chunk_order(num_chunks);
+  for_each_chunk(nnz, num_chunks, [&](int64_t c, int64_t begin, int64_t end) {
+    int order = kIncreasing;
+    for (int64_t j = std::max(begin, (int64_t)1); j < end && order != kUnsorted; j++) {
+      if (keys[j - 1] > keys[j]) {
+        order = kUnsorted;
+      } else if (keys[j - 1] == keys[j]) {
+        order = kNonDecreasing;
+      }
+    }
+    chunk_order[c] = order;
+  });
+  const int order = *std::max_element(chunk_order.begin(), chunk_order.end());
+  if (order == kIncreasing) {
+    _get_sparse_impl(self)->set_coalesced(true);
+    return self;
+  }
+
+  std::vector<int64_t> perm(nnz);
+  parallel_for(0, nnz, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    std::iota(perm.data() + begin, perm.data() + end, begin);
+  });
+  uint64_t* sorted_keys = keys.data();
+  int64_t* sorted_perm = perm.data();
+  std::vector<uint64_t> keys_tmp;
+  std::vector<int64_t> perm_tmp;
+  if (order == kUnsorted) {
+    // The sort is stable, so duplicates are summed in their original order
+    keys_tmp.resize(nnz);
+    perm_tmp.resize(nnz);
+    std::tie(sorted_keys, sorted_perm) = radix_sort(
+        keys.data(), keys_tmp.data(), perm.data(), perm_tmp.data(), nnz);
+  }
+
+  auto is_start = [&](int64_t j) {
+    return j == 0 || sorted_keys[j] != sorted_keys[j - 1];
+  };
+  const auto first_id = count_groups(nnz, is_start);
+  const int64_t newNnz = first_id.back();
 
   SparseTensor dst = new_sparse(self.type());
   _raw_resize_sparse(dst, sparseDims, denseDims, self.sizes());
   // TODO: is there a more idiomatic way to do this?
-  LongTensor newIndices = indices.type().tensor(indices.sizes());
-  Tensor newValues = values.type().tensor(values.sizes());
+  LongTensor newIndices = indices.type().tensor({sparseDims, newNnz});
+  std::vector<int64_t> newValuesSizes = values.sizes().vec();
+  newValuesSizes[0] = newNnz;
+  Tensor newValues = values.type().tensor(newValuesSizes);
   _alias_into_sparse(dst, newIndices, newValues);
 
-  LongTensor indicesBuffer;
-  LongTensor indicesPermutation;
-  std::tie(indicesBuffer, indicesPermutation) = indices_scalar.sort(0);
-  // NB: The accessor accesses here rely on self._nnz() > 0 (tested earlier in this function)
-  auto newIndicesAccessor = newIndices.accessor<int64_t, 2>();
-  auto indicesAccessor = indices.accessor<int64_t, 2>();
-  auto indicesPermutationAccessor = indicesPermutation.accessor<int64_t, 1>();
-  auto indicesBufferAccessor = indicesBuffer.accessor<int64_t, 1>();
-
-  int64_t i = -1;
+  // Every chunk merges the duplicates of the groups that start in it, which
+  // may run into the next chunk
+  int64_t* newIndices_ptr = newIndices.data<int64_t>();
   AT_DISPATCH_ALL_TYPES(
       values.type(), "coalesce", [&] {
-        int64_t prev = -1;
         int64_t blockSize = values.stride(0);
         scalar_t* values_ptr = values.data<scalar_t>();
         scalar_t* newValues_ptr = newValues.data<scalar_t>();
-        for (int64_t j = 0; j < nnz; j++) {
-          int64_t pos = indicesPermutationAccessor[j];
-          int64_t curr = indicesBufferAccessor[j];
-          if (curr == prev) {
-            THBlas_axpy<scalar_t>(blockSize, 1, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
-          } else {
-            ++i;
+        for_each_chunk(nnz, first_id.size() - 1, [&](int64_t c, int64_t begin, int64_t end) {
+          int64_t id = first_id[c] - 1;
+          for (int64_t j = begin; j < end; j++) {
+            if (!is_start(j)) {
+              continue;
+            }
+            ++id;
+            int64_t pos = sorted_perm[j];
             for (int64_t d = 0; d < sparseDims; d++) {
-              newIndicesAccessor[d][i] = indicesAccessor[d][pos];
+              newIndices_ptr[d * newNnz + id] = indices_ptr[d * indices_stride0 + pos * indices_stride1];
+            }
+            scalar_t* out = newValues_ptr + id * blockSize;
+            if (blockSize == 1) {
+              scalar_t sum = values_ptr[pos];
+              for (int64_t k = j + 1; k < nnz && !is_start(k); k++) {
+                sum += values_ptr[sorted_perm[k]];
+              }
+              *out = sum;
+            } else {
+              THBlas_copy<scalar_t>(blockSize, values_ptr + pos * blockSize, 1, out, 1);
+              for (int64_t k = j + 1; k < nnz && !is_start(k); k++) {
+                THBlas_axpy<scalar_t>(blockSize, 1, values_ptr + sorted_perm[k] * blockSize, 1, out, 1);
+              }
             }
-            THBlas_copy<scalar_t>(blockSize, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
           }
-          prev = curr;
-        }
+        });
     });
 
   _get_sparse_impl(dst)->set_coalesced(true);
-  _get_sparse_impl(dst)->set_nnz(i + 1);
+  _get_sparse_impl(dst)->set_nnz(newNnz);
 
   return dst;
 }
@@ -3,38 +3,12 @@
 #include <ATen/ExpandUtils.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/native/sparse/SparseUtils.h>
+#include <ATen/native/cpu/SparseKernel.h>
 
 #include <TH/THBlasUtils.h>
 
 namespace at { namespace native {
 
-// --------------------------------------------------------------------
-// Utility functions
-// --------------------------------------------------------------------
-
-namespace {
-  LongTensor _to_csr(const int64_t* indices, int64_t dim, int64_t nnz) {
-    int64_t h, i, hp0, hp1;
-    LongTensor csr = native::zeros({dim + 1}, kLong);
-
-    // TODO: eliminate this conditional when zero-size dims supported correctly
-    if (nnz > 0) {
-      auto csr_accessor = csr.accessor<int64_t, 1>();
-      // Convert the sparse matrix to CSR format
-#pragma omp parallel for private(i, h, hp0, hp1) schedule(static) if (nnz > 10000)
-      for (i=0; i<nnz; i++) {
-        hp0 = indices[i];
-        hp1 = (i+1 == nnz) ?  dim : indices[i+1];
-        if (hp0 != hp1) for (h = hp0; h < hp1; h++) {
-          csr_accessor[h+1] = i+1;
-        }
-      }
-    }
-    return csr;
-  }
-
-}
-
 // --------------------------------------------------------------------
 // zero_(SparseTensor)
 // --------------------------------------------------------------------
@@ -507,54 +481,6 @@ SparseTensor& s_mul_sparse_cpu_(SparseTensor& t, const SparseTensor& src) {
 // addmm(Tensor, SparseTensorRef, Tensor, Scalar, Scalar)  [broadcasts]
 // --------------------------------------------------------------------
 
-// NB: OMP pragmas have to get their own functions; can't put them in lambdas
-template <typename scalar_t>
-void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j, int64_t dim_k, Tensor& r, Scalar beta, const Tensor& t, Scalar alpha, const Tensor& csr, const Tensor& indices, const Tensor& values, const Tensor& dense) {
-  int64_t h, i;
-
-  // r_ = alpha * sparse * dense
-  scalar_t cast_alpha = alpha.to<scalar_t>();
-  scalar_t cast_beta = beta.to<scalar_t>();
-  if (cast_beta == 0) {
-    r.zero_();
-  } else if (cast_beta == 1) {
-    if (!isSameTensor(r, t)) {
-      r.copy_(t);
-    }
-  } else {
-    at::mul_out(r, t, beta);
-  }
-
-  auto csr_accessor = csr.accessor<int64_t, 1>();
-  auto indices_accessor = indices.accessor<int64_t, 2>();
-
-  auto values_accessor = values.accessor<scalar_t, 1>();
-  scalar_t* dense_ptr = dense.data<scalar_t>();
-  scalar_t* r_ptr = r.data<scalar_t>();
-
-  int64_t dense_stride0 = dense.stride(0);
-  int64_t dense_stride1 = dense.stride(1);
-  int64_t r_stride0 = r.stride(0);
-  int64_t r_stride1 = r.stride(1);
-#pragma omp parallel for private(h, i) schedule(static) if (nnz > 10000)
-  for (h = 0; h < dim_i; h++) {
-    int64_t i_start = csr_accessor[h];
-    int64_t i_end = csr_accessor[h+1];
-    for (i = i_start; i < i_end; i++) {
-      scalar_t val = values_accessor[i];
-      int64_t col = indices_accessor[1][i];
-      if (col >= 0 && col < dim_j) {
-        THBlas_axpy<scalar_t>(dim_k,
-            cast_alpha * val,
-            dense_ptr + col * dense_stride0, dense_stride1,
-            r_ptr + h * r_stride0, r_stride1);
-      } else {
-        AT_ERROR("index out of bound. spmm: ", col, " not between 1 and ", dim_j);
-      }
-    }
-  }
-};
-
 Tensor& s_addmm_out_sparse_dense_cpu(
     Tensor& r,
     const Tensor& t,
@@ -592,16 +518,22 @@ Tensor& s_addmm_out_sparse_dense_cpu(
     return r;
   }
 
-  LongTensor indices = sparse._indices();
-  Tensor values      = sparse._values();
-  LongTensor csr = _to_csr(indices.data<int64_t>(), dim_i, nnz);
+  if (beta.toDouble() == 0) {
+    r.zero_();
+  } else if (beta.toDouble() == 1) {
+    if (!isSameTensor(r, t)) {
+      r.copy_(t);
+    }
+  } else {
+    at::mul_out(r, t, beta);
+  }
 
-  AT_DISPATCH_ALL_TYPES(
-      values.type(), "addmm_sparse_dense", [&] {
-        s_addmm_out_sparse_dense_worker<scalar_t>(nnz, dim_i, dim_j, dim_k, r, beta, t, alpha, csr, indices, values, dense);
-      }
-  );
+  LongTensor cols = sparse._indices().select(0, 1).contiguous();
+  AT_CHECK(cols.min().toCLong() >= 0 && cols.max().toCLong() < dim_j,
+      "index out of bound. spmm: column indices must be between 0 and ", dim_j - 1);
 
+  // r += alpha * sparse * dense
+  csr_addmm_kernel(r, sparse._crow_indices(), cols, sparse._values().contiguous(), dense, alpha);
   return r;
 
 }
@@ -738,7 +670,7 @@ SparseTensor& _sspaddmm_out_cpu(
   LongTensor indices = sparse._indices();
   Tensor values      = sparse._values();
 
-  LongTensor csr = _to_csr(indices.data<int64_t>(), dim_i, nnz);
+  LongTensor csr = sparse._crow_indices();
 
   int64_t t_nnz = t._nnz();
   int64_t r_nnz = nnz * dim_k + t_nnz;
@@ -3,6 +3,7 @@
 // ${generated_comment}
 
 #include <$header>
+#include <utility>
 
 #include "ATen/Generator.h"
 
@@ -21,6 +22,7 @@ struct ${name}Generator : public Generator {
   virtual ${name}Generator& manualSeed(uint64_t seed) override;
   virtual ${name}Generator& manualSeedAll(uint64_t seed) override;
   virtual void * unsafeGetTH() override;
+  ${methods}
 
 //TODO(zach): figure out friends later
 public:
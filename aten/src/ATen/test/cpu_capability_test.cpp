@@ -0,0 +1,153 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include <cpuinfo.h>
+
+#include "ATen/ATen.h"
+#include "ATen/native/cpu/ReduceOpsKernel.h"
+#include "ATen/native/cpu/SoftmaxKernel.h"
+#include "ATen/native/cpu/UnaryOpsKernel.h"
+#include "test_seed.h"
+
+using namespace at;
+using at::native::CPUCapability;
+using at::native::DispatchStub;
+
+// Calls the kernel compiled for each capability level directly from the
+// DispatchStub's table and compares it against the DEFAULT kernel. Levels that
+// weren't compiled in or that the CPU doesn't support are skipped. The odd
+// lengths leave a tail that doesn't fill a vector.
+
+static bool cpu_supports(CPUCapability capability) {
+  if (!cpuinfo_initialize()) {
+    return capability == CPUCapability::DEFAULT;
+  }
+  switch (capability) {
+    case CPUCapability::DEFAULT:
+      return true;
+    case CPUCapability::AVX:
+      return cpuinfo_has_x86_avx();
+    case CPUCapability::AVX2:
+      return cpuinfo_has_x86_avx2();
+    case CPUCapability::AVX512:
+      return cpuinfo_has_x86_avx512f();
+    default:
+      return false;
+  }
+}
+
+// Calls test(reference, kernel) with the DEFAULT kernel of `stub` and the
+// kernel of every other level this CPU can run
+template <typename FnPtr, typename Test>
+static void for_each_capability(DispatchStub<FnPtr>& stub, Test test) {
+  FnPtr reference = stub.table[static_cast<int>(CPUCapability::DEFAULT)];
+  REQUIRE(reference != nullptr);
+  const int num_capabilities = static_cast<int>(CPUCapability::NUM_OPTIONS);
+  for (int capability = 1; capability < num_capabilities; capability++) {
+    FnPtr kernel = stub.table[capability];
+    if (!kernel || !cpu_supports(static_cast<CPUCapability>(capability))) {
+      continue;
+    }
+    INFO("capability " << capability);
+    test(reference, kernel);
+  }
+}
+
+static const int64_t lengths[] = {1, 7, 63, 1025, 100003};
+
+// Integer sums are exact, floating point ones depend on the vector width
+static bool same_sum(const Tensor& result, const Tensor& expected) {
+  if (isIntegralType(result.type().scalarType())) {
+    return result.equal(expected);
+  }
+  return result.allclose(expected);
+}
+
+static void test_sum(Type& type) {
+  auto test = [&](native::reduce_fn reference, native::reduce_fn kernel) {
+    for (int64_t n : lengths) {
+      INFO("length " << n);
+      auto self = (rand({n}, CPU(kFloat)) * 100).toType(type);
+      auto expected = empty({}, type);
+      auto result = empty({}, type);
+      reference(expected, self, nullopt);
+      kernel(result, self, nullopt);
+      REQUIRE(same_sum(result, expected));
+    }
+    // Reduces over the contiguous and the strided dimension
+    auto self = (rand({37, 129}, CPU(kFloat)) * 100).toType(type);
+    for (int64_t dim = 0; dim < 2; dim++) {
+      INFO("dim " << dim);
+      std::vector<int64_t> sizes = {37, 129};
+      sizes[dim] = 1;
+      auto expected = empty(sizes, type);
+      auto result = empty(sizes, type);
+      reference(expected, self, dim);
+      kernel(result, self, dim);
+      REQUIRE(same_sum(result, expected));
+    }
+  };
+  for_each_capability(native::sum_kernel, test);
+}
+
+static void test_softmax(Type& type, DispatchStub<native::forward_fn>& stub) {
+  auto test = [&](native::forward_fn reference, native::forward_fn kernel) {
+    for (int64_t n : lengths) {
+      INFO("length " << n);
+      auto self = rand({3, n}, type) * 10 - 5;
+      auto expected = empty_like(self);
+      auto result = empty_like(self);
+      reference(expected, self);
+      kernel(result, self);
+      REQUIRE(result.allclose(expected, 1e-5, 1e-6));
+    }
+  };
+  for_each_capability(stub, test);
+}
+
+// Inputs are in [0.5, 10.5), where all of the tested functions are finite
+static void test_unary(Type& type, DispatchStub<native::unary_fn>& stub) {
+  auto test = [&](native::unary_fn reference, native::unary_fn kernel) {
+    for (int64_t n : lengths) {
+      INFO("length " << n);
+      auto self = rand({n}, type) * 10 + 0.5;
+      auto expected = empty_like(self);
+      auto result = empty_like(self);
+      reference(expected, self);
+      kernel(result, self);
+      REQUIRE(result.allclose(expected, 1e-5, 1e-6));
+    }
+  };
+  for_each_capability(stub, test);
+}
+
+TEST_CASE( "cpu capability test", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+
+  SECTION( "sum" ) {
+    test_sum(CPU(kFloat));
+    test_sum(CPU(kDouble));
+    test_sum(CPU(kLong));
+  }
+
+  SECTION( "softmax" ) {
+    test_softmax(CPU(kFloat), native::softmax_lastdim_kernel);
+    test_softmax(CPU(kDouble), native::softmax_lastdim_kernel);
+  }
+
+  SECTION( "log_softmax" ) {
+    test_softmax(CPU(kFloat), native::log_softmax_lastdim_kernel);
+    test_softmax(CPU(kDouble), native::log_softmax_lastdim_kernel);
+  }
+
+  SECTION( "unary" ) {
+    for (auto type : {kFloat, kDouble}) {
+      test_unary(CPU(type), native::expImpl);
+      test_unary(CPU(type), native::logImpl);
+      test_unary(CPU(type), native::tanhImpl);
+      test_unary(CPU(type), native::floorImpl);
+      test_unary(CPU(type), native::sqrtImpl);
+      test_unary(CPU(type), native::rsqrtImpl);
+    }
+  }
+}
@@ -3,7 +3,9 @@
 
 #include "ATen/ATen.h"
 #include "ATen/DLConvertor.h"
+#include "ATen/Parallel.h"
 
+#include <atomic>
 #include <iostream>
 #include <string.h>
 #include <sstream>
@@ -26,3 +28,76 @@ TEST_CASE( "parallel", "[cpu]" ) {
   as[2] = 0;
   REQUIRE(a.sum(0).equal(as));
 }
+
+// Restores the parallel backend of the process when going out of scope, so
+// that the tests below don't leak theirs into the rest of the binary
+struct ParallelBackendGuard {
+  ParallelBackendGuard() : backend(get_parallel_backend()) {}
+  ~ParallelBackendGuard() {
+    set_parallel_backend(backend);
+  }
+  ParallelBackend backend;
+};
+
+TEST_CASE( "parallel_for native backend", "[cpu]" ) {
+  ParallelBackendGuard backend_guard;
+  set_num_threads(4);
+  set_parallel_backend(ParallelBackend::Native);
+
+  std::vector<int> hits(100000, 0);
+  std::atomic<bool> nested_inline(true);
+  parallel_for(0, hits.size(), 1000, [&](int64_t begin, int64_t end) {
+    // nested constructs run inline on the current thread
+    parallel_for(begin, end, 1, [&](int64_t b, int64_t e) {
+      if (!in_parallel_region()) {
+        nested_inline = false;
+      }
+      for (int64_t i = b; i < e; i++) {
+        hits[i]++;
+      }
+    });
+  });
+  REQUIRE(nested_inline);
+  for (auto hit : hits) {
+    REQUIRE(hit == 1);
+  }
+  REQUIRE(!in_parallel_region());
+
+  REQUIRE_THROWS(parallel_for(0, 100000, 1, [](int64_t begin, int64_t end) {
+    if (begin > 0) {
+      throw std::runtime_error("task failed");
+    }
+  }));
+}
+
+TEST_CASE( "parallel_reduce is deterministic", "[cpu]" ) {
+  ParallelBackendGuard backend_guard;
+  std::vector<double> values(1000003);
+  for (size_t i = 0; i < values.size(); i++) {
+    values[i] = 1.0 / (i + 1);
+  }
+  auto reduce = [&]() {
+    return parallel_reduce(
+        0,
+        values.size(),
+        internal::GRAIN_SIZE,
+        0.0,
+        [&](int64_t begin, int64_t end, double ident) {
+          double sum = ident;
+          for (int64_t i = begin; i < end; i++) {
+            sum += values[i];
+          }
+          return sum;
+        },
+        std::plus<double>());
+  };
+
+  set_parallel_backend(ParallelBackend::Serial);
+  double expected = reduce();
+  set_parallel_backend(ParallelBackend::Native);
+  for (int num_threads : {1, 2, 3, 8}) {
+    set_num_threads(num_threads);
+    REQUIRE(reduce() == expected);
+  }
+  set_num_threads(1);
+}
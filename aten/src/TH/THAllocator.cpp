@@ -43,6 +43,7 @@ struct THMapAllocatorContext_ {
   char *filename; /* file name */
   int flags;
   ptrdiff_t size; /* mapped size */
+  ptrdiff_t offset; /* offset of the mapping in the file */
 #ifdef _WIN32
   HANDLE handle;
   HANDLE event;
@@ -94,6 +95,7 @@ THMapAllocatorContext *THMapAllocatorContext_new(const char *filename, int flags
 
   ctx->flags = flags;
   ctx->size = 0;
+  ctx->offset = 0;
 #ifdef _WIN32
   ctx->handle = INVALID_HANDLE_VALUE;
 #else
@@ -115,6 +117,22 @@ THMapAllocatorContext *THMapAllocatorContext_newWithFd(const char *filename, int
 #endif
 }
 
+THMapAllocatorContext *THMapAllocatorContext_newWithFdAndOffset(const char *filename,
+    int fd, ptrdiff_t offset, int flags)
+{
+#ifdef _WIN32
+  THError("THMapAllocatorContext_newWithFdAndOffset is unsupported on Windows");
+#else
+  if (offset < 0 || offset % sysconf(_SC_PAGESIZE) != 0)
+    THError("mapping offset %ld of file <%s> is not a multiple of the page size",
+        (long)offset, filename ? filename : unknown_filename);
+  THMapAllocatorContext *ctx = THMapAllocatorContext_newWithFd(filename, fd, flags);
+  ctx->offset = offset;
+
+  return ctx;
+#endif
+}
+
 char * THMapAllocatorContext_filename(THMapAllocatorContext *ctx)
 {
   return ctx->filename;
@@ -354,13 +372,13 @@ static void *_map_alloc(void* ctx_, ptrdiff_t size)
 
     if(size > 0)
     {
-      if(size > file_stat.st_size)
+      if(ctx->offset + size > file_stat.st_size)
       {
         if(ctx->flags)
         {
-          if(ftruncate(fd, size) == -1)
+          if(ftruncate(fd, ctx->offset + size) == -1)
             THError("unable to resize file <%s> to the right size", ctx->filename);
-          if(fstat(fd, &file_stat) == -1 || file_stat.st_size < size)
+          if(fstat(fd, &file_stat) == -1 || file_stat.st_size < ctx->offset + size)
           {
             close(fd);
             THError("unable to stretch file <%s> to the right size", ctx->filename);
@@ -384,15 +402,23 @@ static void *_map_alloc(void* ctx_, ptrdiff_t size)
       }
     }
     else
-      size = file_stat.st_size;
+    {
+      if(ctx->offset > file_stat.st_size)
+      {
+        if (!(ctx->flags & TH_ALLOCATOR_MAPPED_FROMFD))
+          close(fd);
+        THError("mapping offset %ld is past the end of file <%s>", (long)ctx->offset, ctx->filename);
+      }
+      size = file_stat.st_size - ctx->offset;
+    }
 
     ctx->size = size; /* if we are here, it must be the right size */
 
     /* map it */
     if (ctx->flags & (TH_ALLOCATOR_MAPPED_SHARED | TH_ALLOCATOR_MAPPED_SHAREDMEM))
-      data = mmap(NULL, ctx->size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+      data = mmap(NULL, ctx->size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, ctx->offset);
     else
-      data = mmap(NULL, ctx->size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+      data = mmap(NULL, ctx->size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, ctx->offset);
 
     if (ctx->flags & TH_ALLOCATOR_MAPPED_KEEPFD) {
       ctx->fd = fd;
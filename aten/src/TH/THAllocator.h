@@ -30,6 +30,9 @@ typedef struct THMapAllocatorContext_  THMapAllocatorContext;
 TH_API THMapAllocatorContext *THMapAllocatorContext_new(const char *filename, int flags);
 TH_API THMapAllocatorContext *THMapAllocatorContext_newWithFd(const char *filename,
     int fd, int flags);
+/* maps the file starting at offset, which must be a multiple of the page size */
+TH_API THMapAllocatorContext *THMapAllocatorContext_newWithFdAndOffset(const char *filename,
+    int fd, ptrdiff_t offset, int flags);
 TH_API char * THMapAllocatorContext_filename(THMapAllocatorContext *ctx);
 TH_API int THMapAllocatorContext_fd(THMapAllocatorContext *ctx);
 TH_API ptrdiff_t THMapAllocatorContext_size(THMapAllocatorContext *ctx);
@@ -20,6 +20,10 @@ struct THGeneratorState {
   double normal_y;
   double normal_rho;
   int normal_is_valid; /* = 0; */
+
+  /* Number of Philox blocks handed out since the last seed, used by the
+     parallel samplers in ATen/native/cpu/Philox.h */
+  uint64_t philox_seed_offset; /* = 0; */
 };
 
 /* A THGenerator contains all the state required for a single random number stream */
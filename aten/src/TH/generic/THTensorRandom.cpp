@@ -3,6 +3,8 @@
 #else
 
 #include <cmath>
+#include <cstddef>
+#include <cstring>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -541,12 +543,23 @@ void THTensor_(setRNGState)(THGenerator *_generator, THTensor *self)
 {
   std::lock_guard<std::mutex> lock(_generator->mutex);
   static const size_t size = sizeof(THGeneratorState);
-  THGeneratorState *rng_state;
-  THArgCheck(THTensor_(nElement)(self) == size, 1, "RNG state is wrong size");
+  // States saved before the Philox offset was added stop right before it
+  static const size_t legacy_size = offsetof(THGeneratorState, philox_seed_offset);
+  THGeneratorState rng_state;
+  bool no_philox_seed = false;
+  if (THTensor_(nElement)(self) == legacy_size) {
+    no_philox_seed = true;
+  }
+  else {
+    THArgCheck(THTensor_(nElement)(self) == size, 1, "RNG state is wrong size");
+  }
   THArgCheck(THTensor_(isContiguous)(self), 1, "RNG state needs to be contiguous");
-  rng_state = (THGeneratorState *)THTensor_(data)(self);
-  THArgCheck(THGeneratorState_isValid(rng_state), 1, "Invalid RNG state");
-  THGeneratorState_copy(&_generator->gen_state, rng_state);
+  memcpy(&rng_state, THTensor_(data)(self), THTensor_(nElement)(self));
+  if (no_philox_seed) {
+    rng_state.philox_seed_offset = 0;
+  }
+  THArgCheck(THGeneratorState_isValid(&rng_state), 1, "Invalid RNG state");
+  THGeneratorState_copy(&_generator->gen_state, &rng_state);
 }
 #endif
 #endif
@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmarks bincount and histc on CPU. Dense inputs are spread uniformly
+// over the bins. Skewed inputs put most values in the first few bins, which
+// is the worst case for a shared histogram.
+
+#include <cmath>
+#include <random>
+
+#include "benchmark/benchmark.h"
+
+#include "ATen/ATen.h"
+
+namespace {
+
+enum Distribution { kDense = 0, kSkewed = 1 };
+
+// Values in [0, 1), uniform or concentrated near 0
+at::Tensor random_values(int64_t n, int64_t distribution) {
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<double> dist(0, 1);
+  at::Tensor values = at::empty({n}, at::CPU(at::kDouble));
+  double* data = values.data<double>();
+  for (int64_t i = 0; i < n; ++i) {
+    const double x = dist(gen);
+    data[i] = distribution == kSkewed ? std::pow(x, 8) : x;
+  }
+  return values;
+}
+
+// Arguments are {numel, number of bins, distribution}
+void BM_Bincount(benchmark::State& state) {
+  const int64_t bins = state.range(1);
+  const at::Tensor ids =
+      (random_values(state.range(0), state.range(2)) * bins).toType(at::kLong);
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(at::bincount(ids, {}, bins));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_BincountWeighted(benchmark::State& state) {
+  const int64_t bins = state.range(1);
+  const at::Tensor ids =
+      (random_values(state.range(0), state.range(2)) * bins).toType(at::kLong);
+  const at::Tensor weights = at::ones({state.range(0)}, at::CPU(at::kFloat));
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(at::bincount(ids, weights, bins));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Histc(benchmark::State& state) {
+  const at::Tensor values =
+      random_values(state.range(0), state.range(2)).toType(at::kFloat);
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(at::histc(values, state.range(1), 0, 1));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The range of the input has to be found first
+void BM_HistcMinMax(benchmark::State& state) {
+  const at::Tensor values =
+      random_values(state.range(0), state.range(2)).toType(at::kFloat);
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(at::histc(values, state.range(1)));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void HistogramArgs(benchmark::internal::Benchmark* b) {
+  for (int64_t n : {1 << 16, 1 << 20, 1 << 24}) {
+    for (int64_t bins : {16, 1024, 1 << 20}) {
+      b->Args({n, bins, kDense});
+      b->Args({n, bins, kSkewed});
+    }
+  }
+  b->Unit(benchmark::kMicrosecond);
+}
+
+} // namespace
+
+BENCHMARK(BM_Bincount)->Apply(HistogramArgs);
+BENCHMARK(BM_BincountWeighted)->Apply(HistogramArgs);
+BENCHMARK(BM_Histc)->Apply(HistogramArgs);
+BENCHMARK(BM_HistcMinMax)->Apply(HistogramArgs);
+
+BENCHMARK_MAIN();
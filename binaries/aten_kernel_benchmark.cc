@@ -0,0 +1,214 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Compares the CPU capability levels (DEFAULT, AVX, AVX2, AVX512) of the
+// vectorized ATen kernels on a float tensor. The first argument is the
+// capability; the kernel compiled for it is called directly from the
+// DispatchStub's table, bypassing the runtime selection, so that all levels
+// can be measured in one process. Levels that weren't compiled in or that the
+// CPU doesn't support are skipped. Run with one thread (e.g.
+// OMP_NUM_THREADS=1) to compare the kernels rather than the memory bandwidth.
+//
+// exp and tanh only go through the vectorized kernels when ATen is built
+// without MKL; floor and rsqrt always do.
+
+#include <cpuinfo.h>
+
+#include "benchmark/benchmark.h"
+
+#include "ATen/ATen.h"
+#include "ATen/native/cpu/ReduceOpsKernel.h"
+#include "ATen/native/cpu/SoftmaxKernel.h"
+#include "ATen/native/cpu/UnaryOpsKernel.h"
+
+namespace {
+
+using at::native::CPUCapability;
+
+const char* capability_name(CPUCapability capability) {
+  switch (capability) {
+    case CPUCapability::DEFAULT:
+      return "DEFAULT";
+    case CPUCapability::AVX:
+      return "AVX";
+    case CPUCapability::AVX2:
+      return "AVX2";
+    case CPUCapability::AVX512:
+      return "AVX512";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+bool cpu_supports(CPUCapability capability) {
+  if (!cpuinfo_initialize()) {
+    return capability == CPUCapability::DEFAULT;
+  }
+  switch (capability) {
+    case CPUCapability::DEFAULT:
+      return true;
+    case CPUCapability::AVX:
+      return cpuinfo_has_x86_avx();
+    case CPUCapability::AVX2:
+      return cpuinfo_has_x86_avx2();
+    case CPUCapability::AVX512:
+      return cpuinfo_has_x86_avx512f();
+    default:
+      return false;
+  }
+}
+
+// Returns the kernel of `stub` for the capability in the first argument, or
+// nullptr after marking the benchmark as skipped.
+template <typename FnPtr>
+FnPtr get_kernel(
+    benchmark::State& state,
+    at::native::DispatchStub<FnPtr>& stub) {
+  const auto capability = static_cast<CPUCapability>(state.range(0));
+  state.SetLabel(capability_name(capability));
+  FnPtr kernel = stub.table[static_cast<int>(capability)];
+  if (!kernel) {
+    state.SkipWithError("capability not compiled in");
+    return nullptr;
+  }
+  if (!cpu_supports(capability)) {
+    state.SkipWithError("capability not supported by this CPU");
+    return nullptr;
+  }
+  return kernel;
+}
+
+at::Tensor random_tensor(at::IntList sizes) {
+  return at::rand(sizes, at::CPU(at::kFloat));
+}
+
+// Arguments are {capability, n}
+void BM_Sum(benchmark::State& state) {
+  auto kernel = get_kernel(state, at::native::sum_kernel);
+  if (!kernel) {
+    return;
+  }
+  const at::Tensor self = random_tensor({state.range(1)});
+  at::Tensor result = at::empty({}, self.type());
+  while (state.KeepRunning()) {
+    kernel(result, self, at::nullopt);
+  }
+  state.SetItemsProcessed(state.iterations() * self.numel());
+}
+
+// Sums the columns of a [n, 1024] tensor
+void BM_SumDim0(benchmark::State& state) {
+  auto kernel = get_kernel(state, at::native::sum_kernel);
+  if (!kernel) {
+    return;
+  }
+  const at::Tensor self = random_tensor({state.range(1), 1024});
+  at::Tensor result = at::empty({1, 1024}, self.type());
+  while (state.KeepRunning()) {
+    kernel(result, self, 0);
+  }
+  state.SetItemsProcessed(state.iterations() * self.numel());
+}
+
+// Softmax over the last dimension of a [1024, n] tensor
+template <typename FnPtr>
+void softmax_benchmark(
+    benchmark::State& state,
+    at::native::DispatchStub<FnPtr>& stub) {
+  auto kernel = get_kernel(state, stub);
+  if (!kernel) {
+    return;
+  }
+  const at::Tensor self = random_tensor({1024, state.range(1)});
+  at::Tensor result = at::empty_like(self);
+  while (state.KeepRunning()) {
+    kernel(result, self);
+  }
+  state.SetItemsProcessed(state.iterations() * self.numel());
+}
+
+void BM_Softmax(benchmark::State& state) {
+  softmax_benchmark(state, at::native::softmax_lastdim_kernel);
+}
+
+void BM_LogSoftmax(benchmark::State& state) {
+  softmax_benchmark(state, at::native::log_softmax_lastdim_kernel);
+}
+
+// Unary operations on a contiguous tensor of n elements
+void unary_benchmark(
+    benchmark::State& state,
+    at::native::DispatchStub<at::native::unary_fn>& stub) {
+  auto kernel = get_kernel(state, stub);
+  if (!kernel) {
+    return;
+  }
+  const at::Tensor self = random_tensor({state.range(1)});
+  at::Tensor result = at::empty_like(self);
+  while (state.KeepRunning()) {
+    kernel(result, self);
+  }
+  state.SetItemsProcessed(state.iterations() * self.numel());
+}
+
+void BM_Exp(benchmark::State& state) {
+  unary_benchmark(state, at::native::expImpl);
+}
+
+void BM_Tanh(benchmark::State& state) {
+  unary_benchmark(state, at::native::tanhImpl);
+}
+
+void BM_Floor(benchmark::State& state) {
+  unary_benchmark(state, at::native::floorImpl);
+}
+
+void BM_Rsqrt(benchmark::State& state) {
+  unary_benchmark(state, at::native::rsqrtImpl);
+}
+
+void CapabilityArgs(
+    benchmark::internal::Benchmark* b,
+    std::initializer_list<int64_t> sizes) {
+  const int num_capabilities = static_cast<int>(CPUCapability::NUM_OPTIONS);
+  for (int64_t n : sizes) {
+    for (int capability = 0; capability < num_capabilities; capability++) {
+      b->Args({capability, n});
+    }
+  }
+  b->Unit(benchmark::kMicrosecond);
+}
+
+void VectorArgs(benchmark::internal::Benchmark* b) {
+  CapabilityArgs(b, {1 << 12, 1 << 16, 1 << 22});
+}
+
+void RowArgs(benchmark::internal::Benchmark* b) {
+  CapabilityArgs(b, {16, 128, 1024});
+}
+
+} // namespace
+
+BENCHMARK(BM_Sum)->Apply(VectorArgs);
+BENCHMARK(BM_SumDim0)->Apply(RowArgs);
+BENCHMARK(BM_Softmax)->Apply(RowArgs);
+BENCHMARK(BM_LogSoftmax)->Apply(RowArgs);
+BENCHMARK(BM_Exp)->Apply(VectorArgs);
+BENCHMARK(BM_Tanh)->Apply(VectorArgs);
+BENCHMARK(BM_Floor)->Apply(VectorArgs);
+BENCHMARK(BM_Rsqrt)->Apply(VectorArgs);
+
+BENCHMARK_MAIN();
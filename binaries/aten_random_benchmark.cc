@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmarks filling a CPU tensor with uniform_, normal_ and bernoulli_, with
+// the number of threads given by the second argument.
+
+#include "benchmark/benchmark.h"
+
+#include "ATen/ATen.h"
+
+namespace {
+
+// Arguments are {numel, threads, is_double}
+at::Tensor make_tensor(benchmark::State& state) {
+  at::set_num_threads(static_cast<int>(state.range(1)));
+  return at::empty(
+      {state.range(0)}, at::CPU(state.range(2) ? at::kDouble : at::kFloat));
+}
+
+void BM_Uniform(benchmark::State& state) {
+  at::Tensor tensor = make_tensor(state);
+  while (state.KeepRunning()) {
+    tensor.uniform_(-1, 1);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Normal(benchmark::State& state) {
+  at::Tensor tensor = make_tensor(state);
+  while (state.KeepRunning()) {
+    tensor.normal_(0, 1);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// As used for dropout masks
+void BM_Bernoulli(benchmark::State& state) {
+  at::Tensor tensor = make_tensor(state);
+  while (state.KeepRunning()) {
+    tensor.bernoulli_(0.5);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void RandomArgs(benchmark::internal::Benchmark* b) {
+  for (int64_t n : {1 << 12, 1 << 20, 1 << 24}) {
+    for (int64_t threads : {1, 4, 16}) {
+      b->Args({n, threads, 0});
+      b->Args({n, threads, 1});
+    }
+  }
+  b->Unit(benchmark::kMicrosecond);
+}
+
+} // namespace
+
+BENCHMARK(BM_Uniform)->Apply(RandomArgs);
+BENCHMARK(BM_Normal)->Apply(RandomArgs);
+BENCHMARK(BM_Bernoulli)->Apply(RandomArgs);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmarks sort, topk and kthvalue on CPU along the last dimension of a
+// [batch, n] float tensor, as in beam search over a vocabulary. The strided
+// variants work along the first dimension of the transposed tensor.
+
+#include <random>
+
+#include "benchmark/benchmark.h"
+
+#include "ATen/ATen.h"
+
+namespace {
+
+at::Tensor random_scores(int64_t batch, int64_t n) {
+  std::mt19937 gen(0);
+  std::normal_distribution<float> dist;
+  at::Tensor scores = at::empty({batch, n}, at::CPU(at::kFloat));
+  float* data = scores.data<float>();
+  for (int64_t i = 0; i < batch * n; ++i) {
+    data[i] = dist(gen);
+  }
+  return scores;
+}
+
+// Arguments are {batch, n}
+void BM_Sort(benchmark::State& state) {
+  const at::Tensor scores = random_scores(state.range(0), state.range(1));
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(scores.sort(-1));
+  }
+  state.SetItemsProcessed(state.iterations() * scores.numel());
+}
+
+void BM_SortStrided(benchmark::State& state) {
+  const at::Tensor scores = random_scores(state.range(1), state.range(0)).t();
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(scores.sort(-1));
+  }
+  state.SetItemsProcessed(state.iterations() * scores.numel());
+}
+
+// Arguments are {batch, n, k}
+void BM_Topk(benchmark::State& state) {
+  const at::Tensor scores = random_scores(state.range(0), state.range(1));
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(scores.topk(state.range(2)));
+  }
+  state.SetItemsProcessed(state.iterations() * scores.numel());
+}
+
+void BM_Kthvalue(benchmark::State& state) {
+  const at::Tensor scores = random_scores(state.range(0), state.range(1));
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(scores.kthvalue(state.range(2)));
+  }
+  state.SetItemsProcessed(state.iterations() * scores.numel());
+}
+
+void SortArgs(benchmark::internal::Benchmark* b) {
+  for (int64_t batch : {1, 64, 1024}) {
+    for (int64_t n : {1000, 50000}) {
+      b->Args({batch, n});
+    }
+  }
+  b->Args({1, 1 << 24});
+  b->Unit(benchmark::kMicrosecond);
+}
+
+void SelectArgs(benchmark::internal::Benchmark* b) {
+  for (int64_t batch : {1, 64, 1024}) {
+    for (int64_t k : {1, 10, 100, 5000}) {
+      b->Args({batch, 50000, k});
+    }
+  }
+  b->Unit(benchmark::kMicrosecond);
+}
+
+} // namespace
+
+BENCHMARK(BM_Sort)->Apply(SortArgs);
+BENCHMARK(BM_SortStrided)->Apply(SortArgs);
+BENCHMARK(BM_Topk)->Apply(SelectArgs);
+BENCHMARK(BM_Kthvalue)->Apply(SelectArgs);
+
+BENCHMARK_MAIN();
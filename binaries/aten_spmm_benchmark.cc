@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmarks sparse-dense matrix multiplication on CPU. Uniform matrices
+// spread the nonzeros evenly over the rows. Power-law matrices put most of
+// them in a few rows, as the adjacency matrices of real graphs do.
+
+#include <cmath>
+#include <random>
+
+#include "benchmark/benchmark.h"
+
+#include "ATen/ATen.h"
+
+namespace {
+
+enum Distribution { kUniform = 0, kPowerLaw = 1 };
+
+// A coalesced rows x rows matrix with about nnz nonzeros
+at::Tensor random_sparse(int64_t rows, int64_t nnz, int64_t distribution) {
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<double> dist(0, 1);
+  at::Tensor indices = at::empty({2, nnz}, at::CPU(at::kLong));
+  int64_t* data = indices.data<int64_t>();
+  for (int64_t i = 0; i < nnz; ++i) {
+    const double x = dist(gen);
+    data[i] = static_cast<int64_t>(
+        (distribution == kPowerLaw ? std::pow(x, 8) : x) * rows);
+    data[nnz + i] = static_cast<int64_t>(dist(gen) * rows);
+  }
+  at::Tensor values = at::ones({nnz}, at::CPU(at::kFloat));
+  return at::_sparse_coo_tensor_unsafe(indices, values, {rows, rows}).coalesce();
+}
+
+// Arguments are {rows, nonzeros, dense columns, distribution}
+void BM_SpMM(benchmark::State& state) {
+  const at::Tensor sparse =
+      random_sparse(state.range(0), state.range(1), state.range(3));
+  const at::Tensor dense =
+      at::randn({state.range(0), state.range(2)}, at::CPU(at::kFloat));
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(at::mm(sparse, dense));
+  }
+  state.SetItemsProcessed(
+      state.iterations() * sparse._nnz() * state.range(2));
+}
+
+// The row pointers have to be computed for every matrix
+void BM_CrowIndices(benchmark::State& state) {
+  const at::Tensor sparse =
+      random_sparse(state.range(0), state.range(1), state.range(3));
+  while (state.KeepRunning()) {
+    at::Tensor copy = sparse.clone();
+    benchmark::DoNotOptimize(copy._crow_indices());
+  }
+  state.SetItemsProcessed(state.iterations() * sparse._nnz());
+}
+
+void SpMMArgs(benchmark::internal::Benchmark* b) {
+  for (int64_t rows : {1 << 12, 1 << 16}) {
+    for (int64_t nnz : {rows * 4, rows * 32}) {
+      for (int64_t cols : {1, 16, 128}) {
+        b->Args({rows, nnz, cols, kUniform});
+        b->Args({rows, nnz, cols, kPowerLaw});
+      }
+    }
+  }
+  b->Unit(benchmark::kMicrosecond);
+}
+
+} // namespace
+
+BENCHMARK(BM_SpMM)->Apply(SpMMArgs);
+BENCHMARK(BM_CrowIndices)->Apply(SpMMArgs);
+
+BENCHMARK_MAIN();
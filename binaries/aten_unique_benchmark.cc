@@ -0,0 +1,134 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Compares at::_unique on CPU with the hash set based implementation it
+// replaced, which is kept here as the baseline. Inputs are int64 ids drawn
+// from a range of roughly n / 8 distinct values.
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "ATen/ATen.h"
+
+namespace {
+
+at::Tensor random_ids(int64_t n) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int64_t> dist(0, std::max<int64_t>(n / 8, 1));
+  at::Tensor ids = at::empty({n}, at::CPU(at::kLong));
+  int64_t* data = ids.data<int64_t>();
+  for (int64_t i = 0; i < n; ++i) {
+    data[i] = dist(gen);
+  }
+  return ids;
+}
+
+std::tuple<at::Tensor, at::Tensor> hash_unique(
+    const at::Tensor& self,
+    bool sorted,
+    bool return_inverse) {
+  const at::Tensor input = self.contiguous();
+  const int64_t* input_data = input.data<int64_t>();
+  std::unordered_set<int64_t> set(input_data, input_data + input.numel());
+  at::Tensor output =
+      at::empty({static_cast<int64_t>(set.size())}, input.type());
+  int64_t* output_data = output.data<int64_t>();
+
+  if (sorted) {
+    std::vector<int64_t> vec(set.begin(), set.end());
+    std::sort(vec.begin(), vec.end());
+    std::copy(vec.begin(), vec.end(), output_data);
+  } else {
+    std::copy(set.begin(), set.end(), output_data);
+  }
+
+  at::Tensor inverse_indices = at::empty({0}, input.type());
+  if (return_inverse) {
+    inverse_indices.resize_(input.sizes());
+    int64_t* inverse_indices_data = inverse_indices.data<int64_t>();
+    std::unordered_map<int64_t, int64_t> inverse_map;
+    inverse_map.reserve(output.numel());
+    for (int64_t i = 0; i < output.numel(); ++i) {
+      inverse_map[output_data[i]] = i;
+    }
+    for (int64_t i = 0; i < input.numel(); ++i) {
+      inverse_indices_data[i] = inverse_map[input_data[i]];
+    }
+  }
+  return std::make_tuple(output, inverse_indices);
+}
+
+// Arguments are {numel, return_inverse}
+void BM_HashUnique(benchmark::State& state) {
+  const at::Tensor ids = random_ids(state.range(0));
+  const bool return_inverse = state.range(1);
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(hash_unique(ids, true, return_inverse));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_RadixUnique(benchmark::State& state) {
+  const at::Tensor ids = random_ids(state.range(0));
+  const bool return_inverse = state.range(1);
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(at::_unique(ids, true, return_inverse, false));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_RadixUniqueCounts(benchmark::State& state) {
+  const at::Tensor ids = random_ids(state.range(0));
+  const bool return_inverse = state.range(1);
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(at::_unique(ids, true, return_inverse, true));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Unique rows of a (numel / 4, 4) tensor
+void BM_RadixUniqueDim(benchmark::State& state) {
+  const at::Tensor rows = random_ids(state.range(0)).remainder(4).view({-1, 4});
+  const bool return_inverse = state.range(1);
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(
+        at::_unique_dim(rows, 0, true, return_inverse, false));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void UniqueArgs(benchmark::internal::Benchmark* b) {
+  for (int64_t n : {1 << 10, 1 << 16, 1 << 20, 1 << 24}) {
+    b->Args({n, 0});
+    b->Args({n, 1});
+  }
+  b->Unit(benchmark::kMicrosecond);
+}
+
+} // namespace
+
+BENCHMARK(BM_HashUnique)->Apply(UniqueArgs);
+BENCHMARK(BM_RadixUnique)->Apply(UniqueArgs);
+BENCHMARK(BM_RadixUniqueCounts)->Apply(UniqueArgs);
+BENCHMARK(BM_RadixUniqueDim)->Apply(UniqueArgs);
+
+BENCHMARK_MAIN();
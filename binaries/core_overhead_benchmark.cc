@@ -14,11 +14,18 @@
  * limitations under the License.
  */
 
+#include <atomic>
+#include <thread>
+
 #include "benchmark/benchmark.h"
 
 #include "caffe2/core/context.h"
 #include "caffe2/core/context_gpu.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/net_async_base.h"
 #include "caffe2/core/operator.h"
+#include "caffe2/core/work_stealing_thread_pool.h"
+#include "caffe2/utils/thread_pool.h"
 
 #define CAFFE2_SKIP_IF_NO_GPU                                      \
   if (!caffe2::NumCudaDevices()) {                                 \
@@ -220,4 +227,74 @@ static void BM_TensorAllocDeallocCUDA(benchmark::State& state) {
 }
 BENCHMARK(BM_TensorAllocDeallocCUDA);
 
+// Scheduling cost per task: a root task schedules state.range(1) empty
+// tasks from inside the pool, the way async nets schedule child chains.
+template <class Pool>
+static void BM_ThreadPoolFanOut(benchmark::State& state) {
+  Pool pool(state.range(0));
+  const int num_tasks = state.range(1);
+  std::atomic<int> remaining(0);
+  while (state.KeepRunning()) {
+    remaining = num_tasks;
+    pool.run([&pool, &remaining, num_tasks]() {
+      for (int i = 0; i < num_tasks; ++i) {
+        pool.run([&remaining]() { remaining--; });
+      }
+    });
+    while (remaining.load() > 0) {
+      std::this_thread::yield();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_tasks);
+}
+BENCHMARK_TEMPLATE(BM_ThreadPoolFanOut, TaskThreadPool)
+    ->Args({4, 1000})
+    ->Args({16, 1000})
+    ->Args({40, 1000});
+BENCHMARK_TEMPLATE(BM_ThreadPoolFanOut, WorkStealingThreadPool)
+    ->Args({4, 1000})
+    ->Args({16, 1000})
+    ->Args({40, 1000});
+
+// Per op overhead of an async_scheduling net with state.range(1) empty ops
+// that all depend on a single root op, run by state.range(0) workers.
+static void runAsyncSchedulingNet(benchmark::State& state, bool work_stealing) {
+  const int num_ops = state.range(1);
+  NetDef net_def;
+  net_def.set_type("async_scheduling");
+  net_def.set_num_workers(state.range(0));
+  auto* root = net_def.add_op();
+  root->set_type("DummyEmpty");
+  root->add_output("root");
+  for (int i = 0; i < num_ops; ++i) {
+    auto* op = net_def.add_op();
+    op->set_type("DummyEmpty");
+    op->add_input("root");
+    op->add_output("out_" + caffe2::to_string(i));
+  }
+
+  Workspace ws;
+  auto use_work_stealing_pool = FLAGS_caffe2_net_async_use_work_stealing_pool;
+  FLAGS_caffe2_net_async_use_work_stealing_pool = work_stealing;
+  std::unique_ptr<NetBase> net(CreateNet(net_def, &ws));
+  FLAGS_caffe2_net_async_use_work_stealing_pool = use_work_stealing_pool;
+  CAFFE_ENFORCE(net);
+  while (state.KeepRunning()) {
+    CAFFE_ENFORCE(net->Run());
+  }
+  state.SetItemsProcessed(state.iterations() * (num_ops + 1));
+}
+
+static void BM_AsyncSchedulingNetCPU(benchmark::State& state) {
+  runAsyncSchedulingNet(state, false);
+}
+BENCHMARK(BM_AsyncSchedulingNetCPU)->Args({4, 1000})->Args({40, 1000});
+
+static void BM_AsyncSchedulingNetWorkStealingCPU(benchmark::State& state) {
+  runAsyncSchedulingNet(state, true);
+}
+BENCHMARK(BM_AsyncSchedulingNetWorkStealingCPU)
+    ->Args({4, 1000})
+    ->Args({40, 1000});
+
 BENCHMARK_MAIN();
@@ -30,6 +30,12 @@ CAFFE2_DEFINE_int(repeat, 10, "The number to repeat the throughput test.");
 CAFFE2_DEFINE_bool(use_reader, false, "If true, use the reader interface.");
 CAFFE2_DEFINE_int(num_read_threads, 1,
                    "The number of concurrent reading threads.");
+CAFFE2_DEFINE_int(max_prefetch_threads, 0,
+                  "If positive, use the reader interface and report the "
+                  "throughput for 0, 1, 2, 4, ... up to this many prefetching "
+                  "threads.");
+CAFFE2_DEFINE_int(batch_size, 64,
+                  "The number of records read at once with ReadBatch.");
 
 using caffe2::db::Cursor;
 using caffe2::db::DB;
@@ -87,9 +93,52 @@ void TestThroughputWithReader() {
   }
 }
 
+void TestThroughputWithPrefetchingWorker(
+    const DBReader* reader, int num_batches) {
+  std::vector<string> keys, values;
+  for (int i = 0; i < num_batches; ++i) {
+    reader->ReadBatch(caffe2::FLAGS_batch_size, &keys, &values);
+  }
+}
+
+void TestThroughputWithPrefetching() {
+  const int num_batches = caffe2::FLAGS_repeat *
+      caffe2::FLAGS_report_interval / caffe2::FLAGS_batch_size;
+  std::vector<int> thread_counts = {0};
+  for (int n = 1; n <= caffe2::FLAGS_max_prefetch_threads; n *= 2) {
+    thread_counts.push_back(n);
+  }
+  for (int num_prefetch_threads : thread_counts) {
+    caffe2::db::DBReader reader(
+        caffe2::FLAGS_input_db_type, caffe2::FLAGS_input_db);
+    if (num_prefetch_threads > 0) {
+      reader.StartPrefetching(num_prefetch_threads, caffe2::FLAGS_batch_size);
+    }
+    caffe2::Timer timer;
+    std::vector<std::unique_ptr<std::thread>> reading_threads(
+        caffe2::FLAGS_num_read_threads);
+    for (int i = 0; i < reading_threads.size(); ++i) {
+      reading_threads[i].reset(new std::thread(
+          TestThroughputWithPrefetchingWorker, &reader, num_batches));
+    }
+    for (int i = 0; i < reading_threads.size(); ++i) {
+      reading_threads[i]->join();
+    }
+    double elapsed_seconds = timer.Seconds();
+    const double num_records = (double)reading_threads.size() * num_batches *
+        caffe2::FLAGS_batch_size;
+    printf("Prefetch threads %02d, took %4.5f seconds, "
+           "throughput %f items/sec.\n",
+           num_prefetch_threads, elapsed_seconds,
+           num_records / elapsed_seconds);
+  }
+}
+
 int main(int argc, char** argv) {
   caffe2::GlobalInit(&argc, &argv);
-  if (caffe2::FLAGS_use_reader) {
+  if (caffe2::FLAGS_max_prefetch_threads > 0) {
+    TestThroughputWithPrefetching();
+  } else if (caffe2::FLAGS_use_reader) {
     TestThroughputWithReader();
   } else {
     TestThroughputWithDB();
@@ -0,0 +1,244 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Compares the base, AVX2 and AVX512 embedding lookup kernels behind
+// SparseLengthsSum and its fused rowwise quantized variants. The kernels
+// are called directly, bypassing the runtime dispatch, on a table that is
+// much larger than the last level cache.
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "caffe2/core/common.h"
+#include "caffe2/core/macros.h"
+#include "caffe2/core/types.h"
+#include "caffe2/utils/cpuid.h"
+
+namespace caffe2 {
+
+#define DECLARE_EMBEDDING_LOOKUP(name, InType) \
+  void name(                                   \
+      const TIndex block_size,                 \
+      const TIndex output_size,                \
+      const TIndex index_size,                 \
+      const TIndex data_size,                  \
+      const InType* input,                     \
+      const int64_t* indices,                  \
+      const int* lengths,                      \
+      const float* weights,                    \
+      const float* scale_bias,                 \
+      bool normalize_by_lengths,               \
+      float* out);
+
+#define DECLARE_FUSED_EMBEDDING_LOOKUP(name) \
+  void name(                                 \
+      const TIndex block_size,               \
+      const TIndex output_size,              \
+      const TIndex index_size,               \
+      const TIndex data_size,                \
+      const uint8_t* input,                  \
+      const int64_t* indices,                \
+      const int* lengths,                    \
+      const float* weights,                  \
+      bool normalize_by_lengths,             \
+      float* out);
+
+#define DECLARE_KERNELS(suffix)                                            \
+  DECLARE_EMBEDDING_LOOKUP(                                                \
+      EmbeddingLookup_int64_t_float_float_false##suffix, float)            \
+  DECLARE_EMBEDDING_LOOKUP(                                                \
+      EmbeddingLookup_int64_t_float16_float_false##suffix, float16)        \
+  DECLARE_FUSED_EMBEDDING_LOOKUP(                                          \
+      Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float_false##suffix) \
+  DECLARE_FUSED_EMBEDDING_LOOKUP(                                          \
+      Fused4BitRowwiseEmbeddingLookup_int64_t_uint8_t_float_false##suffix)
+
+DECLARE_KERNELS(__base)
+#ifdef CAFFE2_PERF_WITH_AVX2
+DECLARE_KERNELS(__avx2_fma)
+#endif
+#ifdef CAFFE2_PERF_WITH_AVX512
+DECLARE_KERNELS(__avx512)
+#endif
+
+#undef DECLARE_KERNELS
+#undef DECLARE_FUSED_EMBEDDING_LOOKUP
+#undef DECLARE_EMBEDDING_LOOKUP
+
+} // namespace caffe2
+
+using namespace caffe2;
+
+namespace {
+
+// Size of the embedding table, whatever the format
+constexpr TIndex kTableBytes = 256 << 20;
+constexpr TIndex kNumSegments = 256;
+constexpr int kSegmentLength = 64;
+
+enum class Format { Float, Float16, Fused8Bit, Fused4Bit };
+
+TIndex rowBytes(Format format, TIndex block_size) {
+  switch (format) {
+    case Format::Float:
+      return block_size * sizeof(float);
+    case Format::Float16:
+      return block_size * sizeof(float16);
+    case Format::Fused8Bit:
+      return block_size + 8;
+    case Format::Fused4Bit:
+      return (block_size + 1) / 2 + 8;
+  }
+  return 0;
+}
+
+struct Problem {
+  Problem(Format format, TIndex block_size)
+      : num_rows(kTableBytes / rowBytes(format, block_size)),
+        data(num_rows * rowBytes(format, block_size)),
+        indices(kNumSegments * kSegmentLength),
+        lengths(kNumSegments, kSegmentLength),
+        out(kNumSegments * block_size) {
+    std::mt19937 gen(1701);
+    std::uniform_int_distribution<int64_t> row(0, num_rows - 1);
+    for (auto& index : indices) {
+      index = row(gen);
+    }
+  }
+
+  const TIndex num_rows;
+  // All zeros, which is a valid row in every format
+  std::vector<uint8_t> data;
+  std::vector<int64_t> indices;
+  std::vector<int> lengths;
+  std::vector<float> out;
+};
+
+template <typename Kernel>
+void runFused(benchmark::State& state, Kernel kernel, Format format) {
+  const TIndex block_size = state.range(0);
+  Problem p(format, block_size);
+  while (state.KeepRunning()) {
+    kernel(
+        block_size,
+        kNumSegments,
+        p.indices.size(),
+        p.num_rows,
+        p.data.data(),
+        p.indices.data(),
+        p.lengths.data(),
+        nullptr,
+        false,
+        p.out.data());
+    benchmark::DoNotOptimize(p.out.data());
+  }
+  state.SetBytesProcessed(
+      state.iterations() * p.indices.size() * rowBytes(format, block_size));
+}
+
+template <typename InType, typename Kernel>
+void run(benchmark::State& state, Kernel kernel, Format format) {
+  const TIndex block_size = state.range(0);
+  Problem p(format, block_size);
+  while (state.KeepRunning()) {
+    kernel(
+        block_size,
+        kNumSegments,
+        p.indices.size(),
+        p.num_rows,
+        reinterpret_cast<const InType*>(p.data.data()),
+        p.indices.data(),
+        p.lengths.data(),
+        nullptr,
+        nullptr,
+        false,
+        p.out.data());
+    benchmark::DoNotOptimize(p.out.data());
+  }
+  state.SetBytesProcessed(
+      state.iterations() * p.indices.size() * rowBytes(format, block_size));
+}
+
+void registerKernels(
+    const std::string& isa,
+    decltype(EmbeddingLookup_int64_t_float_float_false__base)* float_kernel,
+    decltype(EmbeddingLookup_int64_t_float16_float_false__base)* half_kernel,
+    decltype(
+        Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float_false__base)*
+        fused_8bit_kernel,
+    decltype(
+        Fused4BitRowwiseEmbeddingLookup_int64_t_uint8_t_float_false__base)*
+        fused_4bit_kernel) {
+  auto block_sizes = [](benchmark::internal::Benchmark* b) {
+    for (int block_size : {16, 32, 64, 128, 100}) {
+      b->Arg(block_size);
+    }
+  };
+  benchmark::RegisterBenchmark(
+      ("EmbeddingLookup_float/" + isa).c_str(),
+      [=](benchmark::State& state) {
+        run<float>(state, float_kernel, Format::Float);
+      })
+      ->Apply(block_sizes);
+  benchmark::RegisterBenchmark(
+      ("EmbeddingLookup_float16/" + isa).c_str(),
+      [=](benchmark::State& state) {
+        run<float16>(state, half_kernel, Format::Float16);
+      })
+      ->Apply(block_sizes);
+  benchmark::RegisterBenchmark(
+      ("EmbeddingLookup_fused_8bit/" + isa).c_str(),
+      [=](benchmark::State& state) {
+        runFused(state, fused_8bit_kernel, Format::Fused8Bit);
+      })
+      ->Apply(block_sizes);
+  benchmark::RegisterBenchmark(
+      ("EmbeddingLookup_fused_4bit/" + isa).c_str(),
+      [=](benchmark::State& state) {
+        runFused(state, fused_4bit_kernel, Format::Fused4Bit);
+      })
+      ->Apply(block_sizes);
+}
+
+#define REGISTER_KERNELS(isa, suffix)                                      \
+  registerKernels(                                                         \
+      isa,                                                                 \
+      EmbeddingLookup_int64_t_float_float_false##suffix,                   \
+      EmbeddingLookup_int64_t_float16_float_false##suffix,                 \
+      Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float_false##suffix, \
+      Fused4BitRowwiseEmbeddingLookup_int64_t_uint8_t_float_false##suffix)
+
+} // namespace
+
+int main(int argc, char** argv) {
+  REGISTER_KERNELS("base", __base);
+#ifdef CAFFE2_PERF_WITH_AVX2
+  if (GetCpuId().avx2() && GetCpuId().fma()) {
+    REGISTER_KERNELS("avx2", __avx2_fma);
+  }
+#endif
+#ifdef CAFFE2_PERF_WITH_AVX512
+  if (GetCpuId().avx512f()) {
+    REGISTER_KERNELS("avx512", __avx512);
+  }
+#endif
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
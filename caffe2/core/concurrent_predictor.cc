@@ -0,0 +1,312 @@
+#include "caffe2/core/concurrent_predictor.h"
+
+#include <future>
+
+#include "caffe2/core/logging.h"
+
+namespace caffe2 {
+
+struct ConcurrentPredictor::Child {
+  explicit Child(const Workspace* shared) : ws(shared) {}
+
+  Workspace ws;
+  NetBase* net = nullptr;
+};
+
+struct ConcurrentPredictor::Request {
+  const TensorVector* inputs;
+  std::vector<TensorCPU>* outputs;
+  int64_t rows;
+  std::chrono::steady_clock::time_point deadline;
+  std::promise<bool> result;
+};
+
+namespace {
+
+// Whether the inputs of two requests can be concatenated
+bool canBatch(
+    const ConcurrentPredictor::TensorVector& a,
+    const ConcurrentPredictor::TensorVector& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i]->meta() != b[i]->meta() || a[i]->ndim() != b[i]->ndim()) {
+      return false;
+    }
+    for (int d = 1; d < a[i]->ndim(); ++d) {
+      if (a[i]->dim(d) != b[i]->dim(d)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+ConcurrentPredictor::ConcurrentPredictor(
+    const NetDef& init_net,
+    const NetDef& run_net,
+    const Options& options,
+    Workspace* parent)
+    : run_net_(run_net), options_(options), ws_(parent) {
+  CAFFE_ENFORCE_GT(options_.num_workspaces, 0);
+  CAFFE_ENFORCE(ws_.RunNetOnce(init_net));
+
+  for (const auto& name : run_net_.external_input()) {
+    if (!ws_.HasBlob(name)) {
+      feedable_inputs_.insert(name);
+    }
+  }
+
+  for (int i = 0; i < options_.num_workspaces; ++i) {
+    auto child = caffe2::make_unique<Child>(&ws_);
+    // Everything run_net writes has to be private to the child, starting
+    // from the value init_net gave it, if any
+    for (const auto& op : run_net_.op()) {
+      for (const auto& name : op.output()) {
+        auto* blob = child->ws.CreateLocalBlob(name);
+        if (ws_.HasBlob(name)) {
+          const auto* shared = ws_.GetBlob(name);
+          CAFFE_ENFORCE(
+              shared->IsType<TensorCPU>(),
+              "Blob ",
+              name,
+              " is created by init_net and written by run_net, "
+              "only CPU tensors can be copied into each workspace");
+          blob->GetMutable<TensorCPU>()->CopyFrom(shared->Get<TensorCPU>());
+        }
+      }
+    }
+    for (const auto& name : feedable_inputs_) {
+      child->ws.CreateLocalBlob(name)->GetMutable<TensorCPU>();
+    }
+    child->net = child->ws.CreateNet(run_net_);
+    CAFFE_ENFORCE(child->net, "Failed to create net ", run_net_.name());
+    free_.push_back(child.get());
+    children_.push_back(std::move(child));
+  }
+
+  if (options_.max_batch_size > 0) {
+    for (auto& child : children_) {
+      batch_threads_.emplace_back(
+          &ConcurrentPredictor::batchLoop, this, child.get());
+    }
+  }
+}
+
+ConcurrentPredictor::~ConcurrentPredictor() {
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    stop_ = true;
+  }
+  queue_cv_.notify_all();
+  for (auto& thread : batch_threads_) {
+    thread.join();
+  }
+}
+
+ConcurrentPredictor::Child* ConcurrentPredictor::acquire() {
+  std::unique_lock<std::mutex> lock(free_mutex_);
+  free_cv_.wait(lock, [this] { return !free_.empty(); });
+  auto* child = free_.back();
+  free_.pop_back();
+  return child;
+}
+
+void ConcurrentPredictor::release(Child* child) {
+  {
+    std::lock_guard<std::mutex> lock(free_mutex_);
+    free_.push_back(child);
+  }
+  free_cv_.notify_one();
+}
+
+bool ConcurrentPredictor::runOnChild(
+    Child* child,
+    const TensorVector& inputs,
+    std::vector<TensorCPU>* outputs) {
+  CAFFE_ENFORCE(inputs.size() <= (unsigned)run_net_.external_input_size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const auto& name = run_net_.external_input(i);
+    CAFFE_ENFORCE(
+        feedable_inputs_.count(name),
+        "Input ",
+        name,
+        " is created by init_net and shared by all workspaces");
+    auto* tensor = child->ws.GetBlob(name)->GetMutable<TensorCPU>();
+    tensor->ResizeLike(*inputs[i]);
+    tensor->ShareData(*inputs[i]);
+  }
+
+  if (!child->net->Run()) {
+    return false;
+  }
+
+  outputs->clear();
+  outputs->reserve(run_net_.external_output_size());
+  for (const auto& name : run_net_.external_output()) {
+    const auto* blob = child->ws.GetBlob(name);
+    CAFFE_ENFORCE(blob, "Blob: ", name, " does not exist");
+    outputs->push_back(blob->Get<TensorCPU>().Clone());
+  }
+  return true;
+}
+
+bool ConcurrentPredictor::run(
+    const TensorVector& inputs,
+    std::vector<TensorCPU>* outputs) {
+  if (options_.max_batch_size <= 0) {
+    auto* child = acquire();
+    bool result;
+    try {
+      result = runOnChild(child, inputs, outputs);
+    } catch (...) {
+      release(child);
+      throw;
+    }
+    release(child);
+    return result;
+  }
+
+  CAFFE_ENFORCE(!inputs.empty(), "Batched requests need at least one input");
+  Request request;
+  request.inputs = &inputs;
+  request.outputs = outputs;
+  for (const auto* input : inputs) {
+    CAFFE_ENFORCE_GT(input->ndim(), 0, "Batched inputs can't be scalars");
+  }
+  request.rows = inputs[0]->dim(0);
+  for (const auto* input : inputs) {
+    CAFFE_ENFORCE_EQ(
+        input->dim(0),
+        request.rows,
+        "All inputs of a batched request need the same first dimension");
+  }
+  request.deadline =
+      std::chrono::steady_clock::now() + options_.max_batch_latency;
+  auto result = request.result.get_future();
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    queue_.push_back(&request);
+    queued_rows_ += request.rows;
+  }
+  queue_cv_.notify_all();
+  return result.get();
+}
+
+void ConcurrentPredictor::batchLoop(Child* child) {
+  while (true) {
+    std::vector<Request*> batch;
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex_);
+      queue_cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      queue_cv_.wait_until(lock, queue_.front()->deadline, [this] {
+        return stop_ || queue_.empty() ||
+            queued_rows_ >= options_.max_batch_size;
+      });
+      // Requests are batched in arrival order, a request that doesn't fit
+      // starts the next batch
+      int64_t rows = 0;
+      while (!queue_.empty()) {
+        auto* request = queue_.front();
+        if (!batch.empty() &&
+            (rows + request->rows > options_.max_batch_size ||
+             !canBatch(*batch.front()->inputs, *request->inputs))) {
+          break;
+        }
+        rows += request->rows;
+        queued_rows_ -= request->rows;
+        batch.push_back(request);
+        queue_.pop_front();
+      }
+    }
+    if (!batch.empty()) {
+      runBatch(child, batch);
+    }
+  }
+}
+
+void ConcurrentPredictor::runBatch(
+    Child* child,
+    const std::vector<Request*>& batch) {
+  if (batch.size() == 1) {
+    try {
+      batch[0]->result.set_value(
+          runOnChild(child, *batch[0]->inputs, batch[0]->outputs));
+    } catch (...) {
+      batch[0]->result.set_exception(std::current_exception());
+    }
+    return;
+  }
+
+  std::vector<std::vector<TensorCPU>> split(batch.size());
+  bool success;
+  try {
+    CPUContext context;
+    int64_t total_rows = 0;
+    for (const auto* request : batch) {
+      total_rows += request->rows;
+    }
+
+    const auto& first = *batch.front()->inputs;
+    std::vector<TensorCPU> concatenated(first.size());
+    TensorVector inputs;
+    for (size_t i = 0; i < first.size(); ++i) {
+      auto dims = first[i]->dims();
+      dims[0] = total_rows;
+      concatenated[i].Resize(dims);
+      auto* dst = static_cast<char*>(
+          concatenated[i].raw_mutable_data(first[i]->meta()));
+      for (const auto* request : batch) {
+        const auto& src = *(*request->inputs)[i];
+        context.CopyItems<CPUContext, CPUContext>(
+            src.meta(), src.size(), src.raw_data(), dst);
+        dst += src.nbytes();
+      }
+      inputs.push_back(&concatenated[i]);
+    }
+
+    std::vector<TensorCPU> outputs;
+    success = runOnChild(child, inputs, &outputs);
+    if (success) {
+      for (size_t o = 0; o < outputs.size(); ++o) {
+        const auto& output = outputs[o];
+        CAFFE_ENFORCE(
+            output.ndim() > 0 && output.dim(0) == total_rows,
+            "Output ",
+            run_net_.external_output(o),
+            " of a batched run doesn't have one row per input row");
+        const auto* src = static_cast<const char*>(output.raw_data());
+        for (size_t r = 0; r < batch.size(); ++r) {
+          auto dims = output.dims();
+          dims[0] = batch[r]->rows;
+          TensorCPU part(dims);
+          auto* dst = part.raw_mutable_data(output.meta());
+          context.CopyItems<CPUContext, CPUContext>(
+              output.meta(), part.size(), src, dst);
+          src += part.size() * output.itemsize();
+          split[r].push_back(std::move(part));
+        }
+      }
+    }
+  } catch (...) {
+    for (auto* request : batch) {
+      request->result.set_exception(std::current_exception());
+    }
+    return;
+  }
+
+  for (size_t r = 0; r < batch.size(); ++r) {
+    if (success) {
+      *batch[r]->outputs = std::move(split[r]);
+    }
+    batch[r]->result.set_value(success);
+  }
+}
+
+} // namespace caffe2
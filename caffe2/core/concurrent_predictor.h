@@ -0,0 +1,106 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "caffe2/core/net.h"
+#include "caffe2/core/tensor.h"
+#include "caffe2/core/workspace.h"
+
+namespace caffe2 {
+
+// Predictor that can serve run() calls from many threads at once.
+//
+// `init_net` runs once, into a workspace that holds the parameters. Each of
+// `num_workspaces` child workspaces sees those parameters without copying
+// them, and has its own instance of `run_net` and its own copy of every blob
+// that `run_net` writes. A call to run() borrows a free child workspace,
+// blocking until one is available.
+//
+// With dynamic batching enabled (max_batch_size > 0), run() queues the
+// request instead. Every child workspace is served by a thread that waits
+// until the queued requests add up to max_batch_size rows, or until the
+// oldest of them has waited for max_batch_latency. It then concatenates the
+// inputs of the requests along the first dimension, runs them as a single
+// batch, and splits every output along the first dimension. Every input of
+// a request must have the same first dimension, and every output of
+// `run_net` must have one row per input row.
+class ConcurrentPredictor {
+ public:
+  using TensorVector = std::vector<TensorCPU*>;
+
+  struct Options {
+    int num_workspaces = 1;
+    int64_t max_batch_size = 0;
+    std::chrono::microseconds max_batch_latency{1000};
+  };
+
+  ConcurrentPredictor(
+      const NetDef& init_net,
+      const NetDef& run_net,
+      const Options& options,
+      Workspace* parent = nullptr);
+
+  ~ConcurrentPredictor();
+
+  // Thread safe. Like Predictor::run, the first `inputs.size()` external
+  // inputs of `run_net` are shared with `inputs`; these may not be blobs
+  // created by `init_net`. `outputs` receives a copy of every external
+  // output, so it stays valid while other requests run.
+  bool run(const TensorVector& inputs, std::vector<TensorCPU>* outputs);
+
+  const NetDef& def() const {
+    return run_net_;
+  }
+
+  // Holds the blobs created by `init_net`
+  Workspace* ws() {
+    return &ws_;
+  }
+
+  size_t num_workspaces() const {
+    return children_.size();
+  }
+
+ private:
+  struct Child;
+  struct Request;
+
+  Child* acquire();
+  void release(Child* child);
+
+  bool runOnChild(
+      Child* child,
+      const TensorVector& inputs,
+      std::vector<TensorCPU>* outputs);
+
+  void batchLoop(Child* child);
+  void runBatch(Child* child, const std::vector<Request*>& batch);
+
+  NetDef run_net_;
+  Options options_;
+  Workspace ws_;
+  // External inputs of run_net_ that are private to each child
+  std::unordered_set<std::string> feedable_inputs_;
+
+  std::vector<std::unique_ptr<Child>> children_;
+  std::mutex free_mutex_;
+  std::condition_variable free_cv_;
+  std::vector<Child*> free_;
+
+  std::mutex queue_mutex_;
+  std::condition_variable queue_cv_;
+  std::deque<Request*> queue_;
+  int64_t queued_rows_ = 0;
+  bool stop_ = false;
+  std::vector<std::thread> batch_threads_;
+
+  DISABLE_COPY_AND_ASSIGN(ConcurrentPredictor);
+};
+} // namespace caffe2
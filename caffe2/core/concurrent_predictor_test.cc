@@ -0,0 +1,146 @@
+#include "caffe2/core/concurrent_predictor.h"
+#include "caffe2/core/context.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/core/tensor.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace caffe2 {
+
+namespace {
+
+const char* predictSpec = R"DOC(
+        name: "predict"
+        type: "simple"
+        external_input: "data"
+        external_input: "W"
+        external_input: "b"
+        external_output: "y"
+        op {
+          input: "data"
+          input: "W"
+          input: "b"
+          output: "y"
+          type: "FC"
+        }
+)DOC";
+
+const char* initSpec = R"DOC(
+        name: "init"
+        type: "simple"
+        op {
+          type: "ConstantFill"
+          output: "W"
+          arg {
+            name: "shape"
+            ints: 10
+            ints: 4
+          }
+          arg {
+            name: "value"
+            f: 2.0
+          }
+        }
+        op {
+          type: "ConstantFill"
+          output: "b"
+          arg {
+            name: "shape"
+            ints: 10
+          }
+          arg {
+            name: "value"
+            f: 2.0
+          }
+        }
+)DOC";
+
+NetDef parseNetDef(const std::string& value) {
+  NetDef def;
+  CAFFE_ENFORCE(
+      TextFormat::ParseFromString(value, &def),
+      "Failed to parse NetDef with value: ",
+      value);
+  return def;
+}
+
+// Runs `num_requests` requests of `rows` rows from each of `num_threads`
+// threads. With W and b filled with 2, every output is 2 * sum(row) + 2.
+void runConcurrently(
+    ConcurrentPredictor* p,
+    int num_threads,
+    int num_requests,
+    int rows) {
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([=]() {
+      for (int r = 0; r < num_requests; ++r) {
+        TensorCPU data(std::vector<TIndex>{rows, 4});
+        auto* d = data.mutable_data<float>();
+        for (int i = 0; i < data.size(); ++i) {
+          d[i] = t + r + i;
+        }
+        ConcurrentPredictor::TensorVector input{&data};
+        std::vector<TensorCPU> output;
+        ASSERT_TRUE(p->run(input, &output));
+        ASSERT_EQ(output.size(), 1);
+        ASSERT_EQ(output[0].ndim(), 2);
+        ASSERT_EQ(output[0].dim(0), rows);
+        ASSERT_EQ(output[0].dim(1), 10);
+        for (int row = 0; row < rows; ++row) {
+          float sum = 0;
+          for (int i = 0; i < 4; ++i) {
+            sum += d[row * 4 + i];
+          }
+          for (int i = 0; i < 10; ++i) {
+            EXPECT_FLOAT_EQ(
+                output[0].data<float>()[row * 10 + i], 2 * sum + 2);
+          }
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+} // namespace
+
+TEST(ConcurrentPredictorTest, ConcurrentRuns) {
+  ConcurrentPredictor::Options options;
+  options.num_workspaces = 2;
+  ConcurrentPredictor p(
+      parseNetDef(initSpec), parseNetDef(predictSpec), options);
+  EXPECT_EQ(p.num_workspaces(), 2);
+  // Parameters live in the shared workspace only
+  EXPECT_TRUE(p.ws()->HasBlob("W"));
+  EXPECT_FALSE(p.ws()->HasBlob("y"));
+  runConcurrently(&p, 4, 50, 3);
+}
+
+TEST(ConcurrentPredictorTest, DynamicBatching) {
+  ConcurrentPredictor::Options options;
+  options.num_workspaces = 2;
+  options.max_batch_size = 8;
+  options.max_batch_latency = std::chrono::microseconds(500);
+  ConcurrentPredictor p(
+      parseNetDef(initSpec), parseNetDef(predictSpec), options);
+  runConcurrently(&p, 8, 50, 1);
+  runConcurrently(&p, 4, 20, 3);
+}
+
+TEST(ConcurrentPredictorTest, InitNetInputsCannotBeFed) {
+  ConcurrentPredictor::Options options;
+  ConcurrentPredictor p(
+      parseNetDef(initSpec), parseNetDef(predictSpec), options);
+  TensorCPU data(std::vector<TIndex>{1, 4});
+  data.mutable_data<float>();
+  ConcurrentPredictor::TensorVector input{&data, &data};
+  std::vector<TensorCPU> output;
+  EXPECT_THROW(p.run(input, &output), EnforceNotMet);
+}
+
+} // namespace caffe2
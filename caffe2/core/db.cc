@@ -169,6 +169,177 @@ class MiniDB : public DB {
 REGISTER_CAFFE2_DB(MiniDB, MiniDB);
 REGISTER_CAFFE2_DB(minidb, MiniDB);
 
+DBPrefetcher::DBPrefetcher(
+    DB* db,
+    Cursor* cursor,
+    uint32_t num_shards,
+    uint32_t shard_id,
+    int num_threads,
+    int batch_size,
+    int max_batches)
+    : num_shards_(num_shards),
+      shard_id_(shard_id),
+      num_threads_(num_threads),
+      batch_size_(batch_size),
+      ring_(max_batches) {
+  CAFFE_ENFORCE(
+      num_threads == 1 || cursor->SupportsSeek(),
+      "Prefetching on more than one thread needs a db that supports seeking.");
+  start_key_ = cursor->key();
+  // The other threads start from the same record as the first one
+  for (int i = 1; i < num_threads; ++i) {
+    own_cursors_.push_back(db->NewCursor());
+    own_cursors_.back()->Seek(start_key_);
+  }
+  threads_.emplace_back(&DBPrefetcher::Work, this, 0, cursor);
+  for (int i = 1; i < num_threads; ++i) {
+    threads_.emplace_back(
+        &DBPrefetcher::Work, this, i, own_cursors_[i - 1].get());
+  }
+}
+
+DBPrefetcher::~DBPrefetcher() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void DBPrefetcher::Work(int thread_id, Cursor* cursor) {
+  auto skip = [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) {
+      DBReader::NextInShard(cursor, num_shards_, shard_id_);
+    }
+  };
+  try {
+    // Thread i reads batches i, i + num_threads, ...
+    skip((uint64_t)thread_id * batch_size_);
+    for (uint64_t b = thread_id;; b += num_threads_) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] {
+          return stop_ || b < num_consumed_batches_ + ring_.size();
+        });
+        if (stop_) {
+          return;
+        }
+      }
+      unique_ptr<Batch> batch(new Batch());
+      batch->keys.resize(batch_size_);
+      batch->values.resize(batch_size_);
+      for (int i = 0; i < batch_size_; ++i) {
+        batch->keys[i] = cursor->key();
+        batch->values[i] = cursor->value();
+        DBReader::NextInShard(cursor, num_shards_, shard_id_);
+      }
+      batch->next_key = cursor->key();
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ring_[b % ring_.size()] = std::move(batch);
+      }
+      cv_.notify_all();
+      skip((uint64_t)(num_threads_ - 1) * batch_size_);
+    }
+  } catch (...) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      error_ = std::current_exception();
+    }
+    cv_.notify_all();
+  }
+}
+
+void DBPrefetcher::NextBatch() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto& slot = ring_[num_consumed_batches_ % ring_.size()];
+  cv_.wait(lock, [&] { return slot || error_; });
+  if (!slot) {
+    std::rethrow_exception(error_);
+  }
+  current_ = std::move(slot);
+  current_pos_ = 0;
+  ++num_consumed_batches_;
+  lock.unlock();
+  cv_.notify_all();
+}
+
+void DBPrefetcher::Read(string* key, string* value) {
+  if (!current_ || current_pos_ == current_->keys.size()) {
+    NextBatch();
+  }
+  *key = std::move(current_->keys[current_pos_]);
+  *value = std::move(current_->values[current_pos_]);
+  ++current_pos_;
+  ++num_read_;
+}
+
+string DBPrefetcher::NextKey() {
+  if (!current_) {
+    return start_key_;
+  }
+  if (current_pos_ < current_->keys.size()) {
+    return current_->keys[current_pos_];
+  }
+  return current_->next_key;
+}
+
+void DBReader::StartPrefetchingLocked(
+    int num_threads,
+    int batch_size,
+    int max_batches) const {
+  CAFFE_ENFORCE_GT(num_threads, 0);
+  CAFFE_ENFORCE_GT(batch_size, 0);
+  // Without seeking, the other threads' cursors can't start from the record
+  // of ours. Such dbs (e.g. minidb) may also not allow a second cursor.
+  if (num_threads > 1 && !cursor_->SupportsSeek()) {
+    LOG(WARNING) << "Db " << source_ << " does not support seeking, "
+                 << "prefetching on one thread instead of " << num_threads;
+    num_threads = 1;
+  }
+  if (max_batches <= 0) {
+    max_batches = 2 * num_threads;
+  }
+  CAFFE_ENFORCE_GE(
+      max_batches, num_threads, "Need room for one batch per thread.");
+  prefetch_threads_ = num_threads;
+  prefetch_batch_size_ = batch_size;
+  prefetch_max_batches_ = max_batches;
+  prefetcher_.reset(new DBPrefetcher(
+      db_.get(),
+      cursor_.get(),
+      num_shards_,
+      shard_id_,
+      num_threads,
+      batch_size,
+      max_batches));
+}
+
+void DBReader::StopPrefetchingLocked() const {
+  if (!prefetcher_) {
+    return;
+  }
+  const string next_key = prefetcher_->NextKey();
+  const uint64_t num_read = prefetcher_->NumRead();
+  prefetcher_.reset();
+  // The first thread moved our cursor past the records it read ahead
+  if (cursor_->SupportsSeek()) {
+    cursor_->Seek(next_key);
+  } else {
+    const uint64_t position = position_ + num_read;
+    MoveToBeginning();
+    for (uint64_t p = 0; p < position; ++p) {
+      ++position_;
+      if (NextInShard(cursor_.get(), num_shards_, shard_id_)) {
+        position_ = 0;
+      }
+    }
+  }
+}
+
 void DBReaderSerializer::Serialize(
     const Blob& blob,
     const string& name,
@@ -180,7 +351,10 @@ void DBReaderSerializer::Serialize(
   proto.set_source(reader.source_);
   proto.set_db_type(reader.db_type_);
   if (reader.cursor() && reader.cursor()->SupportsSeek()) {
-    proto.set_key(reader.cursor()->key());
+    std::unique_lock<std::mutex> mutex_lock(reader.reader_mutex_);
+    proto.set_key(
+        reader.prefetcher_ ? reader.prefetcher_->NextKey()
+                           : reader.cursor()->key());
   }
   BlobProto blob_proto;
   blob_proto.set_name(name);
@@ -1,7 +1,10 @@
 #ifndef CAFFE2_CORE_DB_H_
 #define CAFFE2_CORE_DB_H_
 
+#include <condition_variable>
+#include <exception>
 #include <mutex>
+#include <thread>
 
 #include "caffe2/core/blob_serialization.h"
 #include "caffe2/core/registry.h"
@@ -138,6 +141,82 @@ inline bool DBExists(const string& db_type, const string& full_db_name) {
   }
 }
 
+/**
+ * Reads batches of records ahead of a DBReader on background threads. See
+ * DBReader::StartPrefetching() for the details.
+ */
+class DBPrefetcher {
+ public:
+  /**
+   * Starts prefetching the records of a shard, in the order in which
+   * `cursor` would visit them. The first thread reads from `cursor`, the
+   * others from new cursors of `db` seeked to the current key of `cursor`,
+   * so more than one thread needs a cursor that supports seeking.
+   */
+  DBPrefetcher(
+      DB* db,
+      Cursor* cursor,
+      uint32_t num_shards,
+      uint32_t shard_id,
+      int num_threads,
+      int batch_size,
+      int max_batches);
+  ~DBPrefetcher();
+
+  /**
+   * Moves the next record into key and value, waiting for it to be read if
+   * needed. Not thread safe, calls are serialized by the DBReader.
+   */
+  void Read(string* key, string* value);
+
+  /**
+   * Key of the next record that Read() returns.
+   */
+  string NextKey();
+
+  /**
+   * Number of records returned by Read().
+   */
+  uint64_t NumRead() const {
+    return num_read_;
+  }
+
+ private:
+  struct Batch {
+    vector<string> keys;
+    vector<string> values;
+    // Key of the record after the batch
+    string next_key;
+  };
+
+  void Work(int thread_id, Cursor* cursor);
+  // Waits for the next batch and makes it current_
+  void NextBatch();
+
+  const uint32_t num_shards_;
+  const uint32_t shard_id_;
+  const int num_threads_;
+  const int batch_size_;
+  vector<unique_ptr<Cursor>> own_cursors_;
+  vector<std::thread> threads_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // Batch b is stored in ring_[b % ring_.size()] until it is consumed
+  vector<unique_ptr<Batch>> ring_;
+  uint64_t num_consumed_batches_{0};
+  std::exception_ptr error_;
+  bool stop_{false};
+
+  // Only used by the consumer
+  unique_ptr<Batch> current_;
+  size_t current_pos_{0};
+  string start_key_;
+  uint64_t num_read_{0};
+
+  DISABLE_COPY_AND_ASSIGN(DBPrefetcher);
+};
+
 /**
  * A reader wrapper for DB that also allows us to serialize it.
  */
@@ -145,6 +224,7 @@ class DBReader {
  public:
 
   friend class DBReaderSerializer;
+  friend class DBPrefetcher;
   DBReader() {}
 
   DBReader(
@@ -182,6 +262,7 @@ class DBReader {
       const int32_t shard_id = 0) {
     // Note(jiayq): resetting is needed when we re-open e.g. leveldb where no
     // concurrent access is allowed.
+    prefetcher_.reset();
     cursor_.reset();
     db_.reset();
     db_type_ = db_type;
@@ -195,6 +276,7 @@ class DBReader {
       unique_ptr<DB>&& db,
       const int32_t num_shards = 1,
       const int32_t shard_id = 0) {
+    prefetcher_.reset();
     cursor_.reset();
     db_.reset();
     db_ = std::move(db);
@@ -222,16 +304,21 @@ class DBReader {
   void Read(string* key, string* value) const {
     CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
     std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
-    *key = cursor_->key();
-    *value = cursor_->value();
+    ReadLocked(key, value);
+  }
 
-    // In sharded mode, each read skips num_shards_ records
-    for (uint32_t s = 0; s < num_shards_; s++) {
-      cursor_->Next();
-      if (!cursor_->Valid()) {
-        MoveToBeginning();
-        break;
-      }
+  /**
+   * Reads the next n records into keys and values, as n calls to Read()
+   * would. Thread safe, and the n records are consecutive even when other
+   * threads read from the same reader: the lock is only taken once.
+   */
+  void ReadBatch(int n, vector<string>* keys, vector<string>* values) const {
+    CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
+    keys->resize(n);
+    values->resize(n);
+    std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
+    for (int i = 0; i < n; ++i) {
+      ReadLocked(&(*keys)[i], &(*values)[i]);
     }
   }
 
@@ -241,7 +328,49 @@ class DBReader {
   void SeekToFirst() const {
     CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
     std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
-    MoveToBeginning();
+    if (prefetcher_) {
+      // Restart the threads from the beginning
+      const int num_threads = prefetch_threads_;
+      const int batch_size = prefetch_batch_size_;
+      const int max_batches = prefetch_max_batches_;
+      StopPrefetchingLocked();
+      MoveToBeginning();
+      StartPrefetchingLocked(num_threads, batch_size, max_batches);
+    } else {
+      MoveToBeginning();
+    }
+  }
+
+  /**
+   * Starts reading records ahead of Read() and ReadBatch() on num_threads
+   * background threads, so that reads don't wait for the db. The threads
+   * read batches of batch_size consecutive records in turn, and at most
+   * max_batches batches (2 * num_threads by default) are kept in a ring
+   * buffer. Read() returns the same records in the same order as without
+   * prefetching.
+   *
+   * The first thread reads from the cursor of the reader, so one thread
+   * works with every db. More threads open more cursors on the db and seek
+   * them to the next record, so they need a db with concurrent, seekable
+   * cursors (as LMDB and LevelDB have). Each of them skips over the batches
+   * read by the others. On other dbs, such as minidb, a single thread is
+   * used.
+   */
+  void StartPrefetching(int num_threads, int batch_size, int max_batches = 0)
+      const {
+    CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
+    std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
+    StopPrefetchingLocked();
+    StartPrefetchingLocked(num_threads, batch_size, max_batches);
+  }
+
+  /**
+   * Stops the prefetching threads. The records they read ahead are dropped
+   * and the cursor is moved back to the next unread record.
+   */
+  void StopPrefetching() const {
+    std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
+    StopPrefetchingLocked();
   }
 
   /**
@@ -268,13 +397,51 @@ class DBReader {
     SeekToFirst();
   }
 
+  void ReadLocked(string* key, string* value) const {
+    if (prefetcher_) {
+      prefetcher_->Read(key, value);
+      return;
+    }
+    *key = cursor_->key();
+    *value = cursor_->value();
+    ++position_;
+    if (NextInShard(cursor_.get(), num_shards_, shard_id_)) {
+      position_ = 0;
+    }
+  }
+
   void MoveToBeginning() const {
-    cursor_->SeekToFirst();
-    for (uint32_t s = 0; s < shard_id_; s++) {
-      cursor_->Next();
+    SeekToShardStart(cursor_.get(), shard_id_);
+    position_ = 0;
+  }
+
+  void StartPrefetchingLocked(
+      int num_threads,
+      int batch_size,
+      int max_batches) const;
+  void StopPrefetchingLocked() const;
+
+  static void SeekToShardStart(Cursor* cursor, uint32_t shard_id) {
+    cursor->SeekToFirst();
+    for (uint32_t s = 0; s < shard_id; s++) {
+      cursor->Next();
       CAFFE_ENFORCE(
-          cursor_->Valid(), "Db has less rows than shard id: ", s, shard_id_);
+          cursor->Valid(), "Db has less rows than shard id: ", s, shard_id);
+    }
+  }
+
+  // Moves to the next record of the shard: in sharded mode, each read skips
+  // num_shards records. Returns true when going back to the head of the db.
+  static bool
+  NextInShard(Cursor* cursor, uint32_t num_shards, uint32_t shard_id) {
+    for (uint32_t s = 0; s < num_shards; s++) {
+      cursor->Next();
+      if (!cursor->Valid()) {
+        SeekToShardStart(cursor, shard_id);
+        return true;
+      }
     }
+    return false;
   }
 
   string db_type_;
@@ -284,6 +451,14 @@ class DBReader {
   mutable std::mutex reader_mutex_;
   uint32_t num_shards_;
   uint32_t shard_id_;
+  // Records read since the cursor was at the start of the shard
+  mutable uint64_t position_{0};
+  // Declared after cursor_, which its first thread reads from, so that it is
+  // destroyed first
+  mutable unique_ptr<DBPrefetcher> prefetcher_;
+  mutable int prefetch_threads_{0};
+  mutable int prefetch_batch_size_{0};
+  mutable int prefetch_max_batches_{0};
 
   DISABLE_COPY_AND_ASSIGN(DBReader);
 };
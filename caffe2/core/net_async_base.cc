@@ -3,6 +3,7 @@
 #include "caffe2/core/net_async_tracing.h"
 #include "caffe2/core/operator.h"
 #include "caffe2/core/timer.h"
+#include "caffe2/core/work_stealing_thread_pool.h"
 
 // experimental support for multiple streams per worker per GPU
 CAFFE2_DEFINE_int(
@@ -53,6 +54,11 @@ CAFFE2_DEFINE_bool(
     false,
     "Use per net thread pools");
 
+CAFFE2_DEFINE_bool(
+    caffe2_net_async_use_work_stealing_pool,
+    false,
+    "Use a work stealing thread pool for CPU tasks");
+
 namespace caffe2 {
 
 thread_local std::vector<int> AsyncNetBase::stream_counters_;
@@ -116,7 +122,7 @@ bool AsyncNetBase::RunAsync() {
   return DoRunAsync();
 }
 
-TaskThreadPool* AsyncNetBase::pool_getter(
+TaskThreadPoolBase* AsyncNetBase::pool_getter(
     PoolsMap& pools,
     int device_type,
     int device_id,
@@ -124,14 +130,18 @@ TaskThreadPool* AsyncNetBase::pool_getter(
   std::unique_lock<std::mutex> pools_lock(pools_mutex_);
   auto pool = pools[device_id][pool_size];
   if (!pool) {
+    auto pool_type = DeviceTypeName(device_type);
+    if (device_type == CPU && use_work_stealing_pool_) {
+      pool_type = "WorkStealingCPU";
+    }
     pool = ThreadPoolRegistry()->Create(
-        DeviceTypeName(device_type), device_id, pool_size, use_per_net_pools_);
+        pool_type, device_id, pool_size, use_per_net_pools_);
     pools[device_id][pool_size] = pool;
   }
   return pool.get();
 }
 
-TaskThreadPool* AsyncNetBase::pool(const DeviceOption& device_option) {
+TaskThreadPoolBase* AsyncNetBase::pool(const DeviceOption& device_option) {
   if (use_single_pool_) {
     return pool_getter(cpu_pools_, CPU, -1, num_workers_);
   }
@@ -402,20 +412,25 @@ AsyncNetBase::~AsyncNetBase() {}
 
 CAFFE_DEFINE_SHARED_REGISTRY(
     ThreadPoolRegistry,
-    TaskThreadPool,
+    TaskThreadPoolBase,
     int,
     int,
     bool);
 
 CAFFE_REGISTER_CREATOR(ThreadPoolRegistry, CPU, GetAsyncNetCPUThreadPool);
+CAFFE_REGISTER_CREATOR(
+    ThreadPoolRegistry,
+    WorkStealingCPU,
+    GetAsyncNetWorkStealingCPUThreadPool);
 
-/* static */
-std::shared_ptr<TaskThreadPool>
-GetAsyncNetCPUThreadPool(int numa_node_id, int pool_size, bool create_new) {
+namespace {
+template <typename Pool>
+std::shared_ptr<TaskThreadPoolBase>
+getCPUThreadPool(int numa_node_id, int pool_size, bool create_new) {
   // Note: numa_node_id = -1 (DeviceOption's default value) corresponds to
   // no NUMA used
   static std::
-      unordered_map<int, std::unordered_map<int, std::weak_ptr<TaskThreadPool>>>
+      unordered_map<int, std::unordered_map<int, std::weak_ptr<Pool>>>
           pools;
   static std::mutex pool_mutex;
 
@@ -439,7 +454,7 @@ GetAsyncNetCPUThreadPool(int numa_node_id, int pool_size, bool create_new) {
   if (create_new) {
     LOG(INFO) << "Created new CPU pool, size: " << pool_size
               << "; NUMA node id: " << numa_node_id;
-    return std::make_shared<TaskThreadPool>(pool_size, numa_node_id);
+    return std::make_shared<Pool>(pool_size, numa_node_id);
   } else {
     std::lock_guard<std::mutex> lock(pool_mutex);
 
@@ -447,12 +462,28 @@ GetAsyncNetCPUThreadPool(int numa_node_id, int pool_size, bool create_new) {
     if (!shared_pool) {
       LOG(INFO) << "Created shared CPU pool, size: " << pool_size
                 << "; NUMA node id: " << numa_node_id;
-      shared_pool = std::make_shared<TaskThreadPool>(pool_size, numa_node_id);
+      shared_pool = std::make_shared<Pool>(pool_size, numa_node_id);
       pools[numa_node_id][pool_size] = shared_pool;
     }
     return shared_pool;
   }
 }
+} // namespace
+
+/* static */
+std::shared_ptr<TaskThreadPoolBase>
+GetAsyncNetCPUThreadPool(int numa_node_id, int pool_size, bool create_new) {
+  return getCPUThreadPool<TaskThreadPool>(numa_node_id, pool_size, create_new);
+}
+
+/* static */
+std::shared_ptr<TaskThreadPoolBase> GetAsyncNetWorkStealingCPUThreadPool(
+    int numa_node_id,
+    int pool_size,
+    bool create_new) {
+  return getCPUThreadPool<WorkStealingThreadPool>(
+      numa_node_id, pool_size, create_new);
+}
 
 void AsyncNetBase::computeExecutionModeFlags() {
   static const std::string kDag = "dag";
@@ -473,6 +504,7 @@ void AsyncNetBase::computeExecutionModeFlags() {
     check_stream_status_ = false;
     use_single_pool_ = true;
     use_per_net_pools_ = true;
+    use_work_stealing_pool_ = false;
     is_blocking_ = true;
   } else if (net_type == kAsyncDag) {
     streams_per_gpu_ = 1;
@@ -481,6 +513,7 @@ void AsyncNetBase::computeExecutionModeFlags() {
     check_stream_status_ = false;
     use_single_pool_ = true;
     use_per_net_pools_ = true;
+    use_work_stealing_pool_ = false;
     is_blocking_ = true;
   } else {
     streams_per_gpu_ = FLAGS_caffe2_streams_per_gpu;
@@ -489,6 +522,7 @@ void AsyncNetBase::computeExecutionModeFlags() {
     check_stream_status_ = FLAGS_caffe2_net_async_check_stream_status;
     use_single_pool_ = FLAGS_caffe2_net_async_use_single_pool;
     use_per_net_pools_ = FLAGS_caffe2_net_async_use_per_net_pools;
+    use_work_stealing_pool_ = FLAGS_caffe2_net_async_use_work_stealing_pool;
     is_blocking_ = false;
   }
 }
@@ -22,6 +22,7 @@ CAFFE2_DECLARE_int(caffe2_net_async_cpu_pool_size);
 CAFFE2_DECLARE_bool(caffe2_net_async_check_stream_status);
 CAFFE2_DECLARE_bool(caffe2_net_async_use_single_pool);
 CAFFE2_DECLARE_bool(caffe2_net_async_use_per_net_pools);
+CAFFE2_DECLARE_bool(caffe2_net_async_use_work_stealing_pool);
 
 namespace caffe2 {
 
@@ -73,7 +74,7 @@ class AsyncNetBase : public NetBase {
       const std::vector<int>& wait_task_ids) const;
   bool run(int task_id, int stream_id);
   int stream(int task_id);
-  TaskThreadPool* pool(const DeviceOption& device_option);
+  TaskThreadPoolBase* pool(const DeviceOption& device_option);
 
   void finishTasks(const std::unordered_set<int>& task_ids);
   void finalizeEvents();
@@ -96,7 +97,7 @@ class AsyncNetBase : public NetBase {
   // first int key - device id, second - pool size, one pool per (device, size)
   typedef std::unordered_map<
       int,
-      std::unordered_map<int, std::shared_ptr<TaskThreadPool>>>
+      std::unordered_map<int, std::shared_ptr<TaskThreadPoolBase>>>
       PoolsMap;
   PoolsMap cpu_pools_;
   PoolsMap gpu_pools_;
@@ -123,6 +124,7 @@ class AsyncNetBase : public NetBase {
   bool check_stream_status_;
   bool use_single_pool_;
   bool use_per_net_pools_;
+  bool use_work_stealing_pool_;
   bool is_blocking_;
 
   DISABLE_COPY_AND_ASSIGN(AsyncNetBase);
@@ -130,7 +132,7 @@ class AsyncNetBase : public NetBase {
  private:
   void storeExceptionPtr();
 
-  TaskThreadPool*
+  TaskThreadPoolBase*
   pool_getter(PoolsMap& pools, int device_type, int device_id, int pool_size);
 
   std::unique_ptr<AsyncNetExecutorHelper> helper_;
@@ -141,7 +143,7 @@ class AsyncNetBase : public NetBase {
 
 CAFFE_DECLARE_SHARED_REGISTRY(
     ThreadPoolRegistry,
-    TaskThreadPool,
+    TaskThreadPoolBase,
     int,
     int,
     bool);
@@ -149,7 +151,7 @@ CAFFE_DECLARE_SHARED_REGISTRY(
 class AsyncNetExecutorHelper : public ExecutorHelper {
  public:
   explicit AsyncNetExecutorHelper(AsyncNetBase* net) : net_(net) {}
-  TaskThreadPool* GetPool(const DeviceOption& option) const override {
+  TaskThreadPoolBase* GetPool(const DeviceOption& option) const override {
     return net_->pool(option);
   }
 
@@ -157,9 +159,16 @@ class AsyncNetExecutorHelper : public ExecutorHelper {
   AsyncNetBase* net_;
 };
 
-std::shared_ptr<TaskThreadPool>
+std::shared_ptr<TaskThreadPoolBase>
 GetAsyncNetCPUThreadPool(int numa_node_id, int pool_size, bool create_new);
 
+// Same as GetAsyncNetCPUThreadPool, but returns a WorkStealingThreadPool;
+// registered in ThreadPoolRegistry under "WorkStealingCPU"
+std::shared_ptr<TaskThreadPoolBase> GetAsyncNetWorkStealingCPUThreadPool(
+    int numa_node_id,
+    int pool_size,
+    bool create_new);
+
 } // namespace caffe2
 
 #endif // CAFFE2_CORE_NET_ASYNC_BASE_H_
@@ -1,5 +1,7 @@
 #include "caffe2/core/stats.h"
 
+#include <algorithm>
+#include <cmath>
 #include <condition_variable>
 #include <thread>
 
@@ -50,4 +52,44 @@ StatRegistry& StatRegistry::get() {
   static StatRegistry r;
   return r;
 }
+
+double HistogramExportedStat::quantile(
+    const ExportedStatMap& stats,
+    const std::string& key,
+    double q) {
+  CAFFE_ENFORCE(q >= 0 && q <= 1, "Quantile out of range: ", q);
+  const std::string prefix = key + "/bucket/";
+  // (bucket index, count) of the buckets in ascending order
+  std::vector<std::pair<int, int64_t>> buckets;
+  int64_t total = 0;
+  for (const auto& kv : stats) {
+    if (kv.second <= 0 || kv.first.compare(0, prefix.size(), prefix) != 0) {
+      continue;
+    }
+    const int64_t lower = std::stoll(kv.first.substr(prefix.size()));
+    buckets.emplace_back(bucketIndex(lower), kv.second);
+    total += kv.second;
+  }
+  if (total == 0) {
+    return 0;
+  }
+  std::sort(buckets.begin(), buckets.end());
+  const int64_t rank = std::max(
+      static_cast<int64_t>(std::ceil(q * static_cast<double>(total))),
+      static_cast<int64_t>(1));
+  int64_t seen = 0;
+  for (const auto& bucket : buckets) {
+    seen += bucket.second;
+    if (seen >= rank) {
+      const int index = bucket.first;
+      const int64_t lower = bucketLowerBound(index);
+      if (index == kNumBuckets - 1) {
+        return static_cast<double>(lower);
+      }
+      const int64_t upper = bucketLowerBound(index + 1);
+      return lower + static_cast<double>(upper - 1 - lower) / 2;
+    }
+  }
+  return static_cast<double>(bucketLowerBound(buckets.back().first));
+}
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <memory>
 #include <mutex>
@@ -9,6 +10,10 @@
 #include "caffe2/core/logging.h"
 #include "caffe2/core/static_tracepoint.h"
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 namespace caffe2 {
 
 class StatValue {
@@ -260,6 +265,110 @@ class DetailedExportedStat : public ExportedStat {
 
 namespace detail {
 
+// Index of the highest set bit of value, which must not be 0
+inline int floorLog2(uint64_t value) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanReverse64(&index, value);
+  return static_cast<int>(index);
+#else
+  return 63 - __builtin_clzll(value);
+#endif
+}
+
+} // namespace detail
+
+/**
+ * @brief Log-linear (HDR-style) histogram of the values passed to increment.
+ *
+ * Values below kSubBuckets get a bucket each. Above that, every power of two
+ * is split into kSubBuckets buckets of equal width, so that a bucket is at
+ * most 1/kSubBuckets as wide as its lower bound. Values from 2^kMaxBits on
+ * count in the last bucket, negative ones in the first.
+ *
+ * Besides the sum (<group>/<name>/sum) and count (<group>/<name>/count) of
+ * the values, the count of every bucket that has been used is exported as
+ * <group>/<name>/bucket/<lower bound>. Recording a value takes three atomic
+ * increments and no lock, except for the first value in a bucket, which
+ * registers the bucket's counter.
+ */
+class HistogramExportedStat : public ExportedStat {
+ public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  static constexpr int kMaxBits = 48;
+  static constexpr int kNumBuckets = (kMaxBits - kSubBucketBits + 1) * kSubBuckets;
+
+  HistogramExportedStat(const std::string& gn, const std::string& n)
+      : ExportedStat(gn, n + "/sum"),
+        count_(gn, n + "/count"),
+        bucketPrefix_(gn + "/" + n + "/bucket/") {
+    for (auto& bucket : buckets_) {
+      bucket.store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  int64_t increment(int64_t value = 1) {
+    bucket(bucketIndex(value))->increment(1);
+    count_.increment();
+    return ExportedStat::increment(value);
+  }
+
+  template <typename T, typename Unused1, typename... Unused>
+  int64_t increment(T value, Unused1, Unused...) {
+    return increment(value);
+  }
+
+  static int bucketIndex(int64_t value) {
+    if (value < kSubBuckets) {
+      return value < 0 ? 0 : static_cast<int>(value);
+    }
+    const int log2 = detail::floorLog2(static_cast<uint64_t>(value));
+    if (log2 >= kMaxBits) {
+      return kNumBuckets - 1;
+    }
+    const int shift = log2 - kSubBucketBits;
+    return (shift + 1) * kSubBuckets +
+        static_cast<int>((value >> shift) & (kSubBuckets - 1));
+  }
+
+  static int64_t bucketLowerBound(int index) {
+    if (index < kSubBuckets) {
+      return index;
+    }
+    const int shift = index / kSubBuckets - 1;
+    return static_cast<int64_t>(kSubBuckets + index % kSubBuckets) << shift;
+  }
+
+  /**
+   * Estimates the q-th quantile (0 <= q <= 1) of the values recorded by the
+   * histogram exported as `key` (i.e. <group>/<name>) in `stats`, as the
+   * middle of the bucket that holds it. Returns 0 if it recorded no values.
+   */
+  static double quantile(
+      const ExportedStatMap& stats,
+      const std::string& key,
+      double q);
+
+ private:
+  StatValue* bucket(int index) {
+    StatValue* value = buckets_[index].load(std::memory_order_acquire);
+    if (!value) {
+      // Racing threads get the same counter from the registry
+      value = StatRegistry::get().add(
+          bucketPrefix_ + caffe2::to_string(bucketLowerBound(index)));
+      buckets_[index].store(value, std::memory_order_release);
+    }
+    return value;
+  }
+
+  ExportedStat count_;
+  const std::string bucketPrefix_;
+  std::array<std::atomic<StatValue*>, kNumBuckets> buckets_;
+};
+
+namespace detail {
+
 template <class T>
 struct _ScopeGuard {
   T f_;
@@ -311,6 +420,11 @@ _ScopeGuard<T> ScopeGuard(T f) {
     groupName, #name                       \
   }
 
+#define CAFFE_HISTOGRAM_EXPORTED_STAT(name) \
+  HistogramExportedStat name {              \
+    groupName, #name                        \
+  }
+
 #define CAFFE_STAT(name) \
   Stat name {            \
     groupName, #name     \
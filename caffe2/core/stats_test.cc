@@ -117,5 +117,47 @@ TEST(StatsTest, StatsTestSimple) {
       toMap(reg2.publish()), ExportedStatMap({{"i1/s3", 0}, {"i2/s3", 0}}));
 }
 
+TEST(StatsTest, StatsTestHistogram) {
+  for (int64_t v : {0, 1, 7, 8, 9, 15, 16, 17, 1000, 123456789}) {
+    const int index = HistogramExportedStat::bucketIndex(v);
+    const int64_t lower = HistogramExportedStat::bucketLowerBound(index);
+    const int64_t upper = HistogramExportedStat::bucketLowerBound(index + 1);
+    EXPECT_LE(lower, v);
+    EXPECT_GT(upper, v);
+    if (v >= HistogramExportedStat::kSubBuckets) {
+      EXPECT_LE((upper - lower) * HistogramExportedStat::kSubBuckets, lower);
+    }
+    EXPECT_EQ(HistogramExportedStat::bucketIndex(lower), index);
+  }
+  EXPECT_EQ(HistogramExportedStat::bucketIndex(-5), 0);
+  EXPECT_EQ(
+      HistogramExportedStat::bucketIndex(int64_t(1) << 62),
+      HistogramExportedStat::kNumBuckets - 1);
+
+  struct TestStats {
+    CAFFE_STAT_CTOR(TestStats);
+    CAFFE_HISTOGRAM_EXPORTED_STAT(latency);
+  };
+  TestStats stats("histogram");
+  for (int i = 1; i <= 100; ++i) {
+    CAFFE_EVENT(stats, latency, i);
+  }
+
+  ExportedStatList data;
+  StatRegistry::get().publish(data);
+  auto map = toMap(data);
+  EXPECT_SUBSET(
+      map,
+      ExportedStatMap({{"histogram/latency/count", 100},
+                       {"histogram/latency/sum", 5050},
+                       {"histogram/latency/bucket/1", 1},
+                       {"histogram/latency/bucket/96", 5}}));
+  // Quantiles are within a bucket width (1/8 of the value) of the exact ones
+  EXPECT_NEAR(HistogramExportedStat::quantile(map, "histogram/latency", 0.5), 50, 7);
+  EXPECT_NEAR(HistogramExportedStat::quantile(map, "histogram/latency", 0.99), 99, 13);
+  EXPECT_EQ(HistogramExportedStat::quantile(map, "histogram/latency", 0), 1);
+  EXPECT_EQ(HistogramExportedStat::quantile(map, "histogram/nothing", 0.5), 0);
+}
+
 } // namespace
 } // namespace caffe2
@@ -0,0 +1,254 @@
+#include "caffe2/core/work_stealing_thread_pool.h"
+
+#include <algorithm>
+
+#include "caffe2/core/logging.h"
+#include "caffe2/core/numa.h"
+#include "caffe2/utils/thread_name.h"
+
+namespace caffe2 {
+
+namespace {
+// Number of attempts an idle worker makes to find a task before sleeping
+constexpr int kSpinCount = 64;
+
+// Pool and index of the worker running on the current thread, if any
+thread_local WorkStealingThreadPool* current_pool = nullptr;
+thread_local size_t current_worker = 0;
+} // namespace
+
+WorkStealingTaskDeque::Buffer::Buffer(int64_t capacity)
+    : capacity(capacity), slots(new std::atomic<Task*>[capacity]) {}
+
+WorkStealingTaskDeque::WorkStealingTaskDeque(int64_t capacity)
+    : top_(0), bottom_(0) {
+  CAFFE_ENFORCE(
+      capacity > 0 && (capacity & (capacity - 1)) == 0,
+      "Deque capacity must be a power of two, got ",
+      capacity);
+  buffer_.store(new Buffer(capacity), std::memory_order_relaxed);
+}
+
+WorkStealingTaskDeque::~WorkStealingTaskDeque() {
+  delete buffer_.load(std::memory_order_relaxed);
+}
+
+WorkStealingTaskDeque::Buffer*
+WorkStealingTaskDeque::grow(Buffer* buffer, int64_t bottom, int64_t top) {
+  auto* grown = new Buffer(buffer->capacity * 2);
+  for (auto i = top; i < bottom; ++i) {
+    grown->put(i, buffer->get(i));
+  }
+  retired_.emplace_back(buffer);
+  buffer_.store(grown, std::memory_order_release);
+  return grown;
+}
+
+void WorkStealingTaskDeque::push(Task* task) {
+  auto bottom = bottom_.load(std::memory_order_relaxed);
+  auto top = top_.load(std::memory_order_acquire);
+  auto* buffer = buffer_.load(std::memory_order_relaxed);
+  if (bottom - top > buffer->capacity - 1) {
+    buffer = grow(buffer, bottom, top);
+  }
+  buffer->put(bottom, task);
+  std::atomic_thread_fence(std::memory_order_release);
+  bottom_.store(bottom + 1, std::memory_order_relaxed);
+}
+
+WorkStealingTaskDeque::Task* WorkStealingTaskDeque::pop() {
+  auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+  auto* buffer = buffer_.load(std::memory_order_relaxed);
+  bottom_.store(bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto top = top_.load(std::memory_order_relaxed);
+
+  if (top > bottom) {
+    // Empty
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  auto* task = buffer->get(bottom);
+  if (top == bottom) {
+    // Last task, race the thieves for it
+    if (!top_.compare_exchange_strong(
+            top,
+            top + 1,
+            std::memory_order_seq_cst,
+            std::memory_order_relaxed)) {
+      task = nullptr;
+    }
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+  }
+  return task;
+}
+
+WorkStealingTaskDeque::Task* WorkStealingTaskDeque::steal() {
+  auto top = top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto bottom = bottom_.load(std::memory_order_acquire);
+  if (top >= bottom) {
+    return nullptr;
+  }
+  auto* task = buffer_.load(std::memory_order_acquire)->get(top);
+  if (!top_.compare_exchange_strong(
+          top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+    return nullptr;
+  }
+  return task;
+}
+
+int64_t WorkStealingTaskDeque::size() const {
+  auto bottom = bottom_.load(std::memory_order_relaxed);
+  auto top = top_.load(std::memory_order_relaxed);
+  return bottom > top ? bottom - top : 0;
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool(
+    size_t pool_size,
+    int numa_node_id)
+    : workers_(pool_size),
+      num_injected_(0),
+      queued_(0),
+      active_(0),
+      sleepers_(0),
+      stop_(false),
+      started_(0) {
+  int num_nodes = 1;
+  if (numa_node_id < 0 && IsNUMAEnabled()) {
+    num_nodes = std::max(GetNumNUMANodes(), 1);
+  }
+  for (size_t i = 0; i < pool_size; ++i) {
+    if (numa_node_id >= 0) {
+      workers_[i].numa_node_id = numa_node_id;
+    } else if (num_nodes > 1) {
+      workers_[i].numa_node_id = i % num_nodes;
+    }
+  }
+  for (size_t i = 0; i < pool_size; ++i) {
+    std::vector<size_t> remote;
+    for (size_t k = 1; k < pool_size; ++k) {
+      auto victim = (i + k) % pool_size;
+      if (workers_[victim].numa_node_id == workers_[i].numa_node_id) {
+        workers_[i].victims.push_back(victim);
+      } else {
+        remote.push_back(victim);
+      }
+    }
+    workers_[i].victims.insert(
+        workers_[i].victims.end(), remote.begin(), remote.end());
+  }
+  for (size_t i = 0; i < pool_size; ++i) {
+    workers_[i].thread =
+        std::thread(&WorkStealingThreadPool::mainLoop, this, i);
+  }
+  // Don't accept tasks before every deque exists
+  std::unique_lock<std::mutex> lock(start_mutex_);
+  started_cv_.wait(lock, [this] { return started_ == workers_.size(); });
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_ = true;
+  }
+  wakeup_.notify_all();
+  for (auto& worker : workers_) {
+    try {
+      worker.thread.join();
+    } catch (const std::exception&) {
+    }
+  }
+  // Drop the tasks that never ran, like TaskThreadPool does
+  for (auto& worker : workers_) {
+    while (auto* task = worker.deque->pop()) {
+      delete task;
+    }
+  }
+  for (auto* task : injected_) {
+    delete task;
+  }
+}
+
+void WorkStealingThreadPool::run(const std::function<void()>& func) {
+  auto* task = new Task(func);
+  if (current_pool == this) {
+    workers_[current_worker].deque->push(task);
+  } else {
+    std::lock_guard<std::mutex> lock(injected_mutex_);
+    injected_.push_back(task);
+    ++num_injected_;
+  }
+  // Pairs with the sleepers_ increment in mainLoop: either the worker
+  // sees the new task, or we see the sleeper and wake it up.
+  ++queued_;
+  if (sleepers_ > 0) {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    wakeup_.notify_one();
+  }
+}
+
+WorkStealingThreadPool::Task* WorkStealingThreadPool::findTask(size_t index) {
+  auto& worker = workers_[index];
+  Task* task = worker.deque->pop();
+  if (!task && num_injected_ > 0) {
+    std::lock_guard<std::mutex> lock(injected_mutex_);
+    if (!injected_.empty()) {
+      task = injected_.front();
+      injected_.pop_front();
+      --num_injected_;
+    }
+  }
+  for (size_t i = 0; !task && i < worker.victims.size(); ++i) {
+    task = workers_[worker.victims[i]].deque->steal();
+  }
+  if (task) {
+    --queued_;
+  }
+  return task;
+}
+
+void WorkStealingThreadPool::mainLoop(size_t index) {
+  setThreadName("CaffeWSThread");
+  auto& worker = workers_[index];
+  NUMABind(worker.numa_node_id);
+  current_pool = this;
+  current_worker = index;
+  worker.deque.reset(new WorkStealingTaskDeque());
+  {
+    std::unique_lock<std::mutex> lock(start_mutex_);
+    if (++started_ == workers_.size()) {
+      started_cv_.notify_all();
+    } else {
+      // Other workers may only be stolen from once their deques exist
+      started_cv_.wait(lock, [this] { return started_ == workers_.size(); });
+    }
+  }
+
+  while (!stop_) {
+    Task* task = nullptr;
+    for (int attempt = 0; !task && attempt < kSpinCount; ++attempt) {
+      task = findTask(index);
+      if (!task) {
+        std::this_thread::yield();
+      }
+    }
+    if (task) {
+      ++active_;
+      try {
+        (*task)();
+      } catch (const std::exception&) {
+      }
+      delete task;
+      --active_;
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    ++sleepers_;
+    wakeup_.wait(lock, [this] { return stop_ || queued_ > 0; });
+    --sleepers_;
+  }
+}
+
+} // namespace caffe2
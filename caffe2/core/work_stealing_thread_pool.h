@@ -0,0 +1,135 @@
+#ifndef CAFFE2_CORE_WORK_STEALING_THREAD_POOL_H_
+#define CAFFE2_CORE_WORK_STEALING_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "caffe2/core/common.h"
+#include "caffe2/utils/thread_pool.h"
+
+namespace caffe2 {
+
+/**
+ * Lock-free single producer, multiple consumer deque of tasks
+ * (Chase and Lev, "Dynamic Circular Work-Stealing Deque").
+ * The owning thread pushes and pops at the bottom, any other thread
+ * may steal from the top. The deque grows as needed; buffers that
+ * are outgrown are kept alive until the deque is destroyed since
+ * thieves may still be reading from them.
+ */
+class WorkStealingTaskDeque {
+ public:
+  using Task = std::function<void()>;
+
+  explicit WorkStealingTaskDeque(int64_t capacity = 256);
+  ~WorkStealingTaskDeque();
+
+  // Owner only
+  void push(Task* task);
+  Task* pop();
+
+  // Any thread; returns nullptr if the deque is empty or if another
+  // thread took the top task first
+  Task* steal();
+
+  int64_t size() const;
+
+ private:
+  struct Buffer {
+    explicit Buffer(int64_t capacity);
+
+    Task* get(int64_t index) const {
+      return slots[index & (capacity - 1)].load(std::memory_order_relaxed);
+    }
+
+    void put(int64_t index, Task* task) {
+      slots[index & (capacity - 1)].store(task, std::memory_order_relaxed);
+    }
+
+    const int64_t capacity;
+    std::unique_ptr<std::atomic<Task*>[]> slots;
+  };
+
+  Buffer* grow(Buffer* buffer, int64_t bottom, int64_t top);
+
+  alignas(64) std::atomic<int64_t> top_;
+  alignas(64) std::atomic<int64_t> bottom_;
+  std::atomic<Buffer*> buffer_;
+  std::vector<std::unique_ptr<Buffer>> retired_;
+
+  DISABLE_COPY_AND_ASSIGN(WorkStealingTaskDeque);
+};
+
+/**
+ * Thread pool with a WorkStealingTaskDeque per worker.
+ * Tasks submitted from one of the pool's workers go to that worker's
+ * deque without taking any lock, tasks submitted from other threads go
+ * to a shared queue. Idle workers first drain their own deque, then the
+ * shared queue, then steal from the other workers.
+ *
+ * If numa_node_id is set, all workers are bound to that node. Otherwise,
+ * when NUMA is enabled the workers are spread over all nodes and steal
+ * from workers on their own node first. Each worker allocates its deque
+ * after binding, so the deque lives on the worker's node.
+ */
+class WorkStealingThreadPool : public TaskThreadPoolBase {
+ public:
+  explicit WorkStealingThreadPool(size_t pool_size, int numa_node_id = -1);
+  ~WorkStealingThreadPool() override;
+
+  void run(const std::function<void()>& func) override;
+
+  size_t size() const override {
+    return workers_.size();
+  }
+
+  size_t num_available() const override {
+    return workers_.size() - active_;
+  }
+
+ private:
+  using Task = WorkStealingTaskDeque::Task;
+
+  struct Worker {
+    int numa_node_id = -1;
+    // Workers to steal from, in order of preference
+    std::vector<size_t> victims;
+    std::unique_ptr<WorkStealingTaskDeque> deque;
+    std::thread thread;
+  };
+
+  void mainLoop(size_t index);
+  Task* findTask(size_t index);
+
+  std::vector<Worker> workers_;
+
+  std::mutex injected_mutex_;
+  std::deque<Task*> injected_;
+  std::atomic<size_t> num_injected_;
+
+  // Number of tasks submitted and not yet taken by a worker
+  std::atomic<int64_t> queued_;
+  std::atomic<size_t> active_;
+
+  std::mutex sleep_mutex_;
+  std::condition_variable wakeup_;
+  std::atomic<size_t> sleepers_;
+  std::atomic<bool> stop_;
+
+  std::mutex start_mutex_;
+  std::condition_variable started_cv_;
+  size_t started_;
+
+  DISABLE_COPY_AND_ASSIGN(WorkStealingThreadPool);
+};
+
+} // namespace caffe2
+
+#endif // CAFFE2_CORE_WORK_STEALING_THREAD_POOL_H_
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "caffe2/core/work_stealing_thread_pool.h"
+
+namespace caffe2 {
+
+namespace {
+
+void waitFor(const std::atomic<int>& counter, int expected) {
+  while (counter.load() != expected) {
+    std::this_thread::yield();
+  }
+}
+
+} // namespace
+
+TEST(WorkStealingTaskDequeTest, PopIsLIFOAndStealIsFIFO) {
+  WorkStealingTaskDeque deque(2);
+  std::vector<WorkStealingTaskDeque::Task> tasks(5);
+  // Push past the initial capacity to exercise growing
+  for (auto& task : tasks) {
+    deque.push(&task);
+  }
+  EXPECT_EQ(deque.size(), 5);
+  EXPECT_EQ(deque.steal(), &tasks[0]);
+  EXPECT_EQ(deque.pop(), &tasks[4]);
+  EXPECT_EQ(deque.steal(), &tasks[1]);
+  EXPECT_EQ(deque.pop(), &tasks[3]);
+  EXPECT_EQ(deque.pop(), &tasks[2]);
+  EXPECT_EQ(deque.pop(), nullptr);
+  EXPECT_EQ(deque.steal(), nullptr);
+  EXPECT_EQ(deque.size(), 0);
+}
+
+TEST(WorkStealingTaskDequeTest, ConcurrentStealsTakeEachTaskOnce) {
+  const int kNumTasks = 100000;
+  const int kNumThieves = 4;
+  WorkStealingTaskDeque deque;
+  std::vector<WorkStealingTaskDeque::Task> tasks(kNumTasks);
+  std::vector<std::atomic<int>> taken(kNumTasks);
+  for (auto& count : taken) {
+    count = 0;
+  }
+  std::atomic<int> num_taken(0);
+  auto take = [&](WorkStealingTaskDeque::Task* task) {
+    taken[task - tasks.data()]++;
+    num_taken++;
+  };
+
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < kNumThieves; ++i) {
+    thieves.emplace_back([&]() {
+      while (num_taken.load() < kNumTasks) {
+        if (auto* task = deque.steal()) {
+          take(task);
+        }
+      }
+    });
+  }
+  for (int i = 0; i < kNumTasks; ++i) {
+    deque.push(&tasks[i]);
+    if (i % 3 == 0) {
+      if (auto* task = deque.pop()) {
+        take(task);
+      }
+    }
+  }
+  while (auto* task = deque.pop()) {
+    take(task);
+  }
+  for (auto& thief : thieves) {
+    thief.join();
+  }
+  for (auto& count : taken) {
+    EXPECT_EQ(count.load(), 1);
+  }
+}
+
+TEST(WorkStealingThreadPoolTest, RunsExternallySubmittedTasks) {
+  const int kNumTasks = 10000;
+  WorkStealingThreadPool pool(4);
+  EXPECT_EQ(pool.size(), 4);
+  std::atomic<int> counter(0);
+  for (int i = 0; i < kNumTasks; ++i) {
+    pool.run([&counter]() { counter++; });
+  }
+  waitFor(counter, kNumTasks);
+}
+
+TEST(WorkStealingThreadPoolTest, RunsTasksSubmittedByWorkers) {
+  const int kFanOut = 100;
+  WorkStealingThreadPool pool(4);
+  std::atomic<int> counter(0);
+  // Every task scheduled from a worker lands on that worker's deque, the
+  // other workers have to steal it
+  for (int root = 0; root < 10; ++root) {
+    pool.run([&pool, &counter, kFanOut]() {
+      for (int i = 0; i < kFanOut; ++i) {
+        pool.run([&counter]() { counter++; });
+      }
+    });
+  }
+  waitFor(counter, 10 * kFanOut);
+}
+
+TEST(WorkStealingThreadPoolTest, SurvivesThrowingTasks) {
+  WorkStealingThreadPool pool(2);
+  std::atomic<int> counter(0);
+  pool.run([]() { throw std::runtime_error("task failed"); });
+  pool.run([&counter]() { counter++; });
+  waitFor(counter, 1);
+}
+
+} // namespace caffe2
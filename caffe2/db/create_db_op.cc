@@ -3,7 +3,17 @@
 namespace caffe2 {
 REGISTER_CPU_OPERATOR(CreateDB, CreateDBOp<CPUContext>);
 
-OPERATOR_SCHEMA(CreateDB).NumInputs(0).NumOutputs(1);
+OPERATOR_SCHEMA(CreateDB)
+    .NumInputs(0)
+    .NumOutputs(1)
+    .Arg(
+        "prefetch_threads",
+        "If positive, the reader reads ahead on this many background threads "
+        "(see DBReader::StartPrefetching).")
+    .Arg(
+        "prefetch_batch_size",
+        "Number of consecutive records read at once by each prefetching "
+        "thread.");
 
 NO_GRADIENT(CreateDB);
 }  // namespace caffe2
@@ -196,5 +196,55 @@ TEST(DBReaderShardedTest, Reader) {
   EXPECT_EQ(value, "05");
 }
 
+static void TestPrefetch(const string& db_type) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill(db_type, name);
+
+  for (int num_threads = 1; num_threads <= 3; ++num_threads) {
+    for (int batch_size : {1, 3, 16}) {
+      std::unique_ptr<DBReader> reader(new DBReader(db_type, name, 2, 1));
+      string key;
+      string value;
+      reader->Read(&key, &value);
+      EXPECT_EQ(key, "01");
+      // Records come in the same order as without prefetching
+      reader->StartPrefetching(num_threads, batch_size);
+      for (int i = 1; i < 12; ++i) {
+        reader->Read(&key, &value);
+        std::stringstream ss;
+        ss << std::setw(2) << std::setfill('0') << (2 * (i % 5) + 1);
+        EXPECT_EQ(key, ss.str());
+        EXPECT_EQ(value, ss.str());
+      }
+      vector<string> keys;
+      vector<string> values;
+      reader->ReadBatch(3, &keys, &values);
+      EXPECT_EQ(keys, vector<string>({"05", "07", "09"}));
+      EXPECT_EQ(values, keys);
+
+      // The cursor continues after the last record read
+      reader->StopPrefetching();
+      reader->Read(&key, &value);
+      EXPECT_EQ(key, "01");
+      reader->StartPrefetching(num_threads, batch_size);
+      reader->SeekToFirst();
+      reader->Read(&key, &value);
+      EXPECT_EQ(key, "01");
+      reader->Read(&key, &value);
+      EXPECT_EQ(key, "03");
+    }
+  }
+}
+
+TEST(DBReaderPrefetchTest, Reader) {
+  TestPrefetch("leveldb");
+}
+
+// minidb can't seek and allows one cursor at a time, so a single thread
+// prefetches whatever the number asked for
+TEST(DBReaderPrefetchTest, MiniDB) {
+  TestPrefetch("minidb");
+}
+
 }  // namespace db
 }  // namespace caffe2
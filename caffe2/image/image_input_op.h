@@ -1113,13 +1113,14 @@ bool ImageInputOp<Context>::Prefetch() {
   prefetched_label_.mutable_data<int>();
   // Prefetching handled with a thread pool of "decode_threads" threads.
 
+  // read data
+  std::vector<std::string> keys, values;
+  reader_->ReadBatch(batch_size_, &keys, &values);
+
   for (int item_id = 0; item_id < batch_size_; ++item_id) {
-    std::string key, value;
+    std::string& value = values[item_id];
     cv::Mat img;
 
-    // read data
-    reader_->Read(&key, &value);
-
     // determine label type based on first item
     if( item_id == 0 ) {
       if( use_caffe_datum_ ) {
@@ -1164,7 +1165,7 @@ bool ImageInputOp<Context>::Prefetch() {
       thread_pool_->runTaskWithID(std::bind(
           &ImageInputOp<Context>::DecodeAndTransposeOnly,
           this,
-          std::string(value),
+          std::move(value),
           image_data,
           item_id,
           channels,
@@ -1175,7 +1176,7 @@ bool ImageInputOp<Context>::Prefetch() {
       thread_pool_->runTaskWithID(std::bind(
           &ImageInputOp<Context>::DecodeAndTransform,
           this,
-          std::string(value),
+          std::move(value),
           image_data,
           item_id,
           channels,
@@ -0,0 +1,48 @@
+#include "latency_observer.h"
+
+namespace caffe2 {
+
+LatencyOperatorObserver::LatencyOperatorObserver(
+    OperatorBase* op,
+    LatencyNetObserver* netObserver)
+    : ObserverBase<OperatorBase>(op),
+      netObserver_(netObserver),
+      typeStats_(typeStatName(op->type())),
+      instanceStats_(instanceStatName(
+          netObserver ? netObserver->subject()->Name() : "",
+          op->net_position(),
+          op->type())) {
+  CAFFE_ENFORCE(netObserver_, "Observers can't operate outside of the net");
+}
+
+std::string LatencyOperatorObserver::typeStatName(const std::string& type) {
+  return "op_latency/" + type;
+}
+
+std::string LatencyOperatorObserver::instanceStatName(
+    const std::string& net,
+    int position,
+    const std::string& type) {
+  return "op_latency/" + net + "/" + caffe2::to_string(position) + "_" + type;
+}
+
+void LatencyOperatorObserver::Start() {
+  start_ = std::chrono::steady_clock::now();
+}
+
+void LatencyOperatorObserver::Stop() {
+  const int64_t latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - start_)
+                              .count();
+  CAFFE_EVENT(typeStats_, latency_ns, latency);
+  CAFFE_EVENT(instanceStats_, latency_ns, latency);
+}
+
+std::unique_ptr<ObserverBase<OperatorBase>> LatencyOperatorObserver::rnnCopy(
+    OperatorBase* subject,
+    int rnn_order) const {
+  return std::unique_ptr<ObserverBase<OperatorBase>>(
+      new LatencyOperatorObserver(subject, netObserver_));
+}
+
+} // namespace caffe2
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+
+#include "caffe2/core/net.h"
+#include "caffe2/core/observer.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/core/stats.h"
+#include "caffe2/observers/operator_attaching_net_observer.h"
+
+namespace caffe2 {
+
+// Records the latency of every run of an operator, in nanoseconds, in two
+// HistogramExportedStats: one shared by all operators of the same type
+// (op_latency/<type>/latency_ns) and one for the operator itself
+// (op_latency/<net>/<position>_<type>/latency_ns). They are exported through
+// StatRegistry::publish, and HistogramExportedStat::quantile gives the
+// percentiles of a published snapshot.
+class LatencyNetObserver;
+class LatencyOperatorObserver final : public ObserverBase<OperatorBase> {
+ public:
+  explicit LatencyOperatorObserver(OperatorBase* op) = delete;
+  LatencyOperatorObserver(OperatorBase* op, LatencyNetObserver* netObserver);
+  ~LatencyOperatorObserver() {}
+  std::unique_ptr<ObserverBase<OperatorBase>> rnnCopy(
+      OperatorBase* subject,
+      int rnn_order) const override;
+
+  static std::string typeStatName(const std::string& type);
+  static std::string instanceStatName(
+      const std::string& net,
+      int position,
+      const std::string& type);
+
+ private:
+  void Start() override;
+  void Stop() override;
+
+  struct LatencyStats {
+    CAFFE_STAT_CTOR(LatencyStats);
+    CAFFE_HISTOGRAM_EXPORTED_STAT(latency_ns);
+  };
+
+ private:
+  LatencyNetObserver* netObserver_;
+  LatencyStats typeStats_;
+  LatencyStats instanceStats_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+class LatencyNetObserver final : public OperatorAttachingNetObserver<
+                                     LatencyOperatorObserver,
+                                     LatencyNetObserver> {
+ public:
+  explicit LatencyNetObserver(NetBase* subject_)
+      : OperatorAttachingNetObserver<
+            LatencyOperatorObserver,
+            LatencyNetObserver>(subject_, this) {}
+  ~LatencyNetObserver() {}
+};
+
+} // namespace caffe2
@@ -0,0 +1,85 @@
+#include "caffe2/core/common.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/observer.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/core/stats.h"
+#include "latency_observer.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+namespace caffe2 {
+
+namespace {
+
+class LatencyTestSleepOp final : public OperatorBase {
+ public:
+  using OperatorBase::OperatorBase;
+  bool Run(int /* unused */) override {
+    StartAllObservers();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    StopAllObservers();
+    return true;
+  }
+};
+
+REGISTER_CPU_OPERATOR(LatencyTestSleepOp, LatencyTestSleepOp);
+
+OPERATOR_SCHEMA(LatencyTestSleepOp)
+    .NumInputs(0, INT_MAX)
+    .NumOutputs(0, INT_MAX)
+    .AllowInplace({{0, 0}, {1, 1}});
+
+unique_ptr<NetBase> CreateNetTestHelper(Workspace* ws) {
+  NetDef net_def;
+  net_def.set_name("latency_test_net");
+  {
+    auto& op = *(net_def.add_op());
+    op.set_type("LatencyTestSleepOp");
+    op.add_input("in");
+    op.add_output("hidden");
+  }
+  {
+    auto& op = *(net_def.add_op());
+    op.set_type("LatencyTestSleepOp");
+    op.add_input("hidden");
+    op.add_output("out");
+  }
+  net_def.add_external_input("in");
+  net_def.add_external_output("out");
+
+  return CreateNet(net_def, ws);
+}
+} // namespace
+
+TEST(LatencyObserverTest, TestHistograms) {
+  Workspace ws;
+  ws.CreateBlob("in");
+  unique_ptr<NetBase> net(CreateNetTestHelper(&ws));
+  net->AttachObserver(caffe2::make_unique<LatencyNetObserver>(net.get()));
+  for (int i = 0; i < 3; ++i) {
+    net->Run();
+  }
+
+  auto stats = toMap(StatRegistry::get().publish());
+  const std::string typeKey =
+      LatencyOperatorObserver::typeStatName("LatencyTestSleepOp") +
+      "/latency_ns";
+  EXPECT_EQ(stats[typeKey + "/count"], 6);
+  for (int position = 0; position < 2; ++position) {
+    const std::string instanceKey = LatencyOperatorObserver::instanceStatName(
+                                        "latency_test_net",
+                                        position,
+                                        "LatencyTestSleepOp") +
+        "/latency_ns";
+    EXPECT_EQ(stats[instanceKey + "/count"], 3);
+    EXPECT_GE(stats[instanceKey + "/sum"], 3 * 10000000);
+  }
+  const double p50 = HistogramExportedStat::quantile(stats, typeKey, 0.5);
+  const double p99 = HistogramExportedStat::quantile(stats, typeKey, 0.99);
+  EXPECT_GE(p50, 10000000 * 7 / 8);
+  EXPECT_LT(p50, 100000000);
+  EXPECT_GE(p99, p50);
+}
+} // namespace caffe2
@@ -0,0 +1,71 @@
+#include "caffe2/operators/fused_rowwise_4bit_conversion_ops.h"
+#include "caffe2/core/registry.h"
+
+namespace caffe2 {
+REGISTER_CPU_OPERATOR(
+    FloatToFused4BitRowwiseQuantized,
+    FloatToFused4BitRowwiseQuantizedOp<CPUContext>);
+OPERATOR_SCHEMA(FloatToFused4BitRowwiseQuantized)
+    .NumInputs(1)
+    .NumOutputs(1)
+    .TensorInferenceFunction([](const OperatorDef& /* def */,
+                                const vector<TensorShape>& in) {
+      vector<TensorShape> out;
+      TensorShape X = in[0];
+      X.set_dims(1, (X.dims(1) + 1) / 2 + 8);
+      out.push_back(std::move(X));
+      out[0].set_data_type(TensorProto_DataType_UINT8);
+      return out;
+    })
+    .SetDoc(R"DOC(
+Applies 4-bit row-wise quantization by determining the range
+(maximum - minimum) and offset (minimum value) of each row in the input
+matrix, and then scaling each element to a 4-bit number between 0 and
+15. Two quantized values are packed into each byte, the first one in the
+low nibble. To later de-quantize values, the scale (range / 15) and
+offset (bias) are stored alongside the data: the last 8 bytes of each
+row in the output matrix are the scale and the bias as 32-bit floats.
+This halves the size of 8-bit rowwise quantized embedding tables, at
+the cost of precision.
+)DOC")
+    .Input(0, "input", "Float32 input data")
+    .Output(0, "output", "Fused scale, bias and quantized data");
+NO_GRADIENT(FloatToFused4BitRowwiseQuantized);
+
+REGISTER_CPU_OPERATOR(
+    Fused4BitRowwiseQuantizedToFloat,
+    Fused4BitRowwiseQuantizedToFloatOp<CPUContext>);
+OPERATOR_SCHEMA(Fused4BitRowwiseQuantizedToFloat)
+    .NumInputs(1)
+    .NumOutputs(1)
+    .TensorInferenceFunction([](const OperatorDef& def,
+                                const vector<TensorShape>& in) {
+      ArgumentHelper helper(def);
+      vector<TensorShape> out;
+      TensorShape X = in[0];
+      X.set_dims(
+          1,
+          helper.GetSingleArgument<int>("columns", (X.dims(1) - 8) * 2));
+      out.push_back(std::move(X));
+      out[0].set_data_type(TensorProto_DataType_FLOAT);
+      return out;
+    })
+    .SetDoc(R"DOC(
+De-quantizes the result of the FloatToFused4BitRowwiseQuantized
+operator. The input is expected to encode the scale as a 32-bit float in
+the second to the last 4 bytes of each row, followed by the bias as a
+32-bit float in the next 4 bytes, and the quantized values, two per
+byte, in the preceding bytes of the row. The output is a matrix
+containing only the values, but de-quantized.
+)DOC")
+    .Arg(
+        "columns",
+        "Number of values per row. Defaults to two per byte, which is one "
+        "too many if the quantized matrix had an odd number of columns.")
+    .Input(
+        0,
+        "scale_bias_quantized_input",
+        "Fused scale, bias and quantized data")
+    .Output(0, "float_input", "Float32 data");
+NO_GRADIENT(Fused4BitRowwiseQuantizedToFloat);
+} // namespace caffe2
@@ -0,0 +1,150 @@
+#ifndef CAFFE2_OPERATORS_FUSED_ROWWISE_4BIT_CONVERSION_OPS_H_
+#define CAFFE2_OPERATORS_FUSED_ROWWISE_4BIT_CONVERSION_OPS_H_
+
+#include "caffe2/core/context.h"
+#include "caffe2/core/logging.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/operators/reducer_functors.h"
+#include "caffe2/utils/math.h"
+
+namespace caffe2 {
+
+#define IS_LITTLE_ENDIAN                                      \
+  [] {                                                        \
+    const int32_t kValue = 1;                                 \
+    return reinterpret_cast<const uint8_t*>(&kValue)[0] == 1; \
+  }()
+
+template <class Context>
+class FloatToFused4BitRowwiseQuantizedOp : public Operator<Context> {
+ public:
+  static constexpr float kEpsilon = 1e-8f;
+
+  USE_OPERATOR_CONTEXT_FUNCTIONS;
+  USE_SIMPLE_CTOR_DTOR(FloatToFused4BitRowwiseQuantizedOp)
+
+  bool RunOnDevice() override {
+    CAFFE_ENFORCE(IS_LITTLE_ENDIAN, "Unsupported endianness");
+
+    const auto& input = Input(DATA_FLOAT);
+    auto* output = Output(DATA_FUSED_SCALE_BIAS_INT4);
+
+    CAFFE_ENFORCE_EQ(input.ndim(), 2, "Expect input to be a matrix");
+    const auto input_rows = input.dim(0);
+    const auto input_columns = input.dim(1);
+
+    // Like the 8-bit fused representation, but every byte holds two values,
+    // the first one in the low nibble. An odd number of values leaves the
+    // high nibble of the last byte zero.
+    // | ... int4 data ...         | scale | bias |
+    // | (number_of_columns + 1)/2 |  4B   |  4B  |
+    const auto packed_columns = (input_columns + 1) / 2;
+    const std::vector<TIndex> output_dimensions = {input_rows,
+                                                   packed_columns + 8};
+    output->Resize(output_dimensions);
+
+    const auto* input_data = input.template data<float>();
+    auto* output_data = output->template mutable_data<uint8_t>();
+    const auto output_columns = output->dim(1);
+
+    for (size_t row = 0; row < input_rows; ++row) {
+      ConstEigenVectorArrayMap<float> input_row(
+          input_data + row * input_columns, input_columns);
+
+      uint8_t* output_row = output_data + row * output_columns;
+      EigenVectorArrayMap<float> output_row_scale_bias(
+          reinterpret_cast<float*>(output_row + packed_columns), 2);
+
+      const float minimum_element = input_row.minCoeff();
+      const float maximum_element = input_row.maxCoeff();
+      const float range = maximum_element - minimum_element;
+
+      output_row_scale_bias(0) = range / 15.0f;
+      output_row_scale_bias(1) = minimum_element;
+      const auto inverse_scale = 15.0f / (range + kEpsilon);
+
+      std::fill(output_row, output_row + packed_columns, 0);
+      for (TIndex column = 0; column < input_columns; ++column) {
+        const auto quantized = static_cast<uint8_t>(std::min(
+            15.0f,
+            std::round((input_row(column) - minimum_element) * inverse_scale)));
+        output_row[column / 2] |= quantized << ((column % 2) * 4);
+      }
+    }
+
+    return true;
+  }
+
+ private:
+  INPUT_TAGS(DATA_FLOAT);
+  OUTPUT_TAGS(DATA_FUSED_SCALE_BIAS_INT4);
+};
+
+template <class Context>
+class Fused4BitRowwiseQuantizedToFloatOp : public Operator<Context> {
+ public:
+  USE_OPERATOR_CONTEXT_FUNCTIONS;
+  Fused4BitRowwiseQuantizedToFloatOp(
+      const OperatorDef& operator_def,
+      Workspace* ws)
+      : Operator<Context>(operator_def, ws),
+        columns_(OperatorBase::GetSingleArgument<int>("columns", -1)) {}
+
+  bool RunOnDevice() override {
+    CAFFE_ENFORCE(IS_LITTLE_ENDIAN, "Unsupported endianness");
+
+    const auto& input = Input(DATA_FUSED_SCALE_BIAS_INT4);
+    auto* output = Output(DATA_FLOAT);
+
+    CAFFE_ENFORCE_EQ(input.ndim(), 2, "Expect input to be a matrix");
+    const auto input_rows = input.dim(0);
+    const auto input_columns = input.dim(1);
+    CAFFE_ENFORCE_GT(input_columns, 8, "Expect at least one byte of values");
+
+    // The last 8 bytes per row are the scale and the bias. The rest of
+    // input_columns holds two values per byte, so the number of values in
+    // the original row is ambiguous by one: it's given by the `columns`
+    // argument, if odd.
+    const auto packed_columns = input_columns - 8;
+    TIndex output_columns = packed_columns * 2;
+    if (columns_ >= 0) {
+      CAFFE_ENFORCE_EQ(
+          (columns_ + 1) / 2,
+          packed_columns,
+          "columns doesn't match the number of bytes per row");
+      output_columns = columns_;
+    }
+    const std::vector<TIndex> output_dimensions = {input_rows, output_columns};
+    output->Resize(output_dimensions);
+
+    const auto* input_data = input.template data<uint8_t>();
+    auto* output_data = output->template mutable_data<float>();
+
+    for (size_t row = 0; row < input_rows; ++row) {
+      const uint8_t* input_row = input_data + row * input_columns;
+      const float* input_row_scale_bias =
+          reinterpret_cast<const float*>(input_row + packed_columns);
+      float* output_row = output_data + row * output_columns;
+
+      for (TIndex column = 0; column < output_columns; ++column) {
+        const int quantized =
+            (input_row[column / 2] >> ((column % 2) * 4)) & 0xF;
+        output_row[column] =
+            quantized * input_row_scale_bias[0] + input_row_scale_bias[1];
+      }
+    }
+    return true;
+  }
+
+ private:
+  const int columns_;
+
+  INPUT_TAGS(DATA_FUSED_SCALE_BIAS_INT4);
+  OUTPUT_TAGS(DATA_FLOAT);
+};
+
+#undef IS_LITTLE_ENDIAN
+
+} // namespace caffe2
+
+#endif // CAFFE2_OPERATORS_FUSED_ROWWISE_4BIT_CONVERSION_OPS_H_
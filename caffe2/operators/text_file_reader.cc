@@ -1,3 +1,9 @@
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <thread>
+
 #include "caffe2/core/context.h"
 #include "caffe2/core/operator.h"
 #include "caffe2/core/tensor.h"
@@ -7,32 +13,253 @@
 
 namespace caffe2 {
 
+inline void convert(
+    TensorProto_DataType dst_type,
+    const char* src_start,
+    const char* src_end,
+    void* dst) {
+  switch (dst_type) {
+    case TensorProto_DataType_STRING: {
+      static_cast<std::string*>(dst)->assign(src_start, src_end);
+    } break;
+    case TensorProto_DataType_FLOAT: {
+      // TODO(azzolini): avoid copy, use faster convertion
+      std::string str_copy(src_start, src_end);
+      const char* src_copy = str_copy.c_str();
+      char* src_copy_end;
+      float val = strtof(src_copy, &src_copy_end);
+      if (src_copy == src_copy_end) {
+        throw std::runtime_error("Invalid float: " + str_copy);
+      }
+      *static_cast<float*>(dst) = val;
+    } break;
+    default:
+      throw std::runtime_error("Unsupported type.");
+  }
+}
+
+// Rows of one chunk of a file, with one tensor per field
+struct ParsedChunk {
+  std::vector<TensorCPU> fields;
+  TIndex numRows{0};
+  std::exception_ptr error;
+};
+
+// Parses a file on a pool of threads. The file is memory mapped and split
+// into chunks of about chunkSize bytes that start and end on row boundaries,
+// so that every chunk can be tokenized on its own. Chunks are handed out in
+// file order, so rows are read in the same order as by a single thread. At
+// most 2 * numThreads chunks are parsed ahead of the reader, and the pages of
+// the chunks parsed next are read ahead while the current ones are parsed.
+class ParallelTextParser {
+ public:
+  ParallelTextParser(
+      const std::vector<char>& delims,
+      char escape,
+      const std::string& filename,
+      int numPasses,
+      const std::vector<int>& types,
+      const std::vector<TypeMeta>& metas,
+      int numThreads,
+      size_t chunkSize)
+      : delims_(delims),
+        escape_(escape),
+        file_(filename),
+        fieldTypes_(types),
+        fieldMetas_(metas),
+        chunkSize_(chunkSize),
+        numChunks_((file_.size() + chunkSize - 1) / chunkSize),
+        totalChunks_(numChunks_ * numPasses),
+        maxPending_(2 * numThreads) {
+    file_.willNeed(0, numThreads * chunkSize_);
+    for (int i = 0; i < numThreads; ++i) {
+      workers_.emplace_back([this, numThreads] { work(numThreads); });
+    }
+  }
+
+  ~ParallelTextParser() {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  // Returns the next chunk in file order, or nullptr after the last pass.
+  // Errors found while parsing the chunk are rethrown here.
+  std::unique_ptr<ParsedChunk> next() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (nextToReturn_ == totalChunks_) {
+      return nullptr;
+    }
+    cv_.wait(lock, [this] { return parsed_.count(nextToReturn_) > 0; });
+    auto it = parsed_.find(nextToReturn_);
+    std::unique_ptr<ParsedChunk> chunk = std::move(it->second);
+    parsed_.erase(it);
+    ++nextToReturn_;
+    lock.unlock();
+    cv_.notify_all();
+    if (chunk->error) {
+      std::rethrow_exception(chunk->error);
+    }
+    return chunk;
+  }
+
+ private:
+  void work(int numThreads) {
+    while (true) {
+      size_t index;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] {
+          return stop_ || nextToParse_ == totalChunks_ ||
+              nextToParse_ < nextToReturn_ + maxPending_;
+        });
+        if (stop_ || nextToParse_ == totalChunks_) {
+          return;
+        }
+        index = nextToParse_++;
+      }
+      // The chunk taken by the next round of workers
+      file_.willNeed(
+          ((index + numThreads) % numChunks_) * chunkSize_, chunkSize_);
+      std::unique_ptr<ParsedChunk> chunk(new ParsedChunk());
+      try {
+        parse(index % numChunks_, *chunk);
+      } catch (...) {
+        chunk->error = std::current_exception();
+      }
+      {
+        std::lock_guard<std::mutex> guard(mutex_);
+        parsed_[index] = std::move(chunk);
+      }
+      cv_.notify_all();
+    }
+  }
+
+  void parse(size_t index, ParsedChunk& chunk) {
+    const char* data = file_.data();
+    const size_t size = file_.size();
+    const size_t begin =
+        nextRecordStart(data, size, index * chunkSize_, delims_[0], escape_);
+    const size_t end = nextRecordStart(
+        data, size, (index + 1) * chunkSize_, delims_[0], escape_);
+
+    Tokenizer tokenizer(delims_, escape_);
+    TokenizedString tokenized;
+    // The tokenizer doesn't write to its input
+    tokenizer.next(
+        const_cast<char*>(data + begin),
+        const_cast<char*>(data + end),
+        tokenized);
+    const auto& tokens = tokenized.tokens();
+
+    const size_t numFields = fieldTypes_.size();
+    for (size_t i = 0; i < tokens.size(); ++i) {
+      CAFFE_ENFORCE(
+          tokens[i].startDelimId == (i % numFields == 0 ? 0 : 1),
+          "Invalid number of columns at row ",
+          i / numFields + 1,
+          " of the chunk starting at byte ",
+          begin);
+    }
+    chunk.numRows = tokens.size() / numFields;
+    if (tokens.size() % numFields != 0) {
+      CAFFE_ENFORCE(end != size, "Invalid number of fields at end of file.");
+      CAFFE_THROW(
+          "Invalid number of columns at row ",
+          chunk.numRows + 1,
+          " of the chunk starting at byte ",
+          begin);
+    }
+
+    chunk.fields.resize(numFields);
+    for (size_t field = 0; field < numFields; ++field) {
+      auto& tensor = chunk.fields[field];
+      tensor.Resize(chunk.numRows);
+      char* dst = (char*)tensor.raw_mutable_data(fieldMetas_[field]);
+      for (TIndex row = 0; row < chunk.numRows; ++row) {
+        const Token& token = tokens[row * numFields + field];
+        convert(
+            (TensorProto_DataType)fieldTypes_[field],
+            token.start,
+            token.end,
+            dst);
+        dst += fieldMetas_[field].itemsize();
+      }
+    }
+  }
+
+  const std::vector<char> delims_;
+  const char escape_;
+  const MappedFile file_;
+  const std::vector<int> fieldTypes_;
+  const std::vector<TypeMeta> fieldMetas_;
+  const size_t chunkSize_;
+  const size_t numChunks_;
+  // numChunks_ for every pass
+  const size_t totalChunks_;
+  const size_t maxPending_;
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  size_t nextToParse_{0};
+  size_t nextToReturn_{0};
+  std::map<size_t, std::unique_ptr<ParsedChunk>> parsed_;
+  bool stop_{false};
+};
+
 struct TextFileReaderInstance {
   TextFileReaderInstance(
       const std::vector<char>& delims,
       char escape,
       const std::string& filename,
       int numPasses,
-      const std::vector<int>& types)
-      : fileReader(filename),
-        tokenizer(Tokenizer(delims, escape), &fileReader, numPasses),
-        fieldTypes(types) {
+      const std::vector<int>& types,
+      int numThreads = 1,
+      size_t chunkSize = 0)
+      : fieldTypes(types) {
     for (const auto dt : fieldTypes) {
       fieldMetas.push_back(
           DataTypeToTypeMeta(static_cast<TensorProto_DataType>(dt)));
       fieldByteSizes.push_back(fieldMetas.back().itemsize());
     }
+    if (numThreads > 1) {
+      parser.reset(new ParallelTextParser(
+          delims,
+          escape,
+          filename,
+          numPasses,
+          fieldTypes,
+          fieldMetas,
+          numThreads,
+          chunkSize));
+    } else {
+      fileReader.reset(new FileReader(filename));
+      tokenizer.reset(new BufferedTokenizer(
+          Tokenizer(delims, escape), fileReader.get(), numPasses));
+    }
   }
 
-  FileReader fileReader;
-  BufferedTokenizer tokenizer;
+  // Set when reading on a single thread
+  std::unique_ptr<FileReader> fileReader;
+  std::unique_ptr<BufferedTokenizer> tokenizer;
+  // Set when reading on several threads, with the chunk being read
+  std::unique_ptr<ParallelTextParser> parser;
+  std::unique_ptr<ParsedChunk> chunk;
+  TIndex chunkRow{0};
+
   std::vector<int> fieldTypes;
   std::vector<TypeMeta> fieldMetas;
   std::vector<size_t> fieldByteSizes;
   size_t rowsRead{0};
 
-  // hack to guarantee thread-safeness of the read op
-  // TODO(azzolini): support multi-threaded reading.
+  // Serializes the read ops. With several threads, only handing out the
+  // parsed rows happens under this lock.
   std::mutex globalMutex_;
 };
 
@@ -42,14 +269,24 @@ class CreateTextFileReaderOp : public Operator<CPUContext> {
       : Operator<CPUContext>(operator_def, ws),
         filename_(GetSingleArgument<string>("filename", "")),
         numPasses_(GetSingleArgument<int>("num_passes", 1)),
-        fieldTypes_(GetRepeatedArgument<int>("field_types")) {
+        fieldTypes_(GetRepeatedArgument<int>("field_types")),
+        numThreads_(GetSingleArgument<int>("num_threads", 1)),
+        chunkSize_(GetSingleArgument<int64_t>("chunk_size", 1 << 22)) {
     CAFFE_ENFORCE(fieldTypes_.size() > 0, "field_types arg must be non-empty");
+    CAFFE_ENFORCE(numThreads_ > 0, "num_threads must be positive");
+    CAFFE_ENFORCE(chunkSize_ > 0, "chunk_size must be positive");
   }
 
   bool RunOnDevice() override {
     *OperatorBase::Output<std::unique_ptr<TextFileReaderInstance>>(0) =
         std::unique_ptr<TextFileReaderInstance>(new TextFileReaderInstance(
-            {'\n', '\t'}, '\0', filename_, numPasses_, fieldTypes_));
+            {'\n', '\t'},
+            '\0',
+            filename_,
+            numPasses_,
+            fieldTypes_,
+            numThreads_,
+            chunkSize_));
     return true;
   }
 
@@ -57,33 +294,10 @@ class CreateTextFileReaderOp : public Operator<CPUContext> {
   std::string filename_;
   int numPasses_;
   std::vector<int> fieldTypes_;
+  int numThreads_;
+  int64_t chunkSize_;
 };
 
-inline void convert(
-    TensorProto_DataType dst_type,
-    const char* src_start,
-    const char* src_end,
-    void* dst) {
-  switch (dst_type) {
-    case TensorProto_DataType_STRING: {
-      static_cast<std::string*>(dst)->assign(src_start, src_end);
-    } break;
-    case TensorProto_DataType_FLOAT: {
-      // TODO(azzolini): avoid copy, use faster convertion
-      std::string str_copy(src_start, src_end);
-      const char* src_copy = str_copy.c_str();
-      char* src_copy_end;
-      float val = strtof(src_copy, &src_copy_end);
-      if (src_copy == src_copy_end) {
-        throw std::runtime_error("Invalid float: " + str_copy);
-      }
-      *static_cast<float*>(dst) = val;
-    } break;
-    default:
-      throw std::runtime_error("Unsupported type.");
-  }
-}
-
 class TextFileReaderReadOp : public Operator<CPUContext> {
  public:
   TextFileReaderReadOp(const OperatorDef& operator_def, Workspace* ws)
@@ -113,8 +327,10 @@ class TextFileReaderReadOp : public Operator<CPUContext> {
     }
 
     int rowsRead = 0;
-    {
-      // TODO(azzolini): support multi-threaded reading
+    if (instance->parser) {
+      std::lock_guard<std::mutex> guard(instance->globalMutex_);
+      readParsedRows(instance, datas, rowsRead);
+    } else {
       std::lock_guard<std::mutex> guard(instance->globalMutex_);
 
       bool finished = false;
@@ -122,7 +338,7 @@ class TextFileReaderReadOp : public Operator<CPUContext> {
       while (!finished && (rowsRead < batchSize_)) {
         int field;
         for (field = 0; field < numFields; ++field) {
-          finished = !instance->tokenizer.next(token);
+          finished = !instance->tokenizer->next(token);
           if (finished) {
             CAFFE_ENFORCE(
                 field == 0, "Invalid number of fields at end of file.");
@@ -156,6 +372,40 @@ class TextFileReaderReadOp : public Operator<CPUContext> {
   }
 
  private:
+  // Copies rows out of the chunks parsed by instance->parser
+  void readParsedRows(
+      TextFileReaderInstance* instance,
+      std::vector<char*>& datas,
+      int& rowsRead) {
+    while (rowsRead < batchSize_) {
+      if (!instance->chunk || instance->chunkRow == instance->chunk->numRows) {
+        instance->chunk = instance->parser->next();
+        instance->chunkRow = 0;
+        if (!instance->chunk) {
+          break;
+        }
+        continue;
+      }
+      const TIndex n = std::min(
+          batchSize_ - rowsRead, instance->chunk->numRows - instance->chunkRow);
+      for (size_t i = 0; i < datas.size(); ++i) {
+        const auto& meta = instance->fieldMetas[i];
+        const size_t itemSize = instance->fieldByteSizes[i];
+        const char* src = (const char*)instance->chunk->fields[i].raw_data() +
+            instance->chunkRow * itemSize;
+        if (meta.copy()) {
+          meta.copy()(src, datas[i], n);
+        } else {
+          std::memcpy(datas[i], src, n * itemSize);
+        }
+        datas[i] += n * itemSize;
+      }
+      instance->chunkRow += n;
+      rowsRead += n;
+    }
+    instance->rowsRead += rowsRead;
+  }
+
   TIndex batchSize_;
 };
 
@@ -173,6 +423,15 @@ OPERATOR_SCHEMA(CreateTextFileReader)
     .Arg(
         "field_types",
         "List with type of each field. Type enum is found at core.DataType.")
+    .Arg(
+        "num_threads",
+        "Number of threads parsing the file. With more than one, the file is "
+        "memory mapped and split into chunks that are parsed in parallel; "
+        "rows are still read in file order.")
+    .Arg(
+        "chunk_size",
+        "Approximate size in bytes of the chunks parsed by each thread "
+        "(default 4MB). Only used when num_threads > 1.")
     .Output(0, "handler", "Pointer to the created TextFileReaderInstance.");
 
 OPERATOR_SCHEMA(TextFileReaderRead)
@@ -1,6 +1,10 @@
 #include "caffe2/operators/text_file_reader_utils.h"
 
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 #include <sstream>
@@ -116,4 +120,78 @@ void FileReader::operator()(CharRange& range) {
   range.start = buffer;
   range.end = buffer + numRead;
 }
+
+MappedFile::MappedFile(const std::string& path) {
+  fd_ = open(path.c_str(), O_RDONLY);
+  if (fd_ < 0) {
+    throw std::runtime_error(
+        "Error opening file for reading: " + std::string(std::strerror(errno)) +
+        " Path=" + path);
+  }
+  struct stat st;
+  if (fstat(fd_, &st) == -1) {
+    close(fd_);
+    throw std::runtime_error(
+        "Error reading file size: " + std::string(std::strerror(errno)) +
+        " Path=" + path);
+  }
+  size_ = st.st_size;
+  if (size_ == 0) {
+    // mmap fails on empty ranges
+    return;
+  }
+  void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+  if (addr == MAP_FAILED) {
+    close(fd_);
+    throw std::runtime_error(
+        "Error mapping file: " + std::string(std::strerror(errno)) +
+        " Path=" + path);
+  }
+  data_ = static_cast<char*>(addr);
+  // Only a hint, failures are harmless
+  posix_madvise(data_, size_, POSIX_MADV_SEQUENTIAL);
+}
+
+MappedFile::~MappedFile() {
+  if (data_) {
+    munmap(data_, size_);
+  }
+  close(fd_);
+}
+
+void MappedFile::willNeed(size_t offset, size_t length) const {
+  if (offset >= size_) {
+    return;
+  }
+  // The address passed to posix_madvise must be page aligned
+  static const size_t pageSize = sysconf(_SC_PAGESIZE);
+  const size_t begin = offset - offset % pageSize;
+  const size_t end = std::min(offset + length, size_);
+  posix_madvise(data_ + begin, end - begin, POSIX_MADV_WILLNEED);
+}
+
+size_t nextRecordStart(
+    const char* data,
+    size_t size,
+    size_t offset,
+    char recordDelim,
+    char escape) {
+  if (offset == 0 || offset >= size) {
+    return std::min(offset, size);
+  }
+  for (size_t pos = offset - 1; pos < size; ++pos) {
+    if (data[pos] != recordDelim) {
+      continue;
+    }
+    // The delimiter is escaped if it follows an odd number of escapes
+    size_t numEscapes = 0;
+    while (numEscapes < pos && data[pos - numEscapes - 1] == escape) {
+      ++numEscapes;
+    }
+    if (numEscapes % 2 == 0) {
+      return pos + 1;
+    }
+  }
+  return size;
 }
+} // namespace caffe2
@@ -117,6 +117,40 @@ class FileReader : public StringProvider {
   std::unique_ptr<char[]> buffer_;
 };
 
+// Read-only memory mapping of a whole file, used to parse disjoint parts of a
+// file on several threads. The kernel is told that the file is read
+// sequentially, and willNeed() starts reading a range ahead of its use.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path);
+  ~MappedFile();
+
+  const char* data() const {
+    return data_;
+  }
+  size_t size() const {
+    return size_;
+  }
+
+  void willNeed(size_t offset, size_t length) const;
+
+ private:
+  int fd_;
+  char* data_{nullptr};
+  size_t size_{0};
+};
+
+// Returns the offset of the first record of data[0, size) that starts at or
+// after `offset`, or size if there is none. A record starts at the beginning
+// of the data and after every `recordDelim` that is not escaped. Splitting
+// data at such offsets yields ranges that can be tokenized independently.
+size_t nextRecordStart(
+    const char* data,
+    size_t size,
+    size_t offset,
+    char recordDelim,
+    char escape);
+
 } // namespace caffe2
 
 #endif // CAFFE2_OPERATORS_TEXT_FILE_READER_UTILS_H
@@ -119,4 +119,58 @@ TEST(TextFileReaderUtilsTest, TokenizeTest) {
   std::remove(tmpname);
 }
 
+TEST(TextFileReaderUtilsTest, RecordSplitTest) {
+  std::string ch =
+      "label\1text\xc3\xbf\nlabel2\\\nTest\1tex\\\\t2\n"
+      "Two\\\\Escapes\\\1\1Second\n";
+  std::vector<char> seps = {'\n', '\1'};
+  std::vector<std::pair<int, std::string>> expected = {{0, "label"},
+                                                       {1, "text\xc3\xbf"},
+                                                       {0, "label2\nTest"},
+                                                       {1, "tex\\t2"},
+                                                       {0, "Two\\Escapes\1"},
+                                                       {1, "Second"}};
+
+  // escaped newlines don't start records
+  EXPECT_EQ(0, nextRecordStart(ch.data(), ch.size(), 0, '\n', '\\'));
+  EXPECT_EQ(13, nextRecordStart(ch.data(), ch.size(), 1, '\n', '\\'));
+  EXPECT_EQ(13, nextRecordStart(ch.data(), ch.size(), 13, '\n', '\\'));
+  EXPECT_EQ(34, nextRecordStart(ch.data(), ch.size(), 14, '\n', '\\'));
+  EXPECT_EQ(34, nextRecordStart(ch.data(), ch.size(), 21, '\n', '\\'));
+  EXPECT_EQ(ch.size(), nextRecordStart(ch.data(), ch.size(), 35, '\n', '\\'));
+
+  char* tmpname = std::tmpnam(nullptr);
+  std::ofstream outFile;
+  outFile.open(tmpname);
+  outFile << ch;
+  outFile.close();
+  MappedFile file(tmpname);
+  ASSERT_EQ(ch.size(), file.size());
+  EXPECT_EQ(ch, std::string(file.data(), file.size()));
+
+  // tokenizing the chunks independently yields the tokens of the whole file
+  for (size_t chunkSize = 1; chunkSize <= ch.size(); ++chunkSize) {
+    std::vector<std::pair<int, std::string>> tokens;
+    for (size_t offset = 0; offset < file.size(); offset += chunkSize) {
+      size_t begin =
+          nextRecordStart(file.data(), file.size(), offset, '\n', '\\');
+      size_t end = nextRecordStart(
+          file.data(), file.size(), offset + chunkSize, '\n', '\\');
+      file.willNeed(begin, end - begin);
+      Tokenizer tokenizer(seps, '\\');
+      TokenizedString tokenized;
+      tokenizer.next(
+          const_cast<char*>(file.data() + begin),
+          const_cast<char*>(file.data() + end),
+          tokenized);
+      for (const auto& token : tokenized.tokens()) {
+        tokens.emplace_back(
+            token.startDelimId, std::string(token.start, token.end));
+      }
+    }
+    EXPECT_EQ(expected, tokens);
+  }
+  std::remove(tmpname);
+}
+
 } // namespace caffe2
@@ -0,0 +1,21 @@
+// This file is here merely to check that the flags are not mixed up: for
+// example, if your compiler did not specify -mavx512f, you should not provide
+// the CAFFE2_PERF_WITH_AVX512 macro.
+
+#include "caffe2/core/common.h"
+
+#ifdef CAFFE2_PERF_WITH_AVX512
+#ifndef __AVX512F__
+#error( \
+    "You found a build system error: CAFFE2_PERF_WITH_AVX512 is defined" \
+    "but __AVX512F__ is not defined (via e.g. -mavx512f).");
+#endif // __AVX512F__
+#endif // CAFFE2_PERF_WITH_AVX512
+
+#ifdef __AVX512F__
+#ifndef CAFFE2_PERF_WITH_AVX512
+#error( \
+    "You found a build system error: __AVX512F__ is defined (via e.g. -mavx512f) " \
+    "but CAFFE2_PERF_WITH_AVX512 is not defined.");
+#endif // CAFFE2_PERF_WITH_AVX512
+#endif
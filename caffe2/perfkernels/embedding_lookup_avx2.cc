@@ -24,10 +24,10 @@ static void EmbeddingLookup_int32_t_float_float__avx2_fma(
     const float* scale_bias,
     bool normalize_by_lengths,
     float* out) {
-  const int32_t prefdist_T0 = 16;
   const int32_t fused_block_size = block_size + 0;
   CAFFE_ENFORCE(scale_bias == nullptr, "scale_bias must be nullptr");
   if (block_size == 128) {
+    const int32_t prefdist_T0 = 8;
     // unrolling 16 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -142,6 +142,7 @@ static void EmbeddingLookup_int32_t_float_float__avx2_fma(
       }
     }
   } else if (block_size == 64) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 8 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -216,6 +217,7 @@ static void EmbeddingLookup_int32_t_float_float__avx2_fma(
       }
     }
   } else if (block_size == 32) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 4 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -270,6 +272,7 @@ static void EmbeddingLookup_int32_t_float_float__avx2_fma(
       }
     }
   } else if (block_size == 16) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 2 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -315,6 +318,7 @@ static void EmbeddingLookup_int32_t_float_float__avx2_fma(
     }
   } else {
     // generic code
+    const int32_t prefdist_T0 = 16;
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
       float* op = &out[rangeIndex * block_size];
@@ -439,10 +443,10 @@ static void EmbeddingLookup_int64_t_float_float__avx2_fma(
     const float* scale_bias,
     bool normalize_by_lengths,
     float* out) {
-  const int64_t prefdist_T0 = 16;
   const int64_t fused_block_size = block_size + 0;
   CAFFE_ENFORCE(scale_bias == nullptr, "scale_bias must be nullptr");
   if (block_size == 128) {
+    const int64_t prefdist_T0 = 8;
     // unrolling 16 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -557,6 +561,7 @@ static void EmbeddingLookup_int64_t_float_float__avx2_fma(
       }
     }
   } else if (block_size == 64) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 8 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -631,6 +636,7 @@ static void EmbeddingLookup_int64_t_float_float__avx2_fma(
       }
     }
   } else if (block_size == 32) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 4 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -685,6 +691,7 @@ static void EmbeddingLookup_int64_t_float_float__avx2_fma(
       }
     }
   } else if (block_size == 16) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 2 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -730,6 +737,7 @@ static void EmbeddingLookup_int64_t_float_float__avx2_fma(
     }
   } else {
     // generic code
+    const int64_t prefdist_T0 = 16;
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
       float* op = &out[rangeIndex * block_size];
@@ -854,10 +862,10 @@ static void EmbeddingLookup_int32_t_float16_float__avx2_fma(
     const float* scale_bias,
     bool normalize_by_lengths,
     float* out) {
-  const int32_t prefdist_T0 = 16;
   const int32_t fused_block_size = block_size + 0;
   CAFFE_ENFORCE(scale_bias == nullptr, "scale_bias must be nullptr");
   if (block_size == 128) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 16 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -1036,6 +1044,7 @@ static void EmbeddingLookup_int32_t_float16_float__avx2_fma(
       }
     }
   } else if (block_size == 64) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 8 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -1142,6 +1151,7 @@ static void EmbeddingLookup_int32_t_float16_float__avx2_fma(
       }
     }
   } else if (block_size == 32) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 4 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -1212,6 +1222,7 @@ static void EmbeddingLookup_int32_t_float16_float__avx2_fma(
       }
     }
   } else if (block_size == 16) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 2 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -1265,6 +1276,7 @@ static void EmbeddingLookup_int32_t_float16_float__avx2_fma(
     }
   } else {
     // generic code
+    const int32_t prefdist_T0 = 16;
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
       float* op = &out[rangeIndex * block_size];
@@ -1395,10 +1407,10 @@ static void EmbeddingLookup_int64_t_float16_float__avx2_fma(
     const float* scale_bias,
     bool normalize_by_lengths,
     float* out) {
-  const int64_t prefdist_T0 = 16;
   const int64_t fused_block_size = block_size + 0;
   CAFFE_ENFORCE(scale_bias == nullptr, "scale_bias must be nullptr");
   if (block_size == 128) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 16 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -1577,6 +1589,7 @@ static void EmbeddingLookup_int64_t_float16_float__avx2_fma(
       }
     }
   } else if (block_size == 64) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 8 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -1683,6 +1696,7 @@ static void EmbeddingLookup_int64_t_float16_float__avx2_fma(
       }
     }
   } else if (block_size == 32) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 4 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -1753,6 +1767,7 @@ static void EmbeddingLookup_int64_t_float16_float__avx2_fma(
       }
     }
   } else if (block_size == 16) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 2 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -1806,6 +1821,7 @@ static void EmbeddingLookup_int64_t_float16_float__avx2_fma(
     }
   } else {
     // generic code
+    const int64_t prefdist_T0 = 16;
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
       float* op = &out[rangeIndex * block_size];
@@ -1936,10 +1952,10 @@ static void EmbeddingLookup_int32_t_uint8_t_float__avx2_fma(
     const float* scale_bias,
     bool normalize_by_lengths,
     float* out) {
-  const int32_t prefdist_T0 = 16;
   const int32_t fused_block_size = block_size + 0;
   CAFFE_ENFORCE(scale_bias != nullptr, "scale_bias must not be nullptr");
   if (block_size == 128) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 16 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -2122,6 +2138,7 @@ static void EmbeddingLookup_int32_t_uint8_t_float__avx2_fma(
       }
     }
   } else if (block_size == 64) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 8 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -2232,6 +2249,7 @@ static void EmbeddingLookup_int32_t_uint8_t_float__avx2_fma(
       }
     }
   } else if (block_size == 32) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 4 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -2306,6 +2324,7 @@ static void EmbeddingLookup_int32_t_uint8_t_float__avx2_fma(
       }
     }
   } else if (block_size == 16) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 2 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -2363,6 +2382,7 @@ static void EmbeddingLookup_int32_t_uint8_t_float__avx2_fma(
     }
   } else {
     // generic code
+    const int32_t prefdist_T0 = 16;
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
       float* op = &out[rangeIndex * block_size];
@@ -2495,10 +2515,10 @@ static void EmbeddingLookup_int64_t_uint8_t_float__avx2_fma(
     const float* scale_bias,
     bool normalize_by_lengths,
     float* out) {
-  const int64_t prefdist_T0 = 16;
   const int64_t fused_block_size = block_size + 0;
   CAFFE_ENFORCE(scale_bias != nullptr, "scale_bias must not be nullptr");
   if (block_size == 128) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 16 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -2681,6 +2701,7 @@ static void EmbeddingLookup_int64_t_uint8_t_float__avx2_fma(
       }
     }
   } else if (block_size == 64) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 8 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -2791,6 +2812,7 @@ static void EmbeddingLookup_int64_t_uint8_t_float__avx2_fma(
       }
     }
   } else if (block_size == 32) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 4 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -2865,6 +2887,7 @@ static void EmbeddingLookup_int64_t_uint8_t_float__avx2_fma(
       }
     }
   } else if (block_size == 16) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 2 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -2922,6 +2945,7 @@ static void EmbeddingLookup_int64_t_uint8_t_float__avx2_fma(
     }
   } else {
     // generic code
+    const int64_t prefdist_T0 = 16;
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
       float* op = &out[rangeIndex * block_size];
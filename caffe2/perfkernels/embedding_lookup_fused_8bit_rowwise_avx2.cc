@@ -23,9 +23,9 @@ static void Fused8BitRowwiseEmbeddingLookup_int32_t_float_float__avx2_fma(
     const float* weights,
     bool normalize_by_lengths,
     float* out) {
-  const int32_t prefdist_T0 = 16;
   const int32_t fused_block_size = block_size + 2;
   if (block_size == 128) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 16 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -140,6 +140,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int32_t_float_float__avx2_fma(
       }
     }
   } else if (block_size == 64) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 8 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -214,6 +215,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int32_t_float_float__avx2_fma(
       }
     }
   } else if (block_size == 32) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 4 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -268,6 +270,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int32_t_float_float__avx2_fma(
       }
     }
   } else if (block_size == 16) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 2 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -313,6 +316,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int32_t_float_float__avx2_fma(
     }
   } else {
     // generic code
+    const int32_t prefdist_T0 = 16;
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
       float* op = &out[rangeIndex * block_size];
@@ -432,9 +436,9 @@ static void Fused8BitRowwiseEmbeddingLookup_int64_t_float_float__avx2_fma(
     const float* weights,
     bool normalize_by_lengths,
     float* out) {
-  const int64_t prefdist_T0 = 16;
   const int64_t fused_block_size = block_size + 2;
   if (block_size == 128) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 16 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -549,6 +553,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int64_t_float_float__avx2_fma(
       }
     }
   } else if (block_size == 64) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 8 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -623,6 +628,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int64_t_float_float__avx2_fma(
       }
     }
   } else if (block_size == 32) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 4 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -677,6 +683,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int64_t_float_float__avx2_fma(
       }
     }
   } else if (block_size == 16) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 2 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -722,6 +729,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int64_t_float_float__avx2_fma(
     }
   } else {
     // generic code
+    const int64_t prefdist_T0 = 16;
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
       float* op = &out[rangeIndex * block_size];
@@ -841,9 +849,9 @@ static void Fused8BitRowwiseEmbeddingLookup_int32_t_float16_float__avx2_fma(
     const float* weights,
     bool normalize_by_lengths,
     float* out) {
-  const int32_t prefdist_T0 = 16;
   const int32_t fused_block_size = block_size + 4;
   if (block_size == 128) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 16 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -1022,6 +1030,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int32_t_float16_float__avx2_fma(
       }
     }
   } else if (block_size == 64) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 8 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -1128,6 +1137,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int32_t_float16_float__avx2_fma(
       }
     }
   } else if (block_size == 32) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 4 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -1198,6 +1208,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int32_t_float16_float__avx2_fma(
       }
     }
   } else if (block_size == 16) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 2 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -1251,6 +1262,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int32_t_float16_float__avx2_fma(
     }
   } else {
     // generic code
+    const int32_t prefdist_T0 = 16;
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
       float* op = &out[rangeIndex * block_size];
@@ -1376,9 +1388,9 @@ static void Fused8BitRowwiseEmbeddingLookup_int64_t_float16_float__avx2_fma(
     const float* weights,
     bool normalize_by_lengths,
     float* out) {
-  const int64_t prefdist_T0 = 16;
   const int64_t fused_block_size = block_size + 4;
   if (block_size == 128) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 16 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -1557,6 +1569,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int64_t_float16_float__avx2_fma(
       }
     }
   } else if (block_size == 64) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 8 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -1663,6 +1676,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int64_t_float16_float__avx2_fma(
       }
     }
   } else if (block_size == 32) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 4 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -1733,6 +1747,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int64_t_float16_float__avx2_fma(
       }
     }
   } else if (block_size == 16) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 2 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -1786,6 +1801,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int64_t_float16_float__avx2_fma(
     }
   } else {
     // generic code
+    const int64_t prefdist_T0 = 16;
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
       float* op = &out[rangeIndex * block_size];
@@ -1911,9 +1927,9 @@ static void Fused8BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx2_fma(
     const float* weights,
     bool normalize_by_lengths,
     float* out) {
-  const int32_t prefdist_T0 = 16;
   const int32_t fused_block_size = block_size + 8;
   if (block_size == 128) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 16 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -2098,6 +2114,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx2_fma(
       }
     }
   } else if (block_size == 64) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 8 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -2210,6 +2227,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx2_fma(
       }
     }
   } else if (block_size == 32) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 4 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -2286,6 +2304,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx2_fma(
       }
     }
   } else if (block_size == 16) {
+    const int32_t prefdist_T0 = 16;
     // unrolling 2 times
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -2345,6 +2364,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx2_fma(
     }
   } else {
     // generic code
+    const int32_t prefdist_T0 = 16;
     int32_t dataInd = 0;
     for (int32_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
       float* op = &out[rangeIndex * block_size];
@@ -2473,9 +2493,9 @@ static void Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx2_fma(
     const float* weights,
     bool normalize_by_lengths,
     float* out) {
-  const int64_t prefdist_T0 = 16;
   const int64_t fused_block_size = block_size + 8;
   if (block_size == 128) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 16 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -2660,6 +2680,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx2_fma(
       }
     }
   } else if (block_size == 64) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 8 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -2772,6 +2793,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx2_fma(
       }
     }
   } else if (block_size == 32) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 4 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -2848,6 +2870,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx2_fma(
       }
     }
   } else if (block_size == 16) {
+    const int64_t prefdist_T0 = 16;
     // unrolling 2 times
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
@@ -2907,6 +2930,7 @@ static void Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx2_fma(
     }
   } else {
     // generic code
+    const int64_t prefdist_T0 = 16;
     int64_t dataInd = 0;
     for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
       float* op = &out[rangeIndex * block_size];
@@ -7,50 +7,195 @@ import sys
 
 sizeof = {'float': 4, 'float16': 2, 'uint8_t': 1}
 
+# Vector width (in floats), register type, intrinsic prefix and function
+# suffix for each instruction set we generate kernels for.
+isa_params = {
+    'avx2': {
+        'width': 8,
+        'vtype': '__m256',
+        'mm': '_mm256',
+        'suffix': '__avx2_fma',
+    },
+    'avx512': {
+        'width': 16,
+        'vtype': '__m512',
+        'mm': '_mm512',
+        'suffix': '__avx512',
+    },
+}
+
+
+def prefetch_distance(row_bytes):
+    # Number of indices to look ahead when prefetching. Keeps about 4KB of
+    # upcoming rows in flight, but never looks further ahead than the
+    # distance of 16 used by the generic path, since a longer distance only
+    # evicts rows that have not been used yet.
+    return max(8, min(16, 4096 // row_bytes))
+
+
+def row_bytes(InType, block_size, fused):
+    if fused == 4:
+        return (block_size + 1) // 2 + 8
+    if fused == 8:
+        return block_size + 8
+    return sizeof[InType] * block_size
+
+
+def load(InType, isa, addr):
+    # Loads `width` values starting at addr and converts them to floats.
+    # For 4-bit data, addr points to the byte holding the first value.
+    if InType == "float":
+        return "%s_loadu_ps(%s)" % (isa['mm'], addr)
+    if InType == "float16":
+        if isa['width'] == 8:
+            return (
+                "_mm256_cvtph_ps(_mm_loadu_si128("
+                "reinterpret_cast<const __m128i*>(%s)))" % addr
+            )
+        return (
+            "_mm512_cvtph_ps(_mm256_loadu_si256("
+            "reinterpret_cast<const __m256i*>(%s)))" % addr
+        )
+    if InType == "uint8_t":
+        if isa['width'] == 8:
+            return (
+                "_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64("
+                "reinterpret_cast<const __m128i*>(%s))))" % addr
+            )
+        return (
+            "_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_loadu_si128("
+            "reinterpret_cast<const __m128i*>(%s))))" % addr
+        )
+    if InType == "uint4":
+        return "Load4Bit%s(%s)" % (isa['suffix'], addr)
+    assert False
+
+
+def load_4bit_helper(isa):
+    # Unpacks `width` 4-bit values, two per byte with the first value in the
+    # low nibble: each byte is duplicated, widened to 32 bits and shifted
+    # right by 0 or 4 bits before masking.
+    # Both versions load 8 bytes; the AVX2 one only uses the first 4, which
+    # never reads past the row since the scale and bias follow the values.
+    code = []
+    code.append(
+        "static inline {} Load4Bit{}(const uint8_t* ip) {{".format(
+            isa['vtype'], isa['suffix']
+        )
+    )
+    code.append(
+        "__m128i packed = "
+        "_mm_loadl_epi64(reinterpret_cast<const __m128i*>(ip));"
+    )
+    code.append("packed = _mm_unpacklo_epi8(packed, packed);")
+    if isa['width'] == 8:
+        code.append("__m256i values = _mm256_cvtepu8_epi32(packed);")
+        code.append(
+            "values = _mm256_srlv_epi32("
+            "values, _mm256_setr_epi32(0, 4, 0, 4, 0, 4, 0, 4));"
+        )
+        code.append(
+            "values = _mm256_and_si256(values, _mm256_set1_epi32(0xF));"
+        )
+        code.append("return _mm256_cvtepi32_ps(values);")
+    else:
+        code.append("__m512i values = _mm512_cvtepu8_epi32(packed);")
+        code.append(
+            "values = _mm512_srlv_epi32(values, _mm512_set_epi32("
+            "4, 0, 4, 0, 4, 0, 4, 0, 4, 0, 4, 0, 4, 0, 4, 0));"
+        )
+        code.append(
+            "values = _mm512_and_si512(values, _mm512_set1_epi32(0xF));"
+        )
+        code.append("return _mm512_cvtepi32_ps(values);")
+    code.append("}")
+    return code
+
+
+def scale_bias_code(IndexType, OutType, fused, isa, check_scale_bias=False):
+    code = []
+    code.append(OutType + " wgt = 1.f;")
+    code.append(OutType + " bio;")
+    code.append("if (weights) {")
+    code.append(
+        "wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];")
+    code.append("}")
+    if fused == 4:
+        code.append(
+            'const float* scale_bias = reinterpret_cast<'
+            'const float*>(&input[idx * fused_block_size + '
+            '(block_size + 1) / 2]);'
+        )
+        code.append("bio = wgt * scale_bias[1];")
+        code.append("wgt = wgt * scale_bias[0];")
+    elif fused == 8:
+        code.append(
+            'const float* scale_bias = reinterpret_cast<'
+            'const float*>(&input[idx * fused_block_size + block_size]);'
+        )
+        code.append("bio = wgt * scale_bias[1];")
+        code.append("wgt = wgt * scale_bias[0];")
+    else:
+        if check_scale_bias:
+            code.append("assert (scale_bias);")
+        code.append("bio = wgt * scale_bias[2 * idx + 1];")
+        code.append("wgt = wgt * scale_bias[2 * idx];")
+    code.append("{} vbio = {}_set1_ps(bio);".format(isa['vtype'], isa['mm']))
+    return code
+
+
+def unroll(
+    uf, IndexType, InType, OutType, use_weights, isa, fused, prefdist
+):
+    # InType is the element type of the row: "uint4" for fused 4-bit data,
+    # which is stored as uint8_t.
+    DataType = "uint8_t" if InType == "uint4" else InType
+    width = isa['width']
+    mm = isa['mm']
 
-def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused):
     def compute(regid, InType, use_weights, isa, prefetch):
         code = []
 
-        if InType == "float":
+        if InType == "uint4":
+            offset = regid // 2
+        else:
+            offset = regid
+        if InType in ("uint8_t", "uint4"):
             code.append(
-                "vop%d = _mm256_fmadd_ps(vwgt,  \
-                  _mm256_loadu_ps(ip + (%d)), vop%d);"
-                                                       % (regid, regid, regid)
+                "vop%d = %s_fmadd_ps(vwgt,  \
+                   %s, \
+                   %s_add_ps(vop%d, vbio));"
+                % (regid, mm, load(InType, isa, "ip + (%d)" % offset), mm,
+                   regid)
             )
-        elif InType == "float16":
+        else:
             code.append(
-                "vop%d = _mm256_fmadd_ps(vwgt,  \
-                   _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (%d)))), \
+                "vop%d = %s_fmadd_ps(vwgt,  \
+                   %s, \
                    vop%d);"
-                            % (regid, regid, regid)
+                % (regid, mm, load(InType, isa, "ip + (%d)" % offset), regid)
             )
-        elif InType == "uint8_t":
-            code.append(
-                "vop%d = _mm256_fmadd_ps(vwgt,  \
-                   _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(ip + (%d))))), \
-                   _mm256_add_ps(vop%d, vbio));"
-                                                 % (regid, regid, regid)
-            )
-        else:
-            assert False
 
         if prefetch:
-            code.append("_mm_prefetch((&ip_next_T0[%d]), _MM_HINT_T0);" % (regid))
+            code.append(
+                "_mm_prefetch((&ip_next_T0[%d]), _MM_HINT_T0);" % (offset))
         else:
-            code.append("// skip unnecessary prefetch of (&ip_next_T0[%d])" % (regid))
+            code.append(
+                "// skip unnecessary prefetch of (&ip_next_T0[%d])" % (offset))
 
         return code
 
     code = []
+    code.append("const " + IndexType + " prefdist_T0 = %d;" % prefdist)
     code.append("// unrolling " + str(uf) + " times")
     code.append(IndexType + " dataInd = 0;")
     code.append("for (" + IndexType +
                 " rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {")
     code.append(OutType + " *op = &out[rangeIndex * block_size];")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("__m256 vop" + str(j) + " = _mm256_setzero_ps();")
+        j = width * i
+        code.append(
+            "{} vop{} = {}_setzero_ps();".format(isa['vtype'], j, mm))
 
     # inner loop
     code.append("for (" + IndexType +
@@ -60,33 +205,18 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused):
         'CAFFE_ENFORCE(idx >=0 && idx < data_size, "Index ", dataInd, "'
         ' is out of bounds: ", idx, ", range 0 to ", data_size);')
 
-    if InType == "uint8_t":
-        code.append(OutType + " wgt = 1.f;")
-        code.append(OutType + " bio;")
-        code.append("if (weights) {")
-        code.append(
-            "wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];")
-        code.append("}")
-        if fused:
-            code.append(
-                'const float* scale_bias = reinterpret_cast<'
-                'const float*>(&input[idx * fused_block_size + block_size]);'
-            )
-            code.append("bio = wgt * scale_bias[1];")
-            code.append("wgt = wgt * scale_bias[0];")
-        else:
-            code.append("bio = wgt * scale_bias[2 * idx + 1];")
-            code.append("wgt = wgt * scale_bias[2 * idx];")
-        code.append("__m256 vbio = _mm256_set1_ps(bio);")
+    if InType in ("uint8_t", "uint4"):
+        code += scale_bias_code(IndexType, OutType, fused, isa)
     else:
         code.append(OutType + " wgt = 1.f;")
         code.append("if (weights) {")
         code.append(
             "wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];")
         code.append("}")
-    code.append("__m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("{} vwgt = {}_set1_ps(wgt);".format(isa['vtype'], mm))
 
-    code.append("const {} *ip = &input[idx * fused_block_size];".format(InType))
+    code.append(
+        "const {} *ip = &input[idx * fused_block_size];".format(DataType))
     code.append(
         'const {} next_T0 = (dataInd < index_size - prefdist_T0)'
         ' ? (dataInd + prefdist_T0) : dataInd;'.format(IndexType)
@@ -97,69 +227,76 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused):
 
     code.append(
         'const {} *ip_next_T0 = &input[idx_pref_T0'
-        ' * fused_block_size];'.format(InType)
+        ' * fused_block_size];'.format(DataType)
     )
 
     for i in range(0, uf):
-        j = 8 * i
+        j = width * i
         cachelinesize = 64
-        byteoffset = sizeof[InType] * j
+        if InType == "uint4":
+            byteoffset = j // 2
+        else:
+            byteoffset = sizeof[InType] * j
         prefetch = (byteoffset % cachelinesize) == 0
         code.extend(compute(j, InType, use_weights, isa, prefetch))
     code.append("}")
 
     code.append("if (normalize_by_lengths == false) {")
     for i in range(0, uf):
-        j = 8 * i
+        j = width * i
         code.append(
-            "_mm256_storeu_ps(&op[" + str(j) + "], vop" + str(j) + ");")
+            mm + "_storeu_ps(&op[" + str(j) + "], vop" + str(j) + ");")
     code.append("} else if (lengths[rangeIndex]) {")
     # inv of length
     code.append(
-        "__m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);")
+        "{} vlen_inv = {}_set1_ps(1.0f / lengths[rangeIndex]);".format(
+            isa['vtype'], mm))
     for i in range(0, uf):
-        j = 8 * i
+        j = width * i
         code.append(
-            "_mm256_storeu_ps(&op[" + str(j) + "], _mm256_mul_ps(" + "vop" + str(j) + ", vlen_inv));")
+            mm + "_storeu_ps(&op[" + str(j) + "], " + mm + "_mul_ps(" +
+            "vop" + str(j) + ", vlen_inv));")
     code.append("}")
 
     code.append("}")
     return code
 
 
-def generic(IndexType, InType, OutType, use_weights, isa, fused):
+def generic(IndexType, InType, OutType, use_weights, isa, fused, prefdist):
+    DataType = "uint8_t" if InType == "uint4" else InType
+    width = isa['width']
+    mm = isa['mm']
 
     def compute(InType, use_weights, isa):
         code = []
-        if InType == "float":
+        addr = "&ip[j / 2]" if InType == "uint4" else "&ip[j]"
+        if InType in ("uint8_t", "uint4"):
             code.append(
-                "_mm256_storeu_ps(&op[j], \
-                                 _mm256_fmadd_ps(vwgt,_mm256_loadu_ps(&ip[j]), _mm256_loadu_ps(&op[j])) \
+                "%s_storeu_ps(&op[j], \
+                   %s_fmadd_ps(vwgt, \
+                     %s, \
+                     %s_add_ps(%s_loadu_ps(&op[j]), vbio) ) \
                                    );"
+                % (mm, mm, load(InType, isa, addr), mm, mm)
             )
-        elif InType == "float16":
-            code.append(
-                "_mm256_storeu_ps(&op[j], \
-                   _mm256_fmadd_ps(vwgt, \
-                     _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&ip[j]))), _mm256_loadu_ps(&op[j])) \
-                                   );"
-            )
-        elif InType == "uint8_t":
+        else:
             code.append(
-                "_mm256_storeu_ps(&op[j], \
-                   _mm256_fmadd_ps(vwgt, \
-                     _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&ip[j])))), \
-                     _mm256_add_ps(_mm256_loadu_ps(&op[j]), vbio) ) \
+                "%s_storeu_ps(&op[j], \
+                   %s_fmadd_ps(vwgt, \
+                     %s, %s_loadu_ps(&op[j])) \
                                    );"
+                % (mm, mm, load(InType, isa, addr), mm)
             )
-        else:
-            assert False
 
-        code.append("_mm_prefetch((&ip_next_T0[j]), _MM_HINT_T0);")
+        if InType == "uint4":
+            code.append("_mm_prefetch((&ip_next_T0[j / 2]), _MM_HINT_T0);")
+        else:
+            code.append("_mm_prefetch((&ip_next_T0[j]), _MM_HINT_T0);")
 
         return code
 
     code = []
+    code.append("const " + IndexType + " prefdist_T0 = %d;" % prefdist)
     code.append(IndexType + " dataInd = 0;")
     code.append("for (" + IndexType +
                 " rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {")
@@ -167,8 +304,8 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused):
 
     # initialize to 0
     code.append("TIndex j = 0;")
-    code.append("for(; j + 8 <= block_size; j += 8) {")
-    code.append("_mm256_storeu_ps(op + j, _mm256_setzero_ps());")
+    code.append("for(; j + %d <= block_size; j += %d) {" % (width, width))
+    code.append("%s_storeu_ps(op + j, %s_setzero_ps());" % (mm, mm))
     code.append("}")
     code.append("for(; j < block_size; j++) {")
     code.append("op[j] = 0.0f;")
@@ -182,34 +319,19 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused):
         'CAFFE_ENFORCE(idx >=0 && idx < data_size, "Index ", dataInd, "' +
         ' is out of bounds: ", idx, ", range 0 to ", data_size);')
 
-    if InType == "uint8_t":
-        code.append(OutType + " wgt = 1.f;")
-        code.append(OutType + " bio;")
-        code.append("if (weights) {")
-        code.append(
-            "wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];")
-        code.append("}")
-        if fused:
-            code.append(
-                'const float* scale_bias = reinterpret_cast<'
-                'const float*>(&input[idx * fused_block_size + block_size]);'
-            )
-            code.append("bio = wgt * scale_bias[1];")
-            code.append("wgt = wgt * scale_bias[0];")
-        else:
-            code.append("assert (scale_bias);")
-            code.append("bio = wgt * scale_bias[2 * idx + 1];")
-            code.append("wgt = wgt * scale_bias[2 * idx];")
-        code.append("__m256 vbio = _mm256_set1_ps(bio);")
+    if InType in ("uint8_t", "uint4"):
+        code += scale_bias_code(
+            IndexType, OutType, fused, isa, check_scale_bias=True)
     else:
         code.append(OutType + " wgt = 1.f;")
         code.append("if (weights) {")
         code.append(
             "wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];")
         code.append("}")
-    code.append("__m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("{} vwgt = {}_set1_ps(wgt);".format(isa['vtype'], mm))
 
-    code.append("const {} *ip = &input[idx * fused_block_size];".format(InType))
+    code.append(
+        "const {} *ip = &input[idx * fused_block_size];".format(DataType))
     code.append(
         'const {} next_T0 = (dataInd < index_size - prefdist_T0)'
         ' ? (dataInd + prefdist_T0) : dataInd;'.format(IndexType)
@@ -219,12 +341,12 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused):
         "CAFFE_ENFORCE(idx_pref_T0 >= 0 && idx_pref_T0 < data_size);")
     code.append(
         "const {} *ip_next_T0 = &input[idx_pref_T0 * fused_block_size];".
-        format(InType)
+        format(DataType)
     )
 
     # compute and store main loop
     code.append("j = 0;")
-    code.append("for(; j + 8 <= block_size; j += 8) {")
+    code.append("for(; j + %d <= block_size; j += %d) {" % (width, width))
     code.extend(compute(InType, use_weights, isa))
     code.append("}")
     # leftover
@@ -239,6 +361,10 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused):
         code.append("op[j] += wgt * ((float*)(&vtmp2))[0];")
     elif InType == "uint8_t":
         code.append("op[j] += wgt * ((float)ip[j]) + bio;")
+    elif InType == "uint4":
+        code.append(
+            "op[j] += wgt * ((float)((ip[j / 2] >> ((j & 1) * 4)) & 0xF))"
+            " + bio;")
     else:
         assert False
 
@@ -248,11 +374,13 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused):
 
     code.append("if (normalize_by_lengths && lengths[rangeIndex]) {")
     code.append("float len_inv = 1.0f / lengths[rangeIndex];")
-    code.append("__m256 vlen_inv = _mm256_set1_ps(len_inv);")
+    code.append(
+        "{} vlen_inv = {}_set1_ps(len_inv);".format(isa['vtype'], mm))
     code.append("j = 0;")
-    code.append("for(; j + 8 <= block_size; j += 8) {")
+    code.append("for(; j + %d <= block_size; j += %d) {" % (width, width))
     code.append(
-        "_mm256_storeu_ps(&op[j], _mm256_mul_ps(_mm256_loadu_ps(&op[j]), vlen_inv));")
+        "%s_storeu_ps(&op[j], %s_mul_ps(%s_loadu_ps(&op[j]), vlen_inv));"
+        % (mm, mm, mm))
     code.append("}")
     code.append("for(; j < block_size; j++) {")
     code.append("op[j] = len_inv * op[j];")
@@ -268,21 +396,35 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused):
 parser = argparse.ArgumentParser()
 parser.add_argument('-f', '--filename', help="file name")
 parser.add_argument('--fused', action='store_true')
+parser.add_argument(
+    '--bit-rate',
+    type=int,
+    choices=[4, 8],
+    default=8,
+    help="bits per value of the fused rowwise quantized data")
+parser.add_argument('--isa', choices=sorted(isa_params.keys()), default='avx2')
 opts = parser.parse_args()
+isa = isa_params[opts.isa]
+fused = opts.bit_rate if opts.fused else 0
 if opts.filename:
     filename = opts.filename
 elif opts.fused:
-    filename = "embedding_lookup_fused_8bit_rowwise_avx2.cc"
+    filename = "embedding_lookup_fused_{}bit_rowwise_{}.cc".format(
+        opts.bit_rate, opts.isa)
 else:
-    filename = "embedding_lookup_avx2.cc"
+    filename = "embedding_lookup_{}.cc".format(opts.isa)
 fout = open(filename, 'w')
 
-options = [["int32_t", "float", "float"],
-           ["int64_t", "float", "float"],
-           ["int32_t", "float16", "float"],
-           ["int64_t", "float16", "float"],
-           ["int32_t", "uint8_t", "float"],
-           ["int64_t", "uint8_t", "float"]]
+if fused == 4:
+    options = [["int32_t", "uint4", "float"],
+               ["int64_t", "uint4", "float"]]
+else:
+    options = [["int32_t", "float", "float"],
+               ["int64_t", "float", "float"],
+               ["int32_t", "float16", "float"],
+               ["int64_t", "float16", "float"],
+               ["int32_t", "uint8_t", "float"],
+               ["int64_t", "uint8_t", "float"]]
 
 code = []
 # includes
@@ -299,15 +441,19 @@ code.append("#include <immintrin.h>")
 code.append("\n")
 
 code.append("namespace caffe2 {\n")
+if fused == 4:
+    code += load_4bit_helper(isa)
+    code.append("\n")
 for o in options:
     [IndexType, InType, OutType] = o
+    DataType = "uint8_t" if InType == "uint4" else InType
 
-    prefix = 'Fused8BitRowwise' if opts.fused else ''
+    prefix = 'Fused{}BitRowwise'.format(fused) if fused else ''
     code.append('template <bool IS_WEIGHT_POSITIONAL>')
     fn_base = '{}EmbeddingLookup_{}_{}_{}'.format(
-        prefix, IndexType, InType, OutType
+        prefix, IndexType, DataType, OutType
     )
-    suffix = '__avx2_fma'
+    suffix = isa['suffix']
     fn = "static void " + fn_base + suffix
     code.append(fn + "(")
 
@@ -316,28 +462,33 @@ for o in options:
     args.append("const TIndex output_size,")
     args.append("const TIndex index_size,")
     args.append("const TIndex data_size,")
-    args.append("const " + InType + "* input,")
+    args.append("const " + DataType + "* input,")
     args.append("const " + IndexType + "* indices,")
     args.append("const int* lengths,")
     args.append("const float* weights,")
-    if not opts.fused:
+    if not fused:
         args.append("const float* scale_bias,")
     args.append("bool normalize_by_lengths,")
     args.append(OutType + "* out)")
     code += args
 
     code.append("{")
-    code.append("const " + IndexType + " prefdist_T0 = 16;")
     # block_size is the number of elements and fused_block_size is the size of
     # an entire row, including scale and bias.
-    offset = (8 // sizeof[InType]) if opts.fused else 0
-    code.append(
-        "const {} fused_block_size = block_size + {};".
-        format(IndexType, offset)
-    )
+    if fused == 4:
+        code.append(
+            "const {} fused_block_size = (block_size + 1) / 2 + 8;".
+            format(IndexType)
+        )
+    else:
+        offset = (8 // sizeof[InType]) if fused else 0
+        code.append(
+            "const {} fused_block_size = block_size + {};".
+            format(IndexType, offset)
+        )
 
     #code.append("printf(\"calling " + fn + "\\n\");");
-    if not opts.fused:
+    if not fused:
         if InType != "uint8_t":
             code.append(
                 'CAFFE_ENFORCE(scale_bias == nullptr,'
@@ -349,17 +500,17 @@ for o in options:
                 ' "scale_bias must not be nullptr");'
             )
 
-    code.append("if (block_size == 128) {")
-    code += unroll(16, IndexType, InType, OutType, True, "AVX2", opts.fused)
-    code.append("} else if (block_size == 64) {")
-    code += unroll(8, IndexType, InType, OutType, True, "AVX2", opts.fused)
-    code.append("} else if (block_size == 32) {")
-    code += unroll(4, IndexType, InType, OutType, True, "AVX2", opts.fused)
-    code.append("} else if (block_size == 16) {")
-    code += unroll(2, IndexType, InType, OutType, True, "AVX2", opts.fused)
+    for i, block_size in enumerate([128, 64, 32, 16]):
+        if i == 0:
+            code.append("if (block_size == %d) {" % block_size)
+        else:
+            code.append("} else if (block_size == %d) {" % block_size)
+        code += unroll(
+            block_size // isa['width'], IndexType, InType, OutType, True, isa,
+            fused, prefetch_distance(row_bytes(InType, block_size, fused)))
     code.append("} else {")
     code.append("// generic code")
-    code += generic(IndexType, InType, OutType, True, "AVX2", opts.fused)
+    code += generic(IndexType, InType, OutType, True, isa, fused, 16)
     code.append("}")
 
     code.append("}")
@@ -378,7 +529,7 @@ for o in options:
         code.append("indices,")
         code.append("lengths,")
         code.append("weights,")
-        if not opts.fused:
+        if not fused:
             code.append("scale_bias,")
         code.append("normalize_by_lengths,")
         code.append("out);")
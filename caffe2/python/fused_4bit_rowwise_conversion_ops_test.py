@@ -0,0 +1,94 @@
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+from __future__ import unicode_literals
+
+from caffe2.python import core, workspace
+import caffe2.python.hypothesis_test_util as hu
+
+import numpy as np
+from hypothesis import given
+
+# Eigen/Python round 0.5 away from 0, Numpy rounds to even
+round_to_nearest = np.vectorize(round)
+
+
+def fused_rowwise_4bit_quantize_reference(data):
+    minimum = np.min(data, axis=1, keepdims=True)
+    maximum = np.max(data, axis=1, keepdims=True)
+    span = maximum - minimum
+    bias = minimum
+    scale = span / 15.0
+    inverse_scale = 15.0 / (span + 1e-8)
+    quantized_data = np.minimum(
+        round_to_nearest((data - bias) * inverse_scale), 15
+    ).astype(np.uint8)
+    if quantized_data.shape[1] % 2:
+        quantized_data = np.pad(
+            quantized_data, ((0, 0), (0, 1)), 'constant'
+        )
+    packed_data = quantized_data[:, ::2] | (quantized_data[:, 1::2] << 4)
+    scale_bytes = scale.astype(np.float32).reshape(-1, 1).view(np.uint8)
+    bias_bytes = bias.astype(np.float32).reshape(-1, 1).view(np.uint8)
+    return np.concatenate([packed_data, scale_bytes, bias_bytes], axis=1)
+
+
+def fused_rowwise_4bit_quantize_dequantize_reference(data):
+    fused_quantized = fused_rowwise_4bit_quantize_reference(data)
+    scale = fused_quantized[:, -8:-4].copy().view(np.float32)
+    bias = fused_quantized[:, -4:].copy().view(np.float32)
+    packed_data = fused_quantized[:, :-8]
+    quantized_data = np.empty(
+        [packed_data.shape[0], packed_data.shape[1] * 2], dtype=np.uint8
+    )
+    quantized_data[:, ::2] = packed_data & 0xF
+    quantized_data[:, 1::2] = packed_data >> 4
+    quantized_data = quantized_data[:, :data.shape[1]]
+    return quantized_data * scale + bias
+
+
+class TestFused4BitRowwiseQuantizationConversion(hu.HypothesisTestCase):
+    @given(input_data=hu.tensor(min_dim=2, max_dim=2))
+    def test_quantize_op(self, input_data):
+        quantize = core.CreateOperator(
+            'FloatToFused4BitRowwiseQuantized',
+            ['input_data'],
+            ['quantized_data'],
+        )
+        workspace.FeedBlob('input_data', input_data)
+        workspace.RunOperatorOnce(quantize)
+
+        quantized_data = workspace.FetchBlob('quantized_data')
+
+        reference = fused_rowwise_4bit_quantize_reference(
+            input_data.astype(np.float32)
+        )
+        np.testing.assert_array_almost_equal(quantized_data, reference)
+
+    @given(input_data=hu.tensor(min_dim=2, max_dim=2))
+    def test_quantize_and_dequantize_op(self, input_data):
+        quantize = core.CreateOperator(
+            'FloatToFused4BitRowwiseQuantized',
+            ['input_data'],
+            ['quantized_data'],
+        )
+        workspace.FeedBlob('input_data', input_data)
+        workspace.RunOperatorOnce(quantize)
+
+        quantized_data = workspace.FetchBlob('quantized_data')
+
+        dequantize = core.CreateOperator(
+            'Fused4BitRowwiseQuantizedToFloat',
+            ['quantized_data'],
+            ['dequantized_data'],
+            columns=input_data.shape[1],
+        )
+        workspace.FeedBlob('quantized_data', quantized_data)
+        workspace.RunOperatorOnce(dequantize)
+
+        dequantized_data = workspace.FetchBlob('dequantized_data')
+
+        reference = fused_rowwise_4bit_quantize_dequantize_reference(
+            input_data.astype(np.float32)
+        )
+        np.testing.assert_array_almost_equal(dequantized_data, reference)
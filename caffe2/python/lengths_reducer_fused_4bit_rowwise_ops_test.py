@@ -0,0 +1,67 @@
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+from __future__ import unicode_literals
+
+from caffe2.python import core, workspace
+import caffe2.python.hypothesis_test_util as hu
+
+import numpy as np
+from hypothesis import given
+import hypothesis.strategies as st
+
+
+class TestLengthsReducerOpsFused4BitRowwise(hu.HypothesisTestCase):
+    @given(
+        input_data=hu.tensor(min_dim=2, max_dim=2),
+        reducer=st.sampled_from(['Sum', 'WeightedSum', 'Mean']),
+        seed=st.integers(0, 2**32 - 1),
+    )
+    def test_sparse_lengths_reduce(self, input_data, reducer, seed):
+        net = core.Net("bench")
+
+        np.random.seed(seed)
+
+        input_data = input_data.astype(np.float32)
+        indices = np.random.randint(
+            low=0,
+            high=len(input_data),
+            size=[np.random.randint(len(input_data))],
+            dtype=np.int32
+        )
+        weights = np.random.uniform(size=[len(indices)]).astype(np.float32)
+        lengths_split = np.clip(1, len(indices) // 2, 10)
+        lengths = np.ones(
+            [len(indices) // lengths_split], dtype=np.int32
+        ) * lengths_split
+        columns = input_data.shape[1]
+
+        quantized_data = net.FloatToFused4BitRowwiseQuantized(
+            'input_data', 'quantized_data'
+        )
+        dequantized_data = net.Fused4BitRowwiseQuantizedToFloat(
+            quantized_data, 'dequantized_data', columns=columns
+        )
+
+        inputs = ['indices', 'lengths']
+        if reducer == 'WeightedSum':
+            inputs = ['weights'] + inputs
+        getattr(net, 'SparseLengths' + reducer)(
+            [dequantized_data] + inputs, 'reference'
+        )
+        getattr(net, 'SparseLengths' + reducer + 'Fused4BitRowwise')(
+            [quantized_data] + inputs, 'quantized', columns=columns
+        )
+
+        workspace.FeedBlob('input_data', input_data)
+        workspace.FeedBlob('weights', weights)
+        workspace.FeedBlob('indices', indices)
+        workspace.FeedBlob('lengths', lengths)
+
+        workspace.GlobalInit(['caffe2', '--caffe2_log_level=0'])
+        workspace.CreateNet(net)
+        workspace.RunNetOnce(net)
+
+        reference = workspace.FetchBlob('reference')
+        quantized = workspace.FetchBlob('quantized')
+        np.testing.assert_array_almost_equal(reference, quantized, decimal=4)
@@ -62,6 +62,56 @@ class TestTextFileReader(TestCase):
                         else:
                             np.testing.assert_array_equal(col_batch, results[i])
 
+    def test_text_file_reader_parallel(self):
+        schema = Struct(
+            ('field1', Scalar(dtype=str)),
+            ('field2', Scalar(dtype=np.float32)))
+        num_fields = 2
+        num_rows = 50
+        col_data = [
+            ['l{}f1'.format(i) for i in range(num_rows)],
+            [i * 0.25 - 3 for i in range(num_rows)],
+        ]
+        row_data = list(zip(*col_data))
+        with tempfile.NamedTemporaryFile(mode='w+', delete=False) as txt_file:
+            txt_file.write(
+                '\n'.join(
+                    '\t'.join(str(x) for x in f)
+                    for f in row_data
+                ) + '\n'
+            )
+            txt_file.flush()
+
+            # The file is memory mapped and small chunks split it between rows
+            for num_threads, chunk_size in [(2, 1 << 22), (3, 8), (4, 64)]:
+                for batch_size in [1, 7, num_rows + 1]:
+                    init_net = core.Net('init_net')
+                    reader = TextFileReader(
+                        init_net,
+                        filename=txt_file.name,
+                        schema=schema,
+                        batch_size=batch_size,
+                        num_passes=2,
+                        num_threads=num_threads,
+                        chunk_size=chunk_size)
+                    workspace.RunNetOnce(init_net)
+
+                    net = core.Net('read_net')
+                    should_stop, record = reader.read_record(net)
+
+                    results = [np.array([])] * num_fields
+                    while True:
+                        workspace.RunNetOnce(net)
+                        arrays = FetchRecord(record).field_blobs()
+                        for i in range(num_fields):
+                            results[i] = np.append(results[i], arrays[i])
+                        if workspace.FetchBlob(should_stop):
+                            break
+                    np.testing.assert_array_equal(
+                        np.tile(col_data[0], 2), results[0])
+                    np.testing.assert_array_almost_equal(
+                        np.tile(col_data[1], 2), results[1], decimal=3)
+
 if __name__ == "__main__":
     import unittest
     unittest.main()
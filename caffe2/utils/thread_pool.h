@@ -13,7 +13,22 @@
 
 namespace caffe2 {
 
-class TaskThreadPool {
+// Interface of the pools that async nets schedule their tasks on.
+class TaskThreadPoolBase {
+ public:
+  virtual void run(const std::function<void()>& func) = 0;
+
+  virtual size_t size() const = 0;
+
+  /**
+   * The number of available (i.e. idle) threads in this thread pool.
+   */
+  virtual size_t num_available() const = 0;
+
+  virtual ~TaskThreadPoolBase() noexcept {}
+};
+
+class TaskThreadPool : public TaskThreadPoolBase {
  private:
   struct task_element_t {
     bool run_with_id;
@@ -51,7 +66,7 @@ class TaskThreadPool {
   }
 
   // Set running flag to false then notify all threads.
-  ~TaskThreadPool() {
+  ~TaskThreadPool() override {
     {
       std::unique_lock<std::mutex> lock(mutex_);
       running_ = false;
@@ -66,14 +81,11 @@ class TaskThreadPool {
     }
   }
 
-  size_t size() const {
+  size_t size() const override {
     return threads_.size();
   }
 
-  /**
-   * The number of available (i.e. idle) threads in this thread pool.
-   */
-  size_t num_available() const {
+  size_t num_available() const override {
     return available_;
   }
 
@@ -89,7 +101,7 @@ class TaskThreadPool {
     condition_.notify_one();
   }
 
-  void run(const std::function<void()>& func) {
+  void run(const std::function<void()>& func) override {
     runTask(func);
   }
 
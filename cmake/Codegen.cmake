@@ -87,6 +87,18 @@ if (BUILD_ATEN)
     ENDIF(MSVC)
   ENDIF(CXX_AVX2_FOUND)
 
+  # The AVX512 kernels fall back to AVX2 instructions for the types and
+  # operations that AVX512F doesn't cover, so they need AVX2 as well.
+  IF(CXX_AVX2_FOUND AND CAFFE2_COMPILER_SUPPORTS_AVX512_EXTENSIONS)
+    SET(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DHAVE_AVX512_CPU_DEFINITION")
+    LIST(APPEND CPU_CAPABILITY_NAMES "AVX512")
+    IF(MSVC)
+      LIST(APPEND CPU_CAPABILITY_FLAGS "${MSVC_OPT_FLAG}/arch:AVX512")
+    ELSE(MSVC)
+      LIST(APPEND CPU_CAPABILITY_FLAGS "-O3 -mavx512f -mavx2 -mfma")
+    ENDIF(MSVC)
+  ENDIF()
+
   list(LENGTH CPU_CAPABILITY_NAMES NUM_CPU_CAPABILITY_NAMES)
   math(EXPR NUM_CPU_CAPABILITY_NAMES "${NUM_CPU_CAPABILITY_NAMES}-1")
 
@@ -149,6 +149,28 @@ if (CAFFE2_COMPILER_SUPPORTS_AVX2_EXTENSIONS)
 endif()
 cmake_pop_check_state()
 
+# ---[ Check if the compiler has AVX512F support. The AVX512 perfkernels also
+# use AVX2, FMA and F16C instructions for their leftover loops.
+cmake_push_check_state(RESET)
+if (MSVC)
+  set(CMAKE_REQUIRED_FLAGS "/arch:AVX512")
+else()
+  set(CMAKE_REQUIRED_FLAGS "-mavx512f -mavx2 -mfma -mf16c")
+endif()
+CHECK_CXX_SOURCE_COMPILES(
+    "#include <immintrin.h>
+     int main() {
+       __m512 a = _mm512_set1_ps(1.f);
+       __m512i b = _mm512_cvtepu8_epi32(_mm_set1_epi8(1));
+       a = _mm512_fmadd_ps(a, _mm512_cvtepi32_ps(b), a);
+       return 0;
+     }" CAFFE2_COMPILER_SUPPORTS_AVX512_EXTENSIONS)
+if (CAFFE2_COMPILER_SUPPORTS_AVX512_EXTENSIONS AND CAFFE2_PERF_WITH_AVX2)
+  message(STATUS "Current compiler supports avx512f extention. Will build avx512 perfkernels.")
+  set(CAFFE2_PERF_WITH_AVX512 1)
+endif()
+cmake_pop_check_state()
+
 # ---[ Checks if compiler supports -fvisibility=hidden
 check_cxx_compiler_flag("-fvisibility=hidden" COMPILER_SUPPORTS_HIDDEN_VISIBILITY)
 check_cxx_compiler_flag("-fvisibility-inlines-hidden" COMPILER_SUPPORTS_HIDDEN_INLINE_VISIBILITY)
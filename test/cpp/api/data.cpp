@@ -0,0 +1,126 @@
+#include <catch.hpp>
+
+#include <torch/data.h>
+#include <torch/tensor.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+using namespace torch::data;
+
+namespace {
+struct IndexDataset : Dataset<> {
+  explicit IndexDataset(size_t size) : size_(size) {}
+
+  Example get(size_t index) const override {
+    return {torch::full({2}, static_cast<double>(index)),
+            torch::full({}, static_cast<double>(index))};
+  }
+
+  size_t size() const override {
+    return size_;
+  }
+
+  size_t size_;
+};
+
+struct FailingDataset : IndexDataset {
+  using IndexDataset::IndexDataset;
+
+  Example get(size_t index) const override {
+    if (index == 5) {
+      throw std::runtime_error("bad example");
+    }
+    return IndexDataset::get(index);
+  }
+};
+
+template <typename Loader>
+std::vector<int64_t> collect_targets(Loader& loader) {
+  std::vector<int64_t> targets;
+  for (auto& batch : loader) {
+    for (int64_t i = 0; i < batch.target.size(0); ++i) {
+      targets.push_back(batch.target[i].toCLong());
+    }
+  }
+  return targets;
+}
+} // namespace
+
+TEST_CASE("data/samplers") {
+  SECTION("sequential sampler") {
+    SequentialSampler sampler(5);
+    REQUIRE(*sampler.next(2) == std::vector<size_t>({0, 1}));
+    REQUIRE(*sampler.next(2) == std::vector<size_t>({2, 3}));
+    REQUIRE(*sampler.next(2) == std::vector<size_t>({4}));
+    REQUIRE(!sampler.next(2));
+    sampler.reset();
+    REQUIRE(*sampler.next(5) == std::vector<size_t>({0, 1, 2, 3, 4}));
+  }
+  SECTION("random sampler is a seeded permutation") {
+    RandomSampler a(100, /*seed=*/3), b(100, /*seed=*/3);
+    auto indices = *a.next(100);
+    REQUIRE(indices == *b.next(100));
+    std::vector<bool> seen(100, false);
+    for (auto index : indices) {
+      seen.at(index) = true;
+    }
+    REQUIRE(std::all_of(seen.begin(), seen.end(), [](bool s) { return s; }));
+  }
+}
+
+TEST_CASE("data/dataloader") {
+  SECTION("collates batches") {
+    DataLoader<IndexDataset> loader(
+        IndexDataset(10), SequentialSampler(10), DataLoaderOptions(4));
+    auto batch = loader.next();
+    REQUIRE(batch);
+    REQUIRE(batch->data.sizes().vec() == std::vector<int64_t>({4, 2}));
+    REQUIRE(batch->target.sizes().vec() == std::vector<int64_t>({4}));
+  }
+  SECTION("drop_last") {
+    DataLoader<IndexDataset> loader(
+        IndexDataset(10),
+        SequentialSampler(10),
+        DataLoaderOptions(4).drop_last(true));
+    REQUIRE(collect_targets(loader).size() == 8);
+  }
+  SECTION("ordering does not depend on the number of workers") {
+    std::vector<int64_t> expected;
+    for (size_t workers : {0, 1, 4}) {
+      DataLoader<IndexDataset, RandomSampler> loader(
+          IndexDataset(100),
+          RandomSampler(100, /*seed=*/7),
+          DataLoaderOptions(3).workers(workers));
+      auto targets = collect_targets(loader);
+      REQUIRE(targets.size() == 100);
+      if (expected.empty()) {
+        expected = targets;
+      } else {
+        REQUIRE(targets == expected);
+      }
+    }
+  }
+  SECTION("reset discards prefetched batches") {
+    DataLoader<IndexDataset> loader(
+        IndexDataset(20),
+        SequentialSampler(20),
+        DataLoaderOptions(2).workers(2).max_jobs(4));
+    loader.next();
+    loader.next();
+    loader.reset();
+    auto batch = loader.next();
+    REQUIRE(batch->target[0].toCLong() == 0);
+  }
+  SECTION("worker exceptions are rethrown") {
+    DataLoader<FailingDataset> loader(
+        FailingDataset(10),
+        SequentialSampler(10),
+        DataLoaderOptions(2).workers(2));
+    REQUIRE(loader.next());
+    REQUIRE(loader.next());
+    REQUIRE_THROWS_WITH(loader.next(), "bad example");
+  }
+}
@@ -6,10 +6,14 @@
 #include <torch/tensor.h>
 #include <torch/utils.h>
 
+#include <torch/csrc/autograd/engine.h>
 #include <torch/csrc/utils/memory.h>
 
 #include <ATen/optional.h>
 
+#include <thread>
+#include <vector>
+
 using namespace torch::nn;
 
 template <typename T>
@@ -49,6 +53,62 @@ TEST_CASE("autograd") {
   // Assume everything else is safe from PyTorch tests.
 }
 
+TEST_CASE("autograd/multithreaded-cpu") {
+  // The default engine is shared by all tests, so restore its thread count
+  struct NumCPUThreadsGuard {
+    explicit NumCPUThreadsGuard(torch::autograd::Engine& engine)
+        : engine(engine), previous(engine.num_cpu_threads()) {}
+    ~NumCPUThreadsGuard() {
+      engine.set_num_cpu_threads(previous);
+    }
+    torch::autograd::Engine& engine;
+    int previous;
+  };
+
+  auto& engine = torch::autograd::Engine::get_default_engine();
+  NumCPUThreadsGuard threads_guard(engine);
+  engine.set_num_cpu_threads(4);
+  REQUIRE(engine.num_cpu_threads() == 4);
+
+  torch::manual_seed(0);
+  auto x = torch::randn({8, 8}, torch::requires_grad());
+  SECTION("independent branches") {
+    auto loss = torch::zeros({});
+    for (int i = 1; i <= 16; ++i) {
+      loss = loss + (x * i).tanh().sum();
+    }
+    loss.backward();
+
+    torch::NoGradGuard guard;
+    auto expected = torch::zeros({8, 8});
+    for (int i = 1; i <= 16; ++i) {
+      expected += (1 - (x * i).tanh().pow(2)) * i;
+    }
+    REQUIRE(x.grad().allclose(expected));
+  }
+  SECTION("concurrent backward calls into the same leaf") {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&x] {
+        for (int i = 0; i < 10; ++i) {
+          (x * 2).sum().backward();
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    REQUIRE(x.grad().allclose(torch::full({8, 8}, 80)));
+  }
+  SECTION("lowering the number of threads") {
+    (x * 2).sum().backward();
+    engine.set_num_cpu_threads(1);
+    REQUIRE(engine.num_cpu_threads() == 1);
+    (x * 3).sum().backward();
+    REQUIRE(x.grad().allclose(torch::full({8, 8}, 5)));
+  }
+}
+
 TEST_CASE("expanding-array") {
   torch::manual_seed(0);
   SECTION("successful construction") {
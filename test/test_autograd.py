@@ -2,6 +2,7 @@ import contextlib
 import gc
 import sys
 import math
+import tempfile
 import torch
 import unittest
 import warnings
@@ -12,7 +13,7 @@ from operator import mul, itemgetter
 from functools import reduce, wraps
 from torch.autograd.gradcheck import gradgradcheck, gradcheck
 from torch.autograd.function import once_differentiable
-from torch.autograd.profiler import profile
+from torch.autograd.profiler import profile, sampled_profile
 from common import TEST_MKL, TestCase, run_tests, skipIfNoLapack, \
     suppress_warnings, skipIfNoZeroSize
 from torch.autograd import Variable, Function, detect_anomaly
@@ -2054,6 +2055,43 @@ class TestAutograd(TestCase):
             self.assertEqual(info.name, expected_name)
             last_end = info.cpu_interval.end
 
+    def test_sampled_profiler(self):
+        import json
+        x = torch.randn(10, 10)
+
+        with sampled_profile(period=1, buffer_size=4) as p:
+            y = x * 2 + 4
+        stats = {op.name: op for op in p.op_stats()}
+        self.assertEqual(stats['mul'].count, 1)
+        self.assertEqual(stats['add'].count, 1)
+        self.assertEqual(sum(stats['mul'].histogram), 1)
+
+        # Only the last buffer_size samples are kept
+        with sampled_profile(period=1, buffer_size=4) as p:
+            for _ in range(10):
+                y = x * 2
+        self.assertLessEqual(sum(op.count for op in p.op_stats()), 4)
+
+        with sampled_profile(period=5) as p:
+            for _ in range(100):
+                y = x * 2
+            # Samples can be read while profiling
+            self.assertEqual(p.op_stats()[0].count, 20)
+        with tempfile.NamedTemporaryFile(mode='w+') as f:
+            p.export_chrome_trace(f.name)
+            events = json.load(f)
+        self.assertEqual(len(events), 20)
+        self.assertEqual(events[0]['name'], 'mul')
+
+        # A new run counts from its own first range, whatever the period of
+        # the previous run was
+        with sampled_profile(period=1000):
+            y = x * 2
+        with sampled_profile(period=5) as p:
+            for _ in range(100):
+                y = x * 2
+        self.assertEqual(p.op_stats()[0].count, 20)
+
     def test_dir(self):
         x = torch.randn(10, 10)
         keys = dir(x)
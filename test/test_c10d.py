@@ -3,6 +3,7 @@ import multiprocessing
 import socket
 import sys
 import tempfile
+import threading
 import unittest
 from functools import wraps
 
@@ -49,6 +50,14 @@ class StoreTestBase(object):
     def test_set_get(self):
         self._test_set_get(self._create_store())
 
+    def _test_multi_set_get(self, fs):
+        fs.multi_set(["key0", "key1", "key2"], ["value0", "value1", "value2"])
+        self.assertEqual([b"value2", b"value0"], fs.multi_get(["key2", "key0"]))
+        self.assertEqual([], fs.multi_get([]))
+
+    def test_multi_set_get(self):
+        self._test_multi_set_get(self._create_store())
+
 
 class FileStoreTest(TestCase, StoreTestBase):
     def setUp(self):
@@ -67,6 +76,20 @@ class TCPStoreTest(TestCase, StoreTestBase):
         port = find_free_port()
         return c10d.TCPStore(addr, port, True)
 
+    def test_wait_partially_set(self):
+        addr = 'localhost'
+        port = find_free_port()
+        server_store = c10d.TCPStore(addr, port, True)
+        client_store = c10d.TCPStore(addr, port, False)
+        server_store.set("key0", "value0")
+        # Set the missing key once the server is waiting for it
+        timer = threading.Timer(0.1, client_store.set, ["key1", "value1"])
+        timer.start()
+        server_store.wait(["key0", "key1", "key0"])
+        timer.join()
+        self.assertEqual([b"value0", b"value1"],
+                         server_store.multi_get(["key0", "key1"]))
+
 
 class RendezvousTest(TestCase):
     def test_unknown_handler(self):
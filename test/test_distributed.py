@@ -510,6 +510,25 @@ class _DistTestBase(object):
             group, group_id, rank, dist.reduce_op.MAX, -1, 10, 10
         )
 
+    # Large enough for the TCP backend to use the ring algorithm, and not
+    # divisible by the number of processes
+    @unittest.skipIf(BACKEND == 'nccl', "Nccl does not support CPU tensors")
+    def test_all_reduce_large(self):
+        group, group_id, rank = self._init_global_test()
+        size = (1 << 20) + 7
+        for op, reduce_fn in [
+            (dist.reduce_op.SUM, torch.add),
+            (dist.reduce_op.MAX, torch.max),
+            (dist.reduce_op.MIN, torch.min),
+        ]:
+            inputs = [torch.arange(size).float().mul_(src + 1).remainder_(97)
+                      for src in group]
+            tensor = inputs[rank].clone()
+            dist.all_reduce(tensor, op, group_id)
+            self.assertEqual(tensor, reduce(reduce_fn, inputs))
+
+        self._barrier()
+
     @unittest.skipIf(BACKEND == 'nccl', "Nccl does not support newGroup")
     @skip_if_small_worldsize
     def test_all_reduce_group_sum(self):
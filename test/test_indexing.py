@@ -254,6 +254,41 @@ class TestIndexing(TestCase):
             self.assertEqual(x, x[0])
             self.assertEqual(len(w), 1)
 
+    def test_index_put_accumulate(self):
+        x = torch.zeros(4, 3)
+        idx = torch.tensor([0, 2, 0, 0])
+        x.index_put_((idx,), torch.ones(4, 3), accumulate=True)
+        self.assertEqual(x[:, 0].tolist(), [3, 0, 1, 0])
+        x.index_put_((idx, torch.tensor([1, 1, 1, 2])), torch.tensor(1.), accumulate=True)
+        self.assertEqual(x.tolist(), [[3, 5, 4], [0, 0, 0], [1, 2, 1], [0, 0, 0]])
+        y = torch.zeros(5, dtype=torch.long)
+        y.index_put_((torch.tensor([-1, 4, 1]),), torch.tensor([1, 2, 3]), accumulate=True)
+        self.assertEqual(y.tolist(), [0, 3, 0, 0, 3])
+
+    def test_index_non_contiguous(self):
+        # compares with indexing through an explicit linear index
+        x = torch.randn(5, 6, 7).permute(2, 0, 1)
+        i = torch.tensor([[0, -1], [3, 2]])
+        j = torch.tensor([1, 4])
+        for index in [(i,), (slice(None), i, j), (i, slice(None), j), (Ellipsis, j)]:
+            expected = x.contiguous()[index]
+            self.assertEqual(x[index], expected)
+            y = x.clone()
+            y[index] = 0
+            z = x.contiguous()
+            z[index] = 0
+            self.assertEqual(y, z)
+
+    def test_index_backward(self):
+        x = torch.randn(4, 3, 2, dtype=torch.double, requires_grad=True)
+        i = torch.tensor([0, 3, 0])
+        j = torch.tensor([2, 1, 2])
+        self.assertTrue(torch.autograd.gradcheck(lambda x: x[i, :, j], (x,)))
+        self.assertTrue(torch.autograd.gradgradcheck(lambda x: x[i, :, j], (x,)))
+        v = torch.randn(3, 1, dtype=torch.double, requires_grad=True)
+        self.assertTrue(torch.autograd.gradcheck(
+            lambda x, v: x.index_put((i,), v, accumulate=True), (x, v)))
+
 
 # The tests below are from NumPy test_indexing.py with some modifications to
 # make them compatible with PyTorch. It's licensed under the BDS license below:
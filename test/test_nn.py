@@ -2167,6 +2167,43 @@ class TestNN(NNTestCase):
             input = torch.empty(*shape, device=device, dtype=dtype).uniform_(0, 10)
             self.assertRaises(RuntimeError, lambda: gn(input))
 
+    def test_LayerNorm_GroupNorm_matches_reference(self):
+        # The fused CPU kernels are vectorized, use sizes with remainders
+        def reference(x, num_groups, weight, bias, eps):
+            shape = x.shape
+            x = x.contiguous().view(shape[0], num_groups, -1)
+            mean = x.mean(-1, keepdim=True)
+            var = (x - mean).pow(2).mean(-1, keepdim=True)
+            out = ((x - mean) / (var + eps).sqrt()).view(shape)
+            affine_shape = [1] + list(weight.shape) + [1] * (len(shape) - 1 - weight.dim())
+            return out * weight.view(affine_shape) + bias.view(affine_shape)
+
+        for dtype in [torch.float, torch.double]:
+            prec = 1e-4 if dtype == torch.float else 1e-10
+            for shape, num_groups in [((3, 37), 1), ((4, 3, 33), 3), ((2, 8, 5, 7), 4), ((2, 4, 64), 2)]:
+                x = torch.randn(*shape, dtype=dtype) * 3 + 10
+                grad = torch.randn(*shape, dtype=dtype)
+
+                c = shape[1]
+                gn = nn.GroupNorm(num_groups, c, eps=1e-5).to(dtype)
+                gn.weight.data.uniform_(0.5, 1.5)
+                gn.bias.data.uniform_(-1, 1)
+                ln = nn.LayerNorm(shape[1:], eps=1e-5).to(dtype)
+                ln.weight.data.uniform_(0.5, 1.5)
+                ln.bias.data.uniform_(-1, 1)
+
+                for module, groups in [(gn, num_groups), (ln, 1)]:
+                    params = [module.weight, module.bias]
+                    x_ = x.clone().requires_grad_()
+                    out = module(x_)
+                    grads = torch.autograd.grad(out, [x_] + params, grad)
+                    x_ = x.clone().requires_grad_()
+                    expected = reference(x_, groups, *params, eps=1e-5)
+                    expected_grads = torch.autograd.grad(expected, [x_] + params, grad)
+                    self.assertEqual(out, expected, prec)
+                    for g, e in zip(grads, expected_grads):
+                        self.assertEqual(g, e, prec * 10)
+
     def _test_GroupNorm_cuda_half(self):
         input = Variable(torch.empty(2, 3, 3, 2).to("cuda", torch.half).random_(1, 10), requires_grad=True)
         input = torch.zeros(2, 4, 3, 2, requires_grad=True).cuda().half().random_(1, 10)
@@ -440,6 +440,76 @@ class TestSparse(TestCase):
         test_shape(100, 1000, 200)
         test_shape(64, 10000, 300)
 
+    @cpu_only
+    def test_mm_csr_kernel(self):
+        def test_shape(di, dj, dk, nnz):
+            x, _, _ = self._gen_sparse(2, nnz, [di, dj])
+            t = torch.randn(di, dk)
+            alpha = random.random()
+            beta = random.random()
+
+            y = torch.randn(dj, dk)
+            res = torch.addmm(alpha, t, beta, x, y)
+            expected = torch.addmm(alpha, t, beta, self.safeToDense(x), y)
+            self.assertEqual(res, expected)
+
+            # Non-contiguous dense and result
+            y = torch.randn(dk, dj).t()
+            r = torch.zeros(dk, di).t()
+            torch.addmm(t, x, y, out=r)
+            expected = torch.addmm(t, self.safeToDense(x), y)
+            self.assertEqual(r, expected)
+
+        # dim_k covers the matrix-vector path and the vectorized blocks and
+        # tails of the contiguous path
+        for dk in [1, 3, 4, 17, 64, 67]:
+            test_shape(50, 30, dk, 200)
+        test_shape(5, 5, 8, 0)
+        test_shape(2000, 100, 16, 40000)
+
+    @cpu_only
+    def test_mm_power_law_rows(self):
+        # A few rows hold most of the nonzeros
+        di, dj, dk = 1000, 200, 32
+        rows = (torch.rand(20000) ** 8 * di).long()
+        cols = (torch.rand(20000) * dj).long()
+        x = self.SparseTensor(torch.stack([rows, cols]), torch.randn(20000), torch.Size([di, dj]))
+        y = torch.randn(dj, dk)
+        self.assertEqual(torch.mm(x, y), torch.mm(self.safeToDense(x), y))
+
+    @cpu_only
+    def test_crow_indices(self):
+        x = self._gen_sparse(2, 50, [20, 10])[0].coalesce()
+        crow = x._crow_indices()
+        rows = x._indices()[0]
+        self.assertEqual(crow.size(), torch.Size([21]))
+        for h in range(20):
+            self.assertEqual(crow[h + 1] - crow[h], (rows == h).sum())
+        # Cached until the indices change
+        self.assertEqual(x._crow_indices().data_ptr(), crow.data_ptr())
+
+        self.assertRaises(RuntimeError, lambda: self._gen_sparse(3, 10, 5)[0].coalesce()._crow_indices())
+
+        y = torch._sparse_coo_tensor_from_csr(crow, x._indices()[1], x._values(), x.size())
+        self.assertTrue(y.is_coalesced())
+        self.assertEqual(y._indices(), x._indices())
+        self.assertEqual(y._values(), x._values())
+        self.assertEqual(y._crow_indices(), crow)
+
+        empty = torch._sparse_coo_tensor_from_csr(
+            torch.zeros(4).long(), torch.LongTensor(), torch.DoubleTensor(), torch.Size([3, 2]))
+        self.assertEqual(empty._nnz(), 0)
+        self.assertEqual(self.safeToDense(empty), torch.zeros(3, 2).double())
+
+        crow = torch.LongTensor([0, 2, 3])
+        self.assertRaises(RuntimeError, lambda: torch._sparse_coo_tensor_from_csr(
+            crow, torch.LongTensor([1, 0, 0]), torch.randn(3).double(), torch.Size([2, 2])))
+        self.assertRaises(RuntimeError, lambda: torch._sparse_coo_tensor_from_csr(
+            crow, torch.LongTensor([0, 2, 0]), torch.randn(3).double(), torch.Size([2, 2])))
+        self.assertRaises(RuntimeError, lambda: torch._sparse_coo_tensor_from_csr(
+            torch.LongTensor([0, 2, 4]), torch.LongTensor([0, 1, 0]), torch.randn(3).double(),
+            torch.Size([2, 2])))
+
     @cpu_only
     def test_saddmm(self):
         def test_shape(di, dj, dk):
@@ -858,6 +928,34 @@ class TestSparse(TestCase):
 
         self.assertFalse(z._indices().numel() != 2 and z.is_coalesced())
 
+    def test_coalesce_sorted_input(self):
+        # Increasing indices are coalesced without a copy, sorted indices
+        # with duplicates only have them merged
+        i = self.IndexTensor([[0, 1, 1, 4], [2, 0, 3, 1]])
+        v = self.ValueTensor([1, 2, 3, 4])
+        x = self.SparseTensor(i, v, torch.Size([5, 5]))
+        self.assertFalse(x.is_coalesced())
+        self.assertEqual(self.safeCoalesce(x)._nnz(), 4)
+
+        i = self.IndexTensor([[0, 1, 1, 1, 4, 4], [2, 0, 0, 3, 1, 1]])
+        v = self.ValueTensor([[1, 1], [2, 2], [3, 3], [4, 4], [5, 5], [6, 6]])
+        x = self.SparseTensor(i, v, torch.Size([5, 5, 2]))
+        y = self.safeCoalesce(x)
+        self.assertEqual(y._nnz(), 4)
+        self.assertEqual(y._values(), self.ValueTensor([[1, 1], [5, 5], [4, 4], [11, 11]]))
+
+    @cpu_only
+    def test_coalesce_large(self):
+        # Enough nonzeros to be split between threads, with duplicates
+        # straddling the chunks
+        for d, size in [(1, [50]), (2, [3000, 70]), (3, [7, 5000, 11])]:
+            x = self._gen_sparse(d, 200000, size)[0]
+            self.assertEqual(x.coalesce().to_dense(), x.to_dense())
+            i = x._indices().repeat(1, 2)
+            v = x._values().repeat(2)
+            y = self.SparseTensor(i, v, x.size())
+            self.assertEqual(y.coalesce(), x.coalesce() * 2)
+
     @cuda_only
     def test_storage_not_null(self):
         x = torch.cuda.sparse.FloatTensor(2)
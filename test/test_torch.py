@@ -13,6 +13,7 @@ import unittest
 import warnings
 import pickle
 import gzip
+import mmap
 from torch._utils_internal import get_file_path, get_file_path_2
 from torch.utils.dlpack import from_dlpack, to_dlpack
 from torch._utils import _rebuild_tensor
@@ -1730,6 +1731,25 @@ class TestTorch(TestCase):
         z = torch.Tensor((0, 3, 0, 2, 1))
         self.assertEqual(y, z)
 
+        # large inputs are split between threads
+        for dtype in [torch.float, torch.double]:
+            x = torch.randn(600000, dtype=dtype)[::2]
+            inside = x[(x >= -2) & (x <= 2)]
+            bins = ((inside + 2) / 4 * 50).long().clamp(max=49)
+            expected = torch.bincount(bins, minlength=50).to(dtype)
+            self.assertEqual(torch.histc(x, 50, -2, 2), expected)
+            # min == max uses the range of the input, ignoring NaNs
+            x = x.clamp(-1.5, 1.5)
+            x[0] = float('nan')
+            x[1] = -3
+            x[2] = 3
+            y = torch.histc(x, 6)
+            self.assertEqual(y.sum(), x.numel() - 1)
+            self.assertEqual(y[0], 1)
+            self.assertEqual(y[5], 1)
+        self.assertEqual(torch.histc(torch.tensor([1., 1.]), 2), torch.tensor([0., 2.]))
+        self.assertRaises(RuntimeError, lambda: torch.histc(torch.randn(3), 0))
+
     def test_ones(self):
         res1 = torch.ones(100, 100)
         res2 = torch.Tensor()
@@ -3165,6 +3185,50 @@ class TestTorch(TestCase):
         # input unchanged
         self.assertEqual(x, x0, 0)
 
+    def test_sort_large_slices(self):
+        # Slices long enough for the radix sort and for partitioning in topk,
+        # enough of them to be split over threads, and strided
+        for dtype in (torch.float, torch.double, torch.int, torch.long):
+            x = torch.randint(-100, 100, (3, 3000, 6)).to(dtype).transpose(1, 2)
+            if dtype.is_floating_point:
+                x[0, 0, ::7] = float('nan')
+            x0 = x.clone()
+            xc = x.contiguous()
+            n = x.size(-1)
+
+            for descending in (False, True):
+                values, indices = x.sort(-1, descending)
+                self.assertEqual(values, x.gather(-1, indices), 0)
+                # Ties keep their order in the input
+                ties = values[..., :-1].eq(values[..., 1:])
+                self.assertTrue((indices[..., :-1] < indices[..., 1:])[ties].all())
+                not_nan = values[..., :-1].eq(values[..., :-1]) & values[..., 1:].eq(values[..., 1:])
+                if descending:
+                    self.assertTrue(values[..., :-1].ge(values[..., 1:])[not_nan].all())
+                else:
+                    self.assertTrue(values[..., :-1].le(values[..., 1:])[not_nan].all())
+                self.assertEqual((values, indices), xc.sort(-1, descending), 0)
+
+                for k in (1, 10, 200, n // 2, n):
+                    self.assertEqual(x.topk(k, -1, descending), (values[..., :k], indices[..., :k]), 0)
+                    _, unsorted_indices = x.topk(k, -1, descending, False)
+                    self.assertEqual(unsorted_indices.sort(-1)[0], indices[..., :k].sort(-1)[0], 0)
+
+            values, indices = x.sort(-1)
+            for k in (1, 10, n // 2, n):
+                self.assertEqual(x.kthvalue(k, -1, True), (values[..., k - 1:k], indices[..., k - 1:k]), 0)
+            self.assertEqual(x.median(-1), (values[..., (n - 1) // 2], indices[..., (n - 1) // 2]), 0)
+
+            # The rows without NaNs
+            y = x[1:]
+            mode_values, mode_indices = y.mode(-1)
+            self.assertEqual(mode_values, y.gather(-1, mode_indices.unsqueeze(-1)).squeeze(-1), 0)
+            counts = (y == mode_values.unsqueeze(-1)).sum(-1)
+            for other in range(-100, 100):
+                self.assertTrue(counts.ge((y == other).sum(-1)).all())
+
+            self.assertEqual(x, x0, 0)
+
     def test_tril(self):
         x = torch.rand(SIZE, SIZE)
         res1 = torch.tril(x)
@@ -4593,6 +4657,58 @@ class TestTorch(TestCase):
         self.assertEqual(x, y)
         torch.set_rng_state(rng_state)
 
+    def test_random_independent_of_num_threads(self):
+        samplers = [
+            lambda: torch.rand(100003),
+            lambda: torch.randn(100003, dtype=torch.double),
+            lambda: torch.empty(100003).uniform_(-2, 3),
+            lambda: torch.empty(100003, dtype=torch.double).normal_(1, 2),
+            lambda: torch.empty(100003).bernoulli_(0.3),
+        ]
+        num_threads = torch.get_num_threads()
+        try:
+            for sample in samplers:
+                results = []
+                for threads in [1, 2, 3, 8]:
+                    torch.set_num_threads(threads)
+                    torch.manual_seed(123)
+                    results.append(sample())
+                for result in results[1:]:
+                    self.assertEqual(results[0], result, 0)
+        finally:
+            torch.set_num_threads(num_threads)
+
+    def test_random_non_contiguous(self):
+        torch.manual_seed(5)
+        expected = torch.empty(100, 200).normal_()
+        torch.manual_seed(5)
+        result = torch.empty(200, 100).t().normal_()
+        self.assertEqual(expected, result, 0)
+
+    def test_random_distributions(self):
+        torch.manual_seed(7)
+        x = torch.empty(1000000).uniform_(-2, 3)
+        self.assertGreaterEqual(x.min(), -2)
+        self.assertLess(x.max(), 3)
+        self.assertEqual(x.mean(), 0.5, 1e-2)
+        self.assertEqual(x.var(), 25. / 12, 2e-2)
+        x = torch.empty(1000000, dtype=torch.double).normal_(1, 2)
+        self.assertEqual(x.mean(), 1, 1e-2)
+        self.assertEqual(x.std(), 2, 1e-2)
+        x = torch.empty(1000000).bernoulli_(0.3)
+        self.assertEqual(x.mean(), 0.3, 1e-2)
+        self.assertEqual(torch.empty(1000).bernoulli_(0).sum(), 0)
+        self.assertEqual(torch.empty(1000).bernoulli_(1).sum(), 1000)
+
+    def test_RNGState_legacy(self):
+        # States saved before the Philox offset was added are one word shorter
+        torch.manual_seed(11)
+        state = torch.get_rng_state()
+        before = torch.rand(1000)
+        torch.set_rng_state(state[:-8])
+        after = torch.rand(1000)
+        self.assertEqual(before, after, 0)
+
     @skipIfNoLapack
     def test_cholesky(self):
         x = torch.rand(10, 10) + 1e-1
@@ -6495,6 +6611,32 @@ class TestTorch(TestCase):
             c = torch.load(f)
         self._test_serialization_assert(b, c)
 
+    def test_serialization_page_aligned(self):
+        b = self._test_serialization_data()
+        i = 41
+        with tempfile.NamedTemporaryFile() as f:
+            pickle.dump(i, f)
+            torch.save(b, f, page_aligned=True)
+            end = f.tell()
+            for use_mmap in (False, True):
+                if sys.platform == "win32" and use_mmap:
+                    continue
+                f.seek(0)
+                self.assertEqual(pickle.load(f), i)
+                c = torch.load(f, mmap=use_mmap)
+                self.assertEqual(f.tell(), end)
+                if use_mmap:
+                    self.assertEqual(c[0].data_ptr() % mmap.PAGESIZE, 0)
+                self._test_serialization_assert(b, c)
+            f.seek(0)
+            with BytesIOContext(f.read()) as buf:
+                pickle.load(buf)
+                c = torch.load(buf, mmap=True)
+            self._test_serialization_assert(b, c)
+
+        with BytesIOContext() as f:
+            self.assertRaises(ValueError, lambda: torch.save(b, f, page_aligned=True))
+
     def test_serialization_gzip(self):
         # Test serialization with gzip file
         b = self._test_serialization_data()
@@ -7633,6 +7775,56 @@ class TestTorch(TestCase):
         self.assertEqual(torch.ByteTensor([7, 42, 128, 133]), byte_unique)
         self.assertEqual(torch.LongTensor([3, 0, 0, 0, 1, 2]), byte_inverse)
 
+        x_unique, x_inverse, x_counts = torch.unique(
+            x, return_inverse=True, return_counts=True)
+        self.assertEqual(expected_unique, x_unique)
+        self.assertEqual(expected_inverse, x_inverse)
+        self.assertEqual(torch.LongTensor([1, 3, 2, 1, 1]), x_counts)
+
+        # Negative values, and negative zero is the same as zero
+        float_unique, float_counts = torch.unique(
+            torch.FloatTensor([-1., 0., -0., 3., -2.5, 3.]), return_counts=True)
+        self.assertEqual(torch.FloatTensor([-2.5, -1., 0., 3.]), float_unique)
+        self.assertEqual(torch.LongTensor([1, 1, 2, 2]), float_counts)
+
+        # Large enough to be split into several chunks
+        for dtype in [torch.long, torch.int, torch.float, torch.double]:
+            x = torch.randint(-1000, 1000, (300000,), dtype=dtype)
+            x_unique, x_inverse, x_counts = x.unique(return_inverse=True, return_counts=True)
+            expected_unique = torch.tensor(sorted(set(x.tolist())), dtype=dtype)
+            self.assertEqual(expected_unique, x_unique)
+            self.assertEqual(x, x_unique[x_inverse])
+            self.assertEqual(torch.bincount(x_inverse), x_counts)
+
+    def test_unique_dim(self):
+        x = torch.tensor([[1, 2, 1],
+                          [3, 2, 3],
+                          [1, 2, 1],
+                          [0, 5, 0]])
+        rows, inverse, counts = torch.unique(x, dim=0, return_inverse=True, return_counts=True)
+        self.assertEqual(torch.tensor([[0, 5, 0], [1, 2, 1], [3, 2, 3]]), rows)
+        self.assertEqual(torch.tensor([1, 2, 1, 0]), inverse)
+        self.assertEqual(torch.tensor([1, 2, 1]), counts)
+
+        columns, inverse = x.unique(dim=1, return_inverse=True)
+        self.assertEqual(torch.tensor([[1, 2], [3, 2], [1, 2], [0, 5]]), columns)
+        self.assertEqual(torch.tensor([0, 1, 0]), inverse)
+        self.assertEqual(columns, x.unique(dim=-1))
+
+        y = torch.randint(0, 3, (5000, 2, 2), dtype=torch.float)
+        y_unique, y_inverse, y_counts = y.unique(dim=0, return_inverse=True, return_counts=True)
+        self.assertEqual(y, y_unique[y_inverse])
+        self.assertEqual(torch.bincount(y_inverse), y_counts)
+        self.assertLessEqual(y_unique.size(0), 81)
+        self.assertEqual(y_unique.size()[1:], y.size()[1:])
+
+        empty = torch.empty(0, 3)
+        empty_unique, empty_inverse, empty_counts = empty.unique(
+            dim=0, return_inverse=True, return_counts=True)
+        self.assertEqual(empty_unique.size(), (0, 3))
+        self.assertEqual(empty_inverse.numel(), 0)
+        self.assertEqual(empty_counts.numel(), 0)
+
     @unittest.skipIf(not torch.cuda.is_available(), 'no CUDA')
     def test_unique_cuda(self):
         # unique currently does not support CUDA.
@@ -7698,6 +7890,13 @@ class TestTorch(TestCase):
         big_exp[1] = 1000000
         big_out = torch.ones(1000000, dtype=torch.int8, device=device).bincount()
         self.assertEqual(big_exp, big_out)
+        # test large input size with skewed, weighted input
+        big_in = (torch.rand(1000000, device=device) ** 4 * 10).long()
+        big_w = torch.rand(1000000, dtype=torch.double, device=device)
+        big_out = big_in.bincount(big_w, minlength=10)
+        self.assertEqual(big_out.size(), (10,))
+        for i in range(10):
+            self.assertEqual(big_out[i], big_w[big_in == i].sum())
 
     def test_bincount_cpu(self):
         self._test_bincount(self, device='cpu')
@@ -72,6 +72,8 @@ DONT_REQUIRE_DERIVATIVE = {
     'ones_like', 'zeros_like', 'rand_like', 'randn_like',
     # Tensor constructors
     'sparse_coo_tensor', 'th_sparse_coo_tensor', 'native_sparse_coo_tensor',
+    # Index tensors of sparse tensors
+    '_crow_indices',
     # These are only implemented on integral types
     '__and__', '__iand__', '__ilshift__', '__ior__', '__irshift__', '__ixor__',
     '__lshift__', '__or__', '__rshift__', '__xor__',
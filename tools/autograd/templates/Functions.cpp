@@ -1872,6 +1872,89 @@ std::tuple<Tensor, Tensor, Tensor> batchnorm_double_backward(
 
 }
 
+// Backward of the fused layer norm kernel. The kernel that computes it isn't
+// differentiable, so with grad mode enabled (create_graph=True) the same
+// gradients are computed from differentiable ops, recomputing the statistics
+// from the input.
+std::tuple<Tensor, Tensor, Tensor> layer_norm_backward(
+    const Tensor & grad,
+    const Tensor & input,
+    const Tensor & mean,
+    const Tensor & rstd,
+    const Tensor & weight,
+    int64_t M,
+    int64_t N,
+    double eps,
+    std::array<bool, 3> output_mask) {
+  if (!grad.defined()) {
+    return std::tuple<Tensor, Tensor, Tensor>();
+  }
+  if (!GradMode::is_enabled()) {
+    return at::_layer_norm_backward(grad, input, mean, rstd, weight, M, N, output_mask);
+  }
+  auto x_centered = input.contiguous().view({M, N});
+  x_centered = x_centered - x_centered.mean(1, true);
+  auto x_rstd = (x_centered.pow(2).mean(1, true) + eps).rsqrt();
+  auto x_hat = x_centered * x_rstd;
+  auto g = grad.contiguous().view({M, N});
+  auto g_w = weight.defined() ? g * weight : g;
+
+  Tensor grad_input, grad_weight, grad_bias;
+  if (output_mask[0]) {
+    grad_input = x_rstd * (g_w - g_w.mean(1, true) - x_hat * (g_w * x_hat).mean(1, true));
+    grad_input = grad_input.view(input.sizes());
+  }
+  if (output_mask[1] && weight.defined()) {
+    grad_weight = (g * x_hat).sum(0);
+  }
+  if (output_mask[2]) {
+    grad_bias = g.sum(0);
+  }
+  return std::tuple<Tensor, Tensor, Tensor>{grad_input, grad_weight, grad_bias};
+}
+
+// Same as layer_norm_backward, for the fused group norm kernel
+std::tuple<Tensor, Tensor, Tensor> group_norm_backward(
+    const Tensor & grad,
+    const Tensor & input,
+    const Tensor & mean,
+    const Tensor & rstd,
+    const Tensor & weight,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    double eps,
+    std::array<bool, 3> output_mask) {
+  if (!grad.defined()) {
+    return std::tuple<Tensor, Tensor, Tensor>();
+  }
+  if (!GradMode::is_enabled()) {
+    return at::_group_norm_backward(grad, input, mean, rstd, weight, N, C, HxW, group, output_mask);
+  }
+  const int64_t group_size = C / group * HxW;
+  auto x_centered = input.contiguous().view({N, group, group_size});
+  x_centered = x_centered - x_centered.mean(2, true);
+  auto x_rstd = (x_centered.pow(2).mean(2, true) + eps).rsqrt();
+  auto x_hat = x_centered * x_rstd;
+  auto g = grad.contiguous().view({N, C, HxW});
+  auto g_w = weight.defined() ? g * weight.view({1, C, 1}) : g;
+  g_w = g_w.view({N, group, group_size});
+
+  Tensor grad_input, grad_weight, grad_bias;
+  if (output_mask[0]) {
+    grad_input = x_rstd * (g_w - g_w.mean(2, true) - x_hat * (g_w * x_hat).mean(2, true));
+    grad_input = grad_input.view(input.sizes());
+  }
+  if (output_mask[1] && weight.defined()) {
+    grad_weight = (g * x_hat.view({N, C, HxW})).sum(2).sum(0);
+  }
+  if (output_mask[2]) {
+    grad_bias = g.sum(2).sum(0);
+  }
+  return std::tuple<Tensor, Tensor, Tensor>{grad_input, grad_weight, grad_bias};
+}
+
 std::tuple<Tensor, Tensor, Tensor> _trilinear_backward(const Tensor& grad_out, const Tensor& i1, const Tensor& i2, const Tensor& i3,
 						       IntList expand1, IntList expand2, IntList expand3,
 						       IntList sumdim, int64_t unroll_dim, std::array<bool, 3> grad_mask) {
@@ -222,6 +222,67 @@ class profile(object):
     total_average.__doc__ = EventList.total_average.__doc__
 
 
+class sampled_profile(object):
+    """Context manager that records one in ``period`` autograd operations of
+    every thread into a per-thread ring buffer.
+
+    Recording is cheap enough to leave enabled on serving hosts: operation
+    names are interned and samples are fixed-size records, so no memory is
+    allocated per operation. Only the last ``buffer_size`` samples of every
+    thread are kept. They can be exported at any time, also while the
+    profiler is enabled, and stay available after it is disabled until it is
+    enabled again.
+
+    Arguments:
+        period (int, optional): Record one in ``period`` operations.
+            Default: ``100``.
+        buffer_size (int, optional): Number of samples kept per thread.
+            Default: ``65536``.
+
+    Example:
+        >>> prof = torch.autograd.profiler.sampled_profile(period=10)
+        >>> prof.enable()
+        >>> ...  # serve requests
+        >>> for op in prof.op_stats():
+        ...     print(op.name, op.count, op.total_us / op.count)
+        >>> prof.export_chrome_trace('/tmp/trace.json')
+    """
+
+    def __init__(self, period=100, buffer_size=65536):
+        self.period = period
+        self.buffer_size = buffer_size
+
+    def enable(self):
+        torch.autograd._enable_sampled_profiler(self.period, self.buffer_size)
+
+    def disable(self):
+        torch.autograd._disable_profiler()
+
+    def __enter__(self):
+        self.enable()
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        self.disable()
+        return False
+
+    def export_chrome_trace(self, path):
+        """Writes the samples to ``path`` in the Chrome tracing format, see
+        :meth:`EventList.export_chrome_trace`."""
+        with open(path, 'w') as f:
+            f.write(torch.autograd._sampled_chrome_trace())
+
+    def op_stats(self):
+        """Aggregates the durations of the samples by operation, most frequent
+        first. Every entry has the fields ``name``, ``count``, ``total_us``,
+        ``max_us`` and ``histogram``, where ``histogram[0]`` counts samples
+        shorter than 1us and ``histogram[i]`` those of [2^(i-1), 2^i) us.
+        Counts are numbers of samples; multiply them by ``period`` to estimate
+        the number of calls.
+        """
+        return torch.autograd._sampled_op_stats()
+
+
 class emit_nvtx(object):
     """Context manager that makes every autograd operation emit an NVTX range.
 
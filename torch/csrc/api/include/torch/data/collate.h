@@ -0,0 +1,25 @@
+#pragma once
+
+#include <torch/data/example.h>
+#include <torch/tensor.h>
+
+#include <vector>
+
+namespace torch {
+namespace data {
+/// Collates a batch of examples by stacking their data and target tensors
+/// along a new first dimension.
+struct Stack {
+  Example operator()(const std::vector<Example>& examples) const {
+    std::vector<at::Tensor> data, targets;
+    data.reserve(examples.size());
+    targets.reserve(examples.size());
+    for (const auto& example : examples) {
+      data.push_back(example.data);
+      targets.push_back(example.target);
+    }
+    return {at::stack(data), at::stack(targets)};
+  }
+};
+} // namespace data
+} // namespace torch
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <torch/data/collate.h>
+#include <torch/data/detail/queue.h>
+#include <torch/data/example.h>
+#include <torch/data/samplers.h>
+#include <torch/nn/pimpl.h>
+#include <torch/tensor.h>
+
+#include <ATen/Error.h>
+#include <ATen/optional.h>
+
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace data {
+struct DataLoaderOptions {
+  /* implicit */ DataLoaderOptions(size_t batch_size)
+      : batch_size_(batch_size) {}
+
+  TORCH_ARG(size_t, batch_size);
+  /// Number of background threads that load and collate batches. With zero
+  /// workers, batches are produced on the calling thread.
+  TORCH_ARG(size_t, workers) = 0;
+  /// Maximum number of batches in flight; defaults to twice the number of
+  /// workers. This bounds the memory held by prefetched batches.
+  TORCH_ARG(at::optional<size_t>, max_jobs);
+  /// Drop the last batch of an epoch if it is smaller than `batch_size`.
+  TORCH_ARG(bool, drop_last) = false;
+  /// Copy every batch into page-locked memory so that host-to-device copies
+  /// can be asynchronous. Requires CUDA.
+  TORCH_ARG(bool, pin_memory) = false;
+  /// Return batches in sampler order even when workers finish them out of
+  /// order.
+  TORCH_ARG(bool, enforce_ordering) = true;
+};
+
+namespace detail {
+template <typename T>
+T pin_memory(const T&) {
+  AT_ERROR("pin_memory is not supported for this batch type");
+}
+
+inline Tensor pin_memory(const Tensor& tensor) {
+  return tensor.pin_memory();
+}
+
+inline Example pin_memory(const Example& example) {
+  return {example.data.pin_memory(), example.target.pin_memory()};
+}
+} // namespace detail
+
+/// Loads batches of examples from a dataset, in the order chosen by a
+/// sampler, optionally prefetching them on a pool of worker threads.
+///
+/// Example:
+///   DataLoader<TensorDataset, RandomSampler> loader(
+///       TensorDataset(inputs, targets),
+///       RandomSampler(inputs.size(0)),
+///       DataLoaderOptions(32).workers(4));
+///   for (auto& batch : loader) {
+///     ...
+///   }
+///
+/// Iterating the loader starts a new epoch.
+template <
+    typename DatasetType,
+    typename SamplerType = SequentialSampler,
+    typename CollationType = Stack>
+class DataLoader {
+ public:
+  using ExampleType = typename DatasetType::ExampleType;
+  using BatchType = typename std::result_of<CollationType(
+      const std::vector<ExampleType>&)>::type;
+
+  DataLoader(
+      DatasetType dataset,
+      SamplerType sampler,
+      DataLoaderOptions options,
+      CollationType collate = CollationType())
+      : dataset_(std::move(dataset)),
+        sampler_(std::move(sampler)),
+        collate_(std::move(collate)),
+        options_(std::move(options)),
+        max_jobs_(options_.max_jobs_.value_or(2 * options_.workers_)),
+        jobs_(max_jobs_ + options_.workers_),
+        results_(max_jobs_ + options_.workers_) {
+    AT_CHECK(options_.batch_size_ > 0, "batch_size must be positive");
+    AT_CHECK(
+        options_.workers_ == 0 || max_jobs_ > 0,
+        "max_jobs must be positive when using workers");
+    for (size_t w = 0; w < options_.workers_; ++w) {
+      workers_.emplace_back([this] { worker_thread(); });
+    }
+  }
+
+  DataLoader(const DataLoader&) = delete;
+  DataLoader& operator=(const DataLoader&) = delete;
+
+  ~DataLoader() {
+    jobs_.clear();
+    for (size_t w = 0; w < workers_.size(); ++w) {
+      jobs_.push(Job{});
+    }
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  /// Rewinds the sampler and discards every prefetched batch.
+  void reset() {
+    const size_t dropped = jobs_.clear();
+    in_flight_ -= dropped;
+    while (in_flight_ > 0) {
+      results_.pop();
+      in_flight_ -= 1;
+    }
+    reorder_buffer_.clear();
+    sampler_.reset();
+    next_sequence_ = 0;
+    expected_sequence_ = 0;
+    exhausted_ = false;
+  }
+
+  /// Returns the next batch of the current epoch, or `nullopt` once the epoch
+  /// is exhausted.
+  at::optional<BatchType> next() {
+    if (workers_.empty()) {
+      auto indices = next_indices();
+      if (!indices) {
+        return at::nullopt;
+      }
+      return load(*indices);
+    }
+    prefetch();
+    if (in_flight_ == 0 && reorder_buffer_.empty()) {
+      return at::nullopt;
+    }
+    Result result = next_result();
+    prefetch();
+    if (result.exception) {
+      std::rethrow_exception(result.exception);
+    }
+    return std::move(result.batch);
+  }
+
+  class Iterator;
+  Iterator begin() {
+    reset();
+    return Iterator(this);
+  }
+  Iterator end() {
+    return Iterator(nullptr);
+  }
+
+  const DataLoaderOptions& options() const noexcept {
+    return options_;
+  }
+
+ private:
+  struct Job {
+    // A job without indices tells the worker to quit.
+    Job() = default;
+    Job(std::vector<size_t> indices, size_t sequence)
+        : indices(std::move(indices)), sequence(sequence) {}
+
+    at::optional<std::vector<size_t>> indices;
+    size_t sequence{0};
+  };
+
+  struct Result {
+    at::optional<BatchType> batch;
+    std::exception_ptr exception;
+    size_t sequence{0};
+  };
+
+  at::optional<std::vector<size_t>> next_indices() {
+    if (exhausted_) {
+      return at::nullopt;
+    }
+    auto indices = sampler_.next(options_.batch_size_);
+    if (!indices ||
+        (options_.drop_last_ && indices->size() < options_.batch_size_)) {
+      exhausted_ = true;
+      return at::nullopt;
+    }
+    return indices;
+  }
+
+  BatchType load(const std::vector<size_t>& indices) const {
+    std::vector<ExampleType> examples;
+    examples.reserve(indices.size());
+    for (auto index : indices) {
+      examples.push_back(dataset_.get(index));
+    }
+    auto batch = collate_(examples);
+    if (options_.pin_memory_) {
+      batch = detail::pin_memory(batch);
+    }
+    return batch;
+  }
+
+  /// Keeps up to `max_jobs` batches in flight.
+  void prefetch() {
+    while (in_flight_ + reorder_buffer_.size() < max_jobs_) {
+      auto indices = next_indices();
+      if (!indices) {
+        break;
+      }
+      jobs_.push(Job(std::move(*indices), next_sequence_++));
+      in_flight_ += 1;
+    }
+  }
+
+  /// Returns the next result, in sampler order if `enforce_ordering` is set.
+  /// Results that arrive early are parked in `reorder_buffer_`.
+  Result next_result() {
+    if (!options_.enforce_ordering_) {
+      in_flight_ -= 1;
+      return results_.pop();
+    }
+    while (true) {
+      auto it = reorder_buffer_.find(expected_sequence_);
+      if (it != reorder_buffer_.end()) {
+        Result result = std::move(it->second);
+        reorder_buffer_.erase(it);
+        expected_sequence_ += 1;
+        return result;
+      }
+      Result result = results_.pop();
+      in_flight_ -= 1;
+      if (result.sequence == expected_sequence_) {
+        expected_sequence_ += 1;
+        return result;
+      }
+      reorder_buffer_.emplace(result.sequence, std::move(result));
+    }
+  }
+
+  void worker_thread() {
+    while (true) {
+      Job job = jobs_.pop();
+      if (!job.indices) {
+        return;
+      }
+      Result result;
+      result.sequence = job.sequence;
+      try {
+        result.batch = load(*job.indices);
+      } catch (...) {
+        result.exception = std::current_exception();
+      }
+      results_.push(std::move(result));
+    }
+  }
+
+  DatasetType dataset_;
+  SamplerType sampler_;
+  CollationType collate_;
+  DataLoaderOptions options_;
+  size_t max_jobs_;
+
+  detail::BoundedQueue<Job> jobs_;
+  detail::BoundedQueue<Result> results_;
+  std::vector<std::thread> workers_;
+
+  /// Jobs pushed to `jobs_` whose result has not been taken from `results_`.
+  size_t in_flight_{0};
+  std::map<size_t, Result> reorder_buffer_;
+  size_t next_sequence_{0};
+  size_t expected_sequence_{0};
+  bool exhausted_{false};
+};
+
+/// Single-pass input iterator over the batches of one epoch.
+template <typename DatasetType, typename SamplerType, typename CollationType>
+class DataLoader<DatasetType, SamplerType, CollationType>::Iterator
+    : public std::iterator<std::input_iterator_tag, BatchType> {
+ public:
+  explicit Iterator(DataLoader* loader) : loader_(loader) {
+    advance();
+  }
+
+  BatchType& operator*() {
+    return *batch_;
+  }
+  BatchType* operator->() {
+    return &*batch_;
+  }
+  Iterator& operator++() {
+    advance();
+    return *this;
+  }
+  bool operator==(const Iterator& other) const {
+    return loader_ == other.loader_;
+  }
+  bool operator!=(const Iterator& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  void advance() {
+    if (loader_ == nullptr) {
+      return;
+    }
+    batch_ = loader_->next();
+    if (!batch_) {
+      loader_ = nullptr;
+    }
+  }
+
+  DataLoader* loader_;
+  at::optional<BatchType> batch_;
+};
+} // namespace data
+} // namespace torch
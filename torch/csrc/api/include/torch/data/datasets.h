@@ -0,0 +1,58 @@
+#pragma once
+
+#include <torch/data/example.h>
+#include <torch/tensor.h>
+
+#include <ATen/Error.h>
+
+#include <cstddef>
+
+namespace torch {
+namespace data {
+/// A dataset provides random access to a fixed number of examples.
+///
+/// `get()` is called concurrently from the worker threads of a `DataLoader`,
+/// so implementations must be safe to call from multiple threads at once.
+template <typename ExampleType_ = Example>
+class Dataset {
+ public:
+  using ExampleType = ExampleType_;
+
+  virtual ~Dataset() = default;
+
+  /// Returns the example at the given index.
+  virtual ExampleType get(size_t index) const = 0;
+
+  /// Returns the number of examples in the dataset.
+  virtual size_t size() const = 0;
+};
+
+/// A dataset whose examples are the slices along the first dimension of a
+/// data and a target tensor.
+class TensorDataset : public Dataset<Example> {
+ public:
+  TensorDataset(Tensor data, Tensor target)
+      : data_(std::move(data)), target_(std::move(target)) {
+    AT_CHECK(
+        data_.size(0) == target_.size(0),
+        "TensorDataset: data and target must have the same size in "
+        "dimension 0, but got ",
+        data_.size(0),
+        " and ",
+        target_.size(0));
+  }
+
+  Example get(size_t index) const override {
+    return {data_[index], target_[index]};
+  }
+
+  size_t size() const override {
+    return data_.size(0);
+  }
+
+ private:
+  Tensor data_;
+  Tensor target_;
+};
+} // namespace data
+} // namespace torch
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <queue>
+
+namespace torch {
+namespace data {
+namespace detail {
+/// A FIFO queue that blocks consumers while it is empty and producers while
+/// it holds `capacity` elements.
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(size_t capacity) : capacity_(capacity) {}
+
+  void push(T value) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this] { return queue_.size() < capacity_; });
+    queue_.push(std::move(value));
+    lock.unlock();
+    not_empty_.notify_one();
+  }
+
+  T pop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this] { return !queue_.empty(); });
+    T value = std::move(queue_.front());
+    queue_.pop();
+    lock.unlock();
+    not_full_.notify_one();
+    return value;
+  }
+
+  /// Removes all queued elements and returns how many were dropped.
+  size_t clear() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const size_t size = queue_.size();
+    queue_ = std::queue<T>();
+    lock.unlock();
+    not_full_.notify_all();
+    return size;
+  }
+
+ private:
+  std::queue<T> queue_;
+  const size_t capacity_;
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+};
+} // namespace detail
+} // namespace data
+} // namespace torch
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <torch/tensor.h>
+
+namespace torch {
+namespace data {
+/// A single training example: an input and its target.
+struct Example {
+  Example() = default;
+  Example(Tensor data, Tensor target)
+      : data(std::move(data)), target(std::move(target)) {}
+
+  Tensor data;
+  Tensor target;
+};
+} // namespace data
+} // namespace torch
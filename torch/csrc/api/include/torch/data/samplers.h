@@ -0,0 +1,54 @@
+#pragma once
+
+#include <ATen/optional.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace torch {
+namespace data {
+/// A sampler decides the order in which the indices of a dataset are visited
+/// during one epoch.
+class Sampler {
+ public:
+  virtual ~Sampler() = default;
+
+  /// Rewinds the sampler to the start of a new epoch.
+  virtual void reset() = 0;
+
+  /// Returns the next `batch_size` indices, fewer at the end of the epoch, or
+  /// `nullopt` once the epoch is exhausted.
+  virtual at::optional<std::vector<size_t>> next(size_t batch_size) = 0;
+};
+
+/// Visits the indices `0, 1, ..., size - 1` in order.
+class SequentialSampler : public Sampler {
+ public:
+  explicit SequentialSampler(size_t size);
+
+  void reset() override;
+  at::optional<std::vector<size_t>> next(size_t batch_size) override;
+
+ private:
+  size_t size_;
+  size_t index_{0};
+};
+
+/// Visits the indices `0, 1, ..., size - 1` in a random order that is drawn
+/// anew for every epoch. The sequence of permutations only depends on `seed`.
+class RandomSampler : public Sampler {
+ public:
+  explicit RandomSampler(size_t size, uint64_t seed = 0);
+
+  void reset() override;
+  at::optional<std::vector<size_t>> next(size_t batch_size) override;
+
+ private:
+  std::vector<size_t> indices_;
+  uint64_t seed_;
+  uint64_t epoch_{0};
+  size_t index_{0};
+};
+} // namespace data
+} // namespace torch
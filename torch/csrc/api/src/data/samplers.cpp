@@ -0,0 +1,52 @@
+#include <torch/data/samplers.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+namespace torch {
+namespace data {
+SequentialSampler::SequentialSampler(size_t size) : size_(size) {}
+
+void SequentialSampler::reset() {
+  index_ = 0;
+}
+
+at::optional<std::vector<size_t>> SequentialSampler::next(size_t batch_size) {
+  if (index_ >= size_) {
+    return at::nullopt;
+  }
+  const auto end = std::min(size_, index_ + batch_size);
+  std::vector<size_t> indices(end - index_);
+  std::iota(indices.begin(), indices.end(), index_);
+  index_ = end;
+  return indices;
+}
+
+RandomSampler::RandomSampler(size_t size, uint64_t seed)
+    : indices_(size), seed_(seed) {
+  reset();
+}
+
+void RandomSampler::reset() {
+  // Shuffle from the identity for every epoch so that the permutation of
+  // epoch `n` does not depend on how far earlier epochs were consumed.
+  std::iota(indices_.begin(), indices_.end(), 0);
+  std::mt19937_64 engine(seed_ + epoch_);
+  std::shuffle(indices_.begin(), indices_.end(), engine);
+  epoch_ += 1;
+  index_ = 0;
+}
+
+at::optional<std::vector<size_t>> RandomSampler::next(size_t batch_size) {
+  if (index_ >= indices_.size()) {
+    return at::nullopt;
+  }
+  const auto end = std::min(indices_.size(), index_ + batch_size);
+  std::vector<size_t> indices(
+      indices_.begin() + index_, indices_.begin() + end);
+  index_ = end;
+  return indices;
+}
+} // namespace data
+} // namespace torch
@@ -8,9 +8,11 @@
 
 #include <ATen/DeviceGuard.h>
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -46,11 +48,12 @@ static thread_local int worker_device = NO_DEVICE;
 static thread_local bool checkpoint_valid = true;
 
 // XXX: Changes to the way multithreading works in execute should be done with
-// great care. Right now the implementation guarantees that a single function's
-// apply will never be entered concurrently (even if multiple graphs are
-// executed at the same time). Adding multiple threads per-device or removing
-// engine thread affinity to the device can break this invariant, and we depend
-// on it in a few places (e.g. AccumulateGrad function).
+// great care. With the default of one worker thread per device, a single
+// function's apply is never entered concurrently (even if multiple graphs are
+// executed at the same time). When the CPU queue is served by several workers
+// (see Engine::set_num_cpu_threads) this only holds within a single graph
+// task, so functions with state shared across graph tasks must synchronize
+// themselves (e.g. AccumulateGrad).
 
 struct FunctionTask {
   GraphTask* base;
@@ -77,9 +80,22 @@ struct ReadyQueue {
   std::priority_queue<FunctionTask, std::vector<FunctionTask>, CompareFunctionTaskTime> heap;
   std::condition_variable not_empty;
   std::mutex mutex;
+  // Number of worker threads serving this queue
+  std::atomic<int> num_workers{0};
+  // Number of idle workers that should exit, see Engine::set_num_cpu_threads
+  int workers_to_retire = 0;
 
   void push(FunctionTask item);
-  FunctionTask pop();
+  // Blocks until a task is ready. If graph_task is given, also returns once
+  // it has no outstanding tasks left, in which case the returned task has no
+  // base.  See Note [Reentrant backwards]  Otherwise a task without a base
+  // tells the calling worker to exit.
+  FunctionTask pop(GraphTask* graph_task);
+  // Asks count workers to exit once they are idle in thread_main
+  void retire_workers(int count);
+  // Wakes up every worker blocked in pop, so that the owner of a finished
+  // graph task can leave thread_main.
+  void wake_all();
 };
 
 // Note [Reentrant backwards]
@@ -91,9 +107,10 @@ struct ReadyQueue {
 //  differentiation finishes so that you can get the final result variables
 //  of the backwards pass.
 //
-//  2. The engine operates by having a single worker thread per work queue,
-//  and every work queue is pinned to a specific device where the
-//  operation is executed.
+//  2. The engine operates by having a worker thread per work queue (or a
+//  pool of them for the CPU queue, see Engine::set_num_cpu_threads), and
+//  every work queue is pinned to a specific device where the operation is
+//  executed.
 //
 // The problem is, suppose that you call backward() inside of a worker
 // thread.  By property (1), we're supposed to block until the nested task
@@ -116,7 +133,11 @@ struct ReadyQueue {
 //  - When we finish a GraphTask, we have to make sure we wake up the worker
 //    thread so that it actually has a chance to exit the thread_main()
 //    loop.  Thus the faffing about in thread_main() after
-//    evaluate_function() completes.
+//    evaluate_function() completes.  Any worker may finish the last task of
+//    a graph task, including a different worker of the owner's own queue,
+//    so the owner waits in ReadyQueue::pop for either a new task or its
+//    graph task to finish, and the finishing worker wakes up the owner's
+//    queue.
 
 
 // GraphTask holds metadata needed for a single execution of backward()
@@ -190,14 +211,64 @@ auto ReadyQueue::push(FunctionTask item) -> void {
   not_empty.notify_one();
 }
 
-auto ReadyQueue::pop() -> FunctionTask {
+auto ReadyQueue::pop(GraphTask* graph_task) -> FunctionTask {
   std::unique_lock<std::mutex> lock(mutex);
-  not_empty.wait(lock, [this]{ return !heap.empty(); });
+  auto graph_task_done = [graph_task]{
+    return graph_task && graph_task->outstanding_tasks.load() == 0;
+  };
+  // Only workers idle at the top of thread_main exit, so that no graph task
+  // is left waiting on them
+  auto should_retire = [&]{
+    return !graph_task && workers_to_retire > 0;
+  };
+  not_empty.wait(lock, [&]{
+    return !heap.empty() || graph_task_done() || should_retire();
+  });
+  if (graph_task_done()) {
+    return FunctionTask(nullptr, nullptr, InputBuffer(0));
+  }
+  if (should_retire()) {
+    --workers_to_retire;
+    --num_workers;
+    return FunctionTask(nullptr, nullptr, InputBuffer(0));
+  }
   auto task = std::move(const_cast<FunctionTask&>(heap.top())); heap.pop();
   return task;
 }
 
-Engine::Engine() : ready_queues() {
+auto ReadyQueue::wake_all() -> void {
+  {
+    // Synchronize outstanding_tasks with queue mutex, so that the owner
+    // can't miss the notification between checking it and going to sleep
+    std::lock_guard<std::mutex> lock(mutex);
+  }
+  not_empty.notify_all();
+}
+
+auto ReadyQueue::retire_workers(int count) -> void {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    workers_to_retire += count;
+  }
+  not_empty.notify_all();
+}
+
+static int default_num_cpu_threads() {
+  const char* env = std::getenv("TORCH_AUTOGRAD_CPU_THREADS");
+  if (env) {
+    int num_threads = std::atoi(env);
+    if (num_threads > 0) {
+      return num_threads;
+    }
+    std::cerr << "warning: ignoring invalid TORCH_AUTOGRAD_CPU_THREADS=" << env << "\n";
+  }
+  return 1;
+}
+
+Engine::Engine()
+  : ready_queues()
+  , threads_started(false)
+  , num_cpu_threads_(default_num_cpu_threads()) {
 }
 
 // This Engine's ReadyQueues and their corresponding threads are leaked here
@@ -229,7 +300,15 @@ auto Engine::thread_main(GraphTask *graph_task) -> void {
   // Why the test on graph_task->outstanding_tasks?  See
   // Note [Reentrant backwards]
   while (!graph_task || graph_task->outstanding_tasks > 0) {
-    FunctionTask task = queue->pop();
+    FunctionTask task = queue->pop(graph_task);
+    if (!task.base) {
+      // graph_task has finished, the loop condition takes care of it.
+      // Without a graph_task this worker was retired.
+      if (!graph_task) {
+        return;
+      }
+      continue;
+    }
     if (task.fn && !task.base->has_error.load()) {
       GradMode::set_enabled(task.base->grad_mode);
       try {
@@ -248,21 +327,14 @@ auto Engine::thread_main(GraphTask *graph_task) -> void {
         std::lock_guard<std::mutex> lock(task.base->mutex);
         task.base->not_done.notify_all();
       }
-    } else {
-      // If it's a task initiated from this thread, decrease the counter, but
-      // don't do anything - loop condition will do all checks for us next.
-      if (base_owner == worker_device) {
-        --task.base->outstanding_tasks;
-      // Otherwise send a dummy function task to the owning thread just to
-      // ensure that it's not sleeping. If it has work, it might see that
-      // graph_task->outstanding_tasks == 0 before it gets to the task, but
-      // it's a no-op anyway.
-      } else if (base_owner != worker_device) {
-        if (--task.base->outstanding_tasks == 0) {
-          // Synchronize outstanding_tasks with queue mutex
-          std::atomic_thread_fence(std::memory_order_release);
-          ready_queue(base_owner).push(FunctionTask(task.base, nullptr, InputBuffer(0)));
-        }
+    } else if (--task.base->outstanding_tasks == 0) {
+      // If this thread is the only worker of the owner's queue, the task was
+      // initiated from this thread and the loop condition will do all checks
+      // for us next. Otherwise the owner may be sleeping in pop(), so wake
+      // up its queue.
+      auto& owner_queue = ready_queue(base_owner);
+      if (base_owner != worker_device || owner_queue.num_workers.load() > 1) {
+        owner_queue.wake_all();
       }
     }
   }
@@ -495,6 +567,10 @@ auto Engine::execute(const edge_list& input_roots,
   ClearCallbacks _cb_guard(final_callbacks, post_callbacks_lock);
 
   GraphTask graph_task(keep_graph, create_graph);
+  // Set before any task is queued, since with several CPU workers the tasks
+  // may start running (and read the owner) right away.
+  // See Note [Reentrant backwards]
+  graph_task.owner = worker_device;
   std::unique_lock<std::mutex> lock(graph_task.mutex);
 
   // Now compute the dependencies for all executable functions and queue the root
@@ -515,7 +591,6 @@ auto Engine::execute(const edge_list& input_roots,
     // Get back to work while we wait for our new graph_task to
     // complete!
     // See Note [Reentrant backwards]
-    graph_task.owner = worker_device;
     lock.unlock();
     thread_main(&graph_task);
   }
@@ -575,6 +650,7 @@ auto Engine::ready_queue(int device) -> ReadyQueue& {
 }
 
 auto Engine::start_threads() -> void {
+  std::lock_guard<std::mutex> lock(threads_mutex);
   int num_devices = 0;
 #ifdef USE_CUDA
   // check for case of compiled with CUDA but no available devices
@@ -583,15 +659,47 @@ auto Engine::start_threads() -> void {
     num_devices = 0;
   }
 #endif
-  // One for CPU, plus one for every GPU device
-  int num_threads = num_devices + 1;
-  ready_queues = std::vector<std::shared_ptr<ReadyQueue>>(num_threads);
+  // One queue for CPU, plus one for every GPU device
+  int num_queues = num_devices + 1;
+  ready_queues = std::vector<std::shared_ptr<ReadyQueue>>(num_queues);
   for (auto& queue : ready_queues)
     queue.reset(new ReadyQueue());
-  for (int i = 0; i < num_threads; ++i) {
-    std::thread t(&Engine::thread_init, this, i - 1);
-    t.detach();
+  // A pool of workers for the CPU queue, and one worker per GPU
+  for (int i = 0; i < num_cpu_threads_; ++i) {
+    start_worker(-1);
+  }
+  for (int device = 0; device < num_devices; ++device) {
+    start_worker(device);
+  }
+  threads_started = true;
+}
+
+auto Engine::start_worker(int device) -> void {
+  ready_queue(device).num_workers++;
+  std::thread t(&Engine::thread_init, this, device);
+  t.detach();
+}
+
+void Engine::set_num_cpu_threads(int num_threads) {
+  if (num_threads < 1) {
+    throw std::runtime_error("the autograd engine needs at least one CPU thread");
   }
+  std::lock_guard<std::mutex> lock(threads_mutex);
+  if (threads_started) {
+    // Surplus workers exit as soon as they are idle
+    if (num_threads < num_cpu_threads_) {
+      ready_queue(-1).retire_workers(num_cpu_threads_ - num_threads);
+    }
+    for (int i = num_cpu_threads_; i < num_threads; ++i) {
+      start_worker(-1);
+    }
+  }
+  num_cpu_threads_ = num_threads;
+}
+
+int Engine::num_cpu_threads() {
+  std::lock_guard<std::mutex> lock(threads_mutex);
+  return num_cpu_threads_;
 }
 
 void GraphTask::init_to_execute(Function& graph_root, const edge_list& outputs) {
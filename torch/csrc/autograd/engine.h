@@ -11,6 +11,7 @@
 #include <exception>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -50,11 +51,20 @@ struct Engine {
 
   bool is_checkpoint_valid();
 
+  // Sets the number of worker threads that serve the CPU ready queue.
+  // Independent branches of a backward graph run concurrently on CPU when
+  // this is greater than one. The default is 1, or the value of the
+  // TORCH_AUTOGRAD_CPU_THREADS environment variable. Lowering it while
+  // backward runs takes effect as workers become idle.
+  void set_num_cpu_threads(int num_threads);
+  int num_cpu_threads();
+
 protected:
   void compute_dependencies(Function* root, GraphTask& task);
   void evaluate_function(FunctionTask& task);
   ReadyQueue& ready_queue(int device);
   void start_threads();
+  void start_worker(int device);
   virtual void thread_init(int device);
   virtual void thread_main(GraphTask *task);
   virtual void thread_on_exception(FunctionTask& task, std::exception& e);
@@ -63,6 +73,10 @@ protected:
   std::vector<std::shared_ptr<ReadyQueue>> ready_queues;
   std::vector<std::function<void()>> final_callbacks;
   std::mutex post_callbacks_lock;
+  // Guards threads_started and num_cpu_threads_
+  std::mutex threads_mutex;
+  bool threads_started;
+  int num_cpu_threads_;
 };
 
 // allow python_engine to override the default engine when it loads
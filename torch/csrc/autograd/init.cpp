@@ -36,10 +36,20 @@ PyObject * THPAutograd_initExtension(PyObject *_unused)
   .value("Disabled", torch::autograd::profiler::ProfilerState::Disabled)
   .value("CPU", torch::autograd::profiler::ProfilerState::CPU)
   .value("CUDA", torch::autograd::profiler::ProfilerState::CUDA)
-  .value("NVTX", torch::autograd::profiler::ProfilerState::NVTX);
+  .value("NVTX", torch::autograd::profiler::ProfilerState::NVTX)
+  .value("Sampled", torch::autograd::profiler::ProfilerState::Sampled);
+  py::class_<torch::autograd::profiler::SampledOpStats>(m,"SampledOpStats")
+  .def_readonly("name",&torch::autograd::profiler::SampledOpStats::name)
+  .def_readonly("count",&torch::autograd::profiler::SampledOpStats::count)
+  .def_readonly("total_us",&torch::autograd::profiler::SampledOpStats::total_us)
+  .def_readonly("max_us",&torch::autograd::profiler::SampledOpStats::max_us)
+  .def_readonly("histogram",&torch::autograd::profiler::SampledOpStats::histogram);
 
   m.def("_enable_profiler", torch::autograd::profiler::enableProfiler);
   m.def("_disable_profiler", torch::autograd::profiler::disableProfiler);
+  m.def("_enable_sampled_profiler", torch::autograd::profiler::enableSampledProfiler);
+  m.def("_sampled_chrome_trace", torch::autograd::profiler::sampledChromeTrace);
+  m.def("_sampled_op_stats", torch::autograd::profiler::sampledOpStats);
 
   m.def("_push_range", [](const char *name) {
     using namespace torch::autograd::profiler;
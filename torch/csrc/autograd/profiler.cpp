@@ -1,6 +1,12 @@
 #include "torch/csrc/autograd/profiler.h"
 #include "torch/csrc/autograd/function.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
 namespace torch { namespace autograd { namespace profiler {
 
 ProfilerState state = ProfilerState::Disabled;
@@ -11,9 +17,299 @@ thread_local std::shared_ptr<RangeEventList> event_list;
 thread_local int32_t thread_id;
 
 void RecordFunction::pushFunctionRange(Function* fn) {
+  if (state == ProfilerState::Sampled) {
+    // Only sampled ranges pay for the name
+    pushSampledRange(sampleNextRange() ? fn->name().c_str() : nullptr);
+    return;
+  }
   pushRange(fn->name());
 }
 
+namespace {
+
+// Ring buffer of the sampled ranges of one thread, which is its only writer.
+// Readers copy the slots and then drop the ones that may have been reused
+// meanwhile, as with a seqlock. Slots are atomics so that racing reads are
+// well defined.
+class SampledRangeBuffer {
+ public:
+  SampledRangeBuffer(size_t size, uint32_t thread_id)
+  : slots_(size), thread_id_(thread_id) {}
+
+  void record(uint32_t name, int64_t start_ns, int64_t end_ns) {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    // Readers that see any of the stores below also see head_ == head, see
+    // snapshot
+    std::atomic_thread_fence(std::memory_order_release);
+    Slot& slot = slots_[head % slots_.size()];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start_ns.store(start_ns, std::memory_order_relaxed);
+    slot.end_ns.store(end_ns, std::memory_order_relaxed);
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  void snapshot(std::vector<SampledRange>& out) const {
+    const uint64_t size = slots_.size();
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    std::vector<SampledRange> ranges;
+    for (uint64_t i = head > size ? head - size : 0; i < head; i++) {
+      const Slot& slot = slots_[i % size];
+      ranges.push_back({slot.name.load(std::memory_order_relaxed),
+                        thread_id_,
+                        slot.start_ns.load(std::memory_order_relaxed),
+                        slot.end_ns.load(std::memory_order_relaxed)});
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // Range i is intact unless the writer has started on range i + size
+    const uint64_t new_head = head_.load(std::memory_order_relaxed);
+    const uint64_t first = head > size ? head - size : 0;
+    const uint64_t first_intact = new_head >= size ? new_head - size + 1 : 0;
+    const size_t skip = std::min<uint64_t>(
+        ranges.size(), first_intact > first ? first_intact - first : 0);
+    out.insert(out.end(), ranges.begin() + skip, ranges.end());
+  }
+
+ private:
+  struct Slot {
+    std::atomic<uint32_t> name;
+    std::atomic<int64_t> start_ns;
+    std::atomic<int64_t> end_ns;
+  };
+  std::vector<Slot> slots_;
+  std::atomic<uint64_t> head_{0};
+  uint32_t thread_id_;
+};
+
+constexpr uint32_t kNotSampled = UINT32_MAX;
+
+std::mutex sampled_buffers_mutex;
+std::list<std::shared_ptr<SampledRangeBuffer>> sampled_buffers;
+size_t sampled_buffer_size = 0;
+uint32_t sample_period = 1;
+uint32_t next_sampled_thread_id = 0;
+// Incremented by every enableSampledProfiler, so that threads drop the
+// buffers and open ranges of the previous run
+std::atomic<uint64_t> sampled_generation{0};
+
+std::mutex names_mutex;
+std::unordered_map<std::string, uint32_t> name_ids;
+std::vector<std::string> names;
+
+uint32_t internName(const char* name) {
+  std::lock_guard<std::mutex> guard(names_mutex);
+  auto it = name_ids.find(name);
+  if (it != name_ids.end()) {
+    return it->second;
+  }
+  const uint32_t id = names.size();
+  names.emplace_back(name);
+  name_ids.emplace(names.back(), id);
+  return id;
+}
+
+uint64_t hashName(const char* name) {
+  // FNV-1a
+  uint64_t hash = 14695981039346656037ull;
+  for (; *name; name++) {
+    hash = (hash ^ static_cast<unsigned char>(*name)) * 1099511628211ull;
+  }
+  return hash;
+}
+
+struct SampledThreadState {
+  uint64_t generation = 0;
+  // Sampling period of the current run and the number of ranges left until
+  // the next sampled one, 0 samples the next range
+  uint32_t period = 1;
+  uint32_t countdown = 0;
+  std::shared_ptr<SampledRangeBuffer> buffer;
+  // Name id (or kNotSampled) and start time of the open ranges
+  std::vector<std::pair<uint32_t, int64_t>> open_ranges;
+  // Names seen by this thread by their hash, so that looking them up needs
+  // neither a lock nor a std::string
+  std::unordered_map<uint64_t, std::pair<std::string, uint32_t>> name_cache;
+
+  uint32_t nameId(const char* name) {
+    const uint64_t hash = hashName(name);
+    auto it = name_cache.find(hash);
+    if (it != name_cache.end()) {
+      if (std::strcmp(it->second.first.c_str(), name) == 0) {
+        return it->second.second;
+      }
+      return internName(name);
+    }
+    const uint32_t id = internName(name);
+    name_cache.emplace(hash, std::make_pair(std::string(name), id));
+    return id;
+  }
+};
+
+thread_local SampledThreadState sampled_thread_state;
+
+SampledThreadState& getSampledThreadState() {
+  SampledThreadState& ts = sampled_thread_state;
+  const uint64_t generation = sampled_generation.load(std::memory_order_acquire);
+  if (ts.generation != generation) {
+    std::lock_guard<std::mutex> guard(sampled_buffers_mutex);
+    ts.period = sample_period;
+    ts.buffer = std::make_shared<SampledRangeBuffer>(
+        sampled_buffer_size, next_sampled_thread_id++);
+    // Take the place of the buffer of an exited thread, if any, so that
+    // memory is bounded by the peak number of threads
+    auto dead = std::find_if(
+        sampled_buffers.begin(), sampled_buffers.end(),
+        [](const std::shared_ptr<SampledRangeBuffer>& b) { return b.use_count() == 1; });
+    if (dead != sampled_buffers.end()) {
+      *dead = ts.buffer;
+    } else {
+      sampled_buffers.push_back(ts.buffer);
+    }
+    ts.generation = generation;
+    ts.countdown = 0;
+    ts.open_ranges.clear();
+  }
+  return ts;
+}
+
+void appendJsonString(std::string& out, const std::string& str) {
+  out += '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", c);
+      out += buf;
+    } else {
+      out += c;
+    }
+  }
+  out += '"';
+}
+
+} // namespace
+
+bool sampleNextRange() {
+  SampledThreadState& ts = getSampledThreadState();
+  if (ts.countdown > 1) {
+    --ts.countdown;
+    return false;
+  }
+  ts.countdown = ts.period;
+  return true;
+}
+
+void pushSampledRange(const char* name) {
+  SampledThreadState& ts = getSampledThreadState();
+  if (name) {
+    ts.open_ranges.emplace_back(ts.nameId(name), getTime());
+  } else {
+    ts.open_ranges.emplace_back(kNotSampled, 0);
+  }
+}
+
+void popSampledRange() {
+  SampledThreadState& ts = getSampledThreadState();
+  // The range may have been opened before the profiler was enabled
+  if (ts.open_ranges.empty()) {
+    return;
+  }
+  const auto range = ts.open_ranges.back();
+  ts.open_ranges.pop_back();
+  if (range.first != kNotSampled) {
+    ts.buffer->record(range.first, range.second, getTime());
+  }
+}
+
+void enableSampledProfiler(uint32_t period, size_t buffer_size) {
+  if (period == 0 || buffer_size == 0) {
+    throw std::runtime_error("sampled profiler: period and buffer_size must be positive");
+  }
+  if (state != ProfilerState::Disabled && state != ProfilerState::Sampled) {
+    throw std::runtime_error("can't change kind of profiling (e.g. NVTX to CPU) while profiler is running");
+  }
+  {
+    std::lock_guard<std::mutex> guard(sampled_buffers_mutex);
+    sampled_buffers.clear();
+    sampled_buffer_size = buffer_size;
+    sample_period = period;
+    sampled_generation++;
+  }
+  state = ProfilerState::Sampled;
+}
+
+std::vector<SampledRange> sampledRanges() {
+  std::vector<SampledRange> result;
+  std::lock_guard<std::mutex> guard(sampled_buffers_mutex);
+  for (const auto& buffer : sampled_buffers) {
+    buffer->snapshot(result);
+  }
+  return result;
+}
+
+std::string sampledRangeName(uint32_t name) {
+  std::lock_guard<std::mutex> guard(names_mutex);
+  return names.at(name);
+}
+
+std::string sampledChromeTrace() {
+  const auto ranges = sampledRanges();
+  std::lock_guard<std::mutex> guard(names_mutex);
+  std::string out = "[";
+  char buf[128];
+  for (size_t i = 0; i < ranges.size(); i++) {
+    const SampledRange& range = ranges[i];
+    out += i == 0 ? "{\"name\": " : ", {\"name\": ";
+    appendJsonString(out, names[range.name]);
+    snprintf(buf, sizeof(buf),
+             ", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"tid\": %u, "
+             "\"pid\": \"CPU functions\", \"args\": {}}",
+             range.start_ns / 1000.0, (range.end_ns - range.start_ns) / 1000.0,
+             range.thread_id);
+    out += buf;
+  }
+  out += "]";
+  return out;
+}
+
+std::vector<SampledOpStats> sampledOpStats() {
+  constexpr size_t kNumBuckets = 32;
+  const auto ranges = sampledRanges();
+  std::unordered_map<uint32_t, SampledOpStats> stats;
+  for (const SampledRange& range : ranges) {
+    SampledOpStats& op = stats[range.name];
+    if (op.histogram.empty()) {
+      op.count = 0;
+      op.total_us = 0;
+      op.max_us = 0;
+      op.histogram.resize(kNumBuckets, 0);
+    }
+    const double us = (range.end_ns - range.start_ns) / 1000.0;
+    op.count++;
+    op.total_us += us;
+    op.max_us = std::max(op.max_us, us);
+    size_t bucket = 0;
+    for (double bound = 1; us >= bound && bucket + 1 < kNumBuckets; bound *= 2) {
+      bucket++;
+    }
+    op.histogram[bucket]++;
+  }
+  std::vector<SampledOpStats> result;
+  {
+    std::lock_guard<std::mutex> guard(names_mutex);
+    for (auto& entry : stats) {
+      entry.second.name = names[entry.first];
+      result.push_back(std::move(entry.second));
+    }
+  }
+  std::sort(result.begin(), result.end(),
+            [](const SampledOpStats& a, const SampledOpStats& b) {
+              return a.count > b.count || (a.count == b.count && a.name < b.name);
+            });
+  return result;
+}
+
 #ifdef USE_CUDA
 static void onEachDevice(std::function<void(int)> op) {
   at::DeviceGuard device_guard;
@@ -28,6 +324,9 @@ static void onEachDevice(std::function<void(int)> op) {
 
 void enableProfiler(ProfilerState new_state) {
   TORCH_ASSERT(new_state != ProfilerState::Disabled);
+  if (new_state == ProfilerState::Sampled) {
+    throw std::runtime_error("use enableSampledProfiler to start sampled profiling");
+  }
 #ifndef USE_CUDA
   if (new_state == ProfilerState::NVTX)
     throw std::runtime_error("Can't use NVTX profiler - PyTorch was compiled without CUDA");
@@ -66,7 +365,7 @@ thread_event_lists disableProfiler() {
   ProfilerState old_state = state;
   mark("__stop_profile");
   state = ProfilerState::Disabled;
-  if (old_state == ProfilerState::NVTX) {
+  if (old_state == ProfilerState::NVTX || old_state == ProfilerState::Sampled) {
     return thread_event_lists();
   } else {
     thread_event_lists result;
@@ -160,6 +160,7 @@ enum class ProfilerState {
     CPU, // CPU-only profiling
     CUDA, // CPU + CUDA events
     NVTX,  // only emit NVTX markers
+    Sampled, // CPU-only, 1 in N ranges into per-thread ring buffers
 };
 
 extern ProfilerState state;
@@ -170,6 +171,29 @@ extern std::list<std::shared_ptr<RangeEventList>> all_event_lists;
 extern thread_local std::shared_ptr<RangeEventList> event_list;
 extern thread_local int32_t thread_id;
 
+// Sampled profiling records every N-th range of each thread as a fixed-size
+// SampledRange, whose name is interned, into a ring buffer that keeps the
+// thread's most recent ranges. Recording takes no locks and, once a thread
+// has seen a name, doesn't allocate, so it can stay enabled on production
+// hosts. The buffers can be read at any time, also while ranges are being
+// recorded.
+
+struct SampledRange {
+  uint32_t name; // see sampledRangeName
+  uint32_t thread_id;
+  int64_t start_ns;
+  int64_t end_ns;
+};
+
+// True for every period-th range of the calling thread, counting from the
+// first range it opens after enableSampledProfiler
+bool sampleNextRange();
+
+// Opens a range of the calling thread, which is recorded when it is closed.
+// A null name opens a range that isn't sampled.
+void pushSampledRange(const char* name);
+void popSampledRange();
+
 inline RangeEventList& getEventList() {
   if (!event_list) {
     std::lock_guard<std::mutex> guard(all_event_lists_mutex);
@@ -181,7 +205,9 @@ inline RangeEventList& getEventList() {
 }
 
 inline void mark(std::string name, bool include_cuda = true) {
-  if (state == ProfilerState::NVTX) {
+  if (state == ProfilerState::Sampled) {
+    return;
+  } else if (state == ProfilerState::NVTX) {
 #ifdef USE_CUDA
     nvtxMarkA(name.c_str());
 #else
@@ -199,6 +225,8 @@ inline void pushRange(std::string name) {
 #else
     throw std::logic_error("pushRange called with NVTX tracing, but compiled without CUDA");
 #endif
+  } else if (state == ProfilerState::Sampled) {
+    pushSampledRange(sampleNextRange() ? name.c_str() : nullptr);
   } else {
     getEventList().record(EventKind::PushRange, std::move(name), thread_id, state == ProfilerState::CUDA);
   }
@@ -211,6 +239,8 @@ inline void popRange() {
 #else
     throw std::logic_error("popRange called with NVTX tracing, but compiled without CUDA");
 #endif
+  } else if (state == ProfilerState::Sampled) {
+    popSampledRange();
   } else {
     getEventList().record(EventKind::PopRange, std::string(), thread_id, state == ProfilerState::CUDA);
   }
@@ -229,6 +259,10 @@ struct RecordFunction {
 
   explicit RecordFunction(const char *name) {
     if (state == ProfilerState::Disabled) return;
+    if (state == ProfilerState::Sampled) {
+      pushSampledRange(sampleNextRange() ? name : nullptr);
+      return;
+    }
     pushRange(name);
   }
 
@@ -247,5 +281,31 @@ using thread_event_lists = std::vector<std::vector<Event>>;
 void enableProfiler(ProfilerState state);
 thread_event_lists disableProfiler();
 
+// Starts sampled profiling (see SampledRange) of 1 in period ranges, keeping
+// the last buffer_size ranges of every thread. The ranges of an earlier run
+// are dropped. disableProfiler stops it, and returns no events.
+void enableSampledProfiler(uint32_t period, size_t buffer_size);
+
+// The ranges held by the buffers, oldest first for every thread. The buffer
+// of an exited thread is kept until a new thread takes its place.
+std::vector<SampledRange> sampledRanges();
+std::string sampledRangeName(uint32_t name);
+
+// sampledRanges in the Chrome trace format (see chrome://tracing)
+std::string sampledChromeTrace();
+
+struct SampledOpStats {
+  std::string name;
+  uint64_t count;
+  double total_us;
+  double max_us;
+  // histogram[0] counts the ranges shorter than 1us and histogram[i] those
+  // in [2^(i-1), 2^i) us; the last bucket also counts all longer ones
+  std::vector<uint64_t> histogram;
+};
+
+// Durations of sampledRanges aggregated by name, most frequent first
+std::vector<SampledOpStats> sampledOpStats();
+
 } // namespace profiler
 }} // namespace torch::autograd
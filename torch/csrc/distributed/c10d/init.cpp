@@ -44,6 +44,26 @@ PyObject* c10d_init(PyObject* _unused) {
       .def(py::init<>())
       .def_readwrite("reduceOp", &::c10d::AllreduceOptions::reduceOp);
 
+  py::class_<::c10d::ReduceOptions>(module, "ReduceOptions")
+      .def(py::init<>())
+      .def_readwrite("reduceOp", &::c10d::ReduceOptions::reduceOp)
+      .def_readwrite("rootRank", &::c10d::ReduceOptions::rootRank)
+      .def_readwrite("rootTensor", &::c10d::ReduceOptions::rootTensor);
+
+  py::class_<::c10d::AllgatherOptions>(module, "AllgatherOptions")
+      .def(py::init<>());
+
+  py::class_<::c10d::GatherOptions>(module, "GatherOptions")
+      .def(py::init<>())
+      .def_readwrite("rootRank", &::c10d::GatherOptions::rootRank);
+
+  py::class_<::c10d::ScatterOptions>(module, "ScatterOptions")
+      .def(py::init<>())
+      .def_readwrite("rootRank", &::c10d::ScatterOptions::rootRank);
+
+  py::class_<::c10d::BarrierOptions>(module, "BarrierOptions")
+      .def(py::init<>());
+
   py::enum_<::c10d::ReduceOp>(module, "ReduceOp")
       .value("SUM", ::c10d::ReduceOp::SUM)
       .value("PRODUCT", ::c10d::ReduceOp::PRODUCT)
@@ -72,6 +92,35 @@ PyObject* c10d_init(PyObject* _unused) {
                     reinterpret_cast<char*>(value.data()), value.size());
               },
               py::call_guard<py::gil_scoped_release>())
+          .def(
+              "multi_set",
+              [](::c10d::Store& store,
+                 const std::vector<std::string>& keys,
+                 const std::vector<std::string>& values) {
+                std::vector<std::vector<uint8_t>> values_;
+                values_.reserve(values.size());
+                for (const auto& value : values) {
+                  values_.emplace_back(value.begin(), value.end());
+                }
+                store.multiSet(keys, values_);
+              },
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "multi_get",
+              [](::c10d::Store& store, const std::vector<std::string>& keys) {
+                std::vector<std::vector<uint8_t>> values;
+                {
+                  py::gil_scoped_release release;
+                  values = store.multiGet(keys);
+                }
+                py::list result;
+                for (const auto& value : values) {
+                  result.append(py::bytes(
+                      reinterpret_cast<const char*>(value.data()),
+                      value.size()));
+                }
+                return result;
+              })
           .def(
               "add",
               &::c10d::Store::add,
@@ -79,6 +128,8 @@ PyObject* c10d_init(PyObject* _unused) {
           .def(
               "wait",
               &::c10d::Store::wait,
+              py::arg("keys"),
+              py::arg("timeout") = ::c10d::Store::kDefaultTimeout,
               py::call_guard<py::gil_scoped_release>());
 
   shared_ptr_class_<::c10d::FileStore>(module, "FileStore", store)
@@ -121,6 +172,52 @@ PyObject* c10d_init(PyObject* _unused) {
               },
               py::arg("tensor"),
               py::arg("op") = ::c10d::ReduceOp::SUM,
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "reduce",
+              &::c10d::ProcessGroup::reduce,
+              py::arg("tensors"),
+              py::arg("opts") = ::c10d::ReduceOptions(),
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "allgather",
+              &::c10d::ProcessGroup::allgather,
+              py::arg("output_tensors"),
+              py::arg("input_tensors"),
+              py::arg("opts") = ::c10d::AllgatherOptions(),
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "gather",
+              &::c10d::ProcessGroup::gather,
+              py::arg("output_tensors"),
+              py::arg("input_tensors"),
+              py::arg("opts") = ::c10d::GatherOptions(),
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "scatter",
+              &::c10d::ProcessGroup::scatter,
+              py::arg("output_tensors"),
+              py::arg("input_tensors"),
+              py::arg("opts") = ::c10d::ScatterOptions(),
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "send",
+              &::c10d::ProcessGroup::send,
+              py::arg("tensors"),
+              py::arg("dst_rank"),
+              py::arg("tag"),
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "recv",
+              &::c10d::ProcessGroup::recv,
+              py::arg("tensors"),
+              py::arg("src_rank"),
+              py::arg("tag"),
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "barrier",
+              &::c10d::ProcessGroup::barrier,
+              py::arg("opts") = ::c10d::BarrierOptions(),
               py::call_guard<py::gil_scoped_release>());
 
   auto processGroupGloo = shared_ptr_class_<::c10d::ProcessGroupGloo>(
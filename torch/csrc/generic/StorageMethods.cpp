@@ -197,6 +197,32 @@ static PyObject * THPStorage_(fromFile)(PyObject *_unused, PyObject *args, PyObj
   END_HANDLE_TH_ERRORS
 }
 
+#if !defined(THC_GENERIC_FILE) && !defined(THD_GENERIC_FILE)
+// Creates a storage of `size` elements backed by a private mapping of an open
+// file, starting `offset` bytes into it. Pages are only read in when they are
+// first touched, and writes to the storage are never written back to the file.
+static PyObject * THPStorage_(newMappedFromFile)(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  PyObject *file;
+  Py_ssize_t offset;
+  Py_ssize_t size;
+  if (!PyArg_ParseTuple(args, "Onn", &file, &offset, &size)) {
+    return NULL;
+  }
+  int fd = PyObject_AsFileDescriptor(file);
+  THPUtils_assert(fd != -1, "_new_mapped_from_file couldn't retrieve a file "
+      "descriptor from given object");
+  THPUtils_assert(size > 0, "_new_mapped_from_file can't map an empty storage");
+  THMapAllocatorContext *ctx = THMapAllocatorContext_newWithFdAndOffset(
+      NULL, fd, offset, TH_ALLOCATOR_MAPPED_FROMFD);
+  THWStorage *storage = THWStorage_(newWithAllocator)(LIBRARY_STATE size, &THMapAllocator, ctx);
+  THWStorage_(clearFlag)(LIBRARY_STATE storage, TH_STORAGE_RESIZABLE);
+  return (PyObject*)THPStorage_(New)(storage);
+  END_HANDLE_TH_ERRORS
+}
+#endif
+
 #ifndef THD_GENERIC_FILE
 PyObject * THPStorage_(writeFile)(THPStorage *self, PyObject *args)
 {
@@ -328,6 +354,7 @@ static PyMethodDef THPStorage_(methods)[] = {
 #endif // !defined(THD_GENERIC_FILE)
 #if !defined(THC_GENERIC_FILE) && !defined(THD_GENERIC_FILE)
   {"from_buffer", (PyCFunction)THPStorage_(fromBuffer), METH_VARARGS | METH_KEYWORDS | METH_STATIC, NULL},
+  {"_new_mapped_from_file", (PyCFunction)THPStorage_(newMappedFromFile), METH_VARARGS | METH_STATIC, NULL},
 #endif
   {"from_file", (PyCFunction)THPStorage_(fromFile), METH_VARARGS | METH_KEYWORDS | METH_STATIC, NULL},
 #ifdef THC_GENERIC_FILE
@@ -7,6 +7,7 @@
 #include "torch/csrc/variable_tensor_functions.h"
 
 #include "ATen/ATen.h"
+#include "ATen/Parallel.h"
 #ifdef USE_CUDA
 #include "THC/THC.h"
 #include "torch/csrc/cuda/cuda_check.h"
@@ -22,6 +23,18 @@
 #include <iostream>
 #include <dlfcn.h>
 #include <unistd.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <set>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
 
 namespace torch { namespace jit {
 
@@ -777,22 +790,226 @@ static void disas(const std::string & so_file) {
   JIT_ASSERT(r == 0);
 }
 
+// 64-bit FNV-1a. Unlike std::hash, its value is stable across builds,
+// which the on-disk kernel cache relies on.
+static uint64_t stableHash(const std::string & str) {
+  uint64_t hash = 14695981039346656037ULL;
+  for(unsigned char c : str) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+static std::string toHex(uint64_t value) {
+  std::stringstream ss;
+  ss << std::hex << std::setw(16) << std::setfill('0') << value;
+  return ss.str();
+}
+
+// The complete compiler command line without the file names. Together with
+// the compiler version and the host CPU it determines the generated code.
+static std::string compileFlags(const FusionCompilerConfig & config) {
+  TemplateEnv env;
+  env.s("cxx", config.cxx);
+  env.s("fopenmp", config.openmp ? "-fopenmp" : "");
+  env.s("cpp_file", "");
+  env.s("so_file", "");
+  return format(compile_string, env);
+}
+
+static std::string compilerVersion(const std::string & cxx) {
+  std::string cmd = "\"" + cxx + "\" --version 2>/dev/null";
+  FILE * pipe = popen(cmd.c_str(), "r");
+  if(pipe == nullptr) {
+    return "";
+  }
+  std::string version;
+  char buf[256];
+  size_t n;
+  while((n = fread(buf, 1, sizeof(buf), pipe)) > 0) {
+    version.append(buf, n);
+  }
+  pclose(pipe);
+  return version;
+}
+
+// Identifies the CPU that -march=native resolves against, so that kernels
+// in a cache directory shared between hosts are only loaded on CPUs with
+// the same instruction set extensions.
+static std::string hostCPUIdentity() {
+  std::stringstream id;
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned int eax, ebx, ecx, edx;
+  unsigned int max_leaf = __get_cpuid_max(0, nullptr);
+  // vendor, family/model/stepping and feature flags
+  for(unsigned int leaf : {0u, 1u, 7u}) {
+    if(leaf > max_leaf) {
+      break;
+    }
+    __cpuid_count(leaf, 0, eax, ebx, ecx, edx);
+    if(leaf == 1) {
+      // drop the APIC id and the logical processor count, which differ
+      // between the cores of the same CPU
+      ebx &= 0xffff;
+    }
+    id << std::hex << leaf << ":" << eax << "," << ebx << "," << ecx << "," << edx << ";";
+  }
+  if(__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx)) {
+    id << std::hex << "ext:" << ecx << "," << edx << ";";
+  }
+#else
+  // everything in /proc/cpuinfo that doesn't vary between cores or over time
+  static const std::set<std::string> skipped = {
+    "processor", "cpu MHz", "bogomips", "BogoMIPS", "core id", "apicid",
+    "initial apicid", "physical id", "siblings", "cpu cores"};
+  std::set<std::string> lines;
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while(std::getline(cpuinfo, line)) {
+    std::string key = line.substr(0, line.find(':'));
+    key.erase(key.find_last_not_of(" \t") + 1);
+    if(!key.empty() && skipped.count(key) == 0) {
+      lines.insert(line);
+    }
+  }
+  for(auto & l : lines) {
+    id << l << "\n";
+  }
+#endif
+  return id.str();
+}
+
+// Everything that determines the compiled kernel. Its hash names the cached
+// library and the key itself is stored next to it, so that a hash collision
+// is detected rather than loading a kernel built from different source.
+static std::string cacheKey(const FusionCompilerConfig & config, const std::string & cpp_source) {
+  static const std::string cpu_identity = hostCPUIdentity();
+  std::stringstream key;
+  key << compileFlags(config) << "\n"
+      << config.cxx_version << "\n"
+      << cpu_identity << "\n"
+      << cpp_source;
+  return key.str();
+}
+
+// path of the cached kernel without the .so/.key extension
+static std::string cachePath(const FusionCompilerConfig & config, const std::string & key) {
+  return config.cache_dir + "/" + toHex(stableHash(key));
+}
+
+static std::unique_ptr<DynamicLibrary> loadCachedKernel(const std::string & path, const std::string & key) {
+  std::ifstream in(path + ".key", std::ios::binary);
+  std::string stored_key((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  if(!in || stored_key != key) {
+    return nullptr;
+  }
+  std::string so_path = path + ".so";
+  if(access(so_path.c_str(), R_OK) != 0) {
+    return nullptr;
+  }
+  try {
+    return std::unique_ptr<DynamicLibrary>(new DynamicLibrary(so_path.c_str()));
+  } catch(const std::exception & e) {
+    std::cerr << "warning: pytorch jit fuser failed to load cached kernel "
+              << so_path << ", recompiling: " << e.what() << "\n";
+    return nullptr;
+  }
+}
+
+static bool storeCacheKey(const std::string & path, const std::string & key) {
+  // Write next to the final location and rename, so that concurrent
+  // processes never observe a partially written key.
+  std::string tmp_path = path + ".key.tmp" + std::to_string(getpid());
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    out << key;
+    if(!out) {
+      std::remove(tmp_path.c_str());
+      return false;
+    }
+  }
+  if(std::rename(tmp_path.c_str(), (path + ".key").c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+// Creates path and its missing parents. Returns whether path is a writable
+// directory afterwards.
+static bool makeWritableDirectory(const std::string & path) {
+  size_t pos = 0;
+  do {
+    pos = path.find('/', pos + 1);
+    std::string prefix = path.substr(0, pos);
+    if(mkdir(prefix.c_str(), 0777) != 0 && errno != EEXIST) {
+      return false;
+    }
+  } while(pos != std::string::npos);
+  struct stat st;
+  return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode) &&
+         access(path.c_str(), W_OK | X_OK) == 0;
+}
+
+// Compiles cpp_source into a shared library and returns its handle.
+// num_compiles counts the libraries that were not found in the cache.
+//
+// If config.cache_dir is set, compiled libraries are kept there, keyed by
+// the generated source (which encodes the fusion graph and the TensorInfo
+// layout of every argument), the full compiler command line, the compiler
+// version and the host CPU. Later processes that generate the same source
+// load the library directly and skip the compiler.
+static std::unique_ptr<DynamicLibrary> compileCPUKernel(FusionCompilerConfig & config, const std::string & cpp_source, size_t & num_compiles) {
+  if(!config.cache_dir.empty()) {
+    std::string key = cacheKey(config, cpp_source);
+    if(auto lib = loadCachedKernel(cachePath(config, key), key)) {
+      return lib;
+    }
+    // A process whose compiler failed with OpenMP published its kernels
+    // under the flags it fell back to. They are used rather than retrying
+    // the failing compile in every process.
+    if(config.openmp) {
+      FusionCompilerConfig serial = config;
+      serial.openmp = false;
+      std::string serial_key = cacheKey(serial, cpp_source);
+      if(auto lib = loadCachedKernel(cachePath(serial, serial_key), serial_key)) {
+        return lib;
+      }
+    }
+  }
+
+  // Compile next to the final location so that publishing the library
+  // is an atomic rename on the same file system.
+  TempFile so_file(config.cache_dir.empty() ? so_template : config.cache_dir + "/pytorch_fuserXXXXXX.so", 3);
+  TempFile cpp_file(cpp_template, 4);
+  cpp_file.write(cpp_source);
+  cpp_file.sync();
+  runCompiler(config, cpp_file.name(), so_file.name());
+  num_compiles++;
+  if(config.debug) {
+    disas(so_file.name());
+  }
+  if(!config.cache_dir.empty()) {
+    // keyed after runCompiler, which may have dropped OpenMP
+    std::string key = cacheKey(config, cpp_source);
+    std::string cached = cachePath(config, key);
+    std::string cached_so = cached + ".so";
+    if(storeCacheKey(cached, key) &&
+       std::rename(so_file.name().c_str(), cached_so.c_str()) == 0) {
+      return std::unique_ptr<DynamicLibrary>(new DynamicLibrary(cached_so.c_str()));
+    }
+  }
+  return std::unique_ptr<DynamicLibrary>(new DynamicLibrary(so_file.name().c_str()));
+}
+
 struct CPUFusionFunction : public CompiledFusionFunction {
-  CPUFusionFunction(const std::string & name, AnnotatedGraph & agraph, FusionCompilerConfig & config)
+  CPUFusionFunction(const std::string & name, AnnotatedGraph & agraph, FusionCompilerConfig & config, size_t & num_compiles)
   : CompiledFusionFunction(name, agraph) {
-    TempFile so_file(so_template, 3);
-    TempFile cpp_file(cpp_template, 4);
-
     std::stringstream cu;
     concat_desc = codegen::emitCompilationUnit(cu, name, agraph, false);
     compilation_unit = cu.str();
-    cpp_file.write(compilation_unit);
-    cpp_file.sync();
-    runCompiler(config, cpp_file.name(), so_file.name());
-    if(config.debug) {
-      disas(so_file.name());
-    }
-    so_lib.reset(new DynamicLibrary(so_file.name().c_str()));
+    so_lib = compileCPUKernel(config, compilation_unit, num_compiles);
 #pragma GCC diagnostic ignored "-Wpedantic"
     kernel = reinterpret_cast<void(*)(uint32_t, void**)>(so_lib->sym(name.c_str()));
 #pragma GCC diagnostic pop
@@ -808,6 +1025,397 @@ protected:
   void (*kernel)(uint32_t, void**) = nullptr;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// In-process interpreter
+//
+// Runs CPU fusion groups without a C++ toolchain. The graph is lowered once
+// into a flat list of instructions over float registers that each hold
+// kBlockSize consecutive elements. Every instruction is a plain loop over a
+// block, so the dispatch cost is paid once per block rather than per element
+// and the loops themselves are vectorized by the compiler that built PyTorch.
+// Like the generated kernels, all arithmetic is done in float.
+
+namespace {
+namespace interp {
+
+constexpr int64_t kBlockSize = 256;
+
+enum class OpCode {
+  // unary
+  Abs, Sigmoid, Relu, Log, Log10, Log1p, Log2, Lgamma, Exp, Expm1, Cos, Acos,
+  Cosh, Sin, Asin, Sinh, Tan, Atan, Tanh, Sqrt, Rsqrt, Ceil, Floor, Round,
+  Trunc, Frac, Reciprocal, Neg, TypeAs,
+  // binary
+  Atan2, Min, Max, And, Lshift, Or, Rshift, Xor, Div, Eq, Fmod, Ge, Gt, Le,
+  Lt, Mul, Ne, Remainder, Pow,
+  // binary with scalar attributes
+  Add, Sub, Lerp, Clamp,
+  // simple derivatives
+  SigmoidBackward, TanhBackward,
+};
+
+const std::unordered_map<NodeKind, OpCode> & opCodes() {
+  static std::unordered_map<NodeKind, OpCode> op_codes = {
+    {aten::abs, OpCode::Abs},
+    {aten::sigmoid, OpCode::Sigmoid},
+    {aten::relu, OpCode::Relu},
+    {aten::log, OpCode::Log},
+    {aten::log10, OpCode::Log10},
+    {aten::log1p, OpCode::Log1p},
+    {aten::log2, OpCode::Log2},
+    {aten::lgamma, OpCode::Lgamma},
+    {aten::exp, OpCode::Exp},
+    {aten::expm1, OpCode::Expm1},
+    {aten::cos, OpCode::Cos},
+    {aten::acos, OpCode::Acos},
+    {aten::cosh, OpCode::Cosh},
+    {aten::sin, OpCode::Sin},
+    {aten::asin, OpCode::Asin},
+    {aten::sinh, OpCode::Sinh},
+    {aten::tan, OpCode::Tan},
+    {aten::atan, OpCode::Atan},
+    {aten::tanh, OpCode::Tanh},
+    {aten::sqrt, OpCode::Sqrt},
+    {aten::rsqrt, OpCode::Rsqrt},
+    {aten::ceil, OpCode::Ceil},
+    {aten::floor, OpCode::Floor},
+    {aten::round, OpCode::Round},
+    {aten::trunc, OpCode::Trunc},
+    {aten::frac, OpCode::Frac},
+    {aten::reciprocal, OpCode::Reciprocal},
+    {aten::neg, OpCode::Neg},
+    {aten::type_as, OpCode::TypeAs},
+    {aten::atan2, OpCode::Atan2},
+    {aten::min, OpCode::Min},
+    {aten::max, OpCode::Max},
+    {aten::__and__, OpCode::And},
+    {aten::__lshift__, OpCode::Lshift},
+    {aten::__or__, OpCode::Or},
+    {aten::__rshift__, OpCode::Rshift},
+    {aten::__xor__, OpCode::Xor},
+    {aten::div, OpCode::Div},
+    {aten::eq, OpCode::Eq},
+    {aten::fmod, OpCode::Fmod},
+    {aten::ge, OpCode::Ge},
+    {aten::gt, OpCode::Gt},
+    {aten::le, OpCode::Le},
+    {aten::lt, OpCode::Lt},
+    {aten::mul, OpCode::Mul},
+    {aten::ne, OpCode::Ne},
+    {aten::remainder, OpCode::Remainder},
+    {aten::pow, OpCode::Pow},
+    {aten::add, OpCode::Add},
+    {aten::sub, OpCode::Sub},
+    {aten::lerp, OpCode::Lerp},
+    {aten::clamp, OpCode::Clamp},
+    {aten::_sigmoid_backward, OpCode::SigmoidBackward},
+    {aten::_tanh_backward, OpCode::TanhBackward},
+  };
+  return op_codes;
+}
+
+// out = op(a, b), where c0 and c1 hold the scalar attributes of the node:
+// alpha for add/sub, weight for lerp and min/max for clamp
+struct Instruction {
+  OpCode op;
+  int out;
+  int a;
+  int b;
+  float c0;
+  float c1;
+};
+
+struct Program {
+  // the first registers hold the inputs of the graph
+  int num_registers = 0;
+  // registers holding the scalar operands of ops like a * 2
+  std::vector<std::pair<int, float>> constants;
+  std::vector<Instruction> instructions;
+  // registers holding the flattened outputs, in the order of the arguments
+  std::vector<int> outputs;
+};
+
+float scalarAttribute(Node * n, Symbol name, float default_value) {
+  if(!n->hasAttribute(name)) {
+    return default_value;
+  }
+  return static_cast<float>(at::Scalar(n->t(name)).toDouble());
+}
+
+Program compile(Graph & graph, const std::vector<Value*> & flat_outputs) {
+  Program program;
+  std::unordered_map<Value*, int> registers;
+  for(auto input : graph.inputs()) {
+    registers[input] = program.num_registers++;
+  }
+  for(auto n : graph.nodes()) {
+    if(n->kind() == aten::cat)
+      continue; // Concat nodes by narrowing the output Tensors before the kernel runs
+    auto it = opCodes().find(n->kind());
+    if(it == opCodes().end()) {
+      throw std::runtime_error(std::string("the fusion interpreter does not support ") +
+                               n->kind().toQualString());
+    }
+    Instruction ins;
+    ins.op = it->second;
+    ins.a = registers.at(n->inputs().at(0));
+    ins.b = ins.a;
+    if(n->inputs().size() > 1) {
+      ins.b = registers.at(n->inputs()[1]);
+    } else if(n->hasAttribute(attr::other) || n->hasAttribute(attr::exponent)) {
+      auto name = n->hasAttribute(attr::other) ? attr::other : attr::exponent;
+      ins.b = program.num_registers++;
+      program.constants.emplace_back(ins.b, scalarAttribute(n, name, 0));
+    }
+    ins.c0 = 0;
+    ins.c1 = 0;
+    if(ins.op == OpCode::Add || ins.op == OpCode::Sub) {
+      ins.c0 = scalarAttribute(n, attr::alpha, 1);
+    } else if(ins.op == OpCode::Lerp) {
+      ins.c0 = scalarAttribute(n, attr::weight, 0);
+    } else if(ins.op == OpCode::Clamp) {
+      ins.c0 = scalarAttribute(n, attr::min, -std::numeric_limits<float>::infinity());
+      ins.c1 = scalarAttribute(n, attr::max, std::numeric_limits<float>::infinity());
+    }
+    ins.out = program.num_registers++;
+    registers[n->output()] = ins.out;
+    program.instructions.push_back(ins);
+  }
+  for(auto o : flat_outputs) {
+    program.outputs.push_back(registers.at(o));
+  }
+  return program;
+}
+
+#define UNARY_OP(name, expr)                \
+  case OpCode::name:                        \
+    for(int64_t i = 0; i < n; ++i) {        \
+      float x = a[i];                       \
+      out[i] = (expr);                      \
+    }                                       \
+    break;
+
+#define BINARY_OP(name, expr)               \
+  case OpCode::name:                        \
+    for(int64_t i = 0; i < n; ++i) {        \
+      float x = a[i];                       \
+      float y = b[i];                       \
+      out[i] = (expr);                      \
+    }                                       \
+    break;
+
+// Runs ins on the first n elements of the registers. Every instruction
+// writes a register of its own, so out never aliases a or b.
+void execute(const Instruction & ins, float * registers, int64_t n) {
+  float * __restrict__ out = registers + ins.out * kBlockSize;
+  const float * __restrict__ a = registers + ins.a * kBlockSize;
+  const float * __restrict__ b = registers + ins.b * kBlockSize;
+  const float c0 = ins.c0;
+  const float c1 = ins.c1;
+  switch(ins.op) {
+    UNARY_OP(Abs, std::fabs(x))
+    UNARY_OP(Sigmoid, 1.f / (1.f + std::exp(-x)))
+    UNARY_OP(Relu, x < 0 ? 0.f : x)
+    UNARY_OP(Log, std::log(x))
+    UNARY_OP(Log10, std::log10(x))
+    UNARY_OP(Log1p, std::log1p(x))
+    UNARY_OP(Log2, std::log2(x))
+    UNARY_OP(Lgamma, std::lgamma(x))
+    UNARY_OP(Exp, std::exp(x))
+    UNARY_OP(Expm1, std::expm1(x))
+    UNARY_OP(Cos, std::cos(x))
+    UNARY_OP(Acos, std::acos(x))
+    UNARY_OP(Cosh, std::cosh(x))
+    UNARY_OP(Sin, std::sin(x))
+    UNARY_OP(Asin, std::asin(x))
+    UNARY_OP(Sinh, std::sinh(x))
+    UNARY_OP(Tan, std::tan(x))
+    UNARY_OP(Atan, std::atan(x))
+    UNARY_OP(Tanh, std::tanh(x))
+    UNARY_OP(Sqrt, std::sqrt(x))
+    UNARY_OP(Rsqrt, 1.f / std::sqrt(x))
+    UNARY_OP(Ceil, std::ceil(x))
+    UNARY_OP(Floor, std::floor(x))
+    UNARY_OP(Round, std::round(x))
+    UNARY_OP(Trunc, std::trunc(x))
+    UNARY_OP(Frac, x - std::trunc(x))
+    UNARY_OP(Reciprocal, 1.f / x)
+    UNARY_OP(Neg, -x)
+    UNARY_OP(TypeAs, x)
+    BINARY_OP(Atan2, std::atan2(x, y))
+    BINARY_OP(Min, std::fmin(x, y))
+    BINARY_OP(Max, std::fmax(x, y))
+    BINARY_OP(And, x && y)
+    BINARY_OP(Lshift, static_cast<int64_t>(x) << static_cast<int64_t>(y))
+    BINARY_OP(Or, x || y)
+    BINARY_OP(Rshift, static_cast<int64_t>(x) >> static_cast<int64_t>(y))
+    BINARY_OP(Xor, static_cast<int64_t>(x) ^ static_cast<int64_t>(y))
+    BINARY_OP(Div, x / y)
+    BINARY_OP(Eq, x == y)
+    BINARY_OP(Fmod, std::fmod(x, y))
+    BINARY_OP(Ge, x >= y)
+    BINARY_OP(Gt, x > y)
+    BINARY_OP(Le, x <= y)
+    BINARY_OP(Lt, x < y)
+    BINARY_OP(Mul, x * y)
+    BINARY_OP(Ne, x != y)
+    BINARY_OP(Remainder, std::remainder(x, y))
+    BINARY_OP(Pow, std::pow(x, y))
+    BINARY_OP(Add, x + c0 * y)
+    BINARY_OP(Sub, x - c0 * y)
+    BINARY_OP(Lerp, x + c0 * (y - x))
+    UNARY_OP(Clamp, std::min(std::max(x, c0), c1))
+    BINARY_OP(SigmoidBackward, x * y * (1.f - y))
+    BINARY_OP(TanhBackward, x * (1.f - y * y))
+  }
+}
+
+#undef UNARY_OP
+#undef BINARY_OP
+
+struct Formal;
+using LoadFn = void(*)(const Formal &, TensorInfo *, uint32_t, int64_t, float *);
+using StoreFn = void(*)(const Formal &, TensorInfo *, uint32_t, int64_t, const float *);
+
+// The layout of an argument as described by its TensorDesc, together with
+// the functions that convert its elements to and from float.
+struct Formal {
+  size_t nDim;
+  bool last_is_contiguous;
+  LoadFn load;
+  StoreFn store;
+};
+
+// the same offset as the one computed by emitIndexingFor
+inline uint32_t offsetOf(const Formal & f, TensorInfo * t, uint32_t linear_index) {
+  uint32_t * sizes = t->sizes(f.nDim);
+  uint32_t * strides = t->strides(f.nDim);
+  uint32_t offset = 0;
+  for(int d = f.nDim - 1; d >= 0; --d) {
+    uint32_t index = d > 0 ? linear_index % sizes[d] : linear_index;
+    bool unit_stride = d == static_cast<int>(f.nDim) - 1 && f.last_is_contiguous;
+    offset += unit_stride ? index : index * strides[d];
+    if(d > 0) {
+      linear_index /= sizes[d];
+    }
+  }
+  return offset;
+}
+
+template<typename T>
+void load(const Formal & f, TensorInfo * t, uint32_t begin, int64_t n, float * out) {
+  T * data = static_cast<T*>(t->data);
+  if(f.nDim == 1 && f.last_is_contiguous) {
+    data += begin;
+    for(int64_t i = 0; i < n; ++i) {
+      out[i] = static_cast<float>(data[i]);
+    }
+  } else {
+    for(int64_t i = 0; i < n; ++i) {
+      out[i] = static_cast<float>(data[offsetOf(f, t, begin + i)]);
+    }
+  }
+}
+
+template<typename T>
+void store(const Formal & f, TensorInfo * t, uint32_t begin, int64_t n, const float * in) {
+  T * data = static_cast<T*>(t->data);
+  if(f.nDim == 1 && f.last_is_contiguous) {
+    data += begin;
+    for(int64_t i = 0; i < n; ++i) {
+      data[i] = static_cast<T>(in[i]);
+    }
+  } else {
+    for(int64_t i = 0; i < n; ++i) {
+      data[offsetOf(f, t, begin + i)] = static_cast<T>(in[i]);
+    }
+  }
+}
+
+Formal makeFormal(const TensorDesc & desc) {
+  Formal f;
+  f.nDim = desc.nDim();
+  f.last_is_contiguous = desc.lastIsContiguous();
+  switch(desc.scalar_type) {
+    #define DEFINE_CASE(ctype,name,_) \
+      case at::ScalarType::name: \
+        f.load = &load<ctype>; \
+        f.store = &store<ctype>; \
+        break;
+    AT_FORALL_SCALAR_TYPES(DEFINE_CASE)
+    #undef DEFINE_CASE
+    default:
+      throw std::runtime_error("unknown scalar type");
+  }
+  return f;
+}
+
+// arguments has the layout described in CompiledFusionFunction::launch_raw,
+// formals describes the inputs followed by the flattened outputs
+void run(const Program & program, const std::vector<Formal> & formals, uint32_t numel, void ** arguments) {
+  auto tensors = reinterpret_cast<TensorInfo**>(arguments + 1);
+  size_t num_inputs = formals.size() - program.outputs.size();
+  at::parallel_for(0, numel, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    std::vector<float> registers(program.num_registers * kBlockSize);
+    for(auto & c : program.constants) {
+      std::fill_n(registers.begin() + c.first * kBlockSize, kBlockSize, c.second);
+    }
+    for(int64_t block = begin; block < end; block += kBlockSize) {
+      int64_t n = std::min(kBlockSize, end - block);
+      for(size_t i = 0; i < num_inputs; ++i) {
+        formals[i].load(formals[i], tensors[i], block, n, &registers[i * kBlockSize]);
+      }
+      for(auto & ins : program.instructions) {
+        execute(ins, registers.data(), n);
+      }
+      for(size_t i = 0; i < program.outputs.size(); ++i) {
+        auto & f = formals[num_inputs + i];
+        f.store(f, tensors[num_inputs + i], block, n, &registers[program.outputs[i] * kBlockSize]);
+      }
+    }
+  });
+}
+
+} // interp namespace
+} // anonymous namespace
+
+struct InterpretedFusionFunction : public CompiledFusionFunction {
+  InterpretedFusionFunction(const std::string & name, AnnotatedGraph & agraph)
+  : CompiledFusionFunction(name, agraph) {
+    Graph & subgraph = *agraph.graph;
+    for(auto & desc : agraph.input_desc) {
+      formals.push_back(interp::makeFormal(desc));
+    }
+    std::vector<Value*> flat_outputs;
+    size_t i = 0;
+    for(auto o : subgraph.outputs()) {
+      auto & desc = agraph.output_desc[i++];
+      if(o->node()->kind() != aten::cat) {
+        formals.push_back(interp::makeFormal(desc));
+        concat_desc.emplace_back();
+        flat_outputs.push_back(o);
+      } else {
+        auto cat = o->node();
+        concat_desc.emplace_back(desc, cat->inputs().size(), cat->i(attr::dim));
+        for(auto c : cat->inputs()) {
+          formals.push_back(interp::makeFormal(*concat_desc.back().subtensorDesc));
+          flat_outputs.push_back(c);
+        }
+      }
+    }
+    program = interp::compile(subgraph, flat_outputs);
+  }
+protected:
+  virtual at::Backend backend() const override {
+    return at::kCPU;
+  }
+  virtual void launch_raw(uint32_t numel, void ** arguments) override {
+    interp::run(program, formals, numel, arguments);
+  }
+  interp::Program program;
+  std::vector<interp::Formal> formals;
+};
+
 std::shared_ptr<CompiledFusionFunction> FusionCompiler::getOrCompile(AnnotatedGraph & agraph) {
   std::stringstream key;
   key << *agraph.graph << "\n";
@@ -820,17 +1428,25 @@ std::shared_ptr<CompiledFusionFunction> FusionCompiler::getOrCompile(AnnotatedGr
 
   auto it = cache.find(key_);
   if (it == cache.end()) {
-    std::string name = "kernel_" + std::to_string(cache.size());
     CompiledFusionFunction * raw_func;
     if(agraph.device != kCPUDevice) {
 #ifdef USE_CUDA
+      std::string name = "kernel_" + std::to_string(cache.size());
       raw_func = new CUDAFusionFunction(name, agraph);
 #else
       throw std::runtime_error("cannot compile a CUDA fusion group, CUDA is not enabled.");
 #endif
     } else {
       JIT_ASSERT(canCompileOnCPU());
-      raw_func = new CPUFusionFunction(name, agraph, config_);
+      // name CPU kernels after the graph rather than the order in which they
+      // were compiled, so that the generated source (and with it the key of
+      // the on-disk kernel cache) is the same in every process
+      std::string name = "kernel_" + toHex(stableHash(key_));
+      if(config_.interpret) {
+        raw_func = new InterpretedFusionFunction(name, agraph);
+      } else {
+        raw_func = new CPUFusionFunction(name, agraph, config_, num_cpu_compiles_);
+      }
     }
     it = cache.emplace(key_, std::shared_ptr<CompiledFusionFunction>(raw_func)).first;
   }
@@ -891,6 +1507,18 @@ FusionCompiler::FusionCompiler() {
   }
   const char * debug_env = getenv("PYTORCH_FUSION_DEBUG");
   config_.debug = debug_env && atoi(debug_env) != 0;
+  const char * interpret_env = getenv("PYTORCH_FUSION_INTERPRET");
+  config_.interpret = config_.cxx.empty() || (interpret_env && atoi(interpret_env) != 0);
+  const char * cache_env = getenv("PYTORCH_FUSION_CACHE_DIR");
+  if(cache_env != nullptr && *cache_env != '\0' && !config_.interpret) {
+    if(makeWritableDirectory(cache_env)) {
+      config_.cache_dir = cache_env;
+      config_.cxx_version = compilerVersion(config_.cxx);
+    } else {
+      std::cerr << "warning: pytorch jit fuser cannot write to PYTORCH_FUSION_CACHE_DIR "
+                << cache_env << ", compiled kernels will not be cached\n";
+    }
+  }
 }
 
 //TODO: thread safety
@@ -121,6 +121,13 @@ struct FusionCompilerConfig {
   std::string cxx = "g++"; // compiler location
   bool debug = false; // emit debugging information about fusions
   bool openmp = true;
+  // directory of the persistent CPU kernel cache, disabled if empty
+  std::string cache_dir;
+  // output of `cxx --version`, part of the cache key
+  std::string cxx_version;
+  // run CPU fusion groups in the in-process interpreter instead of compiling
+  // them, always the case when no compiler is available
+  bool interpret = false;
 };
 
 // caching compiler
@@ -144,10 +151,18 @@ struct FusionCompiler {
   // the graph each time
   void debugLaunchGraph(Graph & graph, int device, at::ArrayRef<at::Tensor> inputs, at::ArrayRef<at::Tensor> outputs);
   bool canCompileOnCPU() const {
-    return config_.cxx.size() > 0;
+    return config_.interpret || config_.cxx.size() > 0;
+  }
+  bool interpretsOnCPU() const {
+    return config_.interpret;
+  }
+  // number of CPU kernels that were compiled rather than loaded from the cache
+  size_t numCPUCompiles() const {
+    return num_cpu_compiles_;
   }
 private:
   FusionCompilerConfig config_;
+  size_t num_cpu_compiles_ = 0;
   std::unordered_map<std::string, std::shared_ptr<CompiledFusionFunction>> cache;
 };
 
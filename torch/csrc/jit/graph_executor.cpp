@@ -19,6 +19,7 @@
 #include "torch/csrc/jit/passes/specialize_undef.h"
 #include "torch/csrc/jit/passes/loop_unrolling.h"
 #include "torch/csrc/jit/passes/lower_grad_of.h"
+#include "torch/csrc/jit/plan_cache.h"
 #include "torch/csrc/jit/symbolic_variable.h"
 
 #include "torch/csrc/autograd/edge.h"
@@ -380,13 +381,42 @@ private:
     return false;
   }
 
+  // The serialized unoptimized graph, which keys its plans in the on-disk
+  // plan cache. Empty if the cache is disabled or the graph cannot be
+  // serialized.
+  const std::string & planCacheSource() {
+    if(!plan_cache_source_computed && sharedPlanCache().enabled()) {
+      plan_cache_source_computed = true;
+      try {
+        plan_cache_source = serializeGraph(*graph);
+      } catch(const std::exception &) {
+        plan_cache_source.clear();
+      }
+    }
+    return plan_cache_source;
+  }
+
   ExecutionPlan compileSpec(const ArgumentSpec & spec) {
+    // Only plans that do not need a gradient go through the on-disk cache,
+    // since the Gradient of a differentiable plan is not serializable.
+    bool requires_gradient = argumentSpecRequiresGradient(spec);
+    bool use_disk_cache = !requires_gradient && !planCacheSource().empty();
+    if(use_disk_cache) {
+      auto cached = sharedPlanCache().load(plan_cache_source, spec);
+      if(cached) {
+        return ExecutionPlan(cached);
+      }
+    }
+
     auto graph_ = graph->copy();
 
     specializeToSpec(graph_, spec);
 
-    if(!argumentSpecRequiresGradient(spec)) {
+    if(!requires_gradient) {
       runOptimization(graph_, /*graphMustSupportVariables=*/false);
+      if(use_disk_cache) {
+        sharedPlanCache().store(plan_cache_source, spec, *graph_);
+      }
       return ExecutionPlan(graph_);
     }
     JIT_ASSERT(symbolically_differentiable);
@@ -434,6 +464,10 @@ private:
   // Spec describes input conditions, Plan describes how to execute them.
   std::unordered_map<ArgumentSpec, ExecutionPlan> plan_cache;
 
+  // see planCacheSource()
+  bool plan_cache_source_computed = false;
+  std::string plan_cache_source;
+
   // GraphExecutor can be accessed from  multiple thread so
   // anytime we are checking or updating the autograd_fallback or
   // plan_cache, we must hold the compile mutex.
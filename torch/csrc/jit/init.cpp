@@ -20,6 +20,7 @@
 #include "torch/csrc/jit/passes/loop_unrolling.h"
 #include "torch/csrc/jit/passes/specialize_undef.h"
 #include "torch/csrc/jit/graph_executor.h"
+#include "torch/csrc/jit/plan_cache.h"
 #include "torch/csrc/jit/script/init.h"
 #include "torch/csrc/jit/script/python_tree_views.h"
 #include "torch/csrc/jit/batched/BatchTensor.h"
@@ -95,6 +96,16 @@ void initJITBindings(PyObject *module) {
        // jit::differentiate mutates the input Graph
        auto g_clone = g.copy();
        return differentiate(g_clone, requires_grad);
+   })
+   .def("_jit_set_plan_cache_dir", [](const std::string& dir) {
+       sharedPlanCache().setDirectory(dir);
+   })
+   .def("_jit_plan_cache_stats", [] {
+       auto stats = sharedPlanCache().stats();
+       return std::make_tuple(stats.hits, stats.misses, stats.stores);
+   })
+   .def("_jit_reset_plan_cache_stats", [] {
+       sharedPlanCache().resetStats();
    });
 
   py::class_<ArgumentSpec>(m, "ArgumentSpec")
@@ -0,0 +1,568 @@
+#include "torch/csrc/jit/plan_cache.h"
+
+#include "ATen/DeviceGuard.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace torch { namespace jit {
+
+namespace {
+
+// Bump this whenever the serialized graph format changes.
+constexpr uint32_t kFormatVersion = 1;
+constexpr char kMagic[] = "PTJITPLAN";
+
+// Entries written by any other build are ignored, since the operators,
+// passes and the layout of ScalarType may differ between builds. The build
+// is identified by the torch version and git commit, which setup.py and
+// torch/CMakeLists.txt pass in as TORCH_BUILD_VERSION. Builds without it
+// don't use the cache.
+const char* buildStamp() {
+#ifdef TORCH_BUILD_VERSION
+  return TORCH_BUILD_VERSION;
+#else
+  return "";
+#endif
+}
+
+// 64-bit FNV-1a, stable across processes and builds.
+uint64_t stableHash(const std::string & str) {
+  uint64_t hash = 14695981039346656037ULL;
+  for(unsigned char c : str) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+struct GraphWriter {
+  void writeGraph(Graph & g) {
+    values.clear();
+    writeBlock(g.block());
+  }
+
+  std::string out;
+
+private:
+  void writeRaw(const void * data, size_t size) {
+    out.append(reinterpret_cast<const char*>(data), size);
+  }
+  void writeInt(int64_t v) {
+    writeRaw(&v, sizeof(v));
+  }
+  void writeDouble(double v) {
+    writeRaw(&v, sizeof(v));
+  }
+  void writeString(const std::string & s) {
+    writeInt(s.size());
+    writeRaw(s.data(), s.size());
+  }
+  void writeInts(at::IntList v) {
+    writeInt(v.size());
+    for(auto i : v)
+      writeInt(i);
+  }
+  void writeType(const TypePtr & type) {
+    writeInt(static_cast<int64_t>(type->kind()));
+    if(auto tt = type->cast<TensorType>()) {
+      writeInt(static_cast<int64_t>(tt->scalarType()));
+      writeInt(tt->device());
+      writeInts(tt->sizes());
+      writeInts(tt->strides());
+    } else if(auto lt = type->cast<ListType>()) {
+      writeType(lt->getElementType());
+    } else if(auto tt = type->cast<TupleType>()) {
+      writeInt(tt->elements().size());
+      for(auto & e : tt->elements())
+        writeType(e);
+    }
+  }
+  void writeTensor(const at::Tensor & t) {
+    writeInt(t.defined());
+    if(!t.defined())
+      return;
+    writeInt(static_cast<int64_t>(t.type().scalarType()));
+    writeInt(t.type().is_cuda() ? t.get_device() : -1);
+    writeInts(t.sizes());
+    auto cpu = t.toBackend(at::kCPU);
+    if(!cpu.is_contiguous())
+      cpu = cpu.contiguous();
+    writeString(std::string(
+        static_cast<const char*>(cpu.data_ptr()),
+        cpu.numel() * cpu.type().elementSizeInBytes()));
+  }
+  void defineValue(Value * v) {
+    auto index = values.size();
+    values[v] = index;
+    writeType(v->type());
+    writeInt(v->stage());
+    writeString(v->hasUniqueName() ? v->uniqueName() : "");
+  }
+  void writeUse(Value * v) {
+    auto it = values.find(v);
+    if(it == values.end())
+      throw std::runtime_error("plan cache: value used before its definition");
+    writeInt(it->second);
+  }
+  void writeSubgraph(Graph & g) {
+    // subgraphs have their own value numbering
+    GraphWriter sub;
+    sub.writeGraph(g);
+    writeString(sub.out);
+  }
+  void writeAttribute(Node * n, Symbol name) {
+    writeString(name.toQualString());
+    auto kind = n->kindOf(name);
+    writeInt(static_cast<int64_t>(kind));
+    switch(kind) {
+      case AttributeKind::f:
+        writeDouble(n->f(name));
+        break;
+      case AttributeKind::fs:
+        writeInt(n->fs(name).size());
+        for(auto v : n->fs(name))
+          writeDouble(v);
+        break;
+      case AttributeKind::i:
+        writeInt(n->i(name));
+        break;
+      case AttributeKind::is:
+        writeInts(n->is(name));
+        break;
+      case AttributeKind::s:
+        writeString(n->s(name));
+        break;
+      case AttributeKind::ss:
+        writeInt(n->ss(name).size());
+        for(auto & v : n->ss(name))
+          writeString(v);
+        break;
+      case AttributeKind::t:
+        writeTensor(n->t(name));
+        break;
+      case AttributeKind::ts:
+        writeInt(n->ts(name).size());
+        for(auto & v : n->ts(name))
+          writeTensor(v);
+        break;
+      case AttributeKind::g:
+        writeSubgraph(*n->g(name));
+        break;
+      case AttributeKind::gs:
+        writeInt(n->gs(name).size());
+        for(auto & v : n->gs(name))
+          writeSubgraph(*v);
+        break;
+    }
+  }
+  void writeNode(Node * n) {
+    if(n->kind() == prim::PythonOp || n->kind() == prim::CppOp) {
+      throw std::runtime_error(
+          std::string("plan cache: cannot serialize ") + n->kind().toQualString());
+    }
+    writeString(n->kind().toQualString());
+    writeInt(n->stage());
+    writeInt(n->inputs().size());
+    for(auto input : n->inputs())
+      writeUse(input);
+    auto names = n->attributeNames();
+    writeInt(names.size());
+    for(auto name : names)
+      writeAttribute(n, name);
+    writeInt(n->outputs().size());
+    for(auto output : n->outputs())
+      defineValue(output);
+    writeInt(n->blocks().size());
+    for(auto b : n->blocks())
+      writeBlock(b);
+  }
+  void writeBlock(Block * b) {
+    writeInt(b->inputs().size());
+    for(auto input : b->inputs())
+      defineValue(input);
+    int64_t num_nodes = 0;
+    for(auto n : b->nodes()) {
+      (void) n;
+      num_nodes++;
+    }
+    writeInt(num_nodes);
+    for(auto n : b->nodes())
+      writeNode(n);
+    writeInt(b->outputs().size());
+    for(auto output : b->outputs())
+      writeUse(output);
+  }
+
+  std::unordered_map<Value*, int64_t> values;
+};
+
+struct GraphReader {
+  GraphReader(const char * data, size_t size)
+  : cur(data), end(data + size) {}
+
+  std::shared_ptr<Graph> readGraph() {
+    auto g = std::make_shared<Graph>();
+    readBlock(g->block());
+    return g;
+  }
+  bool atEnd() const {
+    return cur == end;
+  }
+
+private:
+  void readRaw(void * data, size_t size) {
+    if(size > static_cast<size_t>(end - cur))
+      throw std::runtime_error("plan cache: unexpected end of data");
+    std::memcpy(data, cur, size);
+    cur += size;
+  }
+  int64_t readInt() {
+    int64_t v;
+    readRaw(&v, sizeof(v));
+    return v;
+  }
+  double readDouble() {
+    double v;
+    readRaw(&v, sizeof(v));
+    return v;
+  }
+  size_t readSize() {
+    auto v = readInt();
+    if(v < 0 || v > end - cur)
+      throw std::runtime_error("plan cache: invalid length");
+    return v;
+  }
+  std::string readString() {
+    std::string s(readSize(), '\0');
+    readRaw(&s[0], s.size());
+    return s;
+  }
+  std::vector<int64_t> readInts() {
+    std::vector<int64_t> v(readSize());
+    for(auto & i : v)
+      i = readInt();
+    return v;
+  }
+  TypePtr readType() {
+    switch(static_cast<TypeKind>(readInt())) {
+      case TypeKind::DynamicType:
+        return DynamicType::get();
+      case TypeKind::TensorType: {
+        auto scalar_type = static_cast<at::ScalarType>(readInt());
+        int device = readInt();
+        auto sizes = readInts();
+        auto strides = readInts();
+        return std::make_shared<TensorType>(scalar_type, device, sizes, strides);
+      }
+      case TypeKind::HandleType:
+        return HandleType::get();
+      case TypeKind::TupleType: {
+        std::vector<TypePtr> elements(readSize());
+        for(auto & e : elements)
+          e = readType();
+        return std::make_shared<TupleType>(std::move(elements));
+      }
+      case TypeKind::ListType:
+        return std::make_shared<ListType>(readType());
+      case TypeKind::NumberType:
+        return NumberType::get();
+      case TypeKind::FloatType:
+        return FloatType::get();
+      case TypeKind::IntType:
+        return IntType::get();
+    }
+    throw std::runtime_error("plan cache: unknown type kind");
+  }
+  at::Tensor readTensor() {
+    if(!readInt())
+      return at::Tensor();
+    auto scalar_type = static_cast<at::ScalarType>(readInt());
+    int device = readInt();
+    auto sizes = readInts();
+    auto data = readString();
+    auto t = at::CPU(scalar_type).tensor(sizes);
+    if(data.size() != t.numel() * t.type().elementSizeInBytes())
+      throw std::runtime_error("plan cache: tensor size mismatch");
+    std::memcpy(t.data_ptr(), data.data(), data.size());
+    if(device >= 0) {
+      at::DeviceGuard guard(device);
+      t = t.toBackend(at::kCUDA);
+    }
+    return t;
+  }
+  void defineValue(Value * v) {
+    v->setType(readType());
+    v->setStage(readInt());
+    auto name = readString();
+    if(!name.empty())
+      v->setUniqueName(name);
+    values.push_back(v);
+  }
+  Value * readUse() {
+    auto i = readInt();
+    if(i < 0 || static_cast<size_t>(i) >= values.size())
+      throw std::runtime_error("plan cache: invalid value reference");
+    return values[i];
+  }
+  std::shared_ptr<Graph> readSubgraph() {
+    auto data = readString();
+    GraphReader sub(data.data(), data.size());
+    auto g = sub.readGraph();
+    if(!sub.atEnd())
+      throw std::runtime_error("plan cache: trailing data in subgraph");
+    return g;
+  }
+  void readAttribute(Node * n) {
+    auto name = Symbol::fromQualString(readString());
+    switch(static_cast<AttributeKind>(readInt())) {
+      case AttributeKind::f:
+        n->f_(name, readDouble());
+        break;
+      case AttributeKind::fs: {
+        std::vector<double> v(readSize());
+        for(auto & f : v)
+          f = readDouble();
+        n->fs_(name, std::move(v));
+      } break;
+      case AttributeKind::i:
+        n->i_(name, readInt());
+        break;
+      case AttributeKind::is:
+        n->is_(name, readInts());
+        break;
+      case AttributeKind::s:
+        n->s_(name, readString());
+        break;
+      case AttributeKind::ss: {
+        std::vector<std::string> v(readSize());
+        for(auto & s : v)
+          s = readString();
+        n->ss_(name, std::move(v));
+      } break;
+      case AttributeKind::t:
+        n->t_(name, readTensor());
+        break;
+      case AttributeKind::ts: {
+        std::vector<at::Tensor> v(readSize());
+        for(auto & t : v)
+          t = readTensor();
+        n->ts_(name, std::move(v));
+      } break;
+      case AttributeKind::g:
+        n->g_(name, readSubgraph());
+        break;
+      case AttributeKind::gs: {
+        std::vector<std::shared_ptr<Graph>> v(readSize());
+        for(auto & g : v)
+          g = readSubgraph();
+        n->gs_(name, std::move(v));
+      } break;
+      default:
+        throw std::runtime_error("plan cache: unknown attribute kind");
+    }
+  }
+  void readNode(Block * b) {
+    auto kind = Symbol::fromQualString(readString());
+    auto stage = readInt();
+    auto n = b->owningGraph()->create(kind, 0);
+    n->setStage(stage);
+    b->appendNode(n);
+    auto num_inputs = readSize();
+    for(size_t i = 0; i < num_inputs; ++i)
+      n->addInput(readUse());
+    auto num_attributes = readSize();
+    for(size_t i = 0; i < num_attributes; ++i)
+      readAttribute(n);
+    auto num_outputs = readSize();
+    for(size_t i = 0; i < num_outputs; ++i)
+      defineValue(n->addOutput());
+    auto num_blocks = readSize();
+    for(size_t i = 0; i < num_blocks; ++i)
+      readBlock(n->addBlock());
+  }
+  void readBlock(Block * b) {
+    auto num_inputs = readSize();
+    for(size_t i = 0; i < num_inputs; ++i)
+      defineValue(b->addInput());
+    auto num_nodes = readSize();
+    for(size_t i = 0; i < num_nodes; ++i)
+      readNode(b);
+    auto num_outputs = readSize();
+    for(size_t i = 0; i < num_outputs; ++i)
+      b->registerOutput(readUse());
+  }
+
+  const char * cur;
+  const char * end;
+  std::vector<Value*> values;
+};
+
+// An entry file holds the header, the full key and the optimized graph.
+// The key is stored so that hash collisions are detected on load.
+std::string encodeEntry(const std::string & source, const std::string & spec, const std::string & plan) {
+  std::stringstream ss;
+  ss << kMagic << '\n' << kFormatVersion << '\n' << buildStamp() << '\n'
+     << source.size() << '\n' << source
+     << spec.size() << '\n' << spec
+     << plan.size() << '\n' << plan;
+  return ss.str();
+}
+
+bool readField(std::istream & in, std::string & field) {
+  size_t size;
+  if(!(in >> size) || in.get() != '\n')
+    return false;
+  field.resize(size);
+  return static_cast<bool>(in.read(&field[0], size));
+}
+
+bool decodeEntry(std::istream & in, const std::string & source, const std::string & spec, std::string & plan) {
+  std::string magic, version, stamp, stored_source, stored_spec;
+  if(!std::getline(in, magic) || magic != kMagic)
+    return false;
+  if(!std::getline(in, version) || version != std::to_string(kFormatVersion))
+    return false;
+  if(!std::getline(in, stamp) || stamp != buildStamp())
+    return false;
+  return readField(in, stored_source) && stored_source == source &&
+         readField(in, stored_spec) && stored_spec == spec &&
+         readField(in, plan);
+}
+
+std::string specString(const ArgumentSpec & spec) {
+  std::stringstream ss;
+  ss << spec;
+  return ss.str();
+}
+
+} // anonymous namespace
+
+std::string serializeGraph(Graph & graph) {
+  GraphWriter writer;
+  writer.writeGraph(graph);
+  return std::move(writer.out);
+}
+
+std::shared_ptr<Graph> deserializeGraph(const std::string & data) {
+  GraphReader reader(data.data(), data.size());
+  auto g = reader.readGraph();
+  if(!reader.atEnd())
+    throw std::runtime_error("plan cache: trailing data after graph");
+  return g;
+}
+
+PersistentPlanCache::PersistentPlanCache()
+: hits_(0), misses_(0), stores_(0) {
+  const char * dir_env = getenv("PYTORCH_JIT_PLAN_CACHE_DIR");
+  if(dir_env != nullptr) {
+    dir_ = dir_env;
+  }
+}
+
+bool PersistentPlanCache::enabled() {
+  return !directory().empty();
+}
+
+void PersistentPlanCache::setDirectory(const std::string & dir) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  dir_ = dir;
+}
+
+std::string PersistentPlanCache::directory() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return dir_;
+}
+
+std::string PersistentPlanCache::pathFor(const std::string & source, const ArgumentSpec & spec) {
+  auto dir = directory();
+  if(dir.empty() || buildStamp()[0] == '\0')
+    return "";
+  std::stringstream key;
+  key << buildStamp() << '\n' << source << '\n' << spec;
+  std::stringstream path;
+  path << dir << "/plan_" << std::hex << std::setw(16) << std::setfill('0')
+       << stableHash(key.str()) << ".bin";
+  return path.str();
+}
+
+std::shared_ptr<Graph> PersistentPlanCache::load(const std::string & source, const ArgumentSpec & spec) {
+  auto path = pathFor(source, spec);
+  if(path.empty())
+    return nullptr;
+  std::ifstream in(path, std::ios::binary);
+  std::string plan;
+  if(in && decodeEntry(in, source, specString(spec), plan)) {
+    try {
+      auto graph = deserializeGraph(plan);
+      graph->lint();
+      hits_++;
+      return graph;
+    } catch(const std::exception & e) {
+      std::cerr << "warning: pytorch jit failed to load cached plan "
+                << path << ": " << e.what() << "\n";
+    }
+  }
+  misses_++;
+  return nullptr;
+}
+
+void PersistentPlanCache::store(const std::string & source, const ArgumentSpec & spec, Graph & optimized) {
+  auto path = pathFor(source, spec);
+  if(path.empty())
+    return;
+  std::string plan;
+  try {
+    plan = serializeGraph(optimized);
+  } catch(const std::exception &) {
+    // graphs with PythonOps and the like are not cacheable
+    return;
+  }
+  // Write next to the final location and rename, so that concurrent
+  // processes never observe a partially written entry.
+  std::string tmp_path = path + ".tmp" + std::to_string(getpid());
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    out << encodeEntry(source, specString(spec), plan);
+    if(!out) {
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  if(std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    return;
+  }
+  stores_++;
+}
+
+PlanCacheStats PersistentPlanCache::stats() const {
+  PlanCacheStats s;
+  s.hits = hits_.load();
+  s.misses = misses_.load();
+  s.stores = stores_.load();
+  return s;
+}
+
+void PersistentPlanCache::resetStats() {
+  hits_ = 0;
+  misses_ = 0;
+  stores_ = 0;
+}
+
+PersistentPlanCache & sharedPlanCache() {
+  static PersistentPlanCache cache;
+  return cache;
+}
+
+}}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "torch/csrc/jit/ir.h"
+#include "torch/csrc/jit/argument_spec.h"
+
+namespace torch { namespace jit {
+
+// Serializes a graph, including the types of all values and every attribute
+// and nested block or subgraph, into a compact binary string.
+// Throws std::runtime_error for graphs that contain nodes whose state lives
+// outside of their attributes (PythonOp and CppOp).
+std::string serializeGraph(Graph& graph);
+
+// Inverse of serializeGraph. Throws std::runtime_error on malformed input.
+std::shared_ptr<Graph> deserializeGraph(const std::string& data);
+
+struct PlanCacheStats {
+  size_t hits;
+  size_t misses;
+  size_t stores;
+};
+
+// On-disk cache of optimized graphs produced by GraphExecutor.
+//
+// Entries are keyed by the unoptimized graph and the ArgumentSpec it was
+// specialized to, and are stamped with the build that produced them, so
+// entries written by a different build are ignored. Fusion groups in a
+// cached graph are compiled lazily as usual; set PYTORCH_FUSION_CACHE_DIR
+// as well to skip compiling their CPU kernels.
+//
+// The cache is enabled by setting PYTORCH_JIT_PLAN_CACHE_DIR to an existing
+// directory, or by calling setDirectory.
+struct PersistentPlanCache {
+  PersistentPlanCache();
+
+  bool enabled();
+  void setDirectory(const std::string& dir);
+
+  // source is serializeGraph() of the unoptimized graph.
+  // Returns the cached optimized graph for (source, spec), or nullptr if
+  // there is no valid entry.
+  std::shared_ptr<Graph> load(const std::string& source, const ArgumentSpec& spec);
+  // Saves optimized as the plan for (source, spec). Failures are not fatal,
+  // the plan is simply not cached.
+  void store(const std::string& source, const ArgumentSpec& spec, Graph& optimized);
+
+  PlanCacheStats stats() const;
+  void resetStats();
+
+private:
+  std::string directory();
+  std::string pathFor(const std::string& source, const ArgumentSpec& spec);
+
+  std::mutex mutex_;
+  std::string dir_;
+  std::atomic<size_t> hits_;
+  std::atomic<size_t> misses_;
+  std::atomic<size_t> stores_;
+};
+
+PersistentPlanCache& sharedPlanCache();
+
+}}
@@ -33,6 +33,7 @@
 #include "torch/csrc/jit/passes/shape_analysis.h"
 
 #include "torch/csrc/jit/graph_executor.h"
+#include "torch/csrc/jit/plan_cache.h"
 #include "torch/csrc/jit/script/compiler.h"
 #include "torch/csrc/jit/script/module.h"
 #include "onnx/onnx_pb.h"
@@ -42,12 +43,16 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
 #include <string>
 #include <tuple>
+#include <unistd.h>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -816,6 +821,248 @@ void testGraphExecutor() {
   REQUIRE(almostEqual(Variable(outputs[1]).data(), r1));
 }
 
+// Removes a directory and the files in it when going out of scope
+struct TempDirRemover {
+  explicit TempDirRemover(std::string path) : path(std::move(path)) {}
+  ~TempDirRemover() {
+    if(DIR * d = opendir(path.c_str())) {
+      while(dirent * entry = readdir(d)) {
+        std::string name = entry->d_name;
+        if(name != "." && name != "..")
+          unlink((path + "/" + name).c_str());
+      }
+      closedir(d);
+    }
+    rmdir(path.c_str());
+  }
+  std::string path;
+};
+
+void testPlanCache() {
+  constexpr int batch_size = 4;
+  constexpr int input_size = 8;
+  int hidden_size = 2*input_size;
+
+  auto v = [](at::Tensor t) { return autograd::make_variable(t, false); };
+  auto input = at::randn({batch_size, input_size}, at::kCPU);
+  auto hx    = at::randn({batch_size, hidden_size}, at::kCPU);
+  auto cx    = at::randn({batch_size, hidden_size}, at::kCPU);
+  auto w_ih  = t_def(at::randn({4 * hidden_size, input_size}, at::kCPU));
+  auto w_hh  = t_def(at::randn({4 * hidden_size, hidden_size}, at::kCPU));
+
+  // graphs round trip with their types, attributes and nested blocks
+  {
+    auto g = build_lstm();
+    ArgumentSpec spec(false, createVarList({v(input), v(hx), v(cx), v(w_ih), v(w_hh)}));
+    PropagateInputShapes(*g, spec);
+    auto n = g->appendNode(g->create(prim::If, {g->inputs()[0]}, 1));
+    n->f_(attr::alpha, 0.1)
+     ->fs_(attr::axes, {1.5, -2.25})
+     ->i_(attr::axis, 3)
+     ->is_(attr::perm, {1, 0})
+     ->s_(attr::name, "cached")
+     ->ss_(attr::direction, {"a", "b"})
+     ->t_(attr::value, at::randn({2, 3}, at::kCPU))
+     ->ts_(attr::sizes, {at::randn({2}, at::kCPU), at::randn({3, 1}, at::kCPU)})
+     ->g_(attr::Subgraph, build_lstm());
+    for(int i = 0; i < 2; ++i) {
+      n->addBlock()->registerOutput(g->inputs()[i]);
+    }
+    g->registerOutput(n->output());
+    g->lint();
+
+    auto g2 = deserializeGraph(serializeGraph(*g));
+    g2->lint();
+    REQUIRE(toString(g) == toString(g2));
+    auto n2 = g2->outputs().back()->node();
+    REQUIRE(n2->f(attr::alpha) == 0.1);
+    REQUIRE(n2->fs(attr::axes) == std::vector<double>({1.5, -2.25}));
+    REQUIRE(exactlyEqual(n2->t(attr::value), n->t(attr::value)));
+    REQUIRE(n2->ts(attr::sizes)[1].sizes().equals(n->ts(attr::sizes)[1].sizes()));
+    REQUIRE(n2->blocks().size() == 2);
+    REQUIRE((*n2->g(attr::Subgraph)->nodes().begin())->kind() == aten::mm);
+  }
+
+  // a second executor of the same graph loads the plan written by the first
+  char dir[] = "/tmp/pytorch_plan_cacheXXXXXX";
+  REQUIRE(mkdtemp(dir) != nullptr);
+  TempDirRemover remove_dir(dir);
+  auto & cache = sharedPlanCache();
+  cache.setDirectory(dir);
+  cache.resetStats();
+
+  std::vector<at::Tensor> outputs[2];
+  for(int i = 0; i < 2; ++i) {
+    GraphExecutor executor(build_lstm());
+    auto results = executor.run(createVarList({v(input), v(hx), v(cx), v(w_ih), v(w_hh)}));
+    outputs[i].assign(results.begin(), results.end());
+  }
+  auto stats = cache.stats();
+  REQUIRE(stats.misses == 1);
+  REQUIRE(stats.stores == 1);
+  REQUIRE(stats.hits == 1);
+  for(size_t i = 0; i < outputs[0].size(); ++i) {
+    REQUIRE(exactlyEqual(Variable(outputs[0][i]).data(), Variable(outputs[1][i]).data()));
+  }
+  at::Tensor r0, r1;
+  std::tie(r0, r1) = lstm(input, hx, cx, w_ih, w_hh);
+  REQUIRE(almostEqual(Variable(outputs[1][0]).data(), r0));
+  REQUIRE(almostEqual(Variable(outputs[1][1]).data(), r1));
+
+  cache.setDirectory("");
+  cache.resetStats();
+}
+
+// Sets an environment variable and restores its previous value when going
+// out of scope
+struct EnvGuard {
+  EnvGuard(std::string name, const std::string & value) : name(std::move(name)) {
+    const char * old = getenv(this->name.c_str());
+    had_value = old != nullptr;
+    if(had_value)
+      old_value = old;
+    setenv(this->name.c_str(), value.c_str(), 1);
+  }
+  ~EnvGuard() {
+    if(had_value)
+      setenv(name.c_str(), old_value.c_str(), 1);
+    else
+      unsetenv(name.c_str());
+  }
+  std::string name;
+  std::string old_value;
+  bool had_value;
+};
+
+void testFusionInterpreter() {
+  EnvGuard interpret("PYTORCH_FUSION_INTERPRET", "1");
+  FusionCompiler comp;
+  REQUIRE(comp.interpretsOnCPU());
+
+  // the pointwise part of an LSTM cell on tensors with different strides,
+  // large enough to be split across threads
+  auto testOne = [&](int ti, int tj, int toi, int toj) {
+    Graph graph;
+    Var i0 = Var::asNewInput(graph);
+    Var i1 = Var::asNewInput(graph);
+    Var i2 = Var::asNewInput(graph);
+    Var i3 = Var::asNewInput(graph);
+    auto o1 = i2.sigmoid() * i0 + i3.sigmoid() * i1.tanh();
+    auto o0 = i3.sigmoid() * o1.tanh();
+    o0.addAsOutput();
+    o1.addAsOutput();
+    graph.lint();
+
+    std::vector<at::Tensor> inputs;
+    std::vector<at::Tensor> outputs;
+    for(size_t i = 0; i < graph.inputs().size(); i++) {
+      std::vector<int64_t> dims = {128, 128, 32};
+      std::swap(dims[ti],dims[tj]);
+      inputs.push_back(at::rand(dims, at::kCPU).transpose(ti, tj));
+    }
+    for(size_t i = 0; i < graph.outputs().size(); i++) {
+      std::vector<int64_t> dims = {128, 128, 32};
+      std::swap(dims[toi],dims[toj]);
+      outputs.push_back(at::zeros(dims, at::kCPU).transpose(toi,toj));
+    }
+    auto out1 = inputs[2].sigmoid() * inputs[0] + inputs[3].sigmoid() * inputs[1].tanh();
+    auto out0 = inputs[3].sigmoid() * out1.tanh();
+
+    comp.debugLaunchGraph(graph, kCPUDevice, inputs, outputs);
+    REQUIRE(almostEqual(outputs[0], out0));
+    REQUIRE(almostEqual(outputs[1], out1));
+  };
+  testOne(0,0,0,0);
+  testOne(0,1,0,0);
+  testOne(1,2,0,0);
+  testOne(0,0,0,1);
+  testOne(1,2,0,2);
+
+  // scalar operands and attributes, a byte output and concats
+  for(int dim = 0; dim < 3; ++dim) {
+    Graph graph;
+    Var i0 = Var::asNewInput(graph);
+    Var i1 = Var::asNewInput(graph);
+    auto o0 = (i0 * 2 + i1 - i1.sigmoid()) / 4;
+    o0.addAsOutput();
+    (i0 > 0.5).addAsOutput();
+    Var::cat({i0, o0}, dim).addAsOutput();
+
+    auto a = at::rand({3,4,5}, at::kCPU);
+    auto b = at::rand({4,3,5}, at::kCPU).transpose(0,1);
+    auto o0_r = (a * 2 + b - b.sigmoid()) / 4;
+    auto o2_r = at::cat({a, o0_r}, dim);
+    auto o0_ = at::zeros({3,4,5}, at::kCPU);
+    auto o1_ = at::zeros({3,4,5}, at::kByte);
+    auto o2_ = at::zeros(o2_r.sizes(), at::kCPU);
+    comp.debugLaunchGraph(graph, kCPUDevice, {a, b}, {o0_, o1_, o2_});
+    REQUIRE(almostEqual(o0_, o0_r));
+    REQUIRE(o1_.equal(a > 0.5));
+    REQUIRE(almostEqual(o2_, o2_r));
+  }
+}
+
+void testFusionKernelCache() {
+  char dir[] = "/tmp/pytorch_fusion_cacheXXXXXX";
+  REQUIRE(mkdtemp(dir) != nullptr);
+  TempDirRemover remove_dir(dir);
+  // the cache directory doesn't exist yet
+  std::string cache_dir = std::string(dir) + "/kernels";
+  TempDirRemover remove_cache_dir(cache_dir);
+  EnvGuard cache_env("PYTORCH_FUSION_CACHE_DIR", cache_dir);
+
+  Graph graph;
+  Var i0 = Var::asNewInput(graph);
+  Var i1 = Var::asNewInput(graph);
+  (i0 * i1).sigmoid().addAsOutput();
+  auto a = at::rand({3,4}, at::kCPU);
+  auto b = at::rand({4,3}, at::kCPU).transpose(0,1);
+  auto launch = [&](FusionCompiler & comp) {
+    auto o = at::zeros({3,4}, at::kCPU);
+    comp.debugLaunchGraph(graph, kCPUDevice, {a, b}, {o});
+    REQUIRE(almostEqual(o, (a * b).sigmoid()));
+  };
+
+  {
+    FusionCompiler comp;
+    if(comp.interpretsOnCPU())
+      return; // no compiler, nothing is cached
+    launch(comp);
+    REQUIRE(comp.numCPUCompiles() == 1);
+  }
+  // a new FusionCompiler, like a new process, loads the kernel from the cache
+  {
+    FusionCompiler comp;
+    launch(comp);
+    REQUIRE(comp.numCPUCompiles() == 0);
+  }
+  // a kernel whose stored key doesn't match is compiled again
+  {
+    DIR * d = opendir(cache_dir.c_str());
+    REQUIRE(d != nullptr);
+    while(dirent * entry = readdir(d)) {
+      std::string name = entry->d_name;
+      if(name.size() > 4 && name.substr(name.size() - 4) == ".key")
+        std::ofstream(cache_dir + "/" + name, std::ios::trunc) << "stale";
+    }
+    closedir(d);
+    FusionCompiler comp;
+    launch(comp);
+    REQUIRE(comp.numCPUCompiles() == 1);
+  }
+  // a cache directory that can't be created disables the cache
+  {
+    std::string file = std::string(dir) + "/file";
+    std::ofstream(file) << "not a directory";
+    EnvGuard bad_cache_env("PYTORCH_FUSION_CACHE_DIR", file + "/kernels");
+    for(int i = 0; i < 2; ++i) {
+      FusionCompiler comp;
+      launch(comp);
+      REQUIRE(comp.numCPUCompiles() == 1);
+    }
+  }
+}
+
 void testBlocks(std::ostream & out) {
   Graph g;
   auto a = Var::asNewInput(g, "a");
@@ -915,6 +1162,9 @@ std::string runJITCPPTests() {
   argumentSpecTest();
   shapeAnalysisTest();
   testProto();
+  testPlanCache();
+  testFusionInterpreter();
+  testFusionKernelCache();
   return out.str();
 }
 
@@ -941,6 +1191,12 @@ TEST_CASE( "jit test CPU", "[cpu]" ) {
     attributesTest();
   SECTION( "interned strings" )
     internedStringsTests();
+  SECTION( "plan cache" )
+    testPlanCache();
+  SECTION( "fusion interpreter" )
+    testFusionInterpreter();
+  SECTION( "fusion kernel cache" )
+    testFusionKernelCache();
 }
 
 TEST_CASE( "jit test CUDA", "[cuda]" ) {
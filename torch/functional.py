@@ -167,8 +167,8 @@ def isnan(tensor):
     return tensor != tensor
 
 
-def unique(input, sorted=False, return_inverse=False):
-    r"""Returns the unique scalar elements of the input tensor as a 1-D tensor.
+def unique(input, sorted=False, return_inverse=False, return_counts=False, dim=None):
+    r"""Returns the unique elements of the input tensor.
 
     Arguments:
         input (Tensor): the input tensor
@@ -176,16 +176,28 @@ def unique(input, sorted=False, return_inverse=False):
             before returning as output.
         return_inverse (bool): Whether to also return the indices for where
             elements in the original input ended up in the returned unique list.
+        return_counts (bool): Whether to also return the number of times
+            every unique element occurs in the input.
+        dim (int): the dimension to apply unique. If ``None``, the unique of the
+            flattened input is returned. Default: ``None``
 
     Returns:
-        (Tensor, Tensor (optional)): A tensor or a tuple of tensors containing
+        (Tensor, Tensor (optional), Tensor (optional)): A tensor or a tuple of
+        tensors containing
 
-            - **output** (*Tensor*): the output list of unique scalar elements.
+            - **output** (*Tensor*): the output list of unique scalar elements,
+              or of unique slices along :attr:`dim`.
             - **inverse_indices** (*Tensor*): (optional) if
-              :attr:`return_inverse` is True, there will be a
-              2nd returned tensor (same shape as input) representing the indices
-              for where elements in the original input map to in the output;
-              otherwise, this function will only return a single tensor.
+              :attr:`return_inverse` is True, there will be an additional
+              returned tensor (same shape as input, or of size
+              ``input.size(dim)`` if :attr:`dim` is given) representing the
+              indices for where elements in the original input map to in the
+              output.
+            - **counts** (*Tensor*): (optional) if :attr:`return_counts` is
+              True, there will be an additional returned tensor (same size as
+              the first dimension of output, or ``output.size(dim)`` if
+              :attr:`dim` is given) holding the number of occurrences of every
+              unique element.
 
     Example::
 
@@ -208,14 +220,37 @@ def unique(input, sorted=False, return_inverse=False):
         tensor([[ 0,  2],
                 [ 1,  2]])
 
+        >>> output, counts = torch.unique(
+                torch.tensor([1, 3, 2, 3], dtype=torch.long), sorted=True, return_counts=True)
+        >>> counts
+        tensor([ 1,  1,  2])
+
+        >>> torch.unique(torch.tensor([[1, 3], [2, 3], [1, 3]]), dim=0)
+        tensor([[ 1,  3],
+                [ 2,  3]])
+
     """
-    output, inverse_indices = torch._unique(
-        input,
-        sorted=sorted,
-        return_inverse=return_inverse,
-    )
-    if return_inverse:
+    if dim is not None:
+        output, inverse_indices, counts = torch._unique_dim(
+            input,
+            dim,
+            sorted=sorted,
+            return_inverse=return_inverse,
+            return_counts=return_counts,
+        )
+    else:
+        output, inverse_indices, counts = torch._unique(
+            input,
+            sorted=sorted,
+            return_inverse=return_inverse,
+            return_counts=return_counts,
+        )
+    if return_inverse and return_counts:
+        return output, inverse_indices, counts
+    elif return_inverse:
         return output, inverse_indices
+    elif return_counts:
+        return output, counts
     else:
         return output
 
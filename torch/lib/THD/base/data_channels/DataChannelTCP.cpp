@@ -37,6 +37,14 @@ inline uint64_t pow2(T value) {
   return pof2;
 }
 
+// Tensors of at least this many bytes are all-reduced with the ring
+// algorithm, smaller ones with recursive doubling.
+constexpr uint64_t RING_ALLREDUCE_MIN_BYTES = 512 * 1024;
+
+// The ring algorithm sends chunks in segments of at most this many bytes, so
+// that a received segment can be reduced while the next ones are in flight.
+constexpr uint64_t RING_SEGMENT_BYTES = 256 * 1024;
+
 } // namespace
 
 
@@ -362,17 +370,17 @@ void DataChannelTCP::scatter(std::vector<at::Tensor>& input,
 void DataChannelTCP::allReduce(at::Tensor& data, THDReduceOp operation,
                                THDGroup group_id) {
   /*
-   * Allreduce implementation is recursive doubling algorithm. It is good
-   * algorithm for small sizes of message but other (theoratically better)
-   * implementations could not be addapted because of non-commutative
-   * operations on tensors (operation cannot be commutative because this could
-   * introduce different numerical errors on different workers).
+   * Small tensors are reduced with recursive doubling, which needs the fewest
+   * messages but sends the whole tensor log(p) times. Large ones are reduced
+   * with a ring (reduce-scatter followed by allgather), which sends each
+   * process' share of the tensor 2(p - 1) times, in total less than twice
+   * the tensor.
+   *
+   * Both algorithms give the same result on every process: in the ring each
+   * chunk is reduced by a single process and then copied to the others.
    *
    * More about efficiency can be found here:
    *   > http://www.mcs.anl.gov/~thakur/papers/ijhpca-coll.pdf (section 4.5)
-   *
-   * Implementation is based on:
-   *   > https://github.com/pmodels/mpich/blob/master/src/mpi/coll/allreduce.c
    */
 
   std::lock_guard<std::mutex> lock(_mutex);
@@ -382,11 +390,33 @@ void DataChannelTCP::allReduce(at::Tensor& data, THDReduceOp operation,
   bool exists;
 
   std::tie(group_rank, exists) = group.getGroupRank(_rank);
-  if (!exists)
+  if (!exists || group.size() == 1)
     return;
 
+  if (!data.is_contiguous())
+    throw std::logic_error("tensor to allReduce is not contiguous");
+
+  uint64_t tensor_bytes = data.type().elementSizeInBytes() * data.numel();
+  if (tensor_bytes >= RING_ALLREDUCE_MIN_BYTES &&
+      static_cast<uint64_t>(data.numel()) >= group.size()) {
+    _allReduceRing(data, operation, group, group_rank);
+  } else {
+    _allReduceRecursiveDoubling(data, operation, group, group_rank);
+  }
+}
+
+
+void DataChannelTCP::_allReduceRecursiveDoubling(
+    at::Tensor& data, THDReduceOp operation,
+    const DataChannel::Group& group, rank_type group_rank) {
+  /*
+   * Implementation is based on:
+   *   > https://github.com/pmodels/mpich/blob/master/src/mpi/coll/allreduce.c
+   */
+
   uint64_t tensor_bytes = data.type().elementSizeInBytes() * data.numel();
-  auto tmp_tensor = data.clone();
+  // Only used to receive, so it doesn't have to be initialized
+  auto tmp_tensor = data.type().tensor(data.sizes());
 
   auto pof2 = pow2(group.size());
   int rem = group.size() - pof2;
@@ -437,6 +467,85 @@ void DataChannelTCP::allReduce(at::Tensor& data, THDReduceOp operation,
 }
 
 
+void DataChannelTCP::_allReduceRing(at::Tensor& data, THDReduceOp operation,
+                                    const DataChannel::Group& group,
+                                    rank_type group_rank) {
+  /*
+   * The tensor is split into p chunks. In step s of the reduce-scatter phase
+   * every process sends chunk (rank - s) to its right neighbour, and reduces
+   * chunk (rank - s - 1) with the partial result received from its left
+   * one. After p - 1 steps chunk (rank + 1) holds the reduction over all
+   * processes, and the allgather phase passes the chunks around the ring
+   * once more to copy them to every process.
+   *
+   * Chunks are sent in segments. All sends and receives of a step are queued
+   * at once on the send and receive workers, and every segment is reduced as
+   * soon as it arrives, while the following ones are still being received.
+   */
+
+  const rank_type size = group.size();
+  const auto left = group.mustGetGlobalRank((group_rank + size - 1) % size);
+  const auto right = group.mustGetGlobalRank((group_rank + 1) % size);
+
+  auto flat = data.view({-1});
+  const int64_t numel = flat.numel();
+  auto chunk = [&](rank_type c) {
+    c %= size;
+    int64_t begin = numel * c / size;
+    int64_t end = numel * (c + 1) / size;
+    return flat.narrow(0, begin, end - begin);
+  };
+
+  const int64_t segment_numel = std::max<int64_t>(
+      RING_SEGMENT_BYTES / data.type().elementSizeInBytes(), 1);
+  // Partial results are received here before being reduced into data
+  auto buffer = data.type().tensor({(numel + size - 1) / size});
+
+  auto exchange = [&](rank_type send_chunk_idx, rank_type recv_chunk_idx,
+                      bool reduce) {
+    auto send_chunk = chunk(send_chunk_idx);
+    auto recv_chunk = chunk(recv_chunk_idx);
+
+    std::vector<req_ptr> send_requests;
+    for (int64_t offset = 0; offset < send_chunk.numel(); offset += segment_numel) {
+      auto segment = send_chunk.narrow(
+          0, offset, std::min(segment_numel, send_chunk.numel() - offset));
+      send_requests.emplace_back(isend(segment, right));
+    }
+
+    std::vector<std::pair<req_ptr, at::Tensor>> recv_requests;
+    for (int64_t offset = 0; offset < recv_chunk.numel(); offset += segment_numel) {
+      int64_t length = std::min(segment_numel, recv_chunk.numel() - offset);
+      auto segment = (reduce ? buffer : recv_chunk).narrow(0, offset, length);
+      recv_requests.emplace_back(req_ptr(ireceive(segment, left)), segment);
+    }
+
+    int64_t offset = 0;
+    for (auto& request : recv_requests) {
+      request.first->wait();
+      if (reduce) {
+        auto result = recv_chunk.narrow(0, offset, request.second.numel());
+        _reduce(result, request.second, operation);
+      }
+      offset += request.second.numel();
+    }
+
+    for (auto& request : send_requests)
+      request->wait();
+  };
+
+  // reduce-scatter
+  for (rank_type step = 0; step < size - 1; ++step) {
+    exchange(group_rank + size - step, group_rank + 2 * size - step - 1, true);
+  }
+
+  // allgather
+  for (rank_type step = 0; step < size - 1; ++step) {
+    exchange(group_rank + size + 1 - step, group_rank + size - step, false);
+  }
+}
+
+
 void DataChannelTCP::reduce(at::Tensor& data, THDReduceOp operation,
                             rank_type dst_rank, THDGroup group_id) {
   /*
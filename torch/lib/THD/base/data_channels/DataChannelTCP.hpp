@@ -93,6 +93,11 @@ private:
   void _receive(const at::Tensor& data, rank_type src_id);
   void _reduce(at::Tensor& result, at::Tensor& data,
                THDReduceOp operation) const;
+  void _allReduceRecursiveDoubling(at::Tensor& data, THDReduceOp operation,
+                                   const DataChannel::Group& group,
+                                   rank_type group_rank);
+  void _allReduceRing(at::Tensor& data, THDReduceOp operation,
+                      const DataChannel::Group& group, rank_type group_rank);
 
 
   rank_type _rank; // Rank of current process, range: [0.._processes.size()-1]
@@ -2,11 +2,17 @@
 
 #include <assert.h>
 #include <fcntl.h>
+#include <libgen.h>
+#include <poll.h>
 #include <stdint.h>
 #include <sys/file.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
 #include <chrono>
 #include <functional>
 #include <iostream>
@@ -118,7 +124,7 @@ class File {
     while (count > 0) {
       auto rv = syscall(std::bind(::write, fd_, buf, count));
       SYSASSERT(rv, "write");
-      buf = (uint8_t*)buf + count;
+      buf = (uint8_t*)buf + rv;
       count -= rv;
     }
   }
@@ -127,7 +133,7 @@ class File {
     while (count > 0) {
       auto rv = syscall(std::bind(::read, fd_, buf, count));
       SYSASSERT(rv, "read");
-      buf = (uint8_t*)buf + count;
+      buf = (uint8_t*)buf + rv;
       count -= rv;
     }
   }
@@ -184,11 +190,74 @@ off_t refresh(
   return pos;
 }
 
+// Size of the file at path, or 0 if it doesn't exist yet. Cheaper than
+// taking the lock, so waiters use it to find out whether there is anything
+// new to read.
+off_t fileSize(const std::string& path) {
+  struct stat st;
+  if (::stat(path.c_str(), &st) == -1) {
+    if (errno == ENOENT) {
+      return 0;
+    }
+    SYSASSERT(-1, "stat(" + path + ")");
+  }
+  return st.st_size;
+}
+
+// Waiters re-read the file every kPollInterval, unless they are woken up
+// earlier by a write (see createWatch).
+constexpr std::chrono::milliseconds kPollInterval =
+    std::chrono::milliseconds(10);
+
+// Returns an inotify instance that has an event whenever a file in the
+// directory of path (which need not exist yet) is written and closed, or -1
+// if inotify is not available. Writes from other hosts of a shared
+// filesystem such as NFS don't generate events, so waiters keep polling.
+int createWatch(const std::string& path) {
+#ifdef __linux__
+  int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd == -1) {
+    return -1;
+  }
+  std::vector<char> buf(path.begin(), path.end());
+  buf.push_back('\0');
+  const char* dir = ::dirname(buf.data());
+  if (inotify_add_watch(fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) == -1) {
+    ::close(fd);
+    return -1;
+  }
+  return fd;
+#else
+  return -1;
+#endif
+}
+
+// Returns after an event on the watch or after at most timeout
+void waitForWrite(int watchFd, std::chrono::milliseconds timeout) {
+  if (watchFd == -1) {
+    /* sleep override */
+    std::this_thread::sleep_for(timeout);
+    return;
+  }
+  struct pollfd pfd = {.fd = watchFd, .events = POLLIN};
+  auto rv = syscall(std::bind(::poll, &pfd, 1, (int)timeout.count()));
+  SYSASSERT(rv, "poll");
+  // Drain the events, they are only used as a wakeup
+  char events[4096];
+  while (::read(watchFd, events, sizeof(events)) > 0) {
+  }
+}
+
 } // namespace
 
-FileStore::FileStore(const std::string& path) : Store(), path_(path), pos_(0) {}
+FileStore::FileStore(const std::string& path)
+    : Store(), path_(path), pos_(0), watchFd_(createWatch(path)) {}
 
-FileStore::~FileStore() {}
+FileStore::~FileStore() {
+  if (watchFd_ != -1) {
+    ::close(watchFd_);
+  }
+}
 
 void FileStore::set(const std::string& key, const std::vector<uint8_t>& value) {
   File file(path_, O_RDWR | O_CREAT);
@@ -198,24 +267,37 @@ void FileStore::set(const std::string& key, const std::vector<uint8_t>& value) {
   file.write(value);
 }
 
-std::vector<uint8_t> FileStore::get(const std::string& key) {
-  while (cache_.count(key) == 0) {
-    File file(path_, O_RDONLY);
-    auto lock = file.lockShared();
-    auto size = file.size();
-    if (size == pos_) {
-      // No new entries; release the shared lock and sleep for a bit
-      lock.unlock();
-      std::this_thread::sleep_for(std::chrono::milliseconds(10));
-      continue;
-    }
-
-    pos_ = refresh(file, pos_, cache_);
+void FileStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  if (keys.size() != values.size()) {
+    throw std::invalid_argument("multiSet: number of keys and values differ");
+  }
+  File file(path_, O_RDWR | O_CREAT);
+  auto lock = file.lockExclusive();
+  file.seek(0, SEEK_END);
+  for (size_t i = 0; i < keys.size(); i++) {
+    file.write(keys[i]);
+    file.write(values[i]);
   }
+}
 
+std::vector<uint8_t> FileStore::get(const std::string& key) {
+  wait({key}, kNoTimeout);
   return cache_[key];
 }
 
+std::vector<std::vector<uint8_t>> FileStore::multiGet(
+    const std::vector<std::string>& keys) {
+  wait(keys, kNoTimeout);
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(keys.size());
+  for (const auto& key : keys) {
+    values.push_back(cache_[key]);
+  }
+  return values;
+}
+
 int64_t FileStore::add(const std::string& key, int64_t i) {
   File file(path_, O_RDWR | O_CREAT);
   auto lock = file.lockExclusive();
@@ -237,35 +319,48 @@ int64_t FileStore::add(const std::string& key, int64_t i) {
   return ti;
 }
 
-bool FileStore::check(const std::vector<std::string>& keys) {
-  File file(path_, O_RDONLY);
-  auto lock = file.lockShared();
-  pos_ = refresh(file, pos_, cache_);
-
+bool FileStore::cached(const std::vector<std::string>& keys) const {
   for (const auto& key : keys) {
     if (cache_.count(key) == 0) {
       return false;
     }
   }
-
   return true;
 }
 
+bool FileStore::check(const std::vector<std::string>& keys) {
+  if (cached(keys)) {
+    return true;
+  }
+  // Keys are never removed, so if the file didn't grow since it was last
+  // read the missing keys are still missing
+  if (fileSize(path_) == pos_) {
+    return false;
+  }
+
+  File file(path_, O_RDONLY);
+  auto lock = file.lockShared();
+  pos_ = refresh(file, pos_, cache_);
+  return cached(keys);
+}
+
 void FileStore::wait(
     const std::vector<std::string>& keys,
     const std::chrono::milliseconds& timeout) {
-  // Not using inotify because it doesn't work on many
-  // shared filesystems (such as NFS).
+  // Writes are only waited for after a check, so none of them is missed
   const auto start = std::chrono::steady_clock::now();
   while (!check(keys)) {
-    const auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-        std::chrono::steady_clock::now() - start);
-    if (timeout != kNoTimeout && elapsed > timeout) {
-      throw std::runtime_error("Wait timeout");
+    auto interval = kPollInterval;
+    if (timeout != kNoTimeout) {
+      const auto elapsed =
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::steady_clock::now() - start);
+      if (elapsed > timeout) {
+        throw std::runtime_error("Wait timeout");
+      }
+      interval = std::min(interval, timeout - elapsed);
     }
-
-    /* sleep override */
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    waitForWrite(watchFd_, interval);
   }
 }
 
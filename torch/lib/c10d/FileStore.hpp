@@ -16,8 +16,15 @@ class FileStore : public Store {
 
   void set(const std::string& key, const std::vector<uint8_t>& value) override;
 
+  void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values) override;
+
   std::vector<uint8_t> get(const std::string& key) override;
 
+  std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys) override;
+
   int64_t add(const std::string& key, int64_t value) override;
 
   bool check(const std::vector<std::string>& keys) override;
@@ -27,8 +34,13 @@ class FileStore : public Store {
       const std::chrono::milliseconds& timeout = kDefaultTimeout) override;
 
  protected:
+  // Whether all keys are in the cache
+  bool cached(const std::vector<std::string>& keys) const;
+
   std::string path_;
   off_t pos_;
+  // inotify instance that wakes up waiters, -1 if not available
+  int watchFd_;
 
   std::unordered_map<std::string, std::vector<uint8_t>> cache_;
 };
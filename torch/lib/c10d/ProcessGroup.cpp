@@ -8,4 +8,50 @@ ProcessGroup::ProcessGroup(int rank, int size) : rank_(rank), size_(size) {}
 
 ProcessGroup::~ProcessGroup() {}
 
+std::shared_ptr<ProcessGroup::Work> ProcessGroup::reduce(
+    std::vector<at::Tensor>& /* unused */,
+    const ReduceOptions& /* unused */) {
+  throw std::runtime_error("ProcessGroup does not support reduce");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroup::allgather(
+    std::vector<std::vector<at::Tensor>>& /* unused */,
+    std::vector<at::Tensor>& /* unused */,
+    const AllgatherOptions& /* unused */) {
+  throw std::runtime_error("ProcessGroup does not support allgather");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroup::gather(
+    std::vector<std::vector<at::Tensor>>& /* unused */,
+    std::vector<at::Tensor>& /* unused */,
+    const GatherOptions& /* unused */) {
+  throw std::runtime_error("ProcessGroup does not support gather");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroup::scatter(
+    std::vector<at::Tensor>& /* unused */,
+    std::vector<std::vector<at::Tensor>>& /* unused */,
+    const ScatterOptions& /* unused */) {
+  throw std::runtime_error("ProcessGroup does not support scatter");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroup::send(
+    std::vector<at::Tensor>& /* unused */,
+    int /* unused */,
+    int /* unused */) {
+  throw std::runtime_error("ProcessGroup does not support send");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroup::recv(
+    std::vector<at::Tensor>& /* unused */,
+    int /* unused */,
+    int /* unused */) {
+  throw std::runtime_error("ProcessGroup does not support recv");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroup::barrier(
+    const BarrierOptions& /* unused */) {
+  throw std::runtime_error("ProcessGroup does not support barrier");
+}
+
 } // namespace c10d
@@ -94,6 +94,59 @@ class ProcessGroup {
       std::vector<at::Tensor>& data,
       const AllreduceOptions& opts = AllreduceOptions()) = 0;
 
+  // The collectives and point to point operations below have default
+  // implementations that throw, so that implementations can add support
+  // for them incrementally.
+
+  // Reduces the tensors of all processes into the tensor at index
+  // `rootTensor` on process `rootRank`. The contents of all other
+  // tensors are left unspecified.
+  virtual std::shared_ptr<Work> reduce(
+      std::vector<at::Tensor>& tensors,
+      const ReduceOptions& opts = ReduceOptions());
+
+  // Gathers the input tensors of all processes into every output list.
+  // Every list in `outputTensors` must hold `getSize() *
+  // inputTensors.size()` tensors; input tensor `j` of process `r` ends
+  // up at index `r * inputTensors.size() + j`.
+  virtual std::shared_ptr<Work> allgather(
+      std::vector<std::vector<at::Tensor>>& outputTensors,
+      std::vector<at::Tensor>& inputTensors,
+      const AllgatherOptions& opts = AllgatherOptions());
+
+  // Gathers the single input tensor of all processes on process
+  // `rootRank`. On the root, `outputTensors` must contain a single list
+  // of `getSize()` tensors; on other processes it must be empty.
+  virtual std::shared_ptr<Work> gather(
+      std::vector<std::vector<at::Tensor>>& outputTensors,
+      std::vector<at::Tensor>& inputTensors,
+      const GatherOptions& opts = GatherOptions());
+
+  // Scatters a list of `getSize()` tensors from process `rootRank` into
+  // the single output tensor of every process. On processes other than
+  // the root, `inputTensors` must be empty.
+  virtual std::shared_ptr<Work> scatter(
+      std::vector<at::Tensor>& outputTensors,
+      std::vector<std::vector<at::Tensor>>& inputTensors,
+      const ScatterOptions& opts = ScatterOptions());
+
+  // Sends the single tensor in `tensors` to process `dstRank`. The
+  // receiving process must call recv with the same tag.
+  virtual std::shared_ptr<Work> send(
+      std::vector<at::Tensor>& tensors,
+      int dstRank,
+      int tag);
+
+  // Receives into the single tensor in `tensors` from process `srcRank`.
+  virtual std::shared_ptr<Work> recv(
+      std::vector<at::Tensor>& tensors,
+      int srcRank,
+      int tag);
+
+  // Completes once all processes in the group have called barrier.
+  virtual std::shared_ptr<Work> barrier(
+      const BarrierOptions& opts = BarrierOptions());
+
  protected:
   const int rank_;
   const int size_;
@@ -1,6 +1,10 @@
 #include "ProcessGroupGloo.hpp"
 
+#include <limits>
+
+#include <gloo/allgather_ring.h>
 #include <gloo/allreduce_halving_doubling.h>
+#include <gloo/barrier_all_to_one.h>
 #include <gloo/broadcast_one_to_all.h>
 #include <gloo/cuda_allreduce_halving_doubling.h>
 #include <gloo/cuda_broadcast_one_to_all.h>
@@ -123,6 +127,113 @@ void synchronizeStreams(THCState* thcState, AlgorithmEntry* entry) {
   }
 }
 
+// Point to point operations use slots at this offset so that they
+// cannot collide with the slots handed out by the Gloo context to
+// collective algorithms. Every tag reserves two slots, one for the
+// data and one for the ready notification.
+constexpr int kSendRecvSlotOffset = 1 << 24;
+
+// Largest tag whose two slots still fit in the int slot ids of the Gloo
+// transport.
+constexpr uint64_t kMaxSendRecvTag =
+    (std::numeric_limits<int>::max() - kSendRecvSlotOffset - 1) / 2;
+
+void assertTag(int tag) {
+  if (tag < 0 || static_cast<uint64_t>(tag) > kMaxSendRecvTag) {
+    throw std::invalid_argument(
+        "invalid tag " + std::to_string(tag) + ", must be in [0, " +
+        std::to_string(kMaxSendRecvTag) + "]");
+  }
+}
+
+// The first slot of a tag that passed assertTag. Computed in 64 bits
+// because twice a large tag overflows an int.
+int sendRecvSlot(int tag) {
+  return static_cast<int>(
+      kSendRecvSlotOffset + 2 * static_cast<uint64_t>(tag));
+}
+
+// PairwiseAlgorithm runs a set of point to point transfers with other
+// processes in the group, each with its own transport buffer.
+//
+// Before every transfer, the receiver notifies the sender that its
+// buffer is ready. This guarantees that back to back runs of the same
+// algorithm cannot overwrite data the receiver has not consumed yet.
+class PairwiseAlgorithm : public ::gloo::Algorithm {
+ public:
+  explicit PairwiseAlgorithm(const std::shared_ptr<::gloo::Context>& context)
+      : ::gloo::Algorithm(context) {}
+
+  void addSend(int rank, int slot, void* ptr, size_t bytes) {
+    auto& pair = context_->getPair(rank);
+    Transfer transfer;
+    transfer.data = pair->createSendBuffer(slot, ptr, bytes);
+    transfer.ready = pair->createRecvBuffer(slot + 1, &dummy_, sizeof(dummy_));
+    sends_.push_back(std::move(transfer));
+  }
+
+  void addRecv(int rank, int slot, void* ptr, size_t bytes) {
+    auto& pair = context_->getPair(rank);
+    Transfer transfer;
+    transfer.data = pair->createRecvBuffer(slot, ptr, bytes);
+    transfer.ready = pair->createSendBuffer(slot + 1, &dummy_, sizeof(dummy_));
+    recvs_.push_back(std::move(transfer));
+  }
+
+  void run() override {
+    for (auto& recv : recvs_) {
+      recv.ready->send();
+    }
+    for (auto& send : sends_) {
+      send.ready->waitRecv();
+      send.data->send();
+    }
+    for (auto& send : sends_) {
+      send.data->waitSend();
+    }
+    for (auto& recv : recvs_) {
+      recv.data->waitRecv();
+      recv.ready->waitSend();
+    }
+  }
+
+ protected:
+  struct Transfer {
+    std::unique_ptr<::gloo::transport::Buffer> data;
+    std::unique_ptr<::gloo::transport::Buffer> ready;
+  };
+
+  std::vector<Transfer> sends_;
+  std::vector<Transfer> recvs_;
+  char dummy_ = 0;
+};
+
+size_t getNumBytes(const at::Tensor& tensor) {
+  return tensor.numel() * tensor.type().elementSizeInBytes();
+}
+
+void assertCPU(const at::Type& type, const char* op) {
+  if (type.is_cuda()) {
+    throw std::invalid_argument(
+        std::string("ProcessGroupGloo::") + op +
+        " only supports CPU tensors");
+  }
+}
+
+void assertRank(int rank, int size, const char* name) {
+  if (rank < 0 || rank >= size) {
+    throw std::invalid_argument(
+        std::string("invalid ") + name + " " + std::to_string(rank));
+  }
+}
+
+void assertRootTensor(int rootTensor, size_t numTensors) {
+  if (rootTensor < 0 || static_cast<size_t>(rootTensor) >= numTensors) {
+    throw std::invalid_argument(
+        "invalid root tensor " + std::to_string(rootTensor));
+  }
+}
+
 } // namespace
 
 ProcessGroupGloo::WorkGloo::WorkGloo() : completed_(false), cuda_(false) {}
@@ -168,7 +279,7 @@ void ProcessGroupGloo::WorkGloo::finish(const AlgorithmEntry& entry) {
   {
     std::unique_lock<std::mutex> lock(m_);
     completed_ = true;
-    cuda_ = entry.key.type->is_cuda();
+    cuda_ = entry.key.type != nullptr && entry.key.type->is_cuda();
 
     // Populate devices and events so that we can later synchronize
     // with the operation associated with this work finishing.
@@ -304,6 +415,27 @@ void ProcessGroupGloo::createAlgorithm(AlgorithmEntry& entry) {
     case CollectiveType::BROADCAST:
       GENERATE_ALL_TYPES(key.type->scalarType(), createBroadcast, entry);
       return;
+    case CollectiveType::REDUCE:
+      GENERATE_ALL_TYPES(key.type->scalarType(), createAllreduce, entry);
+      return;
+    case CollectiveType::ALLGATHER:
+      GENERATE_ALL_TYPES(key.type->scalarType(), createAllgather, entry);
+      return;
+    case CollectiveType::GATHER:
+      createGather(entry);
+      return;
+    case CollectiveType::SCATTER:
+      createScatter(entry);
+      return;
+    case CollectiveType::SEND:
+      createSend(entry);
+      return;
+    case CollectiveType::RECV:
+      createRecv(entry);
+      return;
+    case CollectiveType::BARRIER:
+      createBarrier(entry);
+      return;
     case CollectiveType::UNUSED:
       break;
   }
@@ -378,6 +510,100 @@ void ProcessGroupGloo::createBroadcast(AlgorithmEntry& entry) {
       "Unhandled backend: " + std::string(at::toString(backend)));
 }
 
+template <typename T>
+void ProcessGroupGloo::createAllgather(AlgorithmEntry& entry) {
+  auto& context = contexts_[0];
+  std::vector<const T*> inputs;
+  for (auto ptr : getDataPointers<T>(entry.src)) {
+    inputs.push_back(ptr);
+  }
+  entry.algorithm =
+      std::unique_ptr<::gloo::Algorithm>(new ::gloo::AllgatherRing<T>(
+          context,
+          inputs,
+          getDataPointers<T>(entry.dst)[0],
+          entry.src[0].numel()));
+}
+
+// Gloo doesn't ship gather and scatter algorithms, so they are
+// implemented as direct transfers between the root and every other
+// process. Every process must construct them in the same order for the
+// slots handed out by the context to match up.
+void ProcessGroupGloo::createGather(AlgorithmEntry& entry) {
+  const auto& key = entry.key;
+  auto& context = contexts_[0];
+  auto algorithm = std::unique_ptr<PairwiseAlgorithm>(
+      new PairwiseAlgorithm(context));
+  const auto slot = context->nextSlot(2);
+  if (getRank() == key.dstRank) {
+    for (int rank = 0; rank < getSize(); rank++) {
+      if (rank != getRank()) {
+        auto& tensor = entry.dst[rank];
+        algorithm->addRecv(
+            rank, slot, tensor.data_ptr(), getNumBytes(tensor));
+      }
+    }
+  } else {
+    auto& tensor = entry.src[0];
+    algorithm->addSend(
+        key.dstRank, slot, tensor.data_ptr(), getNumBytes(tensor));
+  }
+  entry.algorithm = std::move(algorithm);
+}
+
+void ProcessGroupGloo::createScatter(AlgorithmEntry& entry) {
+  const auto& key = entry.key;
+  auto& context = contexts_[0];
+  auto algorithm = std::unique_ptr<PairwiseAlgorithm>(
+      new PairwiseAlgorithm(context));
+  const auto slot = context->nextSlot(2);
+  if (getRank() == key.srcRank) {
+    for (int rank = 0; rank < getSize(); rank++) {
+      if (rank != getRank()) {
+        auto& tensor = entry.src[rank];
+        algorithm->addSend(
+            rank, slot, tensor.data_ptr(), getNumBytes(tensor));
+      }
+    }
+  } else {
+    auto& tensor = entry.dst[0];
+    algorithm->addRecv(
+        key.srcRank, slot, tensor.data_ptr(), getNumBytes(tensor));
+  }
+  entry.algorithm = std::move(algorithm);
+}
+
+void ProcessGroupGloo::createSend(AlgorithmEntry& entry) {
+  const auto& key = entry.key;
+  auto algorithm = std::unique_ptr<PairwiseAlgorithm>(
+      new PairwiseAlgorithm(contexts_[0]));
+  auto& tensor = entry.src[0];
+  algorithm->addSend(
+      key.dstRank,
+      sendRecvSlot(key.tag),
+      tensor.data_ptr(),
+      getNumBytes(tensor));
+  entry.algorithm = std::move(algorithm);
+}
+
+void ProcessGroupGloo::createRecv(AlgorithmEntry& entry) {
+  const auto& key = entry.key;
+  auto algorithm = std::unique_ptr<PairwiseAlgorithm>(
+      new PairwiseAlgorithm(contexts_[0]));
+  auto& tensor = entry.src[0];
+  algorithm->addRecv(
+      key.srcRank,
+      sendRecvSlot(key.tag),
+      tensor.data_ptr(),
+      getNumBytes(tensor));
+  entry.algorithm = std::move(algorithm);
+}
+
+void ProcessGroupGloo::createBarrier(AlgorithmEntry& entry) {
+  entry.algorithm = std::unique_ptr<::gloo::Algorithm>(
+      new ::gloo::BarrierAllToOne(contexts_[0]));
+}
+
 // Constructs an AlgorithmEntry instance, except for the algorithm
 // itself. It allocates the temporary input/output tensors necessary
 // to have a fixed address to pass to the Gloo algorithms. The
@@ -393,6 +619,11 @@ EntryType ProcessGroupGloo::construct(const AlgorithmKey& key) {
   auto entry = std::unique_ptr<AlgorithmEntry>(new AlgorithmEntry);
   entry->key = key;
 
+  // Barriers don't move any data
+  if (key.type == nullptr) {
+    return entry;
+  }
+
   // Allocate source tensors for this entry
   auto& srcSizes = key.srcSizes;
   entry->src.resize(srcSizes.size());
@@ -401,6 +632,13 @@ EntryType ProcessGroupGloo::construct(const AlgorithmKey& key) {
     entry->src[i] = key.type->tensor(srcSizes[i]);
   }
 
+  // Allocate destination tensors for this entry (CPU only)
+  auto& dstSizes = key.dstSizes;
+  entry->dst.resize(dstSizes.size());
+  for (size_t i = 0; i < dstSizes.size(); i++) {
+    entry->dst[i] = key.type->tensor(dstSizes[i]);
+  }
+
   // If these are CUDA tensors, create streams and events
   if (key.type->is_cuda()) {
     entry->streams.resize(key.devices.size());
@@ -419,13 +657,19 @@ AlgorithmEntry* ProcessGroupGloo::checkout(const AlgorithmKey& key) {
   auto& vec = cache_[key];
   const auto i = cacheCurrentEntry_[key];
 
+  // Point to point entries derive their slots from the tag, so multiple
+  // entries for the same key would end up sharing transport buffers.
+  const bool pointToPoint = key.collectiveType == CollectiveType::SEND ||
+      key.collectiveType == CollectiveType::RECV;
+  const size_t numEntries = pointToPoint ? 1 : cacheNumAlgorithmEntries_;
+
   // Ensure the cache vector is appropriately sized
-  if (vec.size() != cacheNumAlgorithmEntries_) {
-    vec.resize(cacheNumAlgorithmEntries_);
+  if (vec.size() != numEntries) {
+    vec.resize(numEntries);
   }
 
   // The next call must use the next entry
-  cacheCurrentEntry_[key] = (i + 1) % cacheNumAlgorithmEntries_;
+  cacheCurrentEntry_[key] = (i + 1) % numEntries;
 
   // If there is no entry for this key, create a new one
   if (!vec[i]) {
@@ -458,6 +702,8 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::broadcast(
     std::vector<at::Tensor>& tensors,
     const BroadcastOptions& opts) {
   assertSameSizeAndType(tensors);
+  assertRank(opts.rootRank, getSize(), "root rank");
+  assertRootTensor(opts.rootTensor, tensors.size());
 
   AlgorithmKey key;
   key.collectiveType = CollectiveType::BROADCAST;
@@ -547,4 +793,294 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
   return enqueue(entry);
 }
 
+std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::reduce(
+    std::vector<at::Tensor>& tensors,
+    const ReduceOptions& opts) {
+  assertSameSizeAndType(tensors);
+  assertRank(opts.rootRank, getSize(), "root rank");
+  assertRootTensor(opts.rootTensor, tensors.size());
+
+  AlgorithmKey key;
+  key.collectiveType = CollectiveType::REDUCE;
+  key.type = &tensors[0].type();
+  key.srcSizes = getSizes(tensors);
+  key.devices = getDevices(tensors);
+  key.reduceOp = opts.reduceOp;
+
+  // Retrieve (create or wait for) cache entry
+  auto entry = checkout(key);
+
+  // Copy input tensors
+  for (size_t i = 0; i < tensors.size(); i++) {
+    entry->src[i].copy_(tensors[i]);
+  }
+
+  // Gloo has no reduce algorithm. We run an allreduce and only copy
+  // the result to the root tensor on the root process.
+  const auto isRoot = getRank() == opts.rootRank;
+  const auto rootTensor = opts.rootTensor;
+  if (key.type->is_cuda()) {
+    synchronizeStreams(thcState_, entry);
+    entry->run = [=]() mutable {
+      entry->algorithm->run();
+      if (isRoot) {
+        THCStreamGuard guard(thcState_, entry->streams[rootTensor]);
+        tensors[rootTensor].copy_(entry->src[rootTensor]);
+      }
+    };
+  } else {
+    entry->run = [=]() mutable {
+      entry->algorithm->run();
+      if (isRoot) {
+        tensors[rootTensor].copy_(entry->src[rootTensor]);
+      }
+    };
+  }
+
+  return enqueue(entry);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allgather(
+    std::vector<std::vector<at::Tensor>>& outputs,
+    std::vector<at::Tensor>& inputs,
+    const AllgatherOptions& /* unused */) {
+  assertSameSizeAndType(inputs);
+  assertCPU(inputs[0].type(), "allgather");
+  if (outputs.empty()) {
+    throw std::invalid_argument("allgather requires at least one output list");
+  }
+  const auto numOutputs = getSize() * inputs.size();
+  for (auto& output : outputs) {
+    if (output.size() != numOutputs) {
+      throw std::invalid_argument(
+          "allgather output lists must contain " +
+          std::to_string(numOutputs) + " tensors");
+    }
+    assertSameSizeAndType(output);
+    if (output[0].type() != inputs[0].type() ||
+        !output[0].sizes().equals(inputs[0].sizes())) {
+      throw std::invalid_argument(
+          "allgather outputs must match the inputs in type and size");
+    }
+  }
+
+  AlgorithmKey key;
+  key.collectiveType = CollectiveType::ALLGATHER;
+  key.type = &inputs[0].type();
+  key.srcSizes = getSizes(inputs);
+  key.devices = getDevices(inputs);
+
+  // All inputs are gathered into a single contiguous tensor.
+  std::vector<int64_t> dstSizes = inputs[0].sizes().vec();
+  dstSizes.insert(dstSizes.begin(), numOutputs);
+  key.dstSizes = {dstSizes};
+
+  auto entry = checkout(key);
+
+  for (size_t i = 0; i < inputs.size(); i++) {
+    entry->src[i].copy_(inputs[i]);
+  }
+
+  entry->run = [=]() mutable {
+    entry->algorithm->run();
+    for (auto& output : outputs) {
+      for (size_t i = 0; i < output.size(); i++) {
+        output[i].copy_(entry->dst[0][i]);
+      }
+    }
+  };
+
+  return enqueue(entry);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::gather(
+    std::vector<std::vector<at::Tensor>>& outputs,
+    std::vector<at::Tensor>& inputs,
+    const GatherOptions& opts) {
+  assertRank(opts.rootRank, getSize(), "root rank");
+  if (inputs.size() != 1) {
+    throw std::invalid_argument("gather requires a single input tensor");
+  }
+  assertCPU(inputs[0].type(), "gather");
+
+  const auto isRoot = getRank() == opts.rootRank;
+  if (isRoot) {
+    if (outputs.size() != 1 || outputs[0].size() != getSize()) {
+      throw std::invalid_argument(
+          "gather requires a single list of " + std::to_string(getSize()) +
+          " output tensors on the root process");
+    }
+    assertSameSizeAndType(outputs[0]);
+    if (outputs[0][0].type() != inputs[0].type() ||
+        !outputs[0][0].sizes().equals(inputs[0].sizes())) {
+      throw std::invalid_argument(
+          "gather outputs must match the input in type and size");
+    }
+  } else if (!outputs.empty()) {
+    throw std::invalid_argument(
+        "gather requires empty outputs on non-root processes");
+  }
+
+  AlgorithmKey key;
+  key.collectiveType = CollectiveType::GATHER;
+  key.type = &inputs[0].type();
+  key.srcSizes = getSizes(inputs);
+  key.devices = getDevices(inputs);
+  key.dstRank = opts.rootRank;
+  if (isRoot) {
+    key.dstSizes = getSizes(outputs[0]);
+  }
+
+  auto entry = checkout(key);
+
+  entry->src[0].copy_(inputs[0]);
+
+  if (isRoot) {
+    const auto rank = getRank();
+    entry->run = [=]() mutable {
+      entry->algorithm->run();
+      auto& output = outputs[0];
+      for (size_t i = 0; i < output.size(); i++) {
+        output[i].copy_(i == size_t(rank) ? entry->src[0] : entry->dst[i]);
+      }
+    };
+  } else {
+    entry->run = [=]() mutable { entry->algorithm->run(); };
+  }
+
+  return enqueue(entry);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::scatter(
+    std::vector<at::Tensor>& outputs,
+    std::vector<std::vector<at::Tensor>>& inputs,
+    const ScatterOptions& opts) {
+  assertRank(opts.rootRank, getSize(), "root rank");
+  if (outputs.size() != 1) {
+    throw std::invalid_argument("scatter requires a single output tensor");
+  }
+  assertCPU(outputs[0].type(), "scatter");
+
+  const auto isRoot = getRank() == opts.rootRank;
+  if (isRoot) {
+    if (inputs.size() != 1 || inputs[0].size() != getSize()) {
+      throw std::invalid_argument(
+          "scatter requires a single list of " + std::to_string(getSize()) +
+          " input tensors on the root process");
+    }
+    assertSameSizeAndType(inputs[0]);
+    if (inputs[0][0].type() != outputs[0].type() ||
+        !inputs[0][0].sizes().equals(outputs[0].sizes())) {
+      throw std::invalid_argument(
+          "scatter inputs must match the output in type and size");
+    }
+  } else if (!inputs.empty()) {
+    throw std::invalid_argument(
+        "scatter requires empty inputs on non-root processes");
+  }
+
+  AlgorithmKey key;
+  key.collectiveType = CollectiveType::SCATTER;
+  key.type = &outputs[0].type();
+  key.dstSizes = getSizes(outputs);
+  key.devices = getDevices(outputs);
+  key.srcRank = opts.rootRank;
+  if (isRoot) {
+    key.srcSizes = getSizes(inputs[0]);
+  }
+
+  auto entry = checkout(key);
+
+  if (isRoot) {
+    for (size_t i = 0; i < inputs[0].size(); i++) {
+      entry->src[i].copy_(inputs[0][i]);
+    }
+    const auto rank = getRank();
+    entry->run = [=]() mutable {
+      entry->algorithm->run();
+      outputs[0].copy_(entry->src[rank]);
+    };
+  } else {
+    entry->run = [=]() mutable {
+      entry->algorithm->run();
+      outputs[0].copy_(entry->dst[0]);
+    };
+  }
+
+  return enqueue(entry);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::send(
+    std::vector<at::Tensor>& tensors,
+    int dstRank,
+    int tag) {
+  if (tensors.size() != 1) {
+    throw std::invalid_argument("send requires a single tensor");
+  }
+  assertCPU(tensors[0].type(), "send");
+  assertRank(dstRank, getSize(), "destination rank");
+  if (dstRank == getRank()) {
+    throw std::invalid_argument("cannot send to self");
+  }
+  assertTag(tag);
+
+  AlgorithmKey key;
+  key.collectiveType = CollectiveType::SEND;
+  key.type = &tensors[0].type();
+  key.srcSizes = getSizes(tensors);
+  key.devices = getDevices(tensors);
+  key.dstRank = dstRank;
+  key.tag = tag;
+
+  auto entry = checkout(key);
+
+  entry->src[0].copy_(tensors[0]);
+  entry->run = [=]() mutable { entry->algorithm->run(); };
+
+  return enqueue(entry);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::recv(
+    std::vector<at::Tensor>& tensors,
+    int srcRank,
+    int tag) {
+  if (tensors.size() != 1) {
+    throw std::invalid_argument("recv requires a single tensor");
+  }
+  assertCPU(tensors[0].type(), "recv");
+  assertRank(srcRank, getSize(), "source rank");
+  if (srcRank == getRank()) {
+    throw std::invalid_argument("cannot receive from self");
+  }
+  assertTag(tag);
+
+  AlgorithmKey key;
+  key.collectiveType = CollectiveType::RECV;
+  key.type = &tensors[0].type();
+  key.srcSizes = getSizes(tensors);
+  key.devices = getDevices(tensors);
+  key.srcRank = srcRank;
+  key.tag = tag;
+
+  auto entry = checkout(key);
+
+  entry->run = [=]() mutable {
+    entry->algorithm->run();
+    tensors[0].copy_(entry->src[0]);
+  };
+
+  return enqueue(entry);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::barrier(
+    const BarrierOptions& /* unused */) {
+  AlgorithmKey key;
+  key.collectiveType = CollectiveType::BARRIER;
+
+  auto entry = checkout(key);
+  entry->run = [=]() mutable { entry->algorithm->run(); };
+
+  return enqueue(entry);
+}
+
 } // namespace c10d
@@ -43,7 +43,8 @@ struct AlgorithmKey {
         (devices == other.devices) && (srcSizes == other.srcSizes) &&
         (dstSizes == other.dstSizes) && (srcRank == other.srcRank) &&
         (dstRank == other.dstRank) && (srcTensor == other.srcTensor) &&
-        (dstTensor == other.dstTensor) && (reduceOp == other.reduceOp);
+        (dstTensor == other.dstTensor) && (reduceOp == other.reduceOp) &&
+        (tag == other.tag);
   }
 
   CollectiveType collectiveType = CollectiveType::UNUSED;
@@ -56,6 +57,7 @@ struct AlgorithmKey {
   int srcTensor = -1;
   int dstTensor = -1;
   ReduceOp reduceOp = ReduceOp::UNUSED;
+  int tag = -1;
 
   // This function is called by torch::hash<AlgorithmKey>
   static size_t hash(const AlgorithmKey& k) {
@@ -69,7 +71,8 @@ struct AlgorithmKey {
         k.dstRank,
         k.srcTensor,
         k.dstTensor,
-        k.reduceOp);
+        k.reduceOp,
+        k.tag);
   }
 };
 
@@ -243,6 +246,44 @@ class ProcessGroupGloo : public ProcessGroup {
       std::vector<at::Tensor>& tensors,
       const AllreduceOptions& opts = AllreduceOptions()) override;
 
+  std::shared_ptr<Work> reduce(
+      std::vector<at::Tensor>& tensors,
+      const ReduceOptions& opts = ReduceOptions()) override;
+
+  // The operations below only support CPU tensors.
+
+  std::shared_ptr<Work> allgather(
+      std::vector<std::vector<at::Tensor>>& outputTensors,
+      std::vector<at::Tensor>& inputTensors,
+      const AllgatherOptions& opts = AllgatherOptions()) override;
+
+  std::shared_ptr<Work> gather(
+      std::vector<std::vector<at::Tensor>>& outputTensors,
+      std::vector<at::Tensor>& inputTensors,
+      const GatherOptions& opts = GatherOptions()) override;
+
+  std::shared_ptr<Work> scatter(
+      std::vector<at::Tensor>& outputTensors,
+      std::vector<std::vector<at::Tensor>>& inputTensors,
+      const ScatterOptions& opts = ScatterOptions()) override;
+
+  // Point to point operations use Gloo slots derived from the tag, so
+  // that only the two processes involved need to take part. A tag must
+  // be in [0, 2^30 - 2^23) and can only be reused between the same pair
+  // of processes for tensors of identical type and size.
+  std::shared_ptr<Work> send(
+      std::vector<at::Tensor>& tensors,
+      int dstRank,
+      int tag) override;
+
+  std::shared_ptr<Work> recv(
+      std::vector<at::Tensor>& tensors,
+      int srcRank,
+      int tag) override;
+
+  std::shared_ptr<Work> barrier(
+      const BarrierOptions& opts = BarrierOptions()) override;
+
  protected:
   using KeyType = AlgorithmKey;
   using EntryType = std::unique_ptr<AlgorithmEntry>;
@@ -266,6 +307,19 @@ class ProcessGroupGloo : public ProcessGroup {
   template <typename T>
   void createBroadcast(AlgorithmEntry& entry);
 
+  template <typename T>
+  void createAllgather(AlgorithmEntry& entry);
+
+  void createGather(AlgorithmEntry& entry);
+
+  void createScatter(AlgorithmEntry& entry);
+
+  void createSend(AlgorithmEntry& entry);
+
+  void createRecv(AlgorithmEntry& entry);
+
+  void createBarrier(AlgorithmEntry& entry);
+
   // Construct creates AlgorithmEntry for specified key.
   EntryType construct(const KeyType& key);
 
@@ -21,8 +21,19 @@ class Store {
       const std::string& key,
       const std::vector<uint8_t>& value) = 0;
 
+  // Sets keys[i] to values[i] for all i. The default implementation calls
+  // set for every key, stores override it to do it in one operation.
+  virtual void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values);
+
   virtual std::vector<uint8_t> get(const std::string& key) = 0;
 
+  // Returns the values of keys, waiting for them like get does. The default
+  // implementation calls get for every key.
+  virtual std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys);
+
   virtual int64_t add(const std::string& key, int64_t value) = 0;
 
   virtual bool check(const std::vector<std::string>& keys) = 0;
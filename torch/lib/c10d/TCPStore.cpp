@@ -9,7 +9,15 @@ namespace c10d {
 
 namespace {
 
-enum class QueryType : uint8_t { SET, GET, ADD, CHECK, WAIT };
+enum class QueryType : uint8_t {
+  SET,
+  GET,
+  ADD,
+  CHECK,
+  WAIT,
+  MULTI_SET,
+  MULTI_GET
+};
 
 enum class CheckResponseType : uint8_t { READY, NOT_READY };
 
@@ -125,27 +133,7 @@ void TCPStoreDaemon::run() {
         ::close(fds[fdIdx].fd);
 
         // Remove all the tracking state of the close FD
-        for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
-          for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
-            if (*vecIt == fds[fdIdx].fd) {
-              vecIt = it->second.erase(vecIt);
-            } else {
-              ++vecIt;
-            }
-          }
-          if (it->second.size() == 0) {
-            it = waitingSockets_.erase(it);
-          } else {
-            ++it;
-          }
-        }
-        for (auto it = keysAwaited_.begin(); it != keysAwaited_.end();) {
-          if (it->first == fds[fdIdx].fd) {
-            it = keysAwaited_.erase(it);
-          } else {
-            ++it;
-          }
-        }
+        forgetWaitingClient(fds[fdIdx].fd);
         fds.erase(fds.begin() + fdIdx);
         sockets_.erase(sockets_.begin() + fdIdx - 2);
         --fdIdx;
@@ -168,6 +156,7 @@ void TCPStoreDaemon::stop() {
 // type of query | size of arg1 | arg1 | size of arg2 | arg2 | ...
 // or, in the case of wait
 // type of query | number of args | size of arg1 | arg1 | ...
+// and, in the case of multi_set, with a key and a value per arg
 void TCPStoreDaemon::query(int socket) {
   QueryType qt;
   tcputil::recvBytes<QueryType>(socket, &qt, 1);
@@ -187,6 +176,12 @@ void TCPStoreDaemon::query(int socket) {
   } else if (qt == QueryType::WAIT) {
     waitHandler(socket);
 
+  } else if (qt == QueryType::MULTI_SET) {
+    multiSetHandler(socket);
+
+  } else if (qt == QueryType::MULTI_GET) {
+    multiGetHandler(socket);
+
   } else {
     throw std::runtime_error("Unexpected query type");
   }
@@ -196,7 +191,12 @@ void TCPStoreDaemon::wakeupWaitingClients(const std::string& key) {
   auto socketsToWait = waitingSockets_.find(key);
   if (socketsToWait != waitingSockets_.end()) {
     for (int socket : socketsToWait->second) {
-      if (--keysAwaited_[socket] == 0) {
+      auto keysAwaited = keysAwaited_.find(socket);
+      if (keysAwaited == keysAwaited_.end()) {
+        continue;
+      }
+      if (--keysAwaited->second == 0) {
+        keysAwaited_.erase(keysAwaited);
         tcputil::sendValue<WaitResponseType>(
             socket, WaitResponseType::STOP_WAITING);
       }
@@ -205,6 +205,25 @@ void TCPStoreDaemon::wakeupWaitingClients(const std::string& key) {
   }
 }
 
+// Drops every wait registered by a socket
+void TCPStoreDaemon::forgetWaitingClient(int socket) {
+  for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
+    for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
+      if (*vecIt == socket) {
+        vecIt = it->second.erase(vecIt);
+      } else {
+        ++vecIt;
+      }
+    }
+    if (it->second.size() == 0) {
+      it = waitingSockets_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  keysAwaited_.erase(socket);
+}
+
 void TCPStoreDaemon::setHandler(int socket) {
   std::string key = tcputil::recvString(socket);
   tcpStore_[key] = tcputil::recvVector<uint8_t>(socket);
@@ -212,6 +231,16 @@ void TCPStoreDaemon::setHandler(int socket) {
   wakeupWaitingClients(key);
 }
 
+void TCPStoreDaemon::multiSetHandler(int socket) {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  for (size_t i = 0; i < nargs; i++) {
+    std::string key = tcputil::recvString(socket);
+    tcpStore_[key] = tcputil::recvVector<uint8_t>(socket);
+    wakeupWaitingClients(key);
+  }
+}
+
 void TCPStoreDaemon::addHandler(int socket) {
   std::string key = tcputil::recvString(socket);
   int64_t addVal = tcputil::recvValue<int64_t>(socket);
@@ -235,6 +264,19 @@ void TCPStoreDaemon::getHandler(int socket) const {
   tcputil::sendVector<uint8_t>(socket, data);
 }
 
+void TCPStoreDaemon::multiGetHandler(int socket) const {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  std::vector<std::string> keys(nargs);
+  for (size_t i = 0; i < nargs; i++) {
+    keys[i] = tcputil::recvString(socket);
+  }
+  for (size_t i = 0; i < nargs; i++) {
+    tcputil::sendVector<uint8_t>(
+        socket, tcpStore_.at(keys[i]), (i != (nargs - 1)));
+  }
+}
+
 void TCPStoreDaemon::checkHandler(int socket) const {
   SizeType nargs;
   tcputil::recvBytes<SizeType>(socket, &nargs, 1);
@@ -257,14 +299,26 @@ void TCPStoreDaemon::waitHandler(int socket) {
   for (size_t i = 0; i < nargs; i++) {
     keys[i] = tcputil::recvString(socket);
   }
-  if (checkKeys(keys)) {
+  // A client whose earlier wait timed out can still be registered for its
+  // keys. The new wait replaces that one.
+  if (keysAwaited_.count(socket) > 0) {
+    forgetWaitingClient(socket);
+  }
+  // Only the keys that are still missing are watched, each of them once
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  size_t missing = 0;
+  for (auto& key : keys) {
+    if (tcpStore_.count(key) == 0) {
+      waitingSockets_[key].push_back(socket);
+      ++missing;
+    }
+  }
+  if (missing == 0) {
     tcputil::sendValue<WaitResponseType>(
         socket, WaitResponseType::STOP_WAITING);
   } else {
-    for (auto& key : keys) {
-      waitingSockets_[key].push_back(socket);
-    }
-    keysAwaited_[socket] = keys.size();
+    keysAwaited_[socket] = missing;
   }
 }
 
@@ -309,6 +363,21 @@ void TCPStore::set(const std::string& key, const std::vector<uint8_t>& data) {
   tcputil::sendVector<uint8_t>(storeSocket_, data);
 }
 
+void TCPStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  if (keys.size() != values.size()) {
+    throw std::invalid_argument("multiSet: number of keys and values differ");
+  }
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_SET);
+  SizeType nkeys = keys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    tcputil::sendString(storeSocket_, keys[i], true);
+    tcputil::sendVector<uint8_t>(storeSocket_, values[i], (i != (nkeys - 1)));
+  }
+}
+
 std::vector<uint8_t> TCPStore::get(const std::string& key) {
   wait({key});
   tcputil::sendValue<QueryType>(storeSocket_, QueryType::GET);
@@ -316,6 +385,22 @@ std::vector<uint8_t> TCPStore::get(const std::string& key) {
   return tcputil::recvVector<uint8_t>(storeSocket_);
 }
 
+std::vector<std::vector<uint8_t>> TCPStore::multiGet(
+    const std::vector<std::string>& keys) {
+  wait(keys);
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_GET);
+  SizeType nkeys = keys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    tcputil::sendString(storeSocket_, keys[i], (i != (nkeys - 1)));
+  }
+  std::vector<std::vector<uint8_t>> values(nkeys);
+  for (size_t i = 0; i < nkeys; i++) {
+    values[i] = tcputil::recvVector<uint8_t>(storeSocket_);
+  }
+  return values;
+}
+
 int64_t TCPStore::add(const std::string& key, int64_t value) {
   tcputil::sendValue<QueryType>(storeSocket_, QueryType::ADD);
   tcputil::sendString(storeSocket_, key, true);
@@ -343,24 +428,33 @@ bool TCPStore::check(const std::vector<std::string>& keys) {
 void TCPStore::wait(
     const std::vector<std::string>& keys,
     const std::chrono::milliseconds& timeout) {
-  // Set the socket timeout if there is a wait timeout
-  if (timeout != kNoTimeout) {
-    struct timeval timeoutTV = {.tv_sec = timeout.count() / 1000,
-                                .tv_usec = (timeout.count() % 1000) * 1000};
-    SYSCHECK(::setsockopt(
-        storeSocket_,
-        SOL_SOCKET,
-        SO_RCVTIMEO,
-        reinterpret_cast<char*>(&timeoutTV),
-        sizeof(timeoutTV)));
-  }
+  // Set the socket timeout to the wait timeout. A zero timeout, which is
+  // kNoTimeout, clears the one set by an earlier wait.
+  struct timeval timeoutTV = {.tv_sec = timeout.count() / 1000,
+                              .tv_usec = (timeout.count() % 1000) * 1000};
+  SYSCHECK(::setsockopt(
+      storeSocket_,
+      SOL_SOCKET,
+      SO_RCVTIMEO,
+      reinterpret_cast<char*>(&timeoutTV),
+      sizeof(timeoutTV)));
   tcputil::sendValue<QueryType>(storeSocket_, QueryType::WAIT);
   SizeType nkeys = keys.size();
   tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
   for (size_t i = 0; i < nkeys; i++) {
     tcputil::sendString(storeSocket_, keys[i], (i != (nkeys - 1)));
   }
-  auto waitResponse = tcputil::recvValue<WaitResponseType>(storeSocket_);
+  WaitResponseType waitResponse;
+  try {
+    waitResponse = tcputil::recvValue<WaitResponseType>(storeSocket_);
+  } catch (...) {
+    // The daemon still has this wait registered and would answer it once the
+    // keys are set, where a later request would read the stale response.
+    // Reconnecting drops the registration along with the old connection.
+    ::close(storeSocket_);
+    storeSocket_ = tcputil::connect(tcpStoreAddr_, tcpStorePort_);
+    throw;
+  }
   if (waitResponse != WaitResponseType::STOP_WAITING) {
     throw std::runtime_error("Stop_waiting response is expected");
   }
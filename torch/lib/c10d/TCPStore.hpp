@@ -23,19 +23,22 @@ class TCPStoreDaemon {
   void query(int socket);
 
   void setHandler(int socket);
+  void multiSetHandler(int socket);
   void addHandler(int socket);
   void getHandler(int socket) const;
+  void multiGetHandler(int socket) const;
   void checkHandler(int socket) const;
   void waitHandler(int socket);
 
   bool checkKeys(const std::vector<std::string>& keys) const;
   void wakeupWaitingClients(const std::string& key);
+  void forgetWaitingClient(int socket);
 
   std::thread daemonThread_;
   std::unordered_map<std::string, std::vector<uint8_t>> tcpStore_;
   // From key -> the list of sockets waiting on it
   std::unordered_map<std::string, std::vector<int>> waitingSockets_;
-  // From socket -> number of keys awaited
+  // From socket -> number of missing keys awaited
   std::unordered_map<int, size_t> keysAwaited_;
 
   std::vector<int> sockets_;
@@ -54,8 +57,15 @@ class TCPStore : public Store {
 
   void set(const std::string& key, const std::vector<uint8_t>& value) override;
 
+  void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values) override;
+
   std::vector<uint8_t> get(const std::string& key) override;
 
+  std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys) override;
+
   int64_t add(const std::string& key, int64_t value) override;
 
   bool check(const std::vector<std::string>& keys) override;
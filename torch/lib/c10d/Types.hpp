@@ -7,6 +7,13 @@ namespace c10d {
 enum class CollectiveType : std::uint8_t {
   BROADCAST,
   ALLREDUCE,
+  REDUCE,
+  ALLGATHER,
+  GATHER,
+  SCATTER,
+  BARRIER,
+  SEND,
+  RECV,
   UNUSED,
 };
 
@@ -27,4 +34,22 @@ struct AllreduceOptions {
   ReduceOp reduceOp = ReduceOp::SUM;
 };
 
+struct ReduceOptions {
+  ReduceOp reduceOp = ReduceOp::SUM;
+  int rootRank = 0;
+  int rootTensor = 0;
+};
+
+struct AllgatherOptions {};
+
+struct GatherOptions {
+  int rootRank = 0;
+};
+
+struct ScatterOptions {
+  int rootRank = 0;
+};
+
+struct BarrierOptions {};
+
 } // namespace c10d
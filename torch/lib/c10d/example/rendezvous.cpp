@@ -0,0 +1,100 @@
+// Measures how long it takes N ranks, simulated by threads of this process,
+// to rendezvous through a store. Every rank publishes an address, then waits
+// for and reads the addresses of all ranks, like a full mesh connect does.
+//
+// Usage: rendezvous <file|tcp> <number of ranks> [iterations]
+
+#include <FileStore.hpp>
+#include <TCPStore.hpp>
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ::c10d;
+
+namespace {
+
+constexpr PortType kPort = 29501;
+
+std::string addressKey(int iteration, int rank) {
+  return "iter" + std::to_string(iteration) + "/addr" + std::to_string(rank);
+}
+
+void rendezvous(Store& store, int iteration, int rank, int size) {
+  std::string address = "rank" + std::to_string(rank) + ":12345";
+  store.set(
+      addressKey(iteration, rank),
+      std::vector<uint8_t>(address.begin(), address.end()));
+
+  std::vector<std::string> keys;
+  for (int i = 0; i < size; i++) {
+    keys.push_back(addressKey(iteration, i));
+  }
+  store.wait(keys, Store::kNoTimeout);
+  auto addresses = store.multiGet(keys);
+  if (addresses.size() != static_cast<size_t>(size)) {
+    throw std::runtime_error("Unexpected number of addresses");
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " <file|tcp> <number of ranks> [iterations]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string type = argv[1];
+  const int size = atoi(argv[2]);
+  const int iterations = argc > 3 ? atoi(argv[3]) : 5;
+
+  char path[] = "/tmp/c10d_rendezvousXXXXXX";
+  if (type == "file") {
+    ::close(mkstemp(path));
+  }
+
+  std::unique_ptr<TCPStore> server;
+  if (type == "tcp") {
+    server.reset(new TCPStore("127.0.0.1", kPort, true));
+  }
+
+  std::vector<std::unique_ptr<Store>> stores;
+  for (int rank = 0; rank < size; rank++) {
+    if (type == "file") {
+      stores.emplace_back(new FileStore(path));
+    } else {
+      stores.emplace_back(new TCPStore("127.0.0.1", kPort, false));
+    }
+  }
+
+  for (int iteration = 0; iteration < iterations; iteration++) {
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int rank = 0; rank < size; rank++) {
+      threads.emplace_back([&, rank] {
+        rendezvous(*stores[rank], iteration, rank, size);
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    std::cout << type << " store, " << size << " ranks: " << elapsed.count()
+              << " us" << std::endl;
+  }
+
+  stores.clear();
+  if (type == "file") {
+    ::unlink(path);
+  }
+  return EXIT_SUCCESS;
+}
@@ -74,6 +74,23 @@ int main(int argc, char** argv) {
     c10d::test::check(store, "counter", expected);
   }
 
+  // Batched set and get, and get of keys that another instance sets later
+  {
+    c10d::FileStore store(path);
+    c10d::test::set(store, "wait0", "value0");
+    std::thread thread([&] {
+      c10d::FileStore otherStore(path);
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      otherStore.multiSet({"wait1", "wait2"}, {{'1'}, {'2'}});
+    });
+    auto values = store.multiGet({"wait2", "wait0", "wait1"});
+    thread.join();
+    if (values != std::vector<std::vector<uint8_t>>{
+                      {'2'}, {'v', 'a', 'l', 'u', 'e', '0'}, {'1'}}) {
+      throw std::runtime_error("Unexpected multiGet result");
+    }
+  }
+
   unlink(path.c_str());
   std::cout << "Test succeeded" << std::endl;
   return 0;
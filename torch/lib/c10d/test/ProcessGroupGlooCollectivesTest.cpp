@@ -0,0 +1,180 @@
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <gloo/transport/tcp/device.h>
+
+#include "FileStore.hpp"
+#include "ProcessGroupGloo.hpp"
+#include "test/TestUtils.hpp"
+
+using namespace c10d::test;
+
+// Runs every collective and point to point operation across a group of
+// processes that rendezvous through a FileStore. Rank 0 runs in the
+// test process itself, all other ranks run in forked children.
+
+void check(const at::Tensor& tensor, float expected, const std::string& what) {
+  auto data = tensor.data<float>();
+  for (auto i = 0; i < tensor.numel(); i++) {
+    if (data[i] != expected) {
+      std::stringstream ss;
+      ss << what << ": expected " << expected << ", got " << data[i];
+      throw std::runtime_error(ss.str());
+    }
+  }
+}
+
+void wait(const std::shared_ptr<::c10d::ProcessGroup::Work>& work) {
+  if (!work->wait()) {
+    throw work->exception();
+  }
+}
+
+void testReduce(::c10d::ProcessGroup& pg, int rank, int size) {
+  for (auto root = 0; root < size; root++) {
+    std::vector<at::Tensor> tensors = {
+        at::ones(at::CPU(at::kFloat), {16, 16}) * rank};
+    ::c10d::ReduceOptions opts;
+    opts.rootRank = root;
+    wait(pg.reduce(tensors, opts));
+    if (rank == root) {
+      check(tensors[0], (size * (size - 1)) / 2, "reduce");
+    }
+  }
+}
+
+void testAllgather(::c10d::ProcessGroup& pg, int rank, int size) {
+  std::vector<at::Tensor> inputs = {
+      at::ones(at::CPU(at::kFloat), {16, 16}) * rank,
+      at::ones(at::CPU(at::kFloat), {16, 16}) * (rank + size)};
+  std::vector<std::vector<at::Tensor>> outputs(2);
+  for (auto& output : outputs) {
+    for (size_t i = 0; i < size * inputs.size(); i++) {
+      output.push_back(at::zeros(at::CPU(at::kFloat), {16, 16}));
+    }
+  }
+  wait(pg.allgather(outputs, inputs));
+  for (auto& output : outputs) {
+    for (auto r = 0; r < size; r++) {
+      check(output[2 * r], r, "allgather");
+      check(output[2 * r + 1], r + size, "allgather");
+    }
+  }
+}
+
+void testGather(::c10d::ProcessGroup& pg, int rank, int size) {
+  for (auto root = 0; root < size; root++) {
+    std::vector<at::Tensor> inputs = {
+        at::ones(at::CPU(at::kFloat), {16, 16}) * rank};
+    std::vector<std::vector<at::Tensor>> outputs;
+    if (rank == root) {
+      outputs.resize(1);
+      for (auto r = 0; r < size; r++) {
+        outputs[0].push_back(at::zeros(at::CPU(at::kFloat), {16, 16}));
+      }
+    }
+    ::c10d::GatherOptions opts;
+    opts.rootRank = root;
+    wait(pg.gather(outputs, inputs, opts));
+    if (rank == root) {
+      for (auto r = 0; r < size; r++) {
+        check(outputs[0][r], r, "gather");
+      }
+    }
+  }
+}
+
+void testScatter(::c10d::ProcessGroup& pg, int rank, int size) {
+  for (auto root = 0; root < size; root++) {
+    std::vector<at::Tensor> outputs = {
+        at::zeros(at::CPU(at::kFloat), {16, 16})};
+    std::vector<std::vector<at::Tensor>> inputs;
+    if (rank == root) {
+      inputs.resize(1);
+      for (auto r = 0; r < size; r++) {
+        inputs[0].push_back(at::ones(at::CPU(at::kFloat), {16, 16}) * r);
+      }
+    }
+    ::c10d::ScatterOptions opts;
+    opts.rootRank = root;
+    wait(pg.scatter(outputs, inputs, opts));
+    check(outputs[0], rank, "scatter");
+  }
+}
+
+void testSendRecv(::c10d::ProcessGroup& pg, int rank, int size) {
+  const auto next = (rank + 1) % size;
+  const auto prev = (rank + size - 1) % size;
+
+  // Repeat to exercise reuse of the cached transport buffers
+  for (auto i = 0; i < 3; i++) {
+    std::vector<at::Tensor> send = {
+        at::ones(at::CPU(at::kFloat), {16, 16}) * (rank + i)};
+    std::vector<at::Tensor> recv = {at::zeros(at::CPU(at::kFloat), {16, 16})};
+    auto sendWork = pg.send(send, next, 0);
+    auto recvWork = pg.recv(recv, prev, 0);
+    wait(sendWork);
+    wait(recvWork);
+    check(recv[0], prev + i, "recv");
+  }
+}
+
+void run(const std::string& path, int rank, int size) {
+  auto store = std::make_shared<::c10d::FileStore>(path);
+
+  ::c10d::ProcessGroupGloo::Options options;
+  options.timeout = std::chrono::milliseconds(5000);
+  ::gloo::transport::tcp::attr attr;
+  attr.hostname = "127.0.0.1";
+  options.devices.push_back(::gloo::transport::tcp::CreateDevice(attr));
+
+  ::c10d::ProcessGroupGloo pg(store, rank, size, options);
+  testReduce(pg, rank, size);
+  testAllgather(pg, rank, size);
+  testGather(pg, rank, size);
+  testScatter(pg, rank, size);
+  testSendRecv(pg, rank, size);
+  wait(pg.barrier());
+}
+
+int main(int argc, char** argv) {
+  const auto size = 4;
+  TemporaryFile file;
+
+  std::vector<pid_t> children;
+  for (auto rank = 1; rank < size; rank++) {
+    auto pid = fork();
+    if (pid < 0) {
+      throw std::system_error(errno, std::system_category(), "fork");
+    }
+    if (pid == 0) {
+      try {
+        run(file.path, rank, size);
+      } catch (const std::exception& ex) {
+        std::cerr << "Rank " << rank << " failed: " << ex.what() << std::endl;
+        _exit(1);
+      }
+      _exit(0);
+    }
+    children.push_back(pid);
+  }
+
+  run(file.path, 0, size);
+
+  for (auto pid : children) {
+    int status;
+    if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != 0) {
+      std::cerr << "Child process " << pid << " failed" << std::endl;
+      return 1;
+    }
+  }
+
+  std::cout << "Test successful" << std::endl;
+  return 0;
+}
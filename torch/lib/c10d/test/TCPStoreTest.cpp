@@ -1,6 +1,7 @@
 #include "TCPStore.hpp"
 #include "StoreTestCommon.hpp"
 
+#include <atomic>
 #include <cstdlib>
 #include <iostream>
 #include <thread>
@@ -83,6 +84,48 @@ int main(int argc, char** argv) {
     c10d::test::check(serverStore, key, val);
   }
 
+  // Batched set and get, and get of keys that another client sets later
+  {
+    c10d::TCPStore clientStore("127.0.0.1", 29500, false);
+    c10d::test::set(serverStore, "wait0", "value0");
+    std::thread thread([&] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      clientStore.multiSet({"wait1", "wait2"}, {{'1'}, {'2'}});
+    });
+    auto values = serverStore.multiGet({"wait2", "wait0", "wait1"});
+    thread.join();
+    if (values != std::vector<std::vector<uint8_t>>{
+                      {'2'}, {'v', 'a', 'l', 'u', 'e', '0'}, {'1'}}) {
+      throw std::runtime_error("Unexpected multiGet result");
+    }
+  }
+
+  // A wait that timed out must not be woken up by its keys later on
+  {
+    c10d::TCPStore clientStore("127.0.0.1", 29500, false);
+    bool timedOut = false;
+    try {
+      clientStore.wait({"stale0"}, std::chrono::milliseconds(10));
+    } catch (const std::exception&) {
+      timedOut = true;
+    }
+    if (!timedOut) {
+      throw std::runtime_error("Expected wait to time out");
+    }
+    std::atomic<bool> done(false);
+    std::thread thread([&] {
+      clientStore.wait({"stale1"});
+      done = true;
+    });
+    c10d::test::set(serverStore, "stale0", "value0");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    if (done) {
+      throw std::runtime_error("Wait returned before its key was set");
+    }
+    c10d::test::set(serverStore, "stale1", "value1");
+    thread.join();
+  }
+
   std::cout << "Test succeeded" << std::endl;
   return EXIT_SUCCESS;
 }
@@ -2,6 +2,7 @@ import difflib
 import inspect
 import os
 import io
+import mmap as _mmap
 import shutil
 import struct
 import sys
@@ -26,6 +27,9 @@ SHORT_SIZE = struct.Struct('=h').size
 
 MAGIC_NUMBER = 0x1950a86a20f9469cfc6c
 PROTOCOL_VERSION = 1001
+# Same as PROTOCOL_VERSION, except that the storage data is placed at page
+# aligned offsets that are recorded before the pickled object, see _save
+PAGE_ALIGNED_PROTOCOL_VERSION = 1002
 STORAGE_KEY_SEPARATOR = ','
 
 
@@ -179,7 +183,7 @@ def _check_seekable(f):
         raise_err_msg(["seek", "tell"], e)
 
 
-def save(obj, f, pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL):
+def save(obj, f, pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL, page_aligned=False):
     """Saves an object to a disk file.
 
     See also: :ref:`recommend-saving-models`
@@ -190,6 +194,11 @@ def save(obj, f, pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL):
            containing a file name
         pickle_module: module used for pickling metadata and objects
         pickle_protocol: can be specified to override the default protocol
+        page_aligned: if ``True``, the data of every storage is written at a
+           page aligned offset, so that ``torch.load(f, mmap=True)`` can map
+           it instead of reading it. ``f`` has to be a real file. Files saved
+           this way can't be loaded by versions of PyTorch that predate this
+           option.
 
     .. warning::
         If you are using Python 2, torch.save does NOT support StringIO.StringIO
@@ -206,10 +215,10 @@ def save(obj, f, pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL):
         >>> buffer = io.BytesIO()
         >>> torch.save(x, buffer)
     """
-    return _with_file_like(f, "wb", lambda f: _save(obj, f, pickle_module, pickle_protocol))
+    return _with_file_like(f, "wb", lambda f: _save(obj, f, pickle_module, pickle_protocol, page_aligned))
 
 
-def _save(obj, f, pickle_module, pickle_protocol):
+def _save(obj, f, pickle_module, pickle_protocol, page_aligned=False):
     if sys.version_info[0] == 2:
         import StringIO
         if isinstance(f, StringIO.StringIO):
@@ -262,8 +271,12 @@ def _save(obj, f, pickle_module, pickle_protocol):
 
         return None
 
+    if page_aligned and not _should_read_directly(f):
+        raise ValueError("torch.save with page_aligned=True requires a real file")
+    protocol_version = PAGE_ALIGNED_PROTOCOL_VERSION if page_aligned else PROTOCOL_VERSION
+
     sys_info = dict(
-        protocol_version=PROTOCOL_VERSION,
+        protocol_version=protocol_version,
         little_endian=sys.byteorder == 'little',
         type_sizes=dict(
             short=SHORT_SIZE,
@@ -273,8 +286,11 @@ def _save(obj, f, pickle_module, pickle_protocol):
     )
 
     pickle_module.dump(MAGIC_NUMBER, f, protocol=pickle_protocol)
-    pickle_module.dump(PROTOCOL_VERSION, f, protocol=pickle_protocol)
+    pickle_module.dump(protocol_version, f, protocol=pickle_protocol)
     pickle_module.dump(sys_info, f, protocol=pickle_protocol)
+    if page_aligned:
+        return _save_page_aligned(obj, f, pickle_module, pickle_protocol,
+                                  persistent_id, serialized_storages)
     pickler = pickle_module.Pickler(f, protocol=pickle_protocol)
     pickler.persistent_id = persistent_id
     pickler.dump(obj)
@@ -286,7 +302,42 @@ def _save(obj, f, pickle_module, pickle_protocol):
         serialized_storages[key]._write_file(f, _should_read_directly(f))
 
 
-def load(f, map_location=None, pickle_module=pickle):
+def _save_page_aligned(obj, f, pickle_module, pickle_protocol, persistent_id, serialized_storages):
+    # The storages are only known once obj has been pickled, but their offsets
+    # have to be written before it, so that the loader can map them while
+    # unpickling. Layout after the sys_info header:
+    #   pickled list of storage keys
+    #   int64 data offset of every storage, followed by the end of the file
+    #   pickled obj
+    #   for every storage: padding, int64 number of elements, data
+    # where every data offset is a multiple of the page size.
+    buffer = io.BytesIO()
+    pickler = pickle_module.Pickler(buffer, protocol=pickle_protocol)
+    pickler.persistent_id = persistent_id
+    pickler.dump(obj)
+    pickled_obj = buffer.getvalue()
+
+    serialized_storage_keys = sorted(serialized_storages.keys())
+    pickle_module.dump(serialized_storage_keys, f, protocol=pickle_protocol)
+
+    offsets = []
+    position = f.tell() + 8 * (len(serialized_storage_keys) + 1) + len(pickled_obj)
+    for key in serialized_storage_keys:
+        storage = serialized_storages[key]
+        # leave room for the element count that precedes the data
+        offset = (position + 8 + _mmap.PAGESIZE - 1) // _mmap.PAGESIZE * _mmap.PAGESIZE
+        offsets.append(offset)
+        position = offset + storage.size() * storage.element_size()
+    f.write(struct.pack('<{}q'.format(len(offsets) + 1), *(offsets + [position])))
+    f.write(pickled_obj)
+    f.flush()
+    for key, offset in zip(serialized_storage_keys, offsets):
+        f.seek(offset - 8)
+        serialized_storages[key]._write_file(f, True)
+    f.seek(position)
+
+
+def load(f, map_location=None, pickle_module=pickle, mmap=False):
     """Loads an object saved with :func:`torch.save` from a file.
 
     :meth:`torch.load` uses Python's unpickling facilities but treats storages,
@@ -325,6 +376,14 @@ def load(f, map_location=None, pickle_module=pickle):
             locations
         pickle_module: module used for unpickling metadata and objects (has to
             match the pickle_module used to serialize file)
+        mmap: if ``True`` and `f` is a real file saved with
+            ``torch.save(..., page_aligned=True)``, CPU storages are backed by
+            a private memory mapping of the file instead of being read into
+            memory. Loading then takes time proportional to the size of the
+            metadata, data is paged in as it is accessed, and processes that
+            load the same file share its pages until they write to them. The
+            file must not be truncated or modified while the loaded storages
+            are alive. Ignored for other files.
 
     .. note::
         When you call :meth:`torch.load()` on a file which contains GPU tensors, those tensors
@@ -353,13 +412,13 @@ def load(f, map_location=None, pickle_module=pickle):
         new_fd = True
         f = open(f, 'rb')
     try:
-        return _load(f, map_location, pickle_module)
+        return _load(f, map_location, pickle_module, mmap)
     finally:
         if new_fd:
             f.close()
 
 
-def _load(f, map_location, pickle_module):
+def _load(f, map_location, pickle_module, mmap=False):
     deserialized_objects = {}
 
     if map_location is None:
@@ -475,6 +534,17 @@ def _load(f, map_location, pickle_module):
             return result
 
     deserialized_objects = {}
+    # data offsets of the storages of page aligned files, keyed by root key
+    storage_offsets = {}
+    mapped_storage_keys = set()
+
+    def new_storage(data_type, root_key, size):
+        if root_key in storage_offsets and size > 0:
+            offset = storage_offsets[root_key]
+            if offset % _mmap.PAGESIZE == 0:
+                mapped_storage_keys.add(root_key)
+                return normalize_storage_type(data_type)._new_mapped_from_file(f, offset, size)
+        return data_type(size)
 
     def persistent_load(saved_id):
         assert isinstance(saved_id, tuple)
@@ -490,7 +560,7 @@ def _load(f, map_location, pickle_module):
             data_type, root_key, location, size, view_metadata = data
             if root_key not in deserialized_objects:
                 deserialized_objects[root_key] = restore_location(
-                    data_type(size), location)
+                    new_storage(data_type, root_key, size), location)
             storage = deserialized_objects[root_key]
             if view_metadata is not None:
                 view_key, offset, view_size = view_metadata
@@ -518,10 +588,18 @@ def _load(f, map_location, pickle_module):
     if magic_number != MAGIC_NUMBER:
         raise RuntimeError("Invalid magic number; corrupt file?")
     protocol_version = pickle_module.load(f)
-    if protocol_version != PROTOCOL_VERSION:
+    if protocol_version not in (PROTOCOL_VERSION, PAGE_ALIGNED_PROTOCOL_VERSION):
         raise RuntimeError("Invalid protocol version: %s" % protocol_version)
 
     _sys_info = pickle_module.load(f)
+    if protocol_version == PAGE_ALIGNED_PROTOCOL_VERSION:
+        return _load_page_aligned(f, pickle_module, persistent_load, deserialized_objects,
+                                  storage_offsets, mapped_storage_keys,
+                                  mmap and f_should_read_directly and sys.platform != 'win32')
+    if mmap:
+        warnings.warn("torch.load(..., mmap=True) can only map files saved with "
+                      "torch.save(..., page_aligned=True); reading the storages instead")
+
     unpickler = pickle_module.Unpickler(f)
     unpickler.persistent_load = persistent_load
     result = unpickler.load()
@@ -535,3 +613,29 @@ def _load(f, map_location, pickle_module):
         offset = None
 
     return result
+
+
+def _load_page_aligned(f, pickle_module, persistent_load, deserialized_objects,
+                       storage_offsets, mapped_storage_keys, mmap):
+    deserialized_storage_keys = pickle_module.load(f)
+    num_storages = len(deserialized_storage_keys)
+    offsets = struct.unpack('<{}q'.format(num_storages + 1), f.read(8 * (num_storages + 1)))
+    if mmap:
+        storage_offsets.update(zip(deserialized_storage_keys, offsets))
+
+    unpickler = pickle_module.Unpickler(f)
+    unpickler.persistent_load = persistent_load
+    result = unpickler.load()
+
+    f_should_read_directly = _should_read_directly(f)
+    for key, offset in zip(deserialized_storage_keys, offsets):
+        assert key in deserialized_objects
+        if key in mapped_storage_keys:
+            continue
+        # the element count is stored right before the data
+        f.seek(offset - 8)
+        deserialized_objects[key]._set_from_file(
+            f, offset - 8 if f_should_read_directly else None, f_should_read_directly)
+
+    f.seek(offsets[-1])
+    return result